@@ -24,13 +24,28 @@
  */
 
 #include <config.h>
+#include <elf.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <link.h>
 #include <ltdl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include "cli_plugins.h"
 #include "openvswitch/vlog.h"
 #include <string.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "command.h"
+#include "dynamic-string.h"
+#include "hmap.h"
+#include "sset.h"
+#include "util.h"
+#include "vty_utils.h"
+#include "vtysh/vtysh_ovsdb_if.h"
+#include "vtysh/vtysh_ovsdb_config.h"
 
 
 #define PLUGINS_CALL(FUN) \
@@ -47,6 +62,8 @@ do { \
 
 VLOG_DEFINE_THIS_MODULE(cli_plugins);
 
+extern vector cmdvec;
+
 typedef void(*plugin_func)(void);
 
 /* plugin_class structure used for calling feature specific
@@ -61,6 +78,63 @@ struct plugin_class {
  */
 static lt_dlinterface_id interface_id;
 
+/* Loading hints, kept for the plugins loaded on demand. */
+static lt_dladvise plugins_advise;
+
+/* A plugin shipping a manifest.  It is only loaded when one of its
+ * commands is matched, described or completed, or when the running-config
+ * is shown if it installs running-config contexts.
+ *
+ * The manifest is FEATURES_CLI_MANIFEST_PATH/<plugin>.manifest, as written
+ * by "vtysh --plugin-manifest=PLUGIN", with one entry per line:
+ *
+ *     command NODE WORD     First keyword of a command of node NODE, or
+ *                           "*" if the command starts with an argument.
+ *                           NODE is the name of the node, such as
+ *                           CONFIG_NODE, not its value.
+ *     column TABLE COLUMN read|display
+ *                           Column the plugin registers in the IDL.
+ *     context               The plugin installs running-config contexts.
+ *
+ * The IDL cannot monitor more columns once it is connected, so the
+ * columns are registered from the manifest at startup.  A plugin can only
+ * have a manifest if it registers its columns with
+ * vtysh_ovsdb_add_columns(), "vtysh --plugin-manifest" fails for a plugin
+ * that calls one of manifest_idl_functions. */
+struct plugin {
+    char *filename;
+    bool loaded;
+    bool context;
+};
+
+/* A "command" entry of a manifest, in plugin_commands by node. */
+struct plugin_command {
+    struct hmap_node hmap_node;
+    int node;
+    char *word;
+    struct plugin *plugin;
+};
+
+static struct plugin **plugins;
+static size_t n_plugins, allocated_plugins;
+static struct hmap plugin_commands = HMAP_INITIALIZER(&plugin_commands);
+
+/* Whether vtysh_cli_post_init() has run. */
+static bool plugins_post_init_done;
+
+/* Manifest being recorded by "vtysh --plugin-manifest". */
+static struct ds manifest_columns = DS_EMPTY_INITIALIZER;
+static struct sset manifest_commands = SSET_INITIALIZER(&manifest_commands);
+static bool manifest_recording;
+static bool manifest_context;
+
+/* IDL functions a plugin with a manifest must not call: the columns they
+ * register would not be listed in its manifest. */
+static const char *const manifest_idl_functions[] = {
+    "ovsdb_idl_add_table",
+    "ovsdb_idl_add_column",
+};
+
 /* List of disabled CLI plugins */
 static char *cli_disable_plugins[] = {
   NULL
@@ -104,83 +178,314 @@ plugins_cli_destroy(void)
 }
 
 /*
- * Function : plugins_open_plugin.
- * Responsibility : Load and call the feature specific module and cli node
+ * Function : plugins_load_plugin.
+ * Responsibility : Load the feature specific module and call its cli node
  *                  init function.
  * Parameters :
- *   const char *filename: Module filename which is passed by libltdl.
- *   void *data : It contains module loading modes,
- *                which is initialized by libltdl.
- * Return : Return 0 on success.
+ *   const char *filename: Module filename.
+ * Return : The module handle, NULL on failure.
  */
-static int
-plugins_open_plugin(const char *filename, void *data)
+static lt_dlhandle
+plugins_load_plugin(const char *filename)
 {
     struct plugin_class plcl = {NULL};
     lt_dlhandle handle;
 
-    if (plugins_check_if_plugin_is_disabled(filename)) {
-        VLOG_DBG("Plugin %s is disabled\n",filename);
-        return CLI_PLUGINS_SUCCESS;
-    }
-
-    if (!(handle = lt_dlopenadvise(filename, *(lt_dladvise *)data))) {
+    if (!(handle = lt_dlopenadvise(filename, plugins_advise))) {
         VLOG_ERR("Failed loading %s: %s\n", filename, lt_dlerror());
-        plugins_cli_destroy();
-        return CLI_PLUGINS_ERR;
+        return NULL;
     }
 
     plcl.cli_init = lt_dlsym(handle, "cli_pre_init");
     if (plcl.cli_init == NULL) {
-        plugins_cli_destroy();
-        return CLI_PLUGINS_ERR;
+        return NULL;
     }
 
 
     if (lt_dlcaller_set_data(interface_id, handle, &plcl)) {
         VLOG_ERR("plugin %s initialized twice\n", filename);
-        plugins_cli_destroy();
-        return CLI_PLUGINS_ERR;
+        return NULL;
     }
 
     plcl.cli_init();
 
     VLOG_DBG("Loaded plugin library %s\n", filename);
-    return CLI_PLUGINS_SUCCESS;
+    return handle;
+}
+
+/* Snapshot of the number of commands of every node. */
+static size_t *
+plugins_count_commands(size_t *n_nodes)
+{
+    size_t *counts;
+    size_t i;
+
+    *n_nodes = vector_active(cmdvec);
+    counts = xmalloc(*n_nodes * sizeof *counts);
+    for (i = 0; i < *n_nodes; i++) {
+        struct cmd_node *cnode = vector_slot(cmdvec, i);
+
+        counts[i] = cnode ? vector_active(cnode->cmd_vector) : 0;
+    }
+    return counts;
+}
+
+/* Record in the manifest the commands installed since counts was taken. */
+static void
+plugins_record_commands(size_t *counts, size_t n_nodes)
+{
+    size_t i, j;
+
+    for (i = 0; i < vector_active(cmdvec); i++) {
+        struct cmd_node *cnode = vector_slot(cmdvec, i);
+        const char *node_name = cmd_node_name(i);
+
+        if (cnode == NULL) {
+            continue;
+        }
+        for (j = i < n_nodes ? counts[i] : 0;
+             j < vector_active(cnode->cmd_vector); j++) {
+            struct cmd_element *cmd = vector_slot(cnode->cmd_vector, j);
+            const char *keyword;
+            size_t len;
+            char *entry;
+
+            if (cmd == NULL) {
+                continue;
+            }
+            if (node_name == NULL) {
+                VLOG_ERR("node %"PRIuSIZE" has no name, the plugin cannot "
+                         "have a manifest", i);
+                exit(EXIT_FAILURE);
+            }
+            len = cmd_element_keyword(cmd, &keyword);
+            entry = len ? xasprintf("command %s %.*s", node_name, (int) len,
+                                    keyword)
+                        : xasprintf("command %s *", node_name);
+            sset_add_and_free(&manifest_commands, entry);
+        }
+    }
+    free(counts);
+}
+
+/* Load a deferred plugin and install its commands.  Called with the IDL
+ * lock held. */
+static void
+plugins_load_deferred(struct plugin *plugin)
+{
+    plugin_func post_init;
+    lt_dlhandle handle;
+
+    plugin->loaded = true;
+    handle = plugins_load_plugin(plugin->filename);
+    if (handle == NULL) {
+        return;
+    }
+
+    /* Before vtysh_cli_post_init(), it calls cli_post_init() itself. */
+    post_init = lt_dlsym(handle, "cli_post_init");
+    if (plugins_post_init_done && post_init) {
+        post_init();
+    }
+}
+
+/* Installed as cmd_demand_hook, loads the deferred plugins with a command
+ * in node that word can be the first word of. */
+static void
+plugins_cli_demand(enum node_type node, const char *word)
+{
+    struct plugin_command *command;
+    size_t word_len = word ? strlen(word) : 0;
+    bool locked = false;
+
+    HMAP_FOR_EACH_WITH_HASH (command, hmap_node, node, &plugin_commands) {
+        if (command->node != node || command->plugin->loaded) {
+            continue;
+        }
+        if (word_len && strcmp(command->word, "*")
+            && strncmp(command->word, word, word_len)) {
+            continue;
+        }
+        if (!locked) {
+            VTYSH_OVSDB_LOCK;
+            locked = true;
+        }
+        plugins_load_deferred(command->plugin);
+    }
+    if (locked) {
+        VTYSH_OVSDB_UNLOCK;
+    }
+}
+
+/* Read the manifest of plugin, if it has one, and register its columns and
+ * commands.  Returns false if the plugin must be loaded now. */
+static bool
+plugins_read_manifest(const char *manifest_path, struct plugin *plugin)
+{
+    const char *base = strrchr(plugin->filename, '/');
+    struct plugin_command **commands = NULL;
+    size_t n_commands = 0, allocated_commands = 0;
+    char line[256];
+    char *filename;
+    FILE *file;
+    bool ok = true;
+    size_t i;
+
+    base = base ? base + 1 : plugin->filename;
+    filename = xasprintf("%s/%.*s.manifest", manifest_path,
+                         (int) strcspn(base, "."), base);
+    file = fopen(filename, "r");
+    if (file == NULL) {
+        free(filename);
+        return false;
+    }
+
+    while (ok && fgets(line, sizeof line, file)) {
+        char *save_ptr = NULL;
+        char *type = strtok_r(line, " \t\n", &save_ptr);
+        char *arg1 = strtok_r(NULL, " \t\n", &save_ptr);
+        char *arg2 = strtok_r(NULL, " \t\n", &save_ptr);
+        char *arg3 = strtok_r(NULL, " \t\n", &save_ptr);
+
+        if (type == NULL || type[0] == '#') {
+            continue;
+        } else if (!strcmp(type, "command") && arg1 && arg2) {
+            int node = cmd_node_by_name(arg1);
+            struct plugin_command *command;
+
+            /* Nodes are recorded by name, a node this vtysh does not have
+             * means the manifest is stale. */
+            if (node < 0) {
+                ok = false;
+                continue;
+            }
+            command = xmalloc(sizeof *command);
+            command->node = node;
+            command->word = xstrdup(arg2);
+            command->plugin = plugin;
+            if (n_commands >= allocated_commands) {
+                commands = x2nrealloc(commands, &allocated_commands,
+                                      sizeof *commands);
+            }
+            commands[n_commands++] = command;
+        } else if (!strcmp(type, "column") && arg1 && arg2 && arg3) {
+            ok = vtysh_ovsdb_add_column_by_name(
+                arg1, arg2, !strcmp(arg3, "display")
+                            ? VTYSH_OVSDB_COLUMN_DISPLAY
+                            : VTYSH_OVSDB_COLUMN_READ);
+        } else if (!strcmp(type, "context")) {
+            plugin->context = true;
+        } else {
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    if (!ok) {
+        VLOG_WARN("Ignoring invalid manifest %s\n", filename);
+    }
+    for (i = 0; i < n_commands; i++) {
+        if (ok) {
+            hmap_insert(&plugin_commands, &commands[i]->hmap_node,
+                        commands[i]->node);
+        } else {
+            free(commands[i]->word);
+            free(commands[i]);
+        }
+    }
+    free(commands);
+    free(filename);
+    return ok;
 }
 
 /*
- * Function : plugins_cli_init.
- * Responsibility : Initialize feature specific cli commands.
- * Parameters : const char *path : libltdl search path.
- * Return : void.
+ * Function : plugins_open_plugin.
+ * Responsibility : Load and call the feature specific module and cli node
+ *                  init function, or defer it if the module has a manifest.
+ * Parameters :
+ *   const char *filename: Module filename which is passed by libltdl.
+ *   void *data : Directory of the manifests.
+ * Return : Return 0 on success.
  */
-void
-plugins_cli_init(const char *path)
+static int
+plugins_open_plugin(const char *filename, void *data)
 {
-     lt_dladvise advise;
+    struct plugin *plugin;
+
+    if (plugins_check_if_plugin_is_disabled(filename)) {
+        VLOG_DBG("Plugin %s is disabled\n",filename);
+        return CLI_PLUGINS_SUCCESS;
+    }
+
+    plugin = xzalloc(sizeof *plugin);
+    plugin->filename = xstrdup(filename);
+    if (plugins_read_manifest(data, plugin)) {
+        if (n_plugins >= allocated_plugins) {
+            plugins = x2nrealloc(plugins, &allocated_plugins,
+                                 sizeof *plugins);
+        }
+        plugins[n_plugins++] = plugin;
+        VLOG_DBG("Deferred plugin library %s\n", filename);
+        return CLI_PLUGINS_SUCCESS;
+    }
+    free(plugin->filename);
+    free(plugin);
+
+    if (!plugins_load_plugin(filename)) {
+        plugins_cli_destroy();
+        return CLI_PLUGINS_ERR;
+    }
+    return CLI_PLUGINS_SUCCESS;
+}
 
+/* Initialize libltdl and the loading hints.  Returns false on failure. */
+static bool
+plugins_ltdl_init(const char *path)
+{
     /* Initialize libltdl, set libltdl search path.
      * Initialize advise parameter,which is used to pass hints
      * to module loader when using lt_dlopenadvise to perform the loading.
      */
     if (lt_dlinit() ||
-        lt_dlsetsearchpath(path) ||
-        lt_dladvise_init(&advise)) {
+        (path && lt_dlsetsearchpath(path)) ||
+        lt_dladvise_init(&plugins_advise)) {
         VLOG_ERR("ltdl initializations: %s\n", lt_dlerror());
-        return;
+        return false;
     }
 
     /* Register ops-cli interface validator with libltdl. */
     if (!(interface_id = lt_dlinterface_register("ops-cli", NULL))) {
         VLOG_ERR("lt_dlinterface_register: %s\n", lt_dlerror());
-        if (lt_dladvise_destroy(&advise)) {
+        if (lt_dladvise_destroy(&plugins_advise)) {
             VLOG_ERR("destroying ltdl advise%s\n", lt_dlerror());
         }
+        return false;
+    }
+
+    /* Set symglobal hint. */
+    if (lt_dladvise_global(&plugins_advise) ||
+        lt_dladvise_ext (&plugins_advise)) {
+        VLOG_ERR("ltdl setting advise: %s\n", lt_dlerror());
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Function : plugins_cli_init.
+ * Responsibility : Initialize feature specific cli commands.
+ * Parameters : const char *path : libltdl search path.
+ *              const char *manifest_path : Directory of the manifests.
+ * Return : void.
+ */
+void
+plugins_cli_init(const char *path, const char *manifest_path)
+{
+    if (!plugins_ltdl_init(path)) {
         return;
     }
 
-    /* Set symglobal hint and call the feature specific cli init function via
+    /* Call the feature specific cli init function via
      * pluginins_open_plugin function pointer.
      * 'lt_dlforeachfile' function will continue to make calls to
      * 'plugins_open_plugin()' for each file that it discovers in search_path
@@ -189,16 +494,204 @@ plugins_cli_init(const char *path)
      * `lt_dlforeachfile' returns value returned by the last call
      * made to 'plugins_open_plugin'.
      */
-    if (lt_dladvise_global(&advise) || lt_dladvise_ext (&advise) ||
-        lt_dlforeachfile(lt_dlgetsearchpath(), &plugins_open_plugin, &advise)) {
-        VLOG_ERR("ltdl setting advise: %s\n", lt_dlerror());
+    if (lt_dlforeachfile(lt_dlgetsearchpath(), &plugins_open_plugin,
+                         CONST_CAST(char *, manifest_path))) {
+        VLOG_ERR("ltdl loading plugins: %s\n", lt_dlerror());
         return;
     }
 
-    VLOG_INFO("Successfully initialized all plugins");
+    if (n_plugins) {
+        cmd_demand_hook = plugins_cli_demand;
+    }
+    VLOG_INFO("Successfully initialized all plugins, %"PRIuSIZE" deferred",
+              n_plugins);
     return;
 }
 
+/* Returns the first of manifest_idl_functions that the dynamic symbol
+ * table of the library at filename refers to, or NULL if none does. */
+static const char *
+plugins_find_idl_function(const char *filename)
+{
+    const char *found = NULL;
+    const ElfW(Ehdr) *ehdr;
+    const ElfW(Shdr) *shdrs;
+    struct stat st;
+    size_t i, j, k;
+    char *map;
+    int fd;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        VLOG_ERR("Cannot open %s (%s)", filename, ovs_strerror(errno));
+        return NULL;
+    }
+    if (fstat(fd, &st) < 0 || st.st_size < sizeof *ehdr) {
+        close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    ehdr = (const ElfW(Ehdr) *) map;
+    if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG)
+        || ehdr->e_shentsize != sizeof *shdrs
+        || ehdr->e_shoff + (size_t) ehdr->e_shnum * sizeof *shdrs
+           > st.st_size) {
+        goto out;
+    }
+    shdrs = (const ElfW(Shdr) *) (map + ehdr->e_shoff);
+    for (i = 0; i < ehdr->e_shnum; i++) {
+        const ElfW(Shdr) *strtab;
+        const ElfW(Sym) *syms;
+        size_t n_syms;
+
+        if (shdrs[i].sh_type != SHT_DYNSYM
+            || shdrs[i].sh_link >= ehdr->e_shnum
+            || shdrs[i].sh_offset + shdrs[i].sh_size > st.st_size) {
+            continue;
+        }
+        strtab = &shdrs[shdrs[i].sh_link];
+        if (strtab->sh_offset + strtab->sh_size > st.st_size) {
+            continue;
+        }
+        syms = (const ElfW(Sym) *) (map + shdrs[i].sh_offset);
+        n_syms = shdrs[i].sh_size / sizeof *syms;
+        for (j = 0; j < n_syms; j++) {
+            const char *name = map + strtab->sh_offset + syms[j].st_name;
+
+            if (syms[j].st_name >= strtab->sh_size
+                || !memchr(name, '\0', strtab->sh_size - syms[j].st_name)) {
+                continue;
+            }
+            for (k = 0; k < ARRAY_SIZE(manifest_idl_functions); k++) {
+                if (!strcmp(name, manifest_idl_functions[k])) {
+                    found = manifest_idl_functions[k];
+                    goto out;
+                }
+            }
+        }
+    }
+
+out:
+    munmap(map, st.st_size);
+    return found;
+}
+
+/*
+ * Function : plugins_cli_manifest.
+ * Responsibility : Load a single plugin and record its manifest, which
+ *                  plugins_cli_manifest_write() prints once
+ *                  vtysh_cli_post_init() has run.
+ * Parameters : const char *filename : Path of the plugin.
+ * Return : void.
+ */
+void
+plugins_cli_manifest(const char *filename)
+{
+    const lt_dlinfo *info;
+    const char *function;
+    unsigned int contexts;
+    lt_dlhandle handle;
+    size_t *counts;
+    size_t n_nodes;
+
+    if (!plugins_ltdl_init(NULL)) {
+        exit(EXIT_FAILURE);
+    }
+
+    manifest_recording = true;
+    counts = plugins_count_commands(&n_nodes);
+    contexts = vtysh_sh_run_context_installs();
+    vtysh_ovsdb_record_columns(&manifest_columns);
+    handle = plugins_load_plugin(filename);
+    if (!handle) {
+        exit(EXIT_FAILURE);
+    }
+
+    /* A column registered behind vtysh_ovsdb_add_columns() would be
+     * missing from the IDL of the sessions that defer the plugin. */
+    info = lt_dlgetinfo(handle);
+    function = plugins_find_idl_function(info && info->filename
+                                         ? info->filename : filename);
+    if (function) {
+        VLOG_ERR("%s calls %s(), it must register its columns with "
+                 "vtysh_ovsdb_add_columns() to have a manifest",
+                 filename, function);
+        exit(EXIT_FAILURE);
+    }
+    vtysh_ovsdb_record_columns(NULL);
+    manifest_context = vtysh_sh_run_context_installs() != contexts;
+    plugins_record_commands(counts, n_nodes);
+}
+
+/*
+ * Function : plugins_cli_manifest_write.
+ * Responsibility : Write the manifest recorded by plugins_cli_manifest().
+ * Parameters : FILE *stream : Where to write it.
+ * Return : void.
+ */
+void
+plugins_cli_manifest_write(FILE *stream)
+{
+    const char **commands;
+    size_t i;
+
+    fputs("# Generated by vtysh --plugin-manifest\n", stream);
+    fputs(ds_cstr(&manifest_columns), stream);
+    commands = sset_sort(&manifest_commands);
+    for (i = 0; i < sset_count(&manifest_commands); i++) {
+        fprintf(stream, "%s\n", commands[i]);
+    }
+    free(commands);
+    if (manifest_context) {
+        fputs("context\n", stream);
+    }
+}
+
+/*
+ * Function : plugins_cli_load_all.
+ * Responsibility : Load the deferred plugins, e.g. before forking sessions
+ *                  that should share them.
+ * Parameters : void.
+ * Return : void.
+ */
+void
+plugins_cli_load_all(void)
+{
+    size_t i;
+
+    VTYSH_OVSDB_LOCK;
+    for (i = 0; i < n_plugins; i++) {
+        if (!plugins[i]->loaded) {
+            plugins_load_deferred(plugins[i]);
+        }
+    }
+    VTYSH_OVSDB_UNLOCK;
+}
+
+/*
+ * Function : plugins_cli_load_contexts.
+ * Responsibility : Load the deferred plugins that install running-config
+ *                  contexts.  Called with the IDL lock held.
+ * Parameters : void.
+ * Return : void.
+ */
+void
+plugins_cli_load_contexts(void)
+{
+    size_t i;
+
+    for (i = 0; i < n_plugins; i++) {
+        if (plugins[i]->context && !plugins[i]->loaded) {
+            plugins_load_deferred(plugins[i]);
+        }
+    }
+}
+
 /*
  * Function : vtysh_cli_post_init.
  * Responsibility : Initialize all feature specific cli elements.
@@ -208,5 +701,17 @@ plugins_cli_init(const char *path)
 void
 vtysh_cli_post_init(void)
 {
+    unsigned int contexts = vtysh_sh_run_context_installs();
+    size_t *counts = NULL;
+    size_t n_nodes = 0;
+
+    if (manifest_recording) {
+        counts = plugins_count_commands(&n_nodes);
+    }
     PLUGINS_CALL(cli_post_init);
+    plugins_post_init_done = true;
+    if (manifest_recording) {
+        manifest_context |= vtysh_sh_run_context_installs() != contexts;
+        plugins_record_commands(counts, n_nodes);
+    }
 }
@@ -27,12 +27,18 @@
 #ifndef CLI_PLUGINS_H
 #define CLI_PLUGINS_H 1
 
+#include <stdio.h>
+
 #ifdef  __cplusplus
 extern "C" {
 #endif
 
 #ifdef __linux__
-void plugins_cli_init(const char *path);
+void plugins_cli_init(const char *path, const char *manifest_path);
+void plugins_cli_manifest(const char *filename);
+void plugins_cli_manifest_write(FILE *stream);
+void plugins_cli_load_all(void);
+void plugins_cli_load_contexts(void);
 void vtysh_cli_post_init(void);
 #endif
 
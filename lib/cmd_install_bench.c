@@ -0,0 +1,196 @@
+/* Command installation microbenchmark.
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This file is part of GNU Zebra.
+ *
+ * GNU Zebra is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * GNU Zebra is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Zebra; see the file COPYING.  If not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Installs a corpus of configuration and show commands, as vtysh and its
+   plugins do at startup, and reports the time and resident memory it
+   takes three ways: installing only, as install_element () now does;
+   then typing a few lines, which parses the elements sharing their first
+   keyword; then cmd_parse_all (), which parses every element as
+   install_element () used to at startup.  The argument is the number of
+   commands built from templates, 5000 by default, or a file of format
+   strings, one per line, such as the DEFUN strings of vtysh and its
+   plugins.  Build with "make cmd_install_bench". */
+
+#include <zebra.h>
+
+#include "command.h"
+#include "memory.h"
+#include "vector.h"
+
+/* The first keyword is numbered by groups of 100 commands, so that
+   typing a line only parses the elements of its template in one group. */
+static const struct
+{
+  const char *string;
+  const char *doc;
+} templates[] =
+{
+  { "route%d A.B.C.D/M (A.B.C.D|INTERFACE) {<1-255>|tag <1-4294967295>}",
+    "Static route\nPrefix\nNexthop\nInterface\nDistance\nTag\n"
+    "Tag value\n" },
+  { "prefix-list%d WORD seq <1-4294967295> (permit|deny) A.B.C.D/M "
+    "{ge <0-32>|le <0-32>}",
+    "Prefix list\nName\nSequence\nSequence number\nPermit\nDeny\nPrefix\n"
+    "Minimum length\nLength\nMaximum length\nLength\n" },
+  { "neighbor%d (A.B.C.D|X:X::X:X|WORD) remote-as <1-4294967295>",
+    "Neighbor\nIPv4 address\nIPv6 address\nPeer group\nRemote AS\n"
+    "AS number\n" },
+  { "show%d interface [IFNAME] {brief|transceiver|queues}",
+    "Show running system information\nInterface information\n"
+    "Interface name\nBrief summary\nTransceiver\nQueues\n" },
+  { "vlan%d <1-4094> name WORD",
+    "VLAN\nVLAN id\nName\nVLAN name\n" },
+};
+
+static const char *lines[] =
+{
+  "route7 10.1.0.0/16 10.0.0.1 5",
+  "show8 interface 1 brief",
+  "neighbor9 10.2.2.2 remote-as 65000",
+};
+
+/* Help string long enough for any format string of the corpus. */
+static char file_doc[60 * sizeof ("Help string of one token\n")];
+
+static int
+bench_func (struct cmd_element *self, struct vty *vty, int vtysh_flags,
+	    int argc, const char *argv[])
+{
+  return CMD_SUCCESS;
+}
+
+static double
+elapsed (struct timeval *start)
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - start->tv_sec) * 1000.0
+    + (now.tv_usec - start->tv_usec) / 1000.0;
+}
+
+/* Resident set size of the process, in kB, from /proc/self/status. */
+static long
+rss_kb (void)
+{
+  char line[128];
+  long kb = -1;
+  FILE *f;
+
+  f = fopen ("/proc/self/status", "r");
+  if (f == NULL)
+    return -1;
+  while (fgets (line, sizeof (line), f))
+    if (sscanf (line, "VmRSS: %ld kB", &kb) == 1)
+      break;
+  fclose (f);
+  return kb;
+}
+
+static void
+report (const char *what, double ms, long before, long after)
+{
+  printf ("%-26s %9.1f ms %+9ld kB RSS\n", what, ms, after - before);
+}
+
+int
+main (int argc, char **argv)
+{
+  struct cmd_element *cmds;
+  struct timeval start;
+  struct vty vty;
+  vector vline, matches;
+  char buf[1024];
+  long rss, rss_base;
+  FILE *file = NULL;
+  int n_cmds = 5000;
+  int status;
+  int i, n;
+
+  if (argc > 1 && (n_cmds = atoi (argv[1])) <= 0)
+    {
+      file = fopen (argv[1], "r");
+      if (file == NULL)
+	{
+	  fprintf (stderr, "usage: %s [COMMANDS|FILE]\n", argv[0]);
+	  return 1;
+	}
+      for (n_cmds = 0; fgets (buf, sizeof (buf), file); n_cmds++)
+	;
+      rewind (file);
+      for (i = 0; i < 60; i++)
+	strcat (file_doc, "Help string of one token\n");
+    }
+
+  cmd_init (1);
+  memset (&vty, 0, sizeof (vty));
+  vty.node = CONFIG_NODE;
+
+  /* Strings and elements are built before the first measure, they are
+     static data of the DEFUNs in vtysh. */
+  cmds = XCALLOC (MTYPE_TMP, n_cmds * sizeof (struct cmd_element));
+  for (i = 0; i < n_cmds; i++)
+    {
+      if (file)
+	{
+	  if (!fgets (buf, sizeof (buf), file))
+	    buf[0] = '\0';
+	  buf[strcspn (buf, "\n")] = '\0';
+	  cmds[i].doc = file_doc;
+	}
+      else
+	{
+	  n = i % ZEBRA_NUM_OF (templates);
+	  snprintf (buf, sizeof (buf), templates[n].string, i / 100);
+	  cmds[i].doc = templates[n].doc;
+	}
+      cmds[i].string = XSTRDUP (MTYPE_TMP, buf);
+      cmds[i].func = bench_func;
+    }
+  if (file)
+    fclose (file);
+
+  printf ("%d commands\n", n_cmds);
+  rss_base = rss = rss_kb ();
+  gettimeofday (&start, NULL);
+  for (i = 0; i < n_cmds; i++)
+    install_element (CONFIG_NODE, &cmds[i]);
+  report ("install (lazy)", elapsed (&start), rss, rss_kb ());
+
+  rss = rss_kb ();
+  gettimeofday (&start, NULL);
+  for (i = 0; i < (int) ZEBRA_NUM_OF (lines); i++)
+    {
+      vline = cmd_make_strvec (lines[i]);
+      matches = cmd_describe_command (vline, &vty, &status);
+      if (matches)
+	vector_free (matches);
+      cmd_free_strvec (vline);
+    }
+  report ("type 3 lines", elapsed (&start), rss, rss_kb ());
+
+  rss = rss_kb ();
+  gettimeofday (&start, NULL);
+  cmd_parse_all ();
+  report ("parse all (eager, before)", elapsed (&start), rss, rss_kb ());
+  printf ("%-26s %12s %+9ld kB RSS\n", "total", "", rss_kb () - rss_base);
+  return 0;
+}
@@ -0,0 +1,171 @@
+/* Command matcher microbenchmark.
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This file is part of GNU Zebra.
+ *
+ * GNU Zebra is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * GNU Zebra is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Zebra; see the file COPYING.  If not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Installs corpora of 100, 1k and 5k configuration commands built from
+   route, prefix-list, neighbor and VLAN templates, then times
+   cmd_describe_command () over a set of command lines with the token
+   classification cache off and on, checking that both give the same
+   matches.  Build with "make cmd_match_bench". */
+
+#include <zebra.h>
+
+#include "command.h"
+#include "memory.h"
+#include "vector.h"
+
+#define LINES_PER_RUN 20000
+
+static const int corpus_sizes[] = { 100, 1000, 5000 };
+
+/* Every template ends with a keyword unique to the command, so each
+   element is a distinct candidate for every word before it. */
+static const struct
+{
+  const char *string;
+  const char *doc;
+} templates[] =
+{
+  { "ip route A.B.C.D/M A.B.C.D <1-255> t%d",
+    "IP information\nStatic route\nPrefix\nNexthop\nDistance\nTag\n" },
+  { "ip route A.B.C.D A.B.C.D A.B.C.D t%d",
+    "IP information\nStatic route\nPrefix\nMask\nNexthop\nTag\n" },
+  { "ip prefix-list WORD seq <1-4294967295> permit A.B.C.D/M t%d",
+    "IP information\nPrefix list\nName\nSequence\nSequence number\n"
+    "Permit\nPrefix\nTag\n" },
+  { "ipv6 route X:X::X:X/M X:X::X:X <1-255> t%d",
+    "IPv6 information\nStatic route\nPrefix\nNexthop\nDistance\nTag\n" },
+  { "neighbor (A.B.C.D|X:X::X:X) remote-as <1-4294967295> t%d",
+    "Neighbor\nIPv4 address\nIPv6 address\nRemote AS\nAS number\nTag\n" },
+  { "vlan <1-4094> name WORD t%d",
+    "VLAN\nVLAN id\nName\nVLAN name\nTag\n" },
+};
+
+static const char *lines[] =
+{
+  "ip route 10.1.0.0/16 10.0.0.1 5 t7",
+  "ip route 10.1.0.0 255.255.0.0 10.0.0.1 t12",
+  "ip route 10.1.0.0/16 10.0.0.",
+  "ip prefix-list PL1 seq 10 permit 192.168.0.0/24 t3",
+  "ipv6 route 2001:db8::/32 fe80::1 1 t40",
+  "neighbor 10.2.2.2 remote-as 65000 t5",
+  "neighbor 2001:db8::2 remote-as 65000 t9",
+  "vlan 100 name users t11",
+  "vlan 5000 name users t11",
+  "ip route 300.1.1.1/8 10.0.0.1 1 t1",
+};
+
+static int
+bench_func (struct cmd_element *self, struct vty *vty, int vtysh_flags,
+	    int argc, const char *argv[])
+{
+  return CMD_SUCCESS;
+}
+
+static double
+elapsed (struct timeval *start)
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - start->tv_sec) * 1000.0
+    + (now.tv_usec - start->tv_usec) / 1000.0;
+}
+
+static void
+install_corpus (int from, int to)
+{
+  struct cmd_element *cmd;
+  char buf[128];
+  int i, n;
+
+  for (i = from; i < to; i++)
+    {
+      n = i % ZEBRA_NUM_OF (templates);
+      snprintf (buf, sizeof (buf), templates[n].string, i);
+      cmd = XCALLOC (MTYPE_TMP, sizeof (struct cmd_element));
+      cmd->string = XSTRDUP (MTYPE_TMP, buf);
+      cmd->doc = templates[n].doc;
+      cmd->func = bench_func;
+      install_element (CONFIG_NODE, cmd);
+    }
+}
+
+/* Describe every line LINES_PER_RUN times in total, adding the number of
+   matches of each line to counts. */
+static double
+run (struct vty *vty, unsigned int *counts)
+{
+  struct timeval start;
+  vector vline, matches;
+  unsigned int i, n;
+  int status;
+
+  gettimeofday (&start, NULL);
+  for (i = 0; i < LINES_PER_RUN; i++)
+    {
+      n = i % ZEBRA_NUM_OF (lines);
+      vline = cmd_make_strvec (lines[n]);
+      matches = cmd_describe_command (vline, vty, &status);
+      counts[n] += (matches ? vector_active (matches) : 0) * 16 + status;
+      if (matches)
+	vector_free (matches);
+      cmd_free_strvec (vline);
+    }
+  return elapsed (&start);
+}
+
+int
+main (int argc, char **argv)
+{
+  unsigned int plain[ZEBRA_NUM_OF (lines)], cached[ZEBRA_NUM_OF (lines)];
+  struct vty vty;
+  double plain_ms, cached_ms;
+  unsigned int i, j;
+  int installed = 0;
+  int mismatch = 0;
+
+  cmd_init (1);
+  memset (&vty, 0, sizeof (vty));
+  vty.node = CONFIG_NODE;
+
+  for (i = 0; i < ZEBRA_NUM_OF (corpus_sizes); i++)
+    {
+      install_corpus (installed, corpus_sizes[i]);
+      installed = corpus_sizes[i];
+
+      memset (plain, 0, sizeof (plain));
+      memset (cached, 0, sizeof (cached));
+      cmd_token_class_enable (0);
+      plain_ms = run (&vty, plain);
+      cmd_token_class_enable (1);
+      cached_ms = run (&vty, cached);
+      for (j = 0; j < ZEBRA_NUM_OF (lines); j++)
+	if (plain[j] != cached[j])
+	  mismatch++;
+
+      printf ("%5d commands: %8.1f us/line uncached, %8.1f us/line "
+	      "cached\n", installed, plain_ms * 1e3 / LINES_PER_RUN,
+	      cached_ms * 1e3 / LINES_PER_RUN);
+    }
+
+  printf ("%d mismatches\n", mismatch);
+  return mismatch ? 1 : 0;
+}
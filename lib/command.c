@@ -26,6 +26,7 @@ Boston, MA 02111-1307, USA.  */
 
 
 #include "memory.h"
+#include "hash.h"
 #include "log.h"
 #include <lib/version.h>
 #include "thread.h"
@@ -44,6 +45,7 @@ Boston, MA 02111-1307, USA.  */
 #include "vtysh/utils/tacacs_vtysh_utils.h"
 #include "vtysh/utils/audit_log_utils.h"
 #include "ovsdb-idl.h"
+#include "timeval.h"
 #include "vtysh/utils/vlan_vtysh_utils.h"
 #include <latch.h>
 VLOG_DEFINE_THIS_MODULE(vtysh_command);
@@ -250,6 +252,9 @@ install_node (struct cmd_node *node,
   node->cmd_vector = vector_init (VECTOR_MIN_SIZE);
 }
 
+/* Command line count, see cmd_token_class_get(). */
+static __thread unsigned int cmd_token_class_epoch = 1;
+
 /* Breaking up string into each command piece. I assume given
    character is separated by a space character. Return value is a
    vector which includes char ** data element. */
@@ -277,6 +282,10 @@ cmd_make_strvec (const char *string)
   if (*cp == '!' || *cp == '#')
     return NULL;
 
+  /* Results of the OVSDB validators only hold for this command line. */
+  if (++cmd_token_class_epoch == 0)
+    cmd_token_class_epoch = 1;
+
   /* Prepare return vector. */
   strvec = vector_init (VECTOR_MIN_SIZE);
 
@@ -340,14 +349,218 @@ struct format_parser_state
   int in_multiple; /* flag to remember if we are in a multiple group */
   int just_read_word; /* flag to remember if the last thing we red was a
                        * real word and not some abstract token */
+  int error; /* set when the string could not be parsed */
 };
 #endif
 
+/* Pool of the strings of command tokens.  The same keywords and help
+   strings ("show", IP_STR, NO_STR...) appear in thousands of commands, so
+   each distinct string is stored once and reference counted.  Terminal
+   tokens without a dynamic help string are shared the same way by all the
+   commands they appear in, see cmd_token_share(). */
+struct cmd_intern
+{
+  const char *str;
+  size_t len;
+  unsigned int refcnt;
+  char buf[];
+};
+
+static struct hash *cmd_intern_hash;
+static struct hash *cmd_token_hash;
+
+static unsigned int
+cmd_intern_hash_key (void *data)
+{
+  struct cmd_intern *entry = data;
+  unsigned int key = 0;
+  size_t i;
+
+  for (i = 0; i < entry->len; i++)
+    key = (key * 33) ^ (unsigned char) entry->str[i];
+  return key;
+}
+
+static int
+cmd_intern_hash_cmp (const void *a, const void *b)
+{
+  const struct cmd_intern *entry1 = a;
+  const struct cmd_intern *entry2 = b;
+
+  return entry1->len == entry2->len
+         && memcmp (entry1->str, entry2->str, entry1->len) == 0;
+}
+
+/* Return the pooled copy of the first len characters of str. */
+static char *
+cmd_intern (const char *str, size_t len)
+{
+  struct cmd_intern key, *entry;
+
+  if (cmd_intern_hash == NULL)
+    cmd_intern_hash = hash_create (cmd_intern_hash_key, cmd_intern_hash_cmp);
+
+  key.str = str;
+  key.len = len;
+  entry = hash_lookup (cmd_intern_hash, &key);
+  if (entry)
+    {
+      entry->refcnt++;
+      return entry->buf;
+    }
+
+  entry = XMALLOC (MTYPE_CMD_INTERN, sizeof (struct cmd_intern) + len + 1);
+  memcpy (entry->buf, str, len);
+  entry->buf[len] = '\0';
+  entry->str = entry->buf;
+  entry->len = len;
+  entry->refcnt = 1;
+  hash_get (cmd_intern_hash, entry, hash_alloc_intern);
+  return entry->buf;
+}
+
+/* Drop a reference to a string returned by cmd_intern(). */
+static void
+cmd_unintern (char *str)
+{
+  struct cmd_intern *entry;
+
+  if (str == NULL)
+    return;
+
+  entry = (struct cmd_intern *) (str - offsetof (struct cmd_intern, buf));
+  if (--entry->refcnt > 0)
+    return;
+
+  hash_release (cmd_intern_hash, entry);
+  XFREE (MTYPE_CMD_INTERN, entry);
+}
+
+/* Shared tokens are found by their pooled strings, so comparing the
+   pointers is enough. */
+static unsigned int
+cmd_token_hash_key (void *data)
+{
+  struct cmd_token *token = data;
+
+  return (unsigned int) ((uintptr_t) token->cmd / sizeof (void *) * 33
+                         ^ (uintptr_t) token->desc / sizeof (void *));
+}
+
+static int
+cmd_token_hash_cmp (const void *a, const void *b)
+{
+  const struct cmd_token *token1 = a;
+  const struct cmd_token *token2 = b;
+
+  return token1->cmd == token2->cmd && token1->desc == token2->desc;
+}
+
+/* Pool the help string of a terminal token just read by the parser and
+   return the token already shared with the same word and help string, if
+   any, in place of it. */
+static struct cmd_token *
+cmd_token_share (struct cmd_token *token)
+{
+  struct cmd_token *shared;
+  char *desc = token->desc;
+
+  token->desc = desc ? cmd_intern (desc, strlen (desc)) : NULL;
+  XFREE (MTYPE_CMD_TOKENS, desc);
+
+  if (cmd_token_hash == NULL)
+    cmd_token_hash = hash_create (cmd_token_hash_key, cmd_token_hash_cmp);
+
+  shared = hash_lookup (cmd_token_hash, token);
+  if (shared)
+    {
+      shared->refcnt++;
+      cmd_unintern (token->cmd);
+      cmd_unintern (token->desc);
+      XFREE (MTYPE_CMD_TOKENS, token);
+      return shared;
+    }
+
+  token->refcnt = 1;
+  hash_get (cmd_token_hash, token, hash_alloc_intern);
+  return token;
+}
+
+static void
+cmd_intern_stats (struct hash_backet *backet, void *arg)
+{
+  struct cmd_intern *entry = backet->data;
+  struct cmd_pool_stats *stats = arg;
+
+  stats->string_refs += entry->refcnt;
+  stats->string_bytes += entry->len + 1;
+  stats->saved_bytes += (entry->refcnt - 1) * (entry->len + 1);
+}
+
+static void
+cmd_token_stats (struct hash_backet *backet, void *arg)
+{
+  struct cmd_token *token = backet->data;
+  struct cmd_pool_stats *stats = arg;
+  size_t size = sizeof (struct cmd_token) + strlen (token->cmd) + 1;
+
+  if (token->desc)
+    size += strlen (token->desc) + 1;
+  stats->token_refs += token->refcnt;
+  stats->saved_bytes += (token->refcnt - 1) * size;
+}
+
+/* Report the pooled strings and shared tokens, with the memory that
+   private copies of them would take on top. */
+void
+cmd_pool_stats_get (struct cmd_pool_stats *stats)
+{
+  unsigned int i, j;
+  struct cmd_node *cnode;
+  struct cmd_element *cmd;
+
+  memset (stats, 0, sizeof (*stats));
+  if (cmd_intern_hash)
+    {
+      stats->strings = cmd_intern_hash->count;
+      hash_iterate (cmd_intern_hash, cmd_intern_stats, stats);
+    }
+  if (cmd_token_hash)
+    {
+      stats->tokens = cmd_token_hash->count;
+      hash_iterate (cmd_token_hash, cmd_token_stats, stats);
+    }
+
+  if (!cmdvec)
+    return;
+  for (i = 0; i < vector_active (cmdvec); i++)
+    if ((cnode = vector_slot (cmdvec, i)) != NULL)
+      for (j = 0; j < vector_active (cnode->cmd_vector); j++)
+        if ((cmd = vector_slot (cnode->cmd_vector, j)) != NULL)
+          {
+            stats->elements++;
+            if (cmd->tokens)
+              stats->parsed++;
+          }
+}
+
+/* Set while a command is parsed on first use in a running session, where a
+   broken format string must not end the session. */
+static int format_parser_recover;
+
 static void
 format_parser_error(struct format_parser_state *state, const char *message)
 {
   int offset = state->cp - state->string + 1;
 
+  state->error = 1;
+  if (format_parser_recover)
+    {
+      VLOG_ERR ("Error parsing command \"%s\": %s at offset %d, "
+                "command disabled", state->string, message, offset);
+      return;
+    }
+
   fprintf(stderr, "\nError parsing command: \"%s\"\n", state->string);
   fprintf(stderr, "                        %*c\n", offset, '^');
   fprintf(stderr, "%s at offset %d.\n", message, offset);
@@ -440,7 +653,10 @@ format_parser_begin_keyword(struct format_parser_state *state)
 
   if (state->in_keyword
       || state->in_multiple)
-    format_parser_error(state, "Unexpected '{'");
+    {
+      format_parser_error(state, "Unexpected '{'");
+      return;
+    }
 
   state->cp++;
   state->in_keyword = 1;
@@ -462,10 +678,16 @@ format_parser_begin_multiple(struct format_parser_state *state)
   struct cmd_token *token;
 
   if (state->in_keyword == 1)
-    format_parser_error(state, "Keyword starting with '('");
+    {
+      format_parser_error(state, "Keyword starting with '('");
+      return;
+    }
 
   if (state->in_multiple)
-    format_parser_error(state, "Nested group");
+    {
+      format_parser_error(state, "Nested group");
+      return;
+    }
 
   state->cp++;
   state->in_multiple = 1;
@@ -486,10 +708,16 @@ format_parser_end_keyword(struct format_parser_state *state)
 {
   if (state->in_multiple
       || !state->in_keyword)
-    format_parser_error(state, "Unexpected '}'");
+    {
+      format_parser_error(state, "Unexpected '}'");
+      return;
+    }
 
   if (state->in_keyword == 1)
-    format_parser_error(state, "Empty keyword group");
+    {
+      format_parser_error(state, "Empty keyword group");
+      return;
+    }
 
   state->cp++;
   state->in_keyword = 0;
@@ -502,10 +730,16 @@ format_parser_end_multiple(struct format_parser_state *state)
   char *dummy;
 
   if (!state->in_multiple)
-    format_parser_error(state, "Unepexted ')'");
+    {
+      format_parser_error(state, "Unepexted ')'");
+      return;
+    }
 
   if (vector_active(state->curvect) == 0)
-    format_parser_error(state, "Empty multiple section");
+    {
+      format_parser_error(state, "Empty multiple section");
+      return;
+    }
 
   if (!state->just_read_word)
     {
@@ -555,6 +789,7 @@ format_parser_handle_pipe(struct format_parser_state *state)
   else
     {
       format_parser_error(state, "Unexpected '|'");
+      return;
     }
 }
 
@@ -563,7 +798,6 @@ format_parser_read_word(struct format_parser_state *state)
 {
   const char *start;
   int len;
-  char *cmd;
   struct cmd_token *token;
   struct dyn_cb_func * dyn_cb_temp;
 
@@ -575,13 +809,10 @@ format_parser_read_word(struct format_parser_state *state)
     state->cp++;
 
   len = state->cp - start;
-  cmd = XMALLOC(MTYPE_CMD_TOKENS, len + 1);
-  memcpy(cmd, start, len);
-  cmd[len] = '\0';
 
   token = XCALLOC(MTYPE_CMD_TOKENS, sizeof(*token));
   token->type = TOKEN_TERMINAL;
-  token->cmd = cmd;
+  token->cmd = cmd_intern(start, len);
   token->desc = format_parser_desc_str(state);
 
   if ((state->dyn_cbp != NULL) && (token->dyn_cb == NULL))
@@ -602,6 +833,10 @@ format_parser_read_word(struct format_parser_state *state)
     }
   }
 
+  /* Dynamic help strings are rewritten in the token, keep it private. */
+  if (token->dyn_cb == NULL)
+    token = cmd_token_share(token);
+
   vector_set(state->curvect, token);
 
   if (state->in_keyword == 1)
@@ -610,6 +845,20 @@ format_parser_read_word(struct format_parser_state *state)
   state->just_read_word = 1;
 }
 
+static void cmd_terminate_token (struct cmd_token *token);
+
+/* Free the tokens of a format string that failed to parse. */
+static void
+cmd_free_tokens (vector tokens)
+{
+  unsigned int i;
+
+  for (i = 0; i < vector_active (tokens); i++)
+    if (vector_slot (tokens, i) != NULL)
+      cmd_terminate_token (vector_slot (tokens, i));
+  vector_free (tokens);
+}
+
 /**
  * Parse a given command format string and build a tree of tokens from
  * it that is suitable to be used by the command subsystem.
@@ -645,7 +894,9 @@ cmd_parse_format(const char *string, const char *descstr, const char *dyn_cb_str
           if (state.in_keyword
               || state.in_multiple)
             format_parser_error(&state, "Unclosed group/keyword");
-          return state.topvect;
+          if (!state.error)
+            return state.topvect;
+          break;
         case '{':
           format_parser_begin_keyword(&state);
           break;
@@ -668,6 +919,12 @@ cmd_parse_format(const char *string, const char *descstr, const char *dyn_cb_str
           utils_format_parser_read_word(&state);
 #endif
         }
+
+      if (state.error)
+        {
+          cmd_free_tokens (state.topvect);
+          return NULL;
+        }
     }
 }
 
@@ -700,13 +957,193 @@ install_element (enum node_type ntype, struct cmd_element *cmd)
       exit (1);
     }
 
+  /* The format string is parsed by cmd_element_tokens() on first use. */
   vector_set (cnode->cmd_vector, cmd);
-  if (cmd->tokens == NULL)
+}
+
+static vector
+cmd_element_parse (struct cmd_element *cmd)
+{
 #ifndef ENABLE_OVSDB
-    cmd->tokens = cmd_parse_format(cmd->string, cmd->doc, cmd->dyn_cb_str);
+  return cmd_parse_format(cmd->string, cmd->doc, cmd->dyn_cb_str);
 #else
-    cmd->tokens = utils_cmd_parse_format(cmd->string, cmd->doc, cmd->dyn_cb_str);
+  return utils_cmd_parse_format(cmd->string, cmd->doc, cmd->dyn_cb_str);
+#endif
+}
+
+/* Tokens of a command element, parsed from its format string the first
+   time the element is matched.  Most elements are never matched in a
+   session, so install_element() leaves them unparsed. */
+static vector
+cmd_element_tokens (struct cmd_element *cmd)
+{
+  if (cmd->tokens != NULL
+      || (cmd->attr & CMD_ATTR_DISABLED) == CMD_ATTR_DISABLED)
+    return cmd->tokens;
+
+  /* A broken format string only disables its command, the error is
+     logged and "vtysh --dryrun" reports it. */
+  format_parser_recover = 1;
+  cmd->tokens = cmd_element_parse (cmd);
+  format_parser_recover = 0;
+  if (cmd->tokens == NULL)
+    cmd->attr |= CMD_ATTR_DISABLED;
+  return cmd->tokens;
+}
+
+/* Parse the format strings of all installed commands, so that format
+   errors are reported at once and a process forking sessions shares the
+   tokens with them. */
+void
+cmd_parse_all (void)
+{
+  unsigned int i, j;
+  struct cmd_node *cnode;
+  struct cmd_element *cmd;
+
+  if (!cmdvec)
+    return;
+
+  for (i = 0; i < vector_active (cmdvec); i++)
+    if ((cnode = vector_slot (cmdvec, i)) != NULL)
+      for (j = 0; j < vector_active (cnode->cmd_vector); j++)
+        if ((cmd = vector_slot (cnode->cmd_vector, j)) != NULL
+            && cmd->tokens == NULL)
+          cmd->tokens = cmd_element_parse (cmd);
+}
+
+/* Return the length of the keyword a command element starts with, with
+   *keyword pointing to it, or 0 if the element starts with an argument or
+   a group. */
+size_t
+cmd_element_keyword (const struct cmd_element *cmd, const char **keyword)
+{
+  const char *str = cmd->string;
+  size_t len;
+
+  while (isspace ((int) *str))
+    str++;
+  if (!islower ((int) *str))
+    return 0;
+  for (len = 0; str[len] != '\0' && !isspace ((int) str[len]); len++)
+    if (!islower ((int) str[len]) && !isdigit ((int) str[len])
+        && str[len] != '-' && str[len] != '_')
+      return 0;
+
+  *keyword = str;
+  return len;
+}
+
+/* Names of the nodes, by node, for the files recording commands by node,
+   such as the plugin manifests of vtysh, which must not depend on the
+   order of enum node_type. */
+#define CMD_NODE_NAME(NODE) [NODE] = #NODE
+static const char *const cmd_node_names[] =
+{
+  CMD_NODE_NAME (AUTH_NODE),
+  CMD_NODE_NAME (RESTRICTED_NODE),
+  CMD_NODE_NAME (VIEW_NODE),
+  CMD_NODE_NAME (AUTH_ENABLE_NODE),
+  CMD_NODE_NAME (ENABLE_NODE),
+  CMD_NODE_NAME (CONFIG_NODE),
+  CMD_NODE_NAME (SERVICE_NODE),
+  CMD_NODE_NAME (DEBUG_NODE),
+  CMD_NODE_NAME (AAA_NODE),
+  CMD_NODE_NAME (AAA_SERVER_GROUP_NODE),
+  CMD_NODE_NAME (KEYCHAIN_NODE),
+  CMD_NODE_NAME (KEYCHAIN_KEY_NODE),
+  CMD_NODE_NAME (INTERFACE_NODE),
+  CMD_NODE_NAME (ZEBRA_NODE),
+  CMD_NODE_NAME (TABLE_NODE),
+  CMD_NODE_NAME (RIP_NODE),
+  CMD_NODE_NAME (RIPNG_NODE),
+  CMD_NODE_NAME (BABEL_NODE),
+  CMD_NODE_NAME (BGP_NODE),
+  CMD_NODE_NAME (BGP_VPNV4_NODE),
+  CMD_NODE_NAME (BGP_IPV4_NODE),
+  CMD_NODE_NAME (BGP_IPV4M_NODE),
+  CMD_NODE_NAME (BGP_IPV6_NODE),
+  CMD_NODE_NAME (BGP_IPV6M_NODE),
+  CMD_NODE_NAME (OSPF_NODE),
+  CMD_NODE_NAME (OSPF6_NODE),
+  CMD_NODE_NAME (ISIS_NODE),
+  CMD_NODE_NAME (PIM_NODE),
+  CMD_NODE_NAME (MASC_NODE),
+  CMD_NODE_NAME (IRDP_NODE),
+  CMD_NODE_NAME (IP_NODE),
+  CMD_NODE_NAME (PREFIX_NODE),
+  CMD_NODE_NAME (PREFIX_IPV6_NODE),
+  CMD_NODE_NAME (AS_LIST_NODE),
+  CMD_NODE_NAME (COMMUNITY_LIST_NODE),
+  CMD_NODE_NAME (RMAP_NODE),
+  CMD_NODE_NAME (SMUX_NODE),
+  CMD_NODE_NAME (DUMP_NODE),
+  CMD_NODE_NAME (FORWARDING_NODE),
+  CMD_NODE_NAME (PROTOCOL_NODE),
+#ifdef ENABLE_OVSDB
+  CMD_NODE_NAME (DHCP_SERVER_NODE),
+  CMD_NODE_NAME (TFTP_SERVER_NODE),
+  CMD_NODE_NAME (ACCESS_LIST_NODE),
+  CMD_NODE_NAME (MIRROR_NODE),
+  CMD_NODE_NAME (VLAN_NODE),
+  CMD_NODE_NAME (MGMT_INTERFACE_NODE),
+  CMD_NODE_NAME (LINK_AGGREGATION_NODE),
+  CMD_NODE_NAME (QOS_QUEUE_PROFILE_NODE),
+  CMD_NODE_NAME (QOS_SCHEDULE_PROFILE_NODE),
+  CMD_NODE_NAME (VLAN_INTERFACE_NODE),
+  CMD_NODE_NAME (SUB_INTERFACE_NODE),
+  CMD_NODE_NAME (LOOPBACK_INTERFACE_NODE),
+  CMD_NODE_NAME (IPSEC_IKE_NODE),
+  CMD_NODE_NAME (IPSEC_IKE_ISAKMP_NODE),
+  CMD_NODE_NAME (VRRP_IF_NODE),
 #endif
+  CMD_NODE_NAME (VTY_NODE),
+};
+#undef CMD_NODE_NAME
+
+/* Return the name of node, or NULL if it has none. */
+const char *
+cmd_node_name (enum node_type node)
+{
+  if ((unsigned int) node >= ZEBRA_NUM_OF (cmd_node_names))
+    return NULL;
+  return cmd_node_names[node];
+}
+
+/* Return the node named name, or -1 if there is none. */
+int
+cmd_node_by_name (const char *name)
+{
+  unsigned int i;
+
+  for (i = 0; i < ZEBRA_NUM_OF (cmd_node_names); i++)
+    if (cmd_node_names[i] != NULL && strcmp (cmd_node_names[i], name) == 0)
+      return i;
+  return -1;
+}
+
+/* Return 1 if the first word of vline rules out a command element without
+   parsing its format string.  This is only decided for elements starting
+   with a plain keyword, which the first word must be a prefix of. */
+static int
+cmd_element_skip (struct cmd_element *cmd, vector vline)
+{
+  const char *word;
+  const char *keyword;
+  size_t len;
+
+  if (cmd->tokens != NULL || vector_active (vline) == 0)
+    return 0;
+
+  word = vector_slot (vline, 0);
+  if (word == NULL || *word == '\0')
+    return 0;
+
+  len = cmd_element_keyword (cmd, &keyword);
+  if (len == 0)
+    return 0;
+
+  return strlen (word) > len || strncmp (keyword, word, strlen (word)) != 0;
 }
 
 static const unsigned char itoa64[] =
@@ -838,6 +1275,22 @@ cmd_node_vector (vector v, enum node_type ntype)
   return cnode->cmd_vector;
 }
 
+/* Called with a node and the first word of a line, NULL if the line is
+   empty, before the line is matched against the commands of the node.
+   The plugin loader installs the commands of a plugin from here the first
+   time they are needed. */
+void (*cmd_demand_hook) (enum node_type, const char *);
+
+/* Copy of the commands of a node, for matching vline against them. */
+static vector
+cmd_node_commands (enum node_type node, vector vline)
+{
+  if (cmd_demand_hook)
+    cmd_demand_hook (node, vector_active (vline) ? vector_slot (vline, 0)
+                                                 : NULL);
+  return vector_copy (cmd_node_vector (cmdvec, node));
+}
+
 #if 0
 /* Filter command vector by symbol.  This function is not actually used;
  * should it be deleted? */
@@ -907,6 +1360,7 @@ enum match_type
   partly_match,
   range_match_comma,
   range_match_list,
+  range_match_range_list,
   range_match_comma_list,
   exact_match
 };
@@ -1390,20 +1844,13 @@ cmd_vlan_match (const char *str)
 
 #define DECIMAL_STRLEN_MAX 10
 
+/* Parse the bounds of a "<min-max>" range token. */
 static int
-cmd_range_match (const char *range, const char *str)
+cmd_range_bounds (const char *range, unsigned long *min, unsigned long *max)
 {
-  char *p;
+  const char *p;
   char buf[DECIMAL_STRLEN_MAX + 1];
   char *endptr = NULL;
-  unsigned long min, max, val;
-
-  if (str == NULL)
-    return 1;
-
-  val = strtoul (str, &endptr, 10);
-  if (*endptr != '\0')
-    return 0;
 
   range++;
   p = strchr (range, '-');
@@ -1413,7 +1860,7 @@ cmd_range_match (const char *range, const char *str)
     return 0;
   strncpy (buf, range, p - range);
   buf[p - range] = '\0';
-  min = strtoul (buf, &endptr, 10);
+  *min = strtoul (buf, &endptr, 10);
   if (*endptr != '\0')
     return 0;
 
@@ -1425,16 +1872,261 @@ cmd_range_match (const char *range, const char *str)
     return 0;
   strncpy (buf, range, p - range);
   buf[p - range] = '\0';
-  max = strtoul (buf, &endptr, 10);
+  *max = strtoul (buf, &endptr, 10);
+  if (*endptr != '\0')
+    return 0;
+
+  return 1;
+}
+
+static int
+cmd_range_match (const char *range, const char *str)
+{
+  char *endptr = NULL;
+  unsigned long min, max, val;
+
+  if (str == NULL)
+    return 1;
+
+  val = strtoul (str, &endptr, 10);
   if (*endptr != '\0')
     return 0;
 
+  if (!cmd_range_bounds (range, &min, &max))
+    return 0;
+
   if (val < min || val > max)
     return 0;
 
   return 1;
 }
 
+/* Token classification.  Matching a command line runs the validators of
+   every candidate command element against the same few words, so each
+   word is classified once: a single pass over its characters records which
+   character classes it contains, which rules it out for every address type
+   whose alphabet it does not fit, and the validators that remain are run
+   on first use and their result kept with the word.  Results of the OVSDB
+   callbacks are only reused until the next command line is split. */
+
+#define CMD_CC_DIGIT		0x01
+#define CMD_CC_HEX		0x02	/* a-f, A-F */
+#define CMD_CC_DOT		0x04
+#define CMD_CC_SLASH		0x08
+#define CMD_CC_COLON		0x10
+#define CMD_CC_PERCENT		0x20
+#define CMD_CC_OTHER		0x40
+
+static const unsigned char cmd_char_class[256] =
+{
+  ['0' ... '9'] = CMD_CC_DIGIT,
+  ['a' ... 'f'] = CMD_CC_HEX,
+  ['A' ... 'F'] = CMD_CC_HEX,
+  ['.'] = CMD_CC_DOT,
+  ['/'] = CMD_CC_SLASH,
+  [':'] = CMD_CC_COLON,
+  ['%'] = CMD_CC_PERCENT,
+};
+
+enum cmd_token_kind
+{
+  CMD_TOKEN_IPV4,
+  CMD_TOKEN_IPV4_PREFIX,
+  CMD_TOKEN_IPV4_NETMASK,
+#ifdef HAVE_IPV6
+  CMD_TOKEN_IPV6,
+  CMD_TOKEN_IPV6_PREFIX,
+#endif /* HAVE_IPV6 */
+  CMD_TOKEN_ADDRESS_MAX,
+#ifdef ENABLE_OVSDB
+  CMD_TOKEN_IFNAME = CMD_TOKEN_ADDRESS_MAX,
+  CMD_TOKEN_PORT,
+  CMD_TOKEN_VLAN,
+  CMD_TOKEN_MAC,
+  CMD_TOKEN_MAX
+#else
+  CMD_TOKEN_MAX = CMD_TOKEN_ADDRESS_MAX
+#endif /* ENABLE_OVSDB */
+};
+
+/* Address validators and the characters each one can accept.  A word with
+   any other character is no_match without running the validator. */
+static const struct
+{
+  enum match_type (*match) (const char *);
+  unsigned char chars;
+} cmd_address_kinds[CMD_TOKEN_ADDRESS_MAX] =
+{
+  [CMD_TOKEN_IPV4] = { cmd_ipv4_match, CMD_CC_DIGIT | CMD_CC_DOT },
+  [CMD_TOKEN_IPV4_PREFIX] = { cmd_ipv4_prefix_match,
+                              CMD_CC_DIGIT | CMD_CC_DOT | CMD_CC_SLASH },
+  [CMD_TOKEN_IPV4_NETMASK] = { cmd_ipv4_netmask_match,
+                               CMD_CC_DIGIT | CMD_CC_DOT | CMD_CC_SLASH },
+#ifdef HAVE_IPV6
+  [CMD_TOKEN_IPV6] = { cmd_ipv6_match,
+                       CMD_CC_DIGIT | CMD_CC_HEX | CMD_CC_COLON | CMD_CC_DOT
+                       | CMD_CC_PERCENT },
+  [CMD_TOKEN_IPV6_PREFIX] = { cmd_ipv6_prefix_match,
+                              CMD_CC_DIGIT | CMD_CC_HEX | CMD_CC_COLON
+                              | CMD_CC_DOT | CMD_CC_PERCENT | CMD_CC_SLASH },
+#endif /* HAVE_IPV6 */
+};
+
+#ifdef ENABLE_OVSDB
+static int (*const cmd_callback_kinds[CMD_TOKEN_MAX]) (const char *) =
+{
+  [CMD_TOKEN_IFNAME] = cmd_ifname_match,
+  [CMD_TOKEN_PORT] = cmd_port_match,
+  [CMD_TOKEN_VLAN] = cmd_vlan_match,
+  [CMD_TOKEN_MAC] = cmd_mac_match,
+};
+
+#define CMD_TOKEN_CALLBACKS \
+  ((1 << CMD_TOKEN_IFNAME) | (1 << CMD_TOKEN_PORT) \
+   | (1 << CMD_TOKEN_VLAN) | (1 << CMD_TOKEN_MAC))
+#endif /* ENABLE_OVSDB */
+
+#define CMD_TOKEN_CLASS_WORD_MAX	64
+#define CMD_TOKEN_CLASS_SLOTS		8
+
+struct cmd_token_class
+{
+  char word[CMD_TOKEN_CLASS_WORD_MAX];
+  unsigned int epoch;		/* Command line the callbacks ran for. */
+  unsigned char chars;		/* CMD_CC_* of the characters of word. */
+  unsigned int known;		/* Bit per kind whose result is set. */
+  int result[CMD_TOKEN_MAX];
+  int decimal_known;
+  int decimal_ok;		/* Whole word parsed by strtoul(). */
+  unsigned long decimal;
+};
+
+static __thread struct cmd_token_class cmd_token_classes[CMD_TOKEN_CLASS_SLOTS];
+static __thread unsigned int cmd_token_class_next;
+static __thread unsigned int cmd_token_class_last;
+static int cmd_token_class_disabled;
+
+/* Turn the classification cache off, for benchmarks. */
+void
+cmd_token_class_enable (int enable)
+{
+  cmd_token_class_disabled = !enable;
+}
+
+/* Class of word, or NULL if word is too long to be kept. */
+static struct cmd_token_class *
+cmd_token_class_get (const char *word)
+{
+  struct cmd_token_class *tc;
+  const unsigned char *cp;
+  unsigned char chars = 0;
+  size_t len;
+  int i;
+
+  if (cmd_token_class_disabled)
+    return NULL;
+
+  for (i = 0; i < CMD_TOKEN_CLASS_SLOTS; i++)
+    {
+      tc = &cmd_token_classes[(cmd_token_class_last + i)
+                              % CMD_TOKEN_CLASS_SLOTS];
+      if (tc->epoch && tc->word[0] == word[0] && !strcmp (tc->word, word))
+        {
+          cmd_token_class_last = tc - cmd_token_classes;
+#ifdef ENABLE_OVSDB
+          if (tc->epoch != cmd_token_class_epoch)
+            {
+              tc->known &= ~CMD_TOKEN_CALLBACKS;
+              tc->epoch = cmd_token_class_epoch;
+            }
+#endif /* ENABLE_OVSDB */
+          return tc;
+        }
+    }
+
+  for (cp = (const unsigned char *) word; *cp; cp++)
+    chars |= cmd_char_class[*cp] ? cmd_char_class[*cp] : CMD_CC_OTHER;
+  len = (const char *) cp - word;
+  if (len >= CMD_TOKEN_CLASS_WORD_MAX)
+    return NULL;
+
+  cmd_token_class_last = cmd_token_class_next++ % CMD_TOKEN_CLASS_SLOTS;
+  tc = &cmd_token_classes[cmd_token_class_last];
+  memcpy (tc->word, word, len + 1);
+  tc->epoch = cmd_token_class_epoch;
+  tc->chars = chars;
+  tc->known = 0;
+  tc->decimal_known = 0;
+  return tc;
+}
+
+static enum match_type
+cmd_token_address_match (enum cmd_token_kind kind, const char *word)
+{
+  struct cmd_token_class *tc;
+
+  if (word == NULL || (tc = cmd_token_class_get (word)) == NULL)
+    return cmd_address_kinds[kind].match (word);
+
+  if (!(tc->known & (1 << kind)))
+    {
+      if (tc->chars & ~cmd_address_kinds[kind].chars)
+        tc->result[kind] = no_match;
+      else
+        tc->result[kind] = cmd_address_kinds[kind].match (word);
+      tc->known |= 1 << kind;
+    }
+  return tc->result[kind];
+}
+
+#ifdef ENABLE_OVSDB
+static int
+cmd_token_callback_match (enum cmd_token_kind kind, const char *word)
+{
+  struct cmd_token_class *tc;
+
+  if (word == NULL || (tc = cmd_token_class_get (word)) == NULL)
+    return cmd_callback_kinds[kind] (word);
+
+  if (!(tc->known & (1 << kind)))
+    {
+      tc->result[kind] = cmd_callback_kinds[kind] (word);
+      tc->known |= 1 << kind;
+    }
+  return tc->result[kind];
+}
+#endif /* ENABLE_OVSDB */
+
+/* Same as cmd_range_match(), with the value of word parsed once. */
+static int
+cmd_token_range_match (const char *range, const char *word)
+{
+  struct cmd_token_class *tc;
+  char *endptr = NULL;
+  unsigned long min, max;
+
+  if (word == NULL || (tc = cmd_token_class_get (word)) == NULL)
+    return cmd_range_match (range, word);
+
+  if (!tc->decimal_known)
+    {
+      tc->decimal = strtoul (word, &endptr, 10);
+      tc->decimal_ok = *endptr == '\0';
+      tc->decimal_known = 1;
+    }
+  if (!tc->decimal_ok)
+    return 0;
+
+  if (!cmd_range_bounds (range, &min, &max))
+    return 0;
+
+  if (tc->decimal < min || tc->decimal > max)
+    return 0;
+
+  return 1;
+}
+
+
 static enum match_type
 cmd_word_match(struct cmd_token *token,
                enum filter_type filter,
@@ -1470,13 +2162,20 @@ cmd_word_match(struct cmd_token *token,
                                                      NULL, NULL) == 1)
                 return range_match_list;
         }
+        else if ((str[1] == 'R') && (str[2] == ':'))
+        {
+            if (cmd_range_comma_cli_parser_validate (word, str,
+                                                     RANGE_ONLY_OPERATOR,
+                                                     NULL, NULL) == 1)
+                return range_match_range_list;
+        }
         else if ((str[1] == 'A') && (str[2] == ':'))
         {
             if (cmd_range_comma_cli_parser_validate (word, str, BOTH_OPERATOR,
                                                      NULL, NULL) == 1)
                 return range_match_comma_list;
         }
-        else if (cmd_range_match(str, word))
+        else if (cmd_token_range_match (str, word))
         {
             return range_match;
         }
@@ -1484,14 +2183,14 @@ cmd_word_match(struct cmd_token *token,
 #ifdef HAVE_IPV6
   else if (CMD_IPV6(str))
     {
-      match_type = cmd_ipv6_match(word);
+      match_type = cmd_token_address_match (CMD_TOKEN_IPV6, word);
       if ((filter == FILTER_RELAXED && match_type != no_match)
           || (filter == FILTER_STRICT && match_type == exact_match))
         return ipv6_match;
     }
   else if (CMD_IPV6_PREFIX(str))
     {
-      match_type = cmd_ipv6_prefix_match(word);
+      match_type = cmd_token_address_match (CMD_TOKEN_IPV6_PREFIX, word);
       if ((filter == FILTER_RELAXED && match_type != no_match)
           || (filter == FILTER_STRICT && match_type == exact_match))
         return ipv6_prefix_match;
@@ -1499,21 +2198,21 @@ cmd_word_match(struct cmd_token *token,
 #endif /* HAVE_IPV6 */
   else if (CMD_IPV4(str))
     {
-      match_type = cmd_ipv4_match(word);
+      match_type = cmd_token_address_match (CMD_TOKEN_IPV4, word);
       if ((filter == FILTER_RELAXED && match_type != no_match)
           || (filter == FILTER_STRICT && match_type == exact_match))
         return ipv4_match;
     }
   else if (CMD_IPV4_PREFIX(str))
     {
-      match_type = cmd_ipv4_prefix_match(word);
+      match_type = cmd_token_address_match (CMD_TOKEN_IPV4_PREFIX, word);
       if ((filter == FILTER_RELAXED && match_type != no_match)
           || (filter == FILTER_STRICT && match_type == exact_match))
         return ipv4_prefix_match;
     }
   else if (CMD_IPV4_NETMASK(str))
     {
-      match_type = cmd_ipv4_netmask_match(word);
+      match_type = cmd_token_address_match (CMD_TOKEN_IPV4_NETMASK, word);
       if ((filter == FILTER_RELAXED && match_type != no_match)
           || (filter == FILTER_STRICT && match_type == exact_match))
         return ipv4_netmask_match;
@@ -1573,24 +2272,24 @@ cmd_word_match(struct cmd_token *token,
             }
         }
       }
-      else if (cmd_ifname_match (word) == 0)
+      else if (cmd_token_callback_match (CMD_TOKEN_IFNAME, word) == 0)
         {
             return ifname_match;
         }
     }
   else if (CMD_PORT(str))
     {
-      if(cmd_port_match(word) == 0)
+      if(cmd_token_callback_match (CMD_TOKEN_PORT, word) == 0)
         return port_match;
     }
   else if (CMD_VLAN(str))
     {
-      if(cmd_vlan_match(word) == 0)
+      if(cmd_token_callback_match (CMD_TOKEN_VLAN, word) == 0)
         return vlan_match;
     }
   else if (CMD_MAC(str))
     {
-      if(0 == cmd_mac_match(word))
+      if(0 == cmd_token_callback_match (CMD_TOKEN_MAC, word))
          return mac_match;
     }
 #endif
@@ -2082,7 +2781,9 @@ cmd_element_match(struct cmd_element *cmd_element,
 
   if (argc != NULL)
     *argc = 0;
-  if (cmd_element->tokens) {
+  if (cmd_element_skip(cmd_element, vline))
+    return MATCHER_NO_MATCH;
+  if (cmd_element_tokens(cmd_element)) {
       for (token_index = 0;
            token_index < vector_active(cmd_element->tokens);
            token_index++)
@@ -2304,7 +3005,7 @@ is_cmd_ambiguous (vector cmd_vector,
 		    }
 		  break;
 		case range_match:
-		  if (cmd_range_match (str, command))
+		  if (cmd_token_range_match (str, command))
 		    {
 		      if (matched && strcmp (matched, str) != 0)
 			return 1;
@@ -2321,6 +3022,11 @@ is_cmd_ambiguous (vector cmd_vector,
                    cmd_range_comma_cli_parser_validate (command, str,
                                             RANGE_OPERATOR, &matched, &match);
                    break;
+                case range_match_range_list:
+                   cmd_range_comma_cli_parser_validate (command, str,
+                                            RANGE_ONLY_OPERATOR, &matched,
+                                            &match);
+                   break;
                 case range_match_comma_list:
                    cmd_range_comma_cli_parser_validate (command, str,
                                             BOTH_OPERATOR, &matched, &match);
@@ -2331,7 +3037,8 @@ is_cmd_ambiguous (vector cmd_vector,
 		    match++;
 		  break;
 		case ipv6_prefix_match:
-		  if ((ret = cmd_ipv6_prefix_match (command)) != no_match)
+		  if ((ret = cmd_token_address_match (CMD_TOKEN_IPV6_PREFIX,
+						      command)) != no_match)
 		    {
 		      if (ret == partly_match)
 			return 2;	/* There is incomplete match. */
@@ -2345,7 +3052,8 @@ is_cmd_ambiguous (vector cmd_vector,
 		    match++;
 		  break;
 		case ipv4_prefix_match:
-		  if ((ret = cmd_ipv4_prefix_match (command)) != no_match)
+		  if ((ret = cmd_token_address_match (CMD_TOKEN_IPV4_PREFIX,
+						      command)) != no_match)
 		    {
 		      if (ret == partly_match)
 			return 2;	/* There is incomplete match. */
@@ -2354,7 +3062,8 @@ is_cmd_ambiguous (vector cmd_vector,
 		    }
 		  break;
     case ipv4_netmask_match:
-      if ((ret = cmd_ipv4_netmask_match (command)) != no_match)
+      if ((ret = cmd_token_address_match (CMD_TOKEN_IPV4_NETMASK,
+                                          command)) != no_match)
         {
           if (ret == partly_match)
             return 2; /* There is incomplete match. */
@@ -2438,13 +3147,20 @@ cmd_entry_function_desc (const char *src, const char *dst)
                                                    NULL, NULL) == 1)
               return dst;
       }
+      else if((dst[1] == 'R') && (dst[2] == ':'))
+      {
+          if (cmd_range_comma_cli_parser_validate (src, dst,
+                                                   RANGE_ONLY_OPERATOR,
+                                                   NULL, NULL) == 1)
+              return dst;
+      }
       else if ((dst[1] == 'A') && (dst[2] == ':'))
       {
           if (cmd_range_comma_cli_parser_validate (src, dst, BOTH_OPERATOR,
                                                    NULL, NULL) == 1)
               return dst;
       }
-      else if (cmd_range_match (dst, src))
+      else if (cmd_token_range_match (dst, src))
       {
           return dst;
       }
@@ -2454,7 +3170,7 @@ cmd_entry_function_desc (const char *src, const char *dst)
 #ifdef HAVE_IPV6
   if (CMD_IPV6 (dst))
     {
-      if (cmd_ipv6_match (src))
+      if (cmd_token_address_match (CMD_TOKEN_IPV6, src))
 	return dst;
       else
 	return NULL;
@@ -2462,7 +3178,7 @@ cmd_entry_function_desc (const char *src, const char *dst)
 
   if (CMD_IPV6_PREFIX (dst))
     {
-      if (cmd_ipv6_prefix_match (src))
+      if (cmd_token_address_match (CMD_TOKEN_IPV6_PREFIX, src))
 	return dst;
       else
 	return NULL;
@@ -2471,7 +3187,7 @@ cmd_entry_function_desc (const char *src, const char *dst)
 
   if (CMD_IPV4 (dst))
     {
-      if (cmd_ipv4_match (src))
+      if (cmd_token_address_match (CMD_TOKEN_IPV4, src))
 	return dst;
       else
 	return NULL;
@@ -2479,7 +3195,7 @@ cmd_entry_function_desc (const char *src, const char *dst)
 
   if (CMD_IPV4_PREFIX (dst))
     {
-      if (cmd_ipv4_prefix_match (src))
+      if (cmd_token_address_match (CMD_TOKEN_IPV4_PREFIX, src))
 	return dst;
       else
 	return NULL;
@@ -2487,7 +3203,7 @@ cmd_entry_function_desc (const char *src, const char *dst)
 
   if (CMD_IPV4_NETMASK (dst))
     {
-      if (cmd_ipv4_netmask_match (src))
+      if (cmd_token_address_match (CMD_TOKEN_IPV4_NETMASK, src))
         return dst;
       else
         return NULL;
@@ -2565,6 +3281,20 @@ desc_unique_string (vector v, const char *str)
 
 char ErrDescStr[] =
             "Error: Help strings does not match for the identical tokens";
+
+/* Release the help string of a token, pooled if the token is shared. */
+static void
+cmd_token_free_desc (struct cmd_token *token)
+{
+  if (token->desc == ErrDescStr)
+    ;
+  else if (token->refcnt > 0)
+    cmd_unintern (token->desc);
+  else
+    XFREE (MTYPE_CMD_TOKENS, token->desc);
+  token->desc = NULL;
+}
+
 /**
  * Check the command tokens in the list v for identical commands with
  * different help strings. If so, change the error string to Error String
@@ -2585,7 +3315,13 @@ check_unique_helpstr(vector v, const char *cmdstr, const char *helpstr)
       }
       if (strcmp (token->desc, helpstr) != 0)
       {
+        /* The pool finds shared tokens by their help string. */
+        if (token->refcnt > 0)
+          hash_release (cmd_token_hash, token);
+        cmd_token_free_desc (token);
         token->desc = ErrDescStr;
+        if (token->refcnt > 0)
+          hash_get (cmd_token_hash, token, hash_alloc_intern);
         return 1;
       }
     }
@@ -2662,7 +3398,7 @@ cmd_describe_command_real (vector vline, struct vty *vty, int *status)
   index = vector_active (vline) - 1;
 
   /* Make copy vector of current node's command vector. */
-  cmd_vector = vector_copy (cmd_node_vector (cmdvec, vty->node));
+  cmd_vector = cmd_node_commands (vty->node, vline);
 
   /* Prepare match vector */
   matchvec = vector_init (INIT_MATCHVEC_SIZE);
@@ -2905,7 +3641,7 @@ static char **
 cmd_complete_command_real (vector vline, struct vty *vty, int *status)
 {
   unsigned int i;
-  vector cmd_vector = vector_copy (cmd_node_vector (cmdvec, vty->node));
+  vector cmd_vector = cmd_node_commands (vty->node, vline);
 #define INIT_MATCHVEC_SIZE 10
   vector matchvec;
   unsigned int index;
@@ -3157,7 +3893,8 @@ autocomplete_command_tokens(struct cmd_element *matched_element, vector vline,
   cmd_matcher_init(&matcher, matched_element, 0,
                    vline, -1, NULL, NULL);
 
-  for (token_index= 0; token_index < vector_active(matched_element->tokens);
+  for (token_index= 0;
+       token_index < vector_active(cmd_element_tokens(matched_element));
        token_index++){
     flag = 1;
     struct cmd_token *token = vector_slot(matched_element->tokens, token_index);
@@ -3242,171 +3979,382 @@ autocomplete_command_tokens(struct cmd_element *matched_element, vector vline,
   return cmd_string;
 }
 
-int check_cmd_authorization(char *tac_command)
+/* User the commands are executed for, if not the process owner. */
+static char *cmd_user;
+
+/* Run the following commands on behalf of user, or of the process owner
+   if user is NULL. */
+void
+cmd_user_set (const char *user)
+{
+  if (cmd_user)
+    XFREE (MTYPE_HOST, cmd_user);
+  if (user)
+    cmd_user = XSTRDUP (MTYPE_HOST, user);
+}
+
+/* Name of the user the commands run for, NULL if it cannot be found. */
+const char *
+cmd_user_name (void)
+{
+  struct passwd *pw;
+
+  if (cmd_user)
+    return cmd_user;
+  pw = getpwuid (getuid ());
+  return pw ? pw->pw_name : NULL;
+}
+
+/* A TACACS+ server authorization requests are sent to. */
+struct cmd_author_server
+{
+  char *address;
+  char *passkey;
+  int timeout;
+};
+
+/* An authorization group: its servers in priority order, or none to let
+   the command run. */
+struct cmd_author_group
+{
+  bool none;
+  struct cmd_author_server *servers;
+  size_t n_servers;
+};
+
+/* An authorization decision, EXIT_OK or EXIT_FAIL, for user running the
+   command element whose string is command in node. */
+struct cmd_author_entry
+{
+  char *user;
+  char *command;
+  enum node_type node;
+  int status;
+  time_t expires;
+};
+
+/* The authorization groups, copied out of the IDL by cmd_author_refresh()
+   when the AAA configuration changes, so that commands are authorized
+   without the OVSDB lock. */
+static struct cmd_author_group *cmd_author_groups;
+static size_t cmd_author_n_groups;
+static bool cmd_author_configured;      /* False without a priority list. */
+static bool cmd_author_valid;
+static unsigned int cmd_author_seqno;
+static struct smap cmd_author_aaa = SMAP_INITIALIZER (&cmd_author_aaa);
+
+/* Decisions of the servers, dropped with the groups. */
+static struct hash *cmd_author_cache;
+static struct cmd_author_stats cmd_author_stats = {
+  .ttl = CMD_AUTHOR_CACHE_TTL_DEFAULT,
+  .negative_ttl = CMD_AUTHOR_CACHE_NEGATIVE_TTL_DEFAULT,
+};
+
+static unsigned int
+cmd_author_hash_key (void *data)
+{
+  struct cmd_author_entry *entry = data;
+
+  return string_hash_make (entry->user)
+         ^ (string_hash_make (entry->command) * 33) ^ entry->node;
+}
+
+static int
+cmd_author_hash_cmp (const void *a, const void *b)
+{
+  const struct cmd_author_entry *entry1 = a;
+  const struct cmd_author_entry *entry2 = b;
+
+  return entry1->node == entry2->node
+         && strcmp (entry1->command, entry2->command) == 0
+         && strcmp (entry1->user, entry2->user) == 0;
+}
+
+static void
+cmd_author_entry_free (void *data)
 {
+  struct cmd_author_entry *entry = data;
 
-  int count = 0;
-  const struct ovsrec_tacacs_server *server_row = NULL;
-  const struct ovsrec_aaa_server_group *group_row = NULL;
-  const struct ovsrec_system *ovs = ovsrec_system_first(idl);
-  const struct ovsrec_aaa_server_group_prio *group_prio_list = NULL;
-  struct shash sorted_tacacs_servers;
-  const struct shash_node **nodes = NULL;
-  int count_servers = 0;
-  int idx = 0;
-  int iter = 0;
-  char *passkey = NULL;
-  const char *passkey_const = NULL;
-  const char *timeout_str = NULL;
-  int timeout = 0;
-  char *tty = "mytty";
-  char *remote_addr = "";
-  char *service = "shell";
-  char *protocol = "ip";
-  int tac_author_status = EXIT_OK;
-  bool by_default_priority = false;
-  struct passwd *pw;
-  /* get the logged in user.*/
-  pw = getpwuid( getuid());
+  XFREE (MTYPE_CMD_AUTHOR, entry->user);
+  XFREE (MTYPE_CMD_AUTHOR, entry->command);
+  XFREE (MTYPE_CMD_AUTHOR, entry);
+}
+
+/* Drop the groups and the decisions made with them. */
+static void
+cmd_author_clear (void)
+{
+  size_t i, j;
+
+  for (i = 0; i < cmd_author_n_groups; i++)
+    {
+      struct cmd_author_group *group = &cmd_author_groups[i];
+
+      for (j = 0; j < group->n_servers; j++)
+        {
+          XFREE (MTYPE_CMD_AUTHOR, group->servers[j].address);
+          XFREE (MTYPE_CMD_AUTHOR, group->servers[j].passkey);
+        }
+      if (group->servers)
+        XFREE (MTYPE_CMD_AUTHOR, group->servers);
+    }
+  if (cmd_author_groups)
+    XFREE (MTYPE_CMD_AUTHOR, cmd_author_groups);
+  cmd_author_groups = NULL;
+  cmd_author_n_groups = 0;
 
-  passkey = (char *)malloc(MAX_LENGTH_TACACS_PASSKEY * sizeof(char));
-  memset(passkey, '\0', MAX_LENGTH_TACACS_PASSKEY);
+  if (cmd_author_cache && cmd_author_cache->count)
+    {
+      hash_clean (cmd_author_cache, cmd_author_entry_free);
+      cmd_author_stats.flushes++;
+    }
+}
 
-  group_prio_list = ovsrec_aaa_server_group_prio_first(idl);
+/* Copy the authorization groups and their sorted servers again if the AAA
+   configuration changed.  Called with the OVSDB lock held. */
+static void
+cmd_author_refresh (void)
+{
+  const struct ovsrec_system *ovs = ovsrec_system_first (idl);
+  const struct ovsrec_aaa_server_group_prio *group_prio_list;
+  const struct ovsrec_aaa_server_group *group_row;
+  const struct ovsrec_tacacs_server *server_row;
+  struct smap empty = SMAP_INITIALIZER (&empty);
+  const struct smap *aaa = ovs ? &ovs->aaa : &empty;
+  const struct shash_node **nodes;
+  struct shash servers;
+  bool by_default_priority = false;
+  unsigned int seqno;
+  size_t i, j, count;
+
+  seqno = ovsrec_aaa_server_group_prio_get_seqno (idl)
+          + ovsrec_aaa_server_group_get_seqno (idl)
+          + ovsrec_tacacs_server_get_seqno (idl);
+  if (cmd_author_valid && seqno == cmd_author_seqno
+      && smap_equal (aaa, &cmd_author_aaa))
+    return;
 
+  cmd_author_clear ();
+  cmd_author_valid = true;
+  cmd_author_seqno = seqno;
+  smap_destroy (&cmd_author_aaa);
+  smap_clone (&cmd_author_aaa, aaa);
+  cmd_author_stats.ttl = smap_get_int (aaa, SYSTEM_AAA_TACACS_AUTHOR_CACHE_TTL,
+                                       CMD_AUTHOR_CACHE_TTL_DEFAULT);
+  cmd_author_stats.negative_ttl =
+    smap_get_int (aaa, SYSTEM_AAA_TACACS_AUTHOR_CACHE_NEGATIVE_TTL,
+                  CMD_AUTHOR_CACHE_NEGATIVE_TTL_DEFAULT);
+
+  group_prio_list = ovsrec_aaa_server_group_prio_first (idl);
+  cmd_author_configured = group_prio_list != NULL;
   if (group_prio_list == NULL)
-  {
-    VLOG_DBG("Could not fetch the priority list for tacacs command authorization");
-    free(passkey);
-    return EXIT_FAIL;
-  }
+    return;
 
-  /* count the number of groups configured for authorization */
   count = group_prio_list->n_authorization_group_prios;
-
-  /* check if the number of groups configured is more than one(default) and first group is not "none" */
-  if (count >= 1 && (strcmp(group_prio_list->value_authorization_group_prios[0]->group_name, TAC_NONE_GROUP) != 0))
-  {
-    for (iter = 0; iter < count; iter ++)
+  if (count == 0)
+    return;
+  cmd_author_groups = XCALLOC (MTYPE_CMD_AUTHOR,
+                               count * sizeof *cmd_author_groups);
+  for (i = 0; i < count; i++)
     {
-      /* get the group information */
-      group_row = group_prio_list->value_authorization_group_prios[iter];
+      struct cmd_author_group *group = &cmd_author_groups[i];
 
-      if (strcmp(group_row->group_name, TAC_NONE_GROUP) != 0)
-      {
-        /* initialize the list*/
-        shash_init(&sorted_tacacs_servers);
-        /* Add servers to list if the it is added to group configured for authorization */
-        OVSREC_TACACS_SERVER_FOR_EACH(server_row, idl)
+      cmd_author_n_groups++;
+      group_row = group_prio_list->value_authorization_group_prios[i];
+      if (strcmp (group_row->group_name, TAC_NONE_GROUP) == 0)
         {
-          if (server_row->n_group > 1 && (server_row->group[0] == group_row || server_row->group[1] == group_row))
-          {
-            shash_add(&sorted_tacacs_servers, server_row->address, (void *)server_row);
-          }
-          else if (strcmp(group_row->group_name, TAC_DEFAULT_GROUP) == 0)
-          {
-            shash_add(&sorted_tacacs_servers, server_row->address, (void *)server_row);
-          }
+          /* The groups after none are never asked. */
+          group->none = true;
+          break;
         }
 
-        /* if the groups is default sort by default priority else by group priority */
-        if (strcmp(group_row->group_name, TAC_DEFAULT_GROUP) == 0)
+      /* The servers of the group, or all of them for the default group. */
+      shash_init (&servers);
+      OVSREC_TACACS_SERVER_FOR_EACH (server_row, idl)
         {
-          by_default_priority = true;
+          if ((server_row->n_group > 1
+               && (server_row->group[0] == group_row
+                   || server_row->group[1] == group_row))
+              || strcmp (group_row->group_name, TAC_DEFAULT_GROUP) == 0)
+            shash_add (&servers, server_row->address, (void *) server_row);
         }
 
-        /* get the list sorted , true = default, false = group priority
-         * and true = is_tacacs_server_flag
-         * */
-        nodes = sort_servers(&sorted_tacacs_servers, by_default_priority, true);
+      /* Once the default group is seen, sort by default priority. */
+      if (strcmp (group_row->group_name, TAC_DEFAULT_GROUP) == 0)
+        by_default_priority = true;
 
-        if (nodes == NULL)
+      nodes = sort_servers (&servers, by_default_priority, true);
+      if (nodes)
         {
-           shash_destroy(&sorted_tacacs_servers);
-           VLOG_DBG("Failed to get the sorted tacacs server list");
-           return EXIT_FAIL;
+          group->n_servers = shash_count (&servers);
+          group->servers = XCALLOC (MTYPE_CMD_AUTHOR,
+                                    group->n_servers * sizeof *group->servers);
         }
+      for (j = 0; j < group->n_servers; j++)
+        {
+          struct cmd_author_server *server = &group->servers[j];
+          const char *passkey;
+
+          server_row = nodes[j]->data;
+          server->address = XSTRDUP (MTYPE_CMD_AUTHOR, server_row->address);
+          /* The server's own passkey and timeout, or the global ones. */
+          passkey = server_row->passkey
+                    ? server_row->passkey
+                    : smap_get (aaa, SYSTEM_AAA_TACACS_PASSKEY);
+          server->passkey = XSTRDUP (MTYPE_CMD_AUTHOR, passkey ? passkey : "");
+          server->timeout = server_row->timeout
+                            ? *server_row->timeout
+                            : smap_get_int (aaa, SYSTEM_AAA_TACACS_TIMEOUT, 0);
+        }
+      free (nodes);
+      shash_destroy (&servers);
+    }
+}
+
+/* Ask the servers of the authorization groups, in turn, whether user may
+   run tac_command. */
+static int
+cmd_author_request (const char *user, const char *tac_command)
+{
+  char *tty = "mytty";
+  char *remote_addr = "";
+  char *service = "shell";
+  char *protocol = "ip";
+  int tac_author_status = EXIT_OK;
+  size_t i, j;
+
+  if (!cmd_author_configured)
+    {
+      VLOG_DBG("Could not fetch the priority list for tacacs command authorization");
+      return EXIT_FAIL;
+    }
+
+  for (i = 0; i < cmd_author_n_groups; i++)
+    {
+      const struct cmd_author_group *group = &cmd_author_groups[i];
 
-        /* get the number of servers in the list */
-        count_servers = shash_count(&sorted_tacacs_servers);
-        /* send the cmd for authorization to all the servers in the list*/
-        for(idx = 0; idx < count_servers; idx++)
+      if (group->none)
+        return EXIT_OK;
+      if (group->n_servers == 0)
         {
-          server_row = (const struct ovsrec_tacacs_server *)nodes[idx]->data;
-          /* check if timeout is set by user or get global value*/
-          if (server_row->timeout)
-          {
-            timeout = *(server_row->timeout);
-          }
-	  else
-          {
-            timeout_str = smap_get(&ovs->aaa, SYSTEM_AAA_TACACS_TIMEOUT);
-            timeout = atoi(timeout_str);
-          }
-          /* check if passkey is set by user or get global value*/
-          if (server_row->passkey)
-          {
-            strncpy(passkey, server_row->passkey, strlen(server_row->passkey));
-            passkey[strlen(server_row->passkey)+1] = '\0';
-          }
-          else
-          {
-            passkey_const = smap_get(&ovs->aaa, SYSTEM_AAA_TACACS_PASSKEY);
-            strncpy(passkey, passkey_const, strlen(passkey_const));
-            passkey[strlen(passkey_const)+1] = '\0';
-          }
+          VLOG_DBG("Failed to get the sorted tacacs server list");
+          return EXIT_FAIL;
+        }
 
-          /*send the command for authorization*/
-          tac_author_status = tac_cmd_author_ptr(server_row->address, passkey, pw->pw_name,
-                                                 tty, remote_addr, service, protocol, tac_command,
-                                                 timeout, true, NULL, NULL, NULL);
-          /* if authorized, return */
-          if (tac_author_status == EXIT_OK)
-          {
-            VLOG_DBG(" %s command authorized for %s\n", tac_command, pw->pw_name);
-            free(passkey);
-            free(nodes);
-            shash_destroy(&sorted_tacacs_servers);
-            return tac_author_status;
-          }
-          /*if not authorized, return */
-          else if (tac_author_status == EXIT_FAIL)
-          {
-            free(passkey);
-            free(nodes);
-            shash_destroy(&sorted_tacacs_servers);
-            return tac_author_status;
-          }
+      /* send the cmd for authorization to all the servers in the group */
+      for (j = 0; j < group->n_servers; j++)
+        {
+          const struct cmd_author_server *server = &group->servers[j];
+
+          tac_author_status = tac_cmd_author_ptr (server->address,
+                                                  server->passkey, user, tty,
+                                                  remote_addr, service,
+                                                  protocol,
+                                                  CONST_CAST (char *,
+                                                              tac_command),
+                                                  server->timeout, true,
+                                                  NULL, NULL, NULL);
+          if (tac_author_status == EXIT_OK || tac_author_status == EXIT_FAIL)
+            {
+              VLOG_DBG(" %s command %s for %s\n", tac_command,
+                       tac_author_status == EXIT_OK ? "authorized"
+                                                    : "not authorized",
+                       user);
+              return tac_author_status;
+            }
         }
-        /*
-         * Did not get a valid reply from the servers in this group.
-         * destroy the list and free the node,
-         * so that it can be initialized for different group.
-         */
-        free(passkey);
-        free(nodes);
-        shash_destroy(&sorted_tacacs_servers);
-      }
-      else
-      {
-        free(passkey);
-        return EXIT_OK;
-      }
     }
-    /*
-     * if we are at this stage that means user is not authorized to execute this command
-     * in any of the servers.We need to check if the last option for authorization is
-     * not none. if not, we should not let the user execute this command.
-     */
-    if (strcmp(group_prio_list->value_authorization_group_prios[iter-1]->group_name, TAC_NONE_GROUP) != 0)
+
+  /* The last group is not none, and none of its servers replied. */
+  if (cmd_author_n_groups)
     {
       tac_author_status = EXIT_CONN_ERR;
       VLOG_DBG("Did not receive valid authorization response from any of the configured servers");
     }
-  }
   return tac_author_status;
 }
 
+/* Whether the user of this session may run the command element whose
+   string is tac_command in node, from the cache if the servers were asked
+   recently.  Connection errors are not cached. */
+static int
+check_cmd_authorization (const char *tac_command, enum node_type node)
+{
+  struct cmd_author_entry key, *entry;
+  time_t now = time_now ();
+  int status;
+  int ttl;
+
+  key.user = CONST_CAST (char *, cmd_user_name ());
+  if (key.user == NULL)
+    return EXIT_FAIL;
+  key.command = CONST_CAST (char *, tac_command);
+  key.node = node;
+
+  if (cmd_author_cache == NULL)
+    cmd_author_cache = hash_create (cmd_author_hash_key, cmd_author_hash_cmp);
+  entry = hash_lookup (cmd_author_cache, &key);
+  if (entry && entry->expires > now)
+    {
+      cmd_author_stats.hits++;
+      return entry->status;
+    }
+  if (entry)
+    {
+      cmd_author_stats.expired++;
+      hash_release (cmd_author_cache, entry);
+      cmd_author_entry_free (entry);
+    }
+  cmd_author_stats.misses++;
+
+  status = cmd_author_request (key.user, tac_command);
+  ttl = status == EXIT_OK ? cmd_author_stats.ttl
+        : status == EXIT_FAIL ? cmd_author_stats.negative_ttl : 0;
+  if (ttl > 0)
+    {
+      entry = XMALLOC (MTYPE_CMD_AUTHOR, sizeof *entry);
+      entry->user = XSTRDUP (MTYPE_CMD_AUTHOR, key.user);
+      entry->command = XSTRDUP (MTYPE_CMD_AUTHOR, tac_command);
+      entry->node = node;
+      entry->status = status;
+      entry->expires = now + ttl;
+      hash_get (cmd_author_cache, entry, hash_alloc_intern);
+    }
+  return status;
+}
+
+/* Fill stats with the counters of the authorization cache. */
+void
+cmd_author_stats_get (struct cmd_author_stats *stats)
+{
+  *stats = cmd_author_stats;
+  stats->entries = cmd_author_cache ? cmd_author_cache->count : 0;
+}
+
+/* Run the command, with the IDL of the on-demand tables it reads if it
+   declares some.  Called with the OVSDB lock held. */
+static int
+cmd_execute_element (struct cmd_element *element, struct vty *vty,
+                     int argc, const char *argv[])
+{
+  unsigned int tables = CMD_ATTR_TABLES_GET (element->attr);
+  struct ovsdb_idl *main_idl;
+  int ret;
+
+  if (!tables)
+    return (*element->func) (element, vty, 0, argc, argv);
+
+  if (!vtysh_ovsdb_tables_enter (tables, &main_idl))
+    {
+      vty_out (vty, "System is not ready. Please retry after few seconds..%s",
+               VTY_NEWLINE);
+      return CMD_WARNING;
+    }
+  ret = (*element->func) (element, vty, 0, argc, argv);
+  vtysh_ovsdb_tables_leave (tables, main_idl);
+  return ret;
+}
+
 /* Execute command by argument vline vector. */
 static int
 cmd_execute_command_real (vector vline,
@@ -3434,7 +4382,7 @@ cmd_execute_command_real (vector vline,
   bool ready = false;
 
   /* Make copy of command elements. */
-  cmd_vector = vector_copy (cmd_node_vector (cmdvec, vty->node));
+  cmd_vector = cmd_node_commands (vty->node, vline);
 
   for (index = 0; index < vector_active (vline); index++)
     {
@@ -3532,11 +4480,13 @@ cmd_execute_command_real (vector vline,
     /* check if the system and db is ready */
     VTYSH_OVSDB_LOCK;
     ready = vtysh_chk_for_system_configured_db_is_ready();
+    if (ready == true)
+      cmd_author_refresh ();
     VTYSH_OVSDB_UNLOCK;
     if (ready == true)
     {
       /* send command for authorization */
-      tac_author_return = check_cmd_authorization(tac_command);
+      tac_author_return = check_cmd_authorization(tac_command, vty->node);
       if (tac_author_return == EXIT_FAIL)
       {
         vty_out(vty, "Cannot execute command. Command not allowed.\n");
@@ -3557,25 +4507,27 @@ cmd_execute_command_real (vector vline,
   /* Execute matched command. */
   if(((matched_element->attr) & CMD_ATTR_NOLOCK) == 0)
   {
+      /* Have the OVSDB thread monitor the tables first, without the lock. */
+      if (CMD_ATTR_TABLES_GET (matched_element->attr))
+          vtysh_ovsdb_tables_need (CMD_ATTR_TABLES_GET (matched_element->attr));
       VLOG_DBG("Setting the latch");
       latch_set(&ovsdb_latch);
-      struct range_list *temp = vty->index_list;
+      struct range_list_iter iter;
       static char ifnumber[MAX_IFNAME_LENGTH + 1];
-      if (temp != NULL)
+      if (vty->index_list != NULL)
       {
-          while (temp != NULL)
+          cmd_range_list_iter_init(&iter, vty->index_list);
+          while (cmd_range_list_next(&iter, ifnumber, sizeof ifnumber))
           {
               VTYSH_OVSDB_LOCK;
-              strcpy(ifnumber, temp->value);
               vty->index = ifnumber;
               if ((((matched_element->attr) & CMD_ATTR_NON_IDL_CMD) == CMD_ATTR_NON_IDL_CMD)
                      || (vtysh_chk_for_system_configured_db_is_ready() == true)) {
-                  ret = (*matched_element->func) (matched_element, vty, 0, argc, argv);
+                  ret = cmd_execute_element (matched_element, vty, argc, argv);
               } else {
                   vty_out(vty, "System is not ready. Please retry after few seconds..%s", VTY_NEWLINE);
               }
               AUDIT_LOG_USER_MSG(vty, cfgdata, ret);
-              temp = temp->link;
               VTYSH_OVSDB_UNLOCK;
               if (vty->index == NULL)
                   break;
@@ -3586,7 +4538,7 @@ cmd_execute_command_real (vector vline,
           VTYSH_OVSDB_LOCK;
           if ((((matched_element->attr) & CMD_ATTR_NON_IDL_CMD) == CMD_ATTR_NON_IDL_CMD)
                   || (vtysh_chk_for_system_configured_db_is_ready() == true)) {
-              ret = (*matched_element->func) (matched_element, vty, 0, argc, argv);
+              ret = cmd_execute_element (matched_element, vty, argc, argv);
           } else {
               vty_out(vty, "System is not ready. Please retry after few seconds..%s", VTY_NEWLINE);
           }
@@ -3596,15 +4548,15 @@ cmd_execute_command_real (vector vline,
   }
   else
   {
-      struct range_list *temp = vty->index_list;
+      struct range_list_iter iter;
       static char ifnumber[MAX_IFNAME_LENGTH];
       bool ready = false;
 
-      if (temp != NULL)
+      if (vty->index_list != NULL)
       {
-          while (temp != NULL)
+          cmd_range_list_iter_init(&iter, vty->index_list);
+          while (cmd_range_list_next(&iter, ifnumber, sizeof ifnumber))
           {
-              strcpy(ifnumber, temp->value);
               vty->index = ifnumber;
               if (((matched_element->attr) & CMD_ATTR_NON_IDL_CMD) == CMD_ATTR_NON_IDL_CMD) {
                   ready = true;
@@ -3620,7 +4572,6 @@ cmd_execute_command_real (vector vline,
                   vty_out(vty, "System is not ready. Please retry after few seconds..%s", VTY_NEWLINE);
               }
               AUDIT_LOG_USER_MSG(vty, cfgdata, ret);
-              temp = temp->link;
               if (vty->index == NULL)
                   break;
           }
@@ -3797,7 +4748,7 @@ int cmd_try_execute_command (struct vty *vty, char *buf)
     return CMD_SUCCESS;
 
   /* Make copy of command elements. */
-  cmd_vector = vector_copy (cmd_node_vector (cmdvec, vty->node));
+  cmd_vector = cmd_node_commands (vty->node, vline);
 
   for (index = 0; index < vector_active (vline); index++)
   {
@@ -5453,6 +6404,15 @@ cmd_terminate_token(struct cmd_token *token)
   unsigned int i, j;
   vector keyword_vect;
 
+  /* A shared token is freed with its last command. */
+  if (token->refcnt > 1)
+    {
+      token->refcnt--;
+      return;
+    }
+  if (token->refcnt == 1)
+    hash_release (cmd_token_hash, token);
+
   if (token->multiple)
     {
       for (i = 0; i < vector_active(token->multiple); i++)
@@ -5474,8 +6434,8 @@ cmd_terminate_token(struct cmd_token *token)
       token->keyword = NULL;
     }
 
-  XFREE(MTYPE_CMD_TOKENS, token->cmd);
-  XFREE(MTYPE_CMD_TOKENS, token->desc);
+  cmd_unintern(token->cmd);
+  cmd_token_free_desc(token);
   XFREE(MTYPE_CMD_TOKENS, token->dyn_cb);
 
   XFREE(MTYPE_CMD_TOKENS, token);
@@ -5706,6 +6666,14 @@ cmd_input_comma_str_is_valid(const char *str, enum cli_int_type type)
         return COMMA_ERR;
 
     p++;
+    /* An <R:> list needs a '-', so a single value is left to a <min-max>
+     * form of the same command. */
+    if (type == RANGE_ONLY_OPERATOR)
+    {
+        if (strchr (p, '-') == NULL)
+            return COMMA_ERR;
+        type = RANGE_OPERATOR;
+    }
     if (*p == '\0' && type == RANGE_OPERATOR)
     {
         return COMMA_ERR;
@@ -5824,144 +6792,335 @@ cmd_input_is_within_range(const char *str, const char *range)
 struct range_list *
 cmd_free_memory_range_list(struct range_list *list)
 {
-    while(list != NULL)
-    {
-        struct range_list *temp = list;
-        list = list->link;
-        free(temp);
-    }
+    size_t i;
+
+    if (list == NULL)
+        return NULL;
+    for (i = 0; i < list->n_names; i++)
+        free(list->names[i].name);
+    free(list->names);
+    free(list->ranges);
+    free(list);
     return NULL;
 }
 
 /*
- * Function : cmd_insert_value_list
- * Responsibility : append/create the list with the value from str.
- * Parameters : struct range_list *node : pointer holding the range list.
- *              char *str : string containing input value.
- * Return : struct range_list * : list generated by adding the str.
+ * Function : cmd_range_list_add_range
+ * Responsibility : append the interval [lo, hi] to the list.  Intervals are
+                    sorted and merged once the whole input is parsed, only
+                    with the intervals not separated from them by a name.
+ * Parameters : struct range_list *list : pointer holding the range list.
+ *              unsigned long lo, hi : bounds of the interval.
+ * Return : int : 1, if the interval was added.
+ *                0, if memory could not be allocated.
  */
-struct range_list*
-cmd_insert_value_list(struct range_list *node, const char *str)
+static int
+cmd_range_list_add_range(struct range_list *list, unsigned long lo,
+                         unsigned long hi)
 {
-    struct range_list *temp = NULL;
-    if (node == NULL)
+    if (list->n_ranges >= list->allocated_ranges)
     {
-        temp = (struct range_list*)malloc (sizeof(struct range_list));
-        if (temp)
-        {
-            strcpy (temp->value, str);
-            temp->link = NULL;
-            return temp;
-        }
-        else
-        {
-            return NULL;
-        }
+        size_t n = list->allocated_ranges ? 2 * list->allocated_ranges : 4;
+        struct range_interval *ranges;
+
+        ranges = realloc(list->ranges, n * sizeof *ranges);
+        if (ranges == NULL)
+            return 0;
+        list->ranges = ranges;
+        list->allocated_ranges = n;
     }
-    else
+    list->ranges[list->n_ranges].lo = lo;
+    list->ranges[list->n_ranges].hi = hi;
+    list->n_ranges++;
+    return 1;
+}
+
+/*
+ * Function : cmd_range_list_add_name
+ * Responsibility : append a value which is not a number, such as an
+                    interface name, to the list.
+ * Parameters : struct range_list *list : pointer holding the range list.
+ *              const char *str : the value.
+ * Return : int : 1, if the value was added.
+ *                0, if memory could not be allocated.
+ */
+static int
+cmd_range_list_add_name(struct range_list *list, const char *str)
+{
+    char *name;
+
+    if (list->n_names >= list->allocated_names)
     {
-        node->link = cmd_insert_value_list (node->link, str);
+        size_t n = list->allocated_names ? 2 * list->allocated_names : 4;
+        struct range_name *names;
+
+        names = realloc(list->names, n * sizeof *names);
+        if (names == NULL)
+            return 0;
+        list->names = names;
+        list->allocated_names = n;
     }
-    return node;
+    name = strdup(str);
+    if (name == NULL)
+        return 0;
+    list->names[list->n_names].name = name;
+    list->names[list->n_names].range = list->n_ranges;
+    list->n_names++;
+    return 1;
+}
+
+static int
+cmd_range_interval_cmp(const void *a_, const void *b_)
+{
+    const struct range_interval *a = a_;
+    const struct range_interval *b = b_;
+
+    if (a->lo != b->lo)
+        return a->lo < b->lo ? -1 : 1;
+    return 0;
 }
 
 /*
- * Function :  cmd_get_list_from_range_str
- * Responsibility : give range list of all values from input string which
-                    contain input in form of range (A-B).
- * Parameters : char *value : string containing input value.
- *              int flag_intf : identifying input is interface number or
-                                normal integer.
- * Return : struct range_list * : list generated by adding the str.
+ * Function : cmd_range_list_normalize
+ * Responsibility : sort the intervals given between two names and merge the
+                    ones that overlap or are adjacent, so that the values
+                    keep the order of the names around them.
+ * Parameters : struct range_list *list : pointer holding the range list.
+ * Return : void.
  */
-struct range_list*
-cmd_get_list_from_range_str (const char *str_ptr, int flag_intf)
+static void
+cmd_range_list_normalize(struct range_list *list)
 {
-    unsigned long i;
-    const char *tmp = NULL;
-    unsigned long num[2];
-    struct range_list *node = NULL;
-    char buf[DECIMAL_STRLEN_MAX + 1];
+    size_t in = 0, out = 0, name = 0;
 
-    if (strchr (str_ptr, '-'))
+    while (in < list->n_ranges || name < list->n_names)
     {
-        tmp = str_ptr;
-        if ((flag_intf == 1) && (cmd_ifname_match (tmp) == 0))
-        {
-            node = cmd_insert_value_list (node, tmp);
-        }
-        else if (get_list_value (tmp, num) == 1)
+        size_t end = (name < list->n_names ? list->names[name].range
+                      : list->n_ranges);
+        size_t i;
+
+        if (end > in)
         {
-            for(i = num[0]; i <= num[1]; i++)
+            qsort(list->ranges + in, end - in, sizeof *list->ranges,
+                  cmd_range_interval_cmp);
+            list->ranges[out] = list->ranges[in];
+            for (i = in + 1; i < end; i++)
             {
-                snprintf(buf, DECIMAL_STRLEN_MAX+1,  "%lu", i);
-                node = cmd_insert_value_list (node, buf);
+                struct range_interval *last = &list->ranges[out];
+
+                if (list->ranges[i].lo <= last->hi
+                    || list->ranges[i].lo - 1 == last->hi)
+                {
+                    if (list->ranges[i].hi > last->hi)
+                        last->hi = list->ranges[i].hi;
+                }
+                else
+                {
+                    list->ranges[++out] = list->ranges[i];
+                }
             }
+            out++;
         }
-        else
-        {
-            return NULL;
-        }
+        in = end;
+        while (name < list->n_names && list->names[name].range == end)
+            list->names[name++].range = out;
+    }
+    list->n_ranges = out;
+}
+
+/*
+ * Function : cmd_range_list_add_token
+ * Responsibility : add one comma separated token (a value or a range A-B)
+                    to the list.
+ * Parameters : struct range_list *list : pointer holding the range list.
+ *              const char *tok : the token.
+ *              int flag_intf : identifying input is interface number or
+                                normal integer.
+ * Return : int : 1, if the token was added.
+ *                0, if it is not a valid range or memory ran out.
+ */
+static int
+cmd_range_list_add_token(struct range_list *list, const char *tok,
+                         int flag_intf)
+{
+    unsigned long num[2];
+    char *endptr = NULL;
+
+    if (strchr (tok, '-'))
+    {
+        if ((flag_intf == 1) && (cmd_ifname_match (tok) == 0))
+            return cmd_range_list_add_name (list, tok);
+        if (get_list_value (tok, num) == 1)
+            return cmd_range_list_add_range (list, num[0], num[1]);
+        return 0;
     }
-    return node;
+
+    if (isdigit ((int) *tok))
+    {
+        num[0] = strtoul (tok, &endptr, 10);
+        if (*endptr == '\0')
+            return cmd_range_list_add_range (list, num[0], num[0]);
+    }
+    return cmd_range_list_add_name (list, tok);
 }
 
 /*
  * Function :  cmd_get_range_value
- * Responsibility : give range list of all values from input string.
+ * Responsibility : give range list of all values from input string.  Ranges
+                    are kept as intervals, so parsing costs one step per
+                    comma separated token however many values they cover.
  * Parameters : char *value : string containing input value.
  *              int flag_intf : identifying input is interface number or
                                 normal integer.
- * Return : struct range_list * : list generated from input string value.
+ * Return : struct range_list * : list generated from input string value,
+                                  NULL if it holds no value.
  */
 struct range_list*
 cmd_get_range_value (const char *value, int flag_intf)
 {
-    struct range_list *node = NULL;
-    struct range_list *temp, *temp_node = NULL;
-    char *str_ptr = (char*)value;
-    char *tmp = NULL;
-    if (strchr (str_ptr, ','))
+    struct range_list *list;
+    char *str, *tmp, *save = NULL;
+
+    list = calloc (1, sizeof *list);
+    str = cmd_allocate_memory_str (value);
+    if (list == NULL || str == NULL)
+    {
+        cmd_free_memory_str (str);
+        return cmd_free_memory_range_list (list);
+    }
+
+    if (strchr (str, ','))
     {
-        tmp = strtok (str_ptr, ",");
-        while (tmp != NULL)
+        for (tmp = strtok_r (str, ",", &save); tmp != NULL;
+             tmp = strtok_r (NULL, ",", &save))
         {
-            if (strchr (tmp, '-'))
-            {
-                if (node == NULL)
-                {
-                    node = cmd_get_list_from_range_str (tmp, flag_intf);
-                }
-                else
-                {
-                    temp_node = node;
-                    temp = cmd_get_list_from_range_str (tmp, flag_intf);
-                    if (temp != NULL)
-                    {
-                         while (temp_node->link != NULL)
-                             temp_node = temp_node->link;
-                         temp_node->link = temp;
-                    }
-                }
-            }
-            else
-            {
-                node = cmd_insert_value_list (node, tmp);
-            }
-            tmp = strtok (NULL, ",");
+            cmd_range_list_add_token (list, tmp, flag_intf);
         }
     }
-    else if (strchr (str_ptr, '-'))
+    else if (cmd_range_list_add_token (list, str, flag_intf) == 0)
     {
-       node = cmd_get_list_from_range_str (str_ptr, flag_intf);
-       if (node == NULL)
-           return NULL;
+        cmd_free_memory_str (str);
+        return cmd_free_memory_range_list (list);
     }
-    else
+    cmd_free_memory_str (str);
+
+    if (list->n_ranges == 0 && list->n_names == 0)
+        return cmd_free_memory_range_list (list);
+    cmd_range_list_normalize (list);
+    return list;
+}
+
+/* Binary search for value in the sorted intervals [lo, hi) of list. */
+static int
+cmd_range_list_search (const struct range_list *list, size_t lo, size_t hi,
+                       unsigned long value)
+{
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (value < list->ranges[mid].lo)
+            hi = mid;
+        else if (value > list->ranges[mid].hi)
+            lo = mid + 1;
+        else
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ * Function :  cmd_range_list_contains
+ * Responsibility : check whether a number is in the range list.
+ * Parameters : const struct range_list *list : pointer holding the range
+                                                list.
+ *              unsigned long value : number to look for.
+ * Return : int : 1, if value is in one of the intervals of the list.
+ *                0, otherwise.
+ */
+int
+cmd_range_list_contains (const struct range_list *list, unsigned long value)
+{
+    size_t start = 0, name = 0;
+
+    if (list == NULL)
+        return 0;
+    /* The intervals are sorted between two names. */
+    for (;;)
+    {
+        size_t end = (name < list->n_names ? list->names[name].range
+                      : list->n_ranges);
+
+        if (cmd_range_list_search (list, start, end, value))
+            return 1;
+        if (end == list->n_ranges)
+            return 0;
+        start = end;
+        while (name < list->n_names && list->names[name].range == end)
+            name++;
+    }
+}
+
+/*
+ * Function :  cmd_range_list_iter_init
+ * Responsibility : start iterating over the values of a range list, in
+                    the order they were given, except that the numbers
+                    between two names come out in increasing order and
+                    without duplicates.
+ * Parameters : struct range_list_iter *iter : iterator to initialize.
+ *              const struct range_list *list : list to iterate over, may
+                                                be NULL.
+ * Return : void.
+ */
+void
+cmd_range_list_iter_init (struct range_list_iter *iter,
+                          const struct range_list *list)
+{
+    iter->list = list;
+    iter->range = 0;
+    iter->name = 0;
+    iter->value = (list && list->n_ranges) ? list->ranges[0].lo : 0;
+}
+
+/*
+ * Function :  cmd_range_list_next
+ * Responsibility : format the next value of the range list into buf.
+                    Values are produced one at a time, a range is never
+                    expanded in memory.
+ * Parameters : struct range_list_iter *iter : iterator.
+ *              char *buf : buffer receiving the value.
+ *              size_t len : size of buf.
+ * Return : int : 1, if buf holds the next value.
+ *                0, once every value has been produced.
+ */
+int
+cmd_range_list_next (struct range_list_iter *iter, char *buf, size_t len)
+{
+    const struct range_list *list = iter->list;
+
+    if (list == NULL)
+        return 0;
+    if (iter->name < list->n_names
+        && list->names[iter->name].range <= iter->range)
+    {
+        snprintf (buf, len, "%s", list->names[iter->name++].name);
+        return 1;
+    }
+    if (iter->range < list->n_ranges)
     {
-        node = cmd_insert_value_list (node, str_ptr);
+        snprintf (buf, len, "%lu", iter->value);
+        if (iter->value == list->ranges[iter->range].hi)
+        {
+            if (++iter->range < list->n_ranges)
+                iter->value = list->ranges[iter->range].lo;
+        }
+        else
+        {
+            iter->value++;
+        }
+        return 1;
     }
-    return node;
+    return 0;
 }
 
 /*
@@ -91,6 +91,7 @@ struct format_parser_state
   int in_multiple; /* flag to remember if we are in a multiple group */
   int just_read_word; /* flag to remember if the last thing we red was a
                        * real word and not some abstract token */
+  int error; /* set when the string could not be parsed */
 };
 #endif
 
@@ -185,6 +186,15 @@ struct cmd_node
 #define CMD_ATTR_NOLOCK      8  /* command doesn't take the OVSDB lock */
 #define CMD_ATTR_NON_IDL_CMD 16 /* command is not checking system configuration status,ovsdb status */
 
+/* On-demand OVSDB tables a command reads.  They are not monitored by the
+   IDL of the session until a command that needs them runs, see
+   vtysh_ovsdb_tables_need(). */
+#define CMD_TABLES_BGP_RIB   1  /* BGP_Route, BGP_Nexthop */
+#define CMD_TABLES_OSPF_LSDB 2  /* OSPF_LSA, OSPF_Route */
+#define CMD_ATTR_TABLES_SHIFT 8
+#define CMD_ATTR_TABLES(tables)   ((tables) << CMD_ATTR_TABLES_SHIFT)
+#define CMD_ATTR_TABLES_GET(attr) ((unsigned int) (attr) >> CMD_ATTR_TABLES_SHIFT)
+
 #define CMD_FLAG_NO_CMD      1
 
 /* Structure of command element. */
@@ -225,6 +235,35 @@ struct cmd_token
   void (*dyn_cb_func)(struct cmd_token *token, struct vty *vty, \
                       char * const dyn_helpstr_ptr, int max_strlen);
                                  /* Command's dynamic callback func pointer. */
+  unsigned int refcnt;           /* Commands sharing the token, 0 if it is
+                                    private to one command. */
+};
+
+/* Pooled strings and shared tokens of the parsed commands, see
+   cmd_pool_stats_get(). */
+struct cmd_pool_stats
+{
+  unsigned long elements;       /* Installed command elements. */
+  unsigned long parsed;         /* Elements whose tokens are parsed. */
+  unsigned long strings;        /* Distinct token strings. */
+  unsigned long string_refs;    /* References to them. */
+  unsigned long string_bytes;   /* Bytes held by them. */
+  unsigned long tokens;         /* Distinct shared terminal tokens. */
+  unsigned long token_refs;     /* References to them. */
+  unsigned long saved_bytes;    /* Bytes private copies would add. */
+};
+
+/* Counters of the TACACS+ command authorization cache, see
+   cmd_author_stats_get(). */
+struct cmd_author_stats
+{
+  unsigned long entries;        /* Cached decisions. */
+  unsigned long hits;           /* Commands authorized from the cache. */
+  unsigned long misses;         /* Commands sent to the servers. */
+  unsigned long expired;        /* Decisions dropped for their age. */
+  unsigned long flushes;        /* Drops of all decisions on AAA changes. */
+  int ttl;                      /* Seconds allowed commands are cached. */
+  int negative_ttl;             /* Seconds denied commands are cached. */
 };
 
 /* Structure for dynamic help string */
@@ -480,6 +519,10 @@ struct dyn_cb_func
 #define DEFUN_NOLOCK(funcname, cmdname, cmdstr, helpstr) \
   DEFUN_ATTR (funcname, cmdname, cmdstr, helpstr, CMD_ATTR_NOLOCK)
 
+/* DEFUN_TABLES for the commands reading on-demand tables, CMD_TABLES_* */
+#define DEFUN_TABLES(funcname, cmdname, cmdstr, helpstr, tables) \
+  DEFUN_ATTR (funcname, cmdname, cmdstr, helpstr, CMD_ATTR_TABLES (tables))
+
 #define DEFUN_DEPRECATED(funcname, cmdname, cmdstr, helpstr) \
   DEFUN_ATTR (funcname, cmdname, cmdstr, helpstr, CMD_ATTR_DEPRECATED) \
 
@@ -667,6 +710,13 @@ struct dyn_cb_func
 extern void install_node (struct cmd_node *, int (*) (struct vty *));
 extern void install_default (enum node_type);
 extern void install_element (enum node_type, struct cmd_element *);
+extern void cmd_parse_all (void);
+extern size_t cmd_element_keyword (const struct cmd_element *, const char **);
+extern const char *cmd_node_name (enum node_type);
+extern int cmd_node_by_name (const char *);
+extern void (*cmd_demand_hook) (enum node_type, const char *);
+extern void cmd_pool_stats_get (struct cmd_pool_stats *);
+extern void cmd_author_stats_get (struct cmd_author_stats *);
 
 /* Concatenates argv[shift] through argv[argc-1] into a single NUL-terminated
    string with a space between each element (allocated using
@@ -679,6 +729,9 @@ extern int (*tac_cmd_author_ptr)(const char *, const char *,
                                  const char *, const char * );
 extern vector cmd_make_strvec (const char *);
 extern void cmd_free_strvec (vector);
+extern void cmd_token_class_enable (int);
+extern void cmd_user_set (const char *);
+extern const char *cmd_user_name (void);
 extern vector cmd_describe_command (vector, struct vty *, int *status);
 extern char **cmd_complete_command (vector, struct vty *, int *status);
 extern const char *cmd_prompt (enum node_type);
@@ -729,25 +782,68 @@ void install_dyn_helpstr_funcptr(char *funcname,
 #define SYSTEM_AAA_TACACS_TIMEOUT              "tacacs_timeout"
 #define SYSTEM_AAA_TACACS_PASSKEY              "tacacs_passkey"
 #define SYSTEM_AAA_TACACS_AUTH                 "tacacs_auth"
+#define SYSTEM_AAA_TACACS_AUTHOR_CACHE_TTL     "tacacs_author_cache_ttl"
+#define SYSTEM_AAA_TACACS_AUTHOR_CACHE_NEGATIVE_TTL \
+                                          "tacacs_author_cache_negative_ttl"
+#define CMD_AUTHOR_CACHE_TTL_DEFAULT           60
+#define CMD_AUTHOR_CACHE_NEGATIVE_TTL_DEFAULT  10
 #define EXIT_CMD                               "exit"
 #define END_CMD                                "end"
 #define MAX_LENGTH_TACACS_TIMEOUT              4
 #define MAX_LENGTH_TACACS_PASSKEY              32
 
+struct range_interval
+{
+    unsigned long lo;
+    unsigned long hi;
+};
+
+/* A value which is not a number, such as an interface name. */
+struct range_name
+{
+    char *name;
+    size_t range;               /* Comes before ranges[range]. */
+};
+
+/* Values given as "A-B,C,..." on the command line.  Names are kept in the
+ * order they were given; the numbers between two names are kept as sorted,
+ * non-overlapping intervals.
+ *
+ * This replaced the one-node-per-value "value"/"link" list in version 1 of
+ * the ops-cli library: plugins which walk a range_list must use
+ * cmd_range_list_iter_init()/cmd_range_list_next() and be rebuilt. */
 struct range_list
 {
-    char value[DECIMAL_STRLEN_MAX + 1];
-    struct range_list *link;
+    struct range_interval *ranges;
+    size_t n_ranges;
+    size_t allocated_ranges;
+    struct range_name *names;
+    size_t n_names;
+    size_t allocated_names;
+};
+
+/* Walks a range_list one value at a time. */
+struct range_list_iter
+{
+    const struct range_list *list;
+    size_t range;               /* Current interval. */
+    unsigned long value;        /* Next value of the current interval. */
+    size_t name;                /* Next name. */
 };
 
 struct range_list *cmd_free_memory_range_list(struct range_list *);
+int cmd_range_list_contains(const struct range_list *, unsigned long);
+void cmd_range_list_iter_init(struct range_list_iter *,
+                              const struct range_list *);
+int cmd_range_list_next(struct range_list_iter *, char *, size_t);
 char *cmd_allocate_memory_str(const char *);
 
 enum cli_int_type
 {
     COMMA_OPERATOR = 0,
     RANGE_OPERATOR,
-    BOTH_OPERATOR
+    BOTH_OPERATOR,
+    RANGE_ONLY_OPERATOR         /* <R:>, a RANGE_OPERATOR list with a '-'. */
 };
 
 struct range_list* cmd_get_range_value(const char *, int);
@@ -52,6 +52,8 @@ struct memory_list memory_list_lib[] =
   { MTYPE_ROUTE_MAP_RULE_STR,	"Route map rule str"		},
   { MTYPE_ROUTE_MAP_COMPILED,	"Route map compiled"		},
   { MTYPE_CMD_TOKENS,		"Command desc"			},
+  { MTYPE_CMD_INTERN,		"Command string pool"		},
+  { MTYPE_CMD_AUTHOR,		"Command authorization cache"	},
   { MTYPE_KEY,			"Key"				},
   { MTYPE_KEYCHAIN,		"Key chain"			},
   { MTYPE_IF_RMAP,		"Interface route map"		},
@@ -66,6 +68,8 @@ struct memory_list memory_list_lib[] =
   { MTYPE_PQUEUE,		"Priority queue"		},
   { MTYPE_PQUEUE_DATA,		"Priority queue data"		},
   { MTYPE_HOST,			"Host config"			},
+  { MTYPE_REGEX_CACHE,		"Regex cache entry"		},
+  { MTYPE_REGEX_CACHE_STR,	"Regex cache pattern"		},
   { -1, NULL },
 };
 
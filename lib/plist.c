@@ -30,6 +30,7 @@
 #include "buffer.h"
 #include "stream.h"
 #include "log.h"
+#include "table.h"
 
 #ifndef ENABLE_OVSDB
 /* Each prefix-list's entry. */
@@ -48,6 +49,13 @@ struct prefix_list_entry
   unsigned long refcnt;
   unsigned long hitcnt;
 
+  /* Lifetime match count, not reset by clear, and refcnt baseline. */
+  unsigned long matchcnt;
+  unsigned long refbase;
+
+  /* Next entry in the same trie node, in sequence order. */
+  struct prefix_list_entry *trie_next;
+
   struct prefix_list_entry *next;
   struct prefix_list_entry *prev;
 };
@@ -303,6 +311,7 @@ prefix_list_delete (struct prefix_list *plist)
   struct prefix_master *master;
   struct prefix_list_entry *pentry;
   struct prefix_list_entry *next;
+  afi_t afi;
 
   /* If prefix-list contain prefix_list_entry free all of it. */
   for (pentry = plist->head; pentry; pentry = next)
@@ -312,6 +321,10 @@ prefix_list_delete (struct prefix_list *plist)
       plist->count--;
     }
 
+  for (afi = 0; afi < AFI_MAX; afi++)
+    if (plist->trie[afi])
+      route_table_finish (plist->trie[afi]);
+
   master = plist->master;
 
   if (plist->type == PREFIX_TYPE_NUMBER)
@@ -441,6 +454,82 @@ prefix_list_entry_lookup (struct prefix_list *plist, struct prefix *prefix,
   return NULL;
 }
 
+/* Link pentry into the trie node of its prefix.  Entries sharing a
+   prefix are chained in sequence order, and each one holds a lock on
+   the node. */
+static void
+prefix_list_trie_add (struct prefix_list *plist,
+		      struct prefix_list_entry *pentry)
+{
+  struct route_node *rn;
+  struct prefix_list_entry **pp;
+  afi_t afi;
+
+  afi = family2afi (pentry->prefix.family);
+  if (afi == 0 || afi >= AFI_MAX)
+    return;
+
+  if (plist->trie[afi] == NULL)
+    plist->trie[afi] = route_table_init ();
+
+  rn = route_node_get (plist->trie[afi], &pentry->prefix);
+  for (pp = (struct prefix_list_entry **) &rn->info; *pp;
+       pp = &(*pp)->trie_next)
+    if ((*pp)->seq > pentry->seq)
+      break;
+
+  pentry->trie_next = *pp;
+  *pp = pentry;
+}
+
+static void
+prefix_list_trie_delete (struct prefix_list *plist,
+			 struct prefix_list_entry *pentry)
+{
+  struct route_node *rn;
+  struct prefix_list_entry **pp;
+  afi_t afi;
+
+  afi = family2afi (pentry->prefix.family);
+  if (afi == 0 || afi >= AFI_MAX || plist->trie[afi] == NULL)
+    return;
+
+  rn = route_node_lookup (plist->trie[afi], &pentry->prefix);
+  if (rn == NULL)
+    return;
+
+  for (pp = (struct prefix_list_entry **) &rn->info; *pp;
+       pp = &(*pp)->trie_next)
+    if (*pp == pentry)
+      {
+	*pp = pentry->trie_next;
+	pentry->trie_next = NULL;
+	route_unlock_node (rn);
+	break;
+      }
+
+  /* Lock taken by route_node_lookup(). */
+  route_unlock_node (rn);
+}
+
+/* Bring refcnt of every entry up to date.  refcnt counts the
+   prefix_list_apply() calls that reached an entry, which are the calls
+   where no entry before it matched.  prefix_list_apply() only counts
+   calls and matches, the per entry value is derived here so that
+   applying the list does not have to walk it. */
+static void
+prefix_list_sync_refcnt (struct prefix_list *plist)
+{
+  struct prefix_list_entry *pentry;
+  unsigned long before = 0;
+
+  for (pentry = plist->head; pentry; pentry = pentry->next)
+    {
+      pentry->refcnt = plist->applycnt - before - pentry->refbase;
+      before += pentry->matchcnt;
+    }
+}
+
 #ifdef ENABLE_OVSDB
 void
 #else
@@ -450,8 +539,17 @@ prefix_list_entry_delete (struct prefix_list *plist,
 			  struct prefix_list_entry *pentry,
 			  int update_list)
 {
+  struct prefix_list_entry *point;
+
   if (plist == NULL || pentry == NULL)
     return;
+
+  /* Calls matched by pentry did not reach the entries after it. */
+  for (point = pentry->next; point; point = point->next)
+    point->refbase += pentry->matchcnt;
+  plist->matchcnt -= pentry->matchcnt;
+  prefix_list_trie_delete (plist, pentry);
+
   if (pentry->prev)
     pentry->prev->next = pentry->next;
   else
@@ -488,15 +586,22 @@ prefix_list_entry_add (struct prefix_list *plist,
   if (pentry->seq == -1)
     pentry->seq = prefix_new_seq_get (plist);
 
-  /* Is there any same seq prefix list entry? */
-  replace = prefix_seq_check (plist, pentry->seq);
-  if (replace)
-    prefix_list_entry_delete (plist, replace, 0);
-
-  /* Check insert point. */
-  for (point = plist->head; point; point = point->next)
-    if (point->seq >= pentry->seq)
-      break;
+  /* Entries are sorted by seq, so an entry past the tail is appended
+     and cannot replace anything. */
+  if (plist->tail && plist->tail->seq < pentry->seq)
+    point = NULL;
+  else
+    {
+      /* Is there any same seq prefix list entry? */
+      replace = prefix_seq_check (plist, pentry->seq);
+      if (replace)
+	prefix_list_entry_delete (plist, replace, 0);
+
+      /* Check insert point. */
+      for (point = plist->head; point; point = point->next)
+	if (point->seq >= pentry->seq)
+	  break;
+    }
 
   /* In case of this is the first element of the list. */
   pentry->next = point;
@@ -522,6 +627,18 @@ prefix_list_entry_add (struct prefix_list *plist,
       plist->tail = pentry;
     }
 
+  /* A new entry starts with a zero refcnt. */
+  pentry->matchcnt = 0;
+  if (pentry == plist->tail)
+    pentry->refbase = plist->applycnt - plist->matchcnt;
+  else
+    {
+      pentry->refbase = plist->applycnt;
+      for (point = plist->head; point != pentry; point = point->next)
+	pentry->refbase -= point->matchcnt;
+    }
+  prefix_list_trie_add (plist, pentry);
+
   /* Increment count. */
   plist->count++;
 
@@ -575,6 +692,43 @@ prefix_list_entry_match (struct prefix_list_entry *pentry, struct prefix *p)
   return 1;
 }
 
+/* Return the lowest sequence entry matching p.  Only the trie nodes on
+   the path to p can hold a covering prefix, so the walk is bounded by
+   the address length instead of the number of entries. */
+static struct prefix_list_entry *
+prefix_list_trie_match (struct prefix_list *plist, struct prefix *p)
+{
+  struct route_node *rn;
+  struct prefix_list_entry *pentry;
+  struct prefix_list_entry *best = NULL;
+  afi_t afi;
+
+  afi = family2afi (p->family);
+  if (afi == 0 || afi >= AFI_MAX || plist->trie[afi] == NULL)
+    return NULL;
+
+  rn = plist->trie[afi]->top;
+  while (rn && rn->p.prefixlen <= p->prefixlen && prefix_match (&rn->p, p))
+    {
+      for (pentry = rn->info; pentry; pentry = pentry->trie_next)
+	{
+	  if (best && pentry->seq >= best->seq)
+	    break;
+	  if (prefix_list_entry_match (pentry, p))
+	    {
+	      best = pentry;
+	      break;
+	    }
+	}
+
+      if (rn->p.prefixlen == p->prefixlen)
+	break;
+      rn = rn->link[prefix_bit (&p->u.prefix, rn->p.prefixlen)];
+    }
+
+  return best;
+}
+
 enum prefix_list_type
 prefix_list_apply (struct prefix_list *plist, void *object)
 {
@@ -589,19 +743,38 @@ prefix_list_apply (struct prefix_list *plist, void *object)
   if (plist->count == 0)
     return PREFIX_PERMIT;
 
-  for (pentry = plist->head; pentry; pentry = pentry->next)
+  plist->applycnt++;
+
+  pentry = prefix_list_trie_match (plist, p);
+  if (pentry)
     {
-      pentry->refcnt++;
-      if (prefix_list_entry_match (pentry, p))
-	{
-	  pentry->hitcnt++;
-	  return pentry->type;
-	}
+      pentry->hitcnt++;
+      pentry->matchcnt++;
+      plist->matchcnt++;
+      return pentry->type;
     }
 
   return PREFIX_DENY;
 }
 
+/* Same verdict as prefix_list_apply (), but without touching the hit
+   and reference counters, so several threads may evaluate one list at
+   once as long as nobody modifies it. */
+enum prefix_list_type
+prefix_list_check (struct prefix_list *plist, struct prefix *p)
+{
+  struct prefix_list_entry *pentry;
+
+  if (plist == NULL)
+    return PREFIX_DENY;
+
+  if (plist->count == 0)
+    return PREFIX_PERMIT;
+
+  pentry = prefix_list_trie_match (plist, p);
+  return pentry ? pentry->type : PREFIX_DENY;
+}
+
 static void __attribute__ ((unused))
 prefix_list_print (struct prefix_list *plist)
 {
@@ -941,6 +1114,8 @@ vty_show_prefix_entry (struct vty *vty, afi_t afi, struct prefix_list *plist,
 {
   struct prefix_list_entry *pentry;
 
+  prefix_list_sync_refcnt (plist);
+
   /* Print the name of the protocol */
   if (zlog_default)
       vty_out (vty, "%s: ", zlog_proto_names[zlog_default->protocol]);
@@ -1076,6 +1251,8 @@ vty_show_prefix_list_prefix (struct vty *vty, afi_t afi, const char *name,
       return CMD_WARNING;
     }
 
+  prefix_list_sync_refcnt (plist);
+
   for (pentry = plist->head; pentry; pentry = pentry->next)
     {
       match = 0;
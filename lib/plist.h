@@ -38,6 +38,8 @@ enum prefix_name_type
   PREFIX_TYPE_NUMBER
 };
 
+struct route_table;
+
 struct prefix_list
 {
   char *name;
@@ -53,6 +55,14 @@ struct prefix_list
   struct prefix_list_entry *head;
   struct prefix_list_entry *tail;
 
+  /* Entry prefixes per address family, used by prefix_list_apply(). */
+  struct route_table *trie[AFI_MAX];
+
+  /* Number of prefix_list_apply() calls that walked the entries, and
+     how many of them matched one. */
+  unsigned long applycnt;
+  unsigned long matchcnt;
+
   struct prefix_list *next;
   struct prefix_list *prev;
 };
@@ -73,6 +83,8 @@ extern void prefix_list_delete_hook (void (*func) (struct prefix_list *));
 
 extern struct prefix_list *prefix_list_lookup (afi_t, const char *);
 extern enum prefix_list_type prefix_list_apply (struct prefix_list *, void *);
+extern enum prefix_list_type prefix_list_check (struct prefix_list *,
+						 struct prefix *);
 
 extern struct stream * prefix_bgp_orf_entry (struct stream *,
                                              struct prefix_list *,
@@ -98,6 +110,13 @@ struct prefix_list_entry
   unsigned long refcnt;
   unsigned long hitcnt;
 
+  /* Lifetime match count, not reset by clear, and refcnt baseline. */
+  unsigned long matchcnt;
+  unsigned long refbase;
+
+  /* Next entry in the same trie node, in sequence order. */
+  struct prefix_list_entry *trie_next;
+
   struct prefix_list_entry *next;
   struct prefix_list_entry *prev;
 };
@@ -0,0 +1,155 @@
+/* Prefix list evaluation microbenchmark.
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This file is part of GNU Zebra.
+ *
+ * GNU Zebra is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * GNU Zebra is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Zebra; see the file COPYING.  If not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Compares prefix_list_apply() against a plain linear walk of the same
+   entries for lists of 1k, 10k and 100k entries, and checks that both
+   return the same verdict for every probe.  Build with
+   "make plist_bench". */
+
+#include <zebra.h>
+
+#include "prefix.h"
+#include "plist.h"
+
+#define PROBES 10000
+
+static const int list_sizes[] = { 1000, 10000, 100000 };
+
+/* The evaluation prefix_list_apply() used before the trie. */
+static enum prefix_list_type
+linear_apply (struct prefix_list *plist, struct prefix *p)
+{
+  struct prefix_list_entry *pentry;
+
+  if (plist->count == 0)
+    return PREFIX_PERMIT;
+
+  for (pentry = plist->head; pentry; pentry = pentry->next)
+    {
+      if (! prefix_match (&pentry->prefix, p))
+	continue;
+      if (! pentry->le && ! pentry->ge)
+	{
+	  if (pentry->prefix.prefixlen != p->prefixlen)
+	    continue;
+	}
+      else
+	{
+	  if (pentry->le && p->prefixlen > pentry->le)
+	    continue;
+	  if (pentry->ge && p->prefixlen < pentry->ge)
+	    continue;
+	}
+      return pentry->type;
+    }
+  return PREFIX_DENY;
+}
+
+static void
+random_prefix (struct prefix *p, int minlen)
+{
+  memset (p, 0, sizeof (struct prefix));
+  p->family = AF_INET;
+  p->prefixlen = minlen + random () % (IPV4_MAX_BITLEN - minlen + 1);
+  p->u.prefix4.s_addr = htonl (0x0a000000 | (random () & 0x00ffffff));
+  apply_mask (p);
+}
+
+static double
+elapsed (struct timeval *start)
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - start->tv_sec) * 1000.0
+    + (now.tv_usec - start->tv_usec) / 1000.0;
+}
+
+static int
+bench (int size)
+{
+  struct prefix_list *plist;
+  struct prefix_list_entry *pentry;
+  struct prefix *probes;
+  struct prefix p;
+  struct timeval start;
+  double linear_ms, trie_ms;
+  char name[32];
+  int i, mismatch = 0;
+  int ge, le;
+
+  snprintf (name, sizeof (name), "bench-%d", size);
+  plist = prefix_list_get (AFI_IP, name);
+
+  for (i = 0; i < size; i++)
+    {
+      random_prefix (&p, 16);
+      ge = le = 0;
+      if (p.prefixlen < IPV4_MAX_BITLEN && random () % 2)
+	{
+	  ge = p.prefixlen + 1;
+	  le = ge + random () % (IPV4_MAX_BITLEN - ge + 1);
+	}
+      pentry = prefix_list_entry_make (&p, random () % 2 ?
+				       PREFIX_PERMIT : PREFIX_DENY,
+				       (i + 1) * 5, le, ge, 0);
+      prefix_list_entry_add (plist, pentry);
+    }
+
+  probes = calloc (PROBES, sizeof (struct prefix));
+  for (i = 0; i < PROBES; i++)
+    random_prefix (&probes[i], 24);
+
+  for (i = 0; i < PROBES; i++)
+    if (linear_apply (plist, &probes[i]) != prefix_list_apply (plist, &probes[i]))
+      mismatch++;
+
+  gettimeofday (&start, NULL);
+  for (i = 0; i < PROBES; i++)
+    linear_apply (plist, &probes[i]);
+  linear_ms = elapsed (&start);
+
+  gettimeofday (&start, NULL);
+  for (i = 0; i < PROBES; i++)
+    prefix_list_apply (plist, &probes[i]);
+  trie_ms = elapsed (&start);
+
+  printf ("%7d entries: linear %9.1f ms, trie %7.1f ms, %d mismatches\n",
+	  size, linear_ms, trie_ms, mismatch);
+
+  free (probes);
+  prefix_list_delete (plist);
+  return mismatch;
+}
+
+int
+main (int argc, char **argv)
+{
+  unsigned int i;
+  int mismatch = 0;
+
+  srandom (1);
+  printf ("%d probes per list\n", PROBES);
+  for (i = 0; i < ZEBRA_NUM_OF (list_sizes); i++)
+    mismatch += bench (list_sizes[i]);
+
+  return mismatch ? 1 : 0;
+}
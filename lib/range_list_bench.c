@@ -0,0 +1,194 @@
+/* Command range list microbenchmark.
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This file is part of GNU Zebra.
+ *
+ * GNU Zebra is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * GNU Zebra is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Zebra; see the file COPYING.  If not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Checks that cmd_get_range_value () merges overlapping and out of order
+   numbers, keeps the names where they were given and that
+   cmd_range_list_contains () agrees with the iteration, then times parsing
+   and walking "1-4094" and a list of 1000 single values.  Build with
+   "make range_list_bench". */
+
+#include <zebra.h>
+
+#include "command.h"
+
+#define RUNS 2000
+
+static const struct
+{
+  const char *input;
+  const char *values;           /* Iteration, space separated. */
+  unsigned int n_ranges;        /* Intervals after merging. */
+} cases[] =
+{
+  /* Normalization. */
+  { "7", "7", 1 },
+  { "3-5", "3 4 5", 1 },
+  { "5,1-3,2-4", "1 2 3 4 5", 1 },
+  { "40-45,42,38-41", "38 39 40 41 42 43 44 45", 1 },
+  /* Overlapping, adjacent and disjoint intervals. */
+  { "1-10,5-15", "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15", 1 },
+  { "1-3,4-6", "1 2 3 4 5 6", 1 },
+  { "10-12,1-2,11,2", "1 2 10 11 12", 2 },
+  { "9,7,5,3,1", "1 3 5 7 9", 5 },
+  /* Names keep their place, numbers are merged between two names. */
+  { "1/1", "1/1", 0 },
+  { "lag1,3", "lag1 3", 1 },
+  { "3,lag1", "3 lag1", 1 },
+  { "1/1,5,3,1/2,2,1", "1/1 3 5 1/2 1 2", 3 },
+  { "4,2,lag1,lag2,9-10,8", "2 4 lag1 lag2 8 9 10", 3 },
+  { "2,1/1,2", "2 1/1 2", 2 },
+};
+
+static double
+elapsed (struct timeval *start)
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - start->tv_sec) * 1000.0
+    + (now.tv_usec - start->tv_usec) / 1000.0;
+}
+
+/* Returns the values of list, space separated, in buf. */
+static const char *
+format_values (const struct range_list *list, char *buf, size_t len)
+{
+  struct range_list_iter iter;
+  char value[32];
+  size_t n = 0;
+
+  buf[0] = '\0';
+  cmd_range_list_iter_init (&iter, list);
+  while (cmd_range_list_next (&iter, value, sizeof (value)) && n < len)
+    n += snprintf (buf + n, len - n, "%s%s", n ? " " : "", value);
+  return buf;
+}
+
+/* Returns the number of values of list cmd_range_list_contains ()
+   disagrees on, checking every number up to 20. */
+static int
+check_contains (const struct range_list *list, const char *values)
+{
+  char buf[16];
+  unsigned long i;
+  int mismatch = 0;
+
+  for (i = 0; i <= 20; i++)
+    {
+      const char *p = values;
+      int found = 0;
+
+      snprintf (buf, sizeof (buf), "%lu", i);
+      while ((p = strstr (p, buf)) != NULL)
+	{
+	  size_t len = strlen (buf);
+
+	  if ((p == values || p[-1] == ' ') && (p[len] == ' ' || !p[len]))
+	    found = 1;
+	  p += len;
+	}
+      if (found != cmd_range_list_contains (list, i))
+	mismatch++;
+    }
+  return mismatch;
+}
+
+static int
+check (void)
+{
+  struct range_list *list;
+  char buf[256];
+  unsigned int i;
+  int mismatch = 0;
+
+  for (i = 0; i < ZEBRA_NUM_OF (cases); i++)
+    {
+      list = cmd_get_range_value (cases[i].input, 1);
+      if (list == NULL)
+	{
+	  printf ("\"%s\": no list\n", cases[i].input);
+	  mismatch++;
+	  continue;
+	}
+      format_values (list, buf, sizeof (buf));
+      if (strcmp (buf, cases[i].values)
+	  || list->n_ranges != cases[i].n_ranges
+	  || check_contains (list, cases[i].values))
+	{
+	  printf ("\"%s\": got \"%s\" in %zu intervals, expected \"%s\" in "
+		  "%u\n", cases[i].input, buf, list->n_ranges,
+		  cases[i].values, cases[i].n_ranges);
+	  mismatch++;
+	}
+      cmd_free_memory_range_list (list);
+    }
+  return mismatch;
+}
+
+/* Parses and walks value RUNS times. */
+static double
+run (const char *value, unsigned long *n_values)
+{
+  struct range_list_iter iter;
+  struct range_list *list;
+  struct timeval start;
+  char buf[32];
+  unsigned int i;
+
+  *n_values = 0;
+  gettimeofday (&start, NULL);
+  for (i = 0; i < RUNS; i++)
+    {
+      list = cmd_get_range_value (value, 0);
+      cmd_range_list_iter_init (&iter, list);
+      while (cmd_range_list_next (&iter, buf, sizeof (buf)))
+	(*n_values)++;
+      cmd_free_memory_range_list (list);
+    }
+  return elapsed (&start);
+}
+
+int
+main (int argc, char **argv)
+{
+  char singles[1000 * 6];
+  unsigned long n_values;
+  double ms;
+  size_t n = 0;
+  unsigned int i;
+  int mismatch;
+
+  mismatch = check ();
+
+  ms = run ("1-4094", &n_values);
+  printf ("%-12s %8.1f us/list, %lu values\n", "1-4094", ms * 1e3 / RUNS,
+	  n_values / RUNS);
+
+  for (i = 1000; i > 0; i--)
+    n += snprintf (singles + n, sizeof (singles) - n, "%s%u",
+		   n ? "," : "", i * 4);
+  ms = run (singles, &n_values);
+  printf ("%-12s %8.1f us/list, %lu values\n", "1000 singles",
+	  ms * 1e3 / RUNS, n_values / RUNS);
+
+  printf ("%d mismatches\n", mismatch);
+  return mismatch ? 1 : 0;
+}
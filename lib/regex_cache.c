@@ -0,0 +1,235 @@
+/* Compiled regular expression cache.
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This file is part of GNU Zebra.
+ *
+ * GNU Zebra is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * GNU Zebra is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Zebra; see the file COPYING.  If not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <zebra.h>
+#include <pthread.h>
+
+#ifdef HAVE_GNU_REGEX
+#include <regex.h>
+#else
+#include "regex-gnu.h"
+#endif /* HAVE_GNU_REGEX */
+
+#include "memory.h"
+#include "hash.h"
+#include "regex_cache.h"
+
+/* A compiled pattern.  Entries that are not pinned are also on the LRU
+   list, most recently used first. */
+struct regex_cache_entry
+{
+  char *pattern;
+  int cflags;
+  int pinned;
+  regex_t regex;
+  struct regex_cache_entry *prev;
+  struct regex_cache_entry *next;
+};
+
+static struct hash *regex_cache_hash;
+static struct regex_cache_entry *regex_cache_head;
+static struct regex_cache_entry *regex_cache_tail;
+static unsigned int regex_cache_unpinned;
+static struct regex_cache_stats regex_cache_counters;
+
+/* Validators run from the CLI and from the OVSDB thread. */
+static pthread_mutex_t regex_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int
+regex_cache_hash_key (void *data)
+{
+  struct regex_cache_entry *entry = data;
+
+  return string_hash_make (entry->pattern) ^ (unsigned int) entry->cflags;
+}
+
+static int
+regex_cache_hash_cmp (const void *a, const void *b)
+{
+  const struct regex_cache_entry *entry1 = a;
+  const struct regex_cache_entry *entry2 = b;
+
+  return entry1->cflags == entry2->cflags
+	 && strcmp (entry1->pattern, entry2->pattern) == 0;
+}
+
+static void
+regex_cache_lru_unlink (struct regex_cache_entry *entry)
+{
+  if (entry->prev)
+    entry->prev->next = entry->next;
+  else
+    regex_cache_head = entry->next;
+  if (entry->next)
+    entry->next->prev = entry->prev;
+  else
+    regex_cache_tail = entry->prev;
+  entry->prev = entry->next = NULL;
+}
+
+static void
+regex_cache_lru_push (struct regex_cache_entry *entry)
+{
+  entry->prev = NULL;
+  entry->next = regex_cache_head;
+  if (regex_cache_head)
+    regex_cache_head->prev = entry;
+  else
+    regex_cache_tail = entry;
+  regex_cache_head = entry;
+}
+
+static void
+regex_cache_entry_free (void *data)
+{
+  struct regex_cache_entry *entry = data;
+
+  regfree (&entry->regex);
+  regex_cache_counters.freed++;
+  XFREE (MTYPE_REGEX_CACHE_STR, entry->pattern);
+  XFREE (MTYPE_REGEX_CACHE, entry);
+}
+
+/* Find the compiled form of pattern, compiling it on a miss.  Returns
+   NULL and stores the regcomp () error in *ret if it does not compile.
+   Called with the cache lock held. */
+static struct regex_cache_entry *
+regex_cache_get (const char *pattern, int cflags, int *ret,
+		 char *errbuf, size_t errbuf_size)
+{
+  struct regex_cache_entry key, *entry;
+
+  *ret = 0;
+  if (regex_cache_hash == NULL)
+    regex_cache_hash = hash_create (regex_cache_hash_key,
+				    regex_cache_hash_cmp);
+
+  key.pattern = (char *) pattern;
+  key.cflags = cflags;
+  entry = hash_lookup (regex_cache_hash, &key);
+  if (entry)
+    {
+      regex_cache_counters.hits++;
+      if (! entry->pinned && entry != regex_cache_head)
+	{
+	  regex_cache_lru_unlink (entry);
+	  regex_cache_lru_push (entry);
+	}
+      return entry;
+    }
+
+  regex_cache_counters.misses++;
+  entry = XCALLOC (MTYPE_REGEX_CACHE, sizeof (struct regex_cache_entry));
+  *ret = regcomp (&entry->regex, pattern, cflags);
+  if (*ret)
+    {
+      if (errbuf)
+	regerror (*ret, &entry->regex, errbuf, errbuf_size);
+      XFREE (MTYPE_REGEX_CACHE, entry);
+      return NULL;
+    }
+  regex_cache_counters.compiled++;
+  entry->pattern = XSTRDUP (MTYPE_REGEX_CACHE_STR, pattern);
+  entry->cflags = cflags;
+  hash_get (regex_cache_hash, entry, hash_alloc_intern);
+  regex_cache_lru_push (entry);
+
+  if (++regex_cache_unpinned > REGEX_CACHE_SIZE)
+    {
+      struct regex_cache_entry *victim = regex_cache_tail;
+
+      regex_cache_lru_unlink (victim);
+      hash_release (regex_cache_hash, victim);
+      regex_cache_entry_free (victim);
+      regex_cache_unpinned--;
+      regex_cache_counters.evictions++;
+    }
+  return entry;
+}
+
+/* Match str against pattern, compiling pattern only the first time it
+   is seen.  Returns 0 on a match, REG_NOMATCH, or the regcomp () or
+   regexec () error, described in errbuf when errbuf is not NULL. */
+int
+regex_cache_match (const char *pattern, int cflags, const char *str,
+		   char *errbuf, size_t errbuf_size)
+{
+  struct regex_cache_entry *entry;
+  int ret;
+
+  pthread_mutex_lock (&regex_cache_mutex);
+  entry = regex_cache_get (pattern, cflags, &ret, errbuf, errbuf_size);
+  if (entry)
+    {
+      ret = regexec (&entry->regex, str, 0, NULL, 0);
+      if (ret && ret != REG_NOMATCH && errbuf)
+	regerror (ret, &entry->regex, errbuf, errbuf_size);
+    }
+  pthread_mutex_unlock (&regex_cache_mutex);
+  return ret;
+}
+
+/* Compile pattern now and keep it for the life of the process.  Meant
+   for the constant patterns of command validators, from the same init
+   function that installs the commands.  Returns the regcomp () error, or
+   0. */
+int
+regex_cache_pin (const char *pattern, int cflags)
+{
+  struct regex_cache_entry *entry;
+  int ret;
+
+  pthread_mutex_lock (&regex_cache_mutex);
+  entry = regex_cache_get (pattern, cflags, &ret, NULL, 0);
+  if (entry && ! entry->pinned)
+    {
+      regex_cache_lru_unlink (entry);
+      regex_cache_unpinned--;
+      entry->pinned = 1;
+    }
+  pthread_mutex_unlock (&regex_cache_mutex);
+  return ret;
+}
+
+void
+regex_cache_stats (struct regex_cache_stats *stats)
+{
+  pthread_mutex_lock (&regex_cache_mutex);
+  *stats = regex_cache_counters;
+  stats->count = regex_cache_hash ? regex_cache_hash->count : 0;
+  pthread_mutex_unlock (&regex_cache_mutex);
+}
+
+/* Free every compiled pattern, pinned ones included. */
+void
+regex_cache_flush (void)
+{
+  pthread_mutex_lock (&regex_cache_mutex);
+  if (regex_cache_hash)
+    {
+      hash_clean (regex_cache_hash, regex_cache_entry_free);
+      hash_free (regex_cache_hash);
+      regex_cache_hash = NULL;
+    }
+  regex_cache_head = regex_cache_tail = NULL;
+  regex_cache_unpinned = 0;
+  pthread_mutex_unlock (&regex_cache_mutex);
+}
@@ -0,0 +1,46 @@
+/* Compiled regular expression cache.
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This file is part of GNU Zebra.
+ *
+ * GNU Zebra is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * GNU Zebra is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Zebra; see the file COPYING.  If not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _ZEBRA_REGEX_CACHE_H
+#define _ZEBRA_REGEX_CACHE_H
+
+/* Patterns kept compiled, besides the pinned ones.  The least recently
+   used pattern is freed to make room for a new one. */
+#define REGEX_CACHE_SIZE 64
+
+struct regex_cache_stats
+{
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long evictions;
+  unsigned long compiled;	/* regcomp () calls that succeeded. */
+  unsigned long freed;		/* regfree () calls. */
+  unsigned int count;		/* Patterns in the cache, pinned included. */
+};
+
+extern int regex_cache_match (const char *pattern, int cflags,
+			      const char *str, char *errbuf,
+			      size_t errbuf_size);
+extern int regex_cache_pin (const char *pattern, int cflags);
+extern void regex_cache_stats (struct regex_cache_stats *);
+extern void regex_cache_flush (void);
+
+#endif /* _ZEBRA_REGEX_CACHE_H */
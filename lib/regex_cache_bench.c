@@ -0,0 +1,164 @@
+/* Regex cache microbenchmark and leak check.
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This file is part of GNU Zebra.
+ *
+ * GNU Zebra is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * GNU Zebra is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Zebra; see the file COPYING.  If not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Times token validation with a regcomp () per call against
+   regex_cache_match (), checking that both give the same verdicts.  Then
+   runs 1M validations over more distinct patterns than the cache holds
+   and checks that every compiled pattern is freed, either on eviction or
+   by regex_cache_flush ().  Build with "make regex_cache_bench". */
+
+#include <zebra.h>
+
+#ifdef HAVE_GNU_REGEX
+#include <regex.h>
+#else
+#include "regex-gnu.h"
+#endif /* HAVE_GNU_REGEX */
+
+#include "regex_cache.h"
+
+#define VALIDATIONS 1000000
+#define UNCACHED    100000
+#define PATTERNS    (4 * REGEX_CACHE_SIZE)
+
+/* Basic regular expressions, as vtysh_regex_match () compiles them. */
+static const char *patterns[] =
+{
+  "^[a-zA-Z][a-zA-Z0-9_.-]*$",
+  "^[0-9a-fA-F]\\{2\\}\\(:[0-9a-fA-F]\\{2\\}\\)\\{5\\}$",
+  "^[0-9]\\{1,3\\}\\(\\.[0-9]\\{1,3\\}\\)\\{3\\}$",
+  "^[[:print:]]\\{1,64\\}$",
+};
+
+static const char *inputs[] =
+{
+  "switch-1", "1switch", "00:1a:2b:3c:4d:5e", "00:1a:2b:3c:4d",
+  "10.0.0.1", "10.0.0", "banner text", "",
+};
+
+static double
+elapsed (struct timeval *start)
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - start->tv_sec) * 1000.0
+    + (now.tv_usec - start->tv_usec) / 1000.0;
+}
+
+/* What vtysh_regex_match () did before the cache, minus the leak. */
+static int
+uncached_match (const char *pattern, const char *str)
+{
+  regex_t regex;
+  int ret;
+
+  ret = regcomp (&regex, pattern, 0);
+  if (ret)
+    return ret;
+  ret = regexec (&regex, str, 0, NULL, 0);
+  regfree (&regex);
+  return ret;
+}
+
+static int
+bench (void)
+{
+  struct timeval start;
+  double uncached_ms, cached_ms;
+  unsigned int i, n_patterns, n_inputs;
+  int mismatch = 0;
+
+  n_patterns = ZEBRA_NUM_OF (patterns);
+  n_inputs = ZEBRA_NUM_OF (inputs);
+  for (i = 0; i < n_patterns * n_inputs; i++)
+    if (uncached_match (patterns[i % n_patterns], inputs[i / n_patterns])
+	!= regex_cache_match (patterns[i % n_patterns], 0,
+			      inputs[i / n_patterns], NULL, 0))
+      mismatch++;
+
+  gettimeofday (&start, NULL);
+  for (i = 0; i < UNCACHED; i++)
+    uncached_match (patterns[i % n_patterns], inputs[i % n_inputs]);
+  uncached_ms = elapsed (&start);
+
+  gettimeofday (&start, NULL);
+  for (i = 0; i < VALIDATIONS; i++)
+    regex_cache_match (patterns[i % n_patterns], 0, inputs[i % n_inputs],
+		       NULL, 0);
+  cached_ms = elapsed (&start);
+
+  printf ("regcomp per call: %7.0f ns/validation (%d runs)\n",
+	  uncached_ms * 1e6 / UNCACHED, UNCACHED);
+  printf ("regex cache:      %7.0f ns/validation (%d runs), "
+	  "%d mismatches\n",
+	  cached_ms * 1e6 / VALIDATIONS, VALIDATIONS, mismatch);
+  return mismatch;
+}
+
+static int
+leak_check (void)
+{
+  struct regex_cache_stats before, stats;
+  char pattern[32];
+  unsigned int i;
+  int errors = 0;
+
+  regex_cache_flush ();
+  regex_cache_pin (patterns[0], 0);
+  regex_cache_stats (&before);
+  for (i = 0; i < VALIDATIONS; i++)
+    {
+      snprintf (pattern, sizeof (pattern), "^token%u$",
+		(i * 7919) % PATTERNS);
+      regex_cache_match (pattern, 0, "token1", NULL, 0);
+    }
+
+  regex_cache_stats (&stats);
+  printf ("%d validations over %d patterns: %lu hits, %lu misses, "
+	  "%lu evictions, %u cached\n", VALIDATIONS, PATTERNS,
+	  stats.hits - before.hits, stats.misses - before.misses,
+	  stats.evictions - before.evictions, stats.count);
+  if (stats.count > REGEX_CACHE_SIZE + 1
+      || stats.compiled - stats.freed != stats.count)
+    errors++;
+  if (regex_cache_match (patterns[0], 0, "switch", NULL, 0) != 0)
+    errors++;
+
+  regex_cache_flush ();
+  regex_cache_stats (&stats);
+  printf ("after flush: %lu compiled, %lu freed\n", stats.compiled,
+	  stats.freed);
+  if (stats.compiled != stats.freed || stats.count != 0)
+    errors++;
+  return errors;
+}
+
+int
+main (int argc, char **argv)
+{
+  int errors = 0;
+
+  errors += bench ();
+  errors += leak_check ();
+  printf ("%s\n", errors ? "FAILED" : "OK");
+  return errors ? 1 : 0;
+}
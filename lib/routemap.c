@@ -23,6 +23,7 @@ Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
 
 #include "linklist.h"
 #include "memory.h"
+#include "hash.h"
 #include "vector.h"
 #include "prefix.h"
 #include "routemap.h"
@@ -71,11 +72,70 @@ static struct route_map_list route_map_master = { NULL, NULL, NULL, NULL };
 struct route_map_list route_map_master = { NULL, NULL, NULL, NULL };
 #endif
 
+/* Route maps hashed by name, for route_map_lookup_by_name (). */
+static struct hash *route_map_hash;
+
+/* Match or set rule as seen by route_map_apply (). */
+struct route_map_compiled_rule
+{
+  route_map_result_t (*func_apply)(void *, struct prefix *,
+				   route_map_object_t, void *);
+  void *value;
+};
+
+/* One index of a compiled route map.  Its match rules are
+   rules[match_start .. match_start + n_match - 1], followed directly by
+   its set rules. */
+struct route_map_compiled_index
+{
+  struct route_map_index *index;
+  unsigned int match_start;
+  unsigned int n_match;
+  unsigned int n_set;
+};
+
+/* Route map flattened into two arrays, so that applying it walks
+   contiguous memory instead of three levels of linked lists. */
+struct route_map_compiled
+{
+  unsigned int n_index;
+  struct route_map_compiled_index *index;
+  struct route_map_compiled_rule *rules;
+};
+
 
 static void
 route_map_rule_delete (struct route_map_rule_list *,
 		       struct route_map_rule *);
 
+static unsigned int
+route_map_hash_key (void *data)
+{
+  struct route_map *map = data;
+
+  return string_hash_make (map->name);
+}
+
+static int
+route_map_hash_cmp (const void *a, const void *b)
+{
+  const struct route_map *map1 = a;
+  const struct route_map *map2 = b;
+
+  return strcmp (map1->name, map2->name) == 0;
+}
+
+/* Drop the compiled form of the map; the next apply rebuilds it. */
+static void
+route_map_compiled_free (struct route_map *map)
+{
+  if (map->compiled)
+    {
+      XFREE (MTYPE_ROUTE_MAP_COMPILED, map->compiled);
+      map->compiled = NULL;
+    }
+}
+
 /* New route map allocation. Please note route map's name must be
    specified. */
 static struct route_map *
@@ -106,6 +166,10 @@ route_map_add (const char *name)
     list->head = map;
   list->tail = map;
 
+  if (route_map_hash == NULL)
+    route_map_hash = hash_create (route_map_hash_key, route_map_hash_cmp);
+  hash_get (route_map_hash, map, hash_alloc_intern);
+
   /* Execute hook. */
   if (route_map_master.add_hook)
     (*route_map_master.add_hook) (name);
@@ -142,6 +206,9 @@ route_map_delete (struct route_map *map)
   else
     list->head = map->next;
 
+  if (route_map_hash)
+    hash_release (route_map_hash, map);
+  route_map_compiled_free (map);
   XFREE (MTYPE_ROUTE_MAP, map);
 
   /* Execute deletion hook. */
@@ -157,12 +224,13 @@ route_map_delete (struct route_map *map)
 struct route_map *
 route_map_lookup_by_name (const char *name)
 {
-  struct route_map *map;
+  struct route_map key;
 
-  for (map = route_map_master.head; map; map = map->next)
-    if (strcmp (map->name, name) == 0)
-      return map;
-  return NULL;
+  if (route_map_hash == NULL)
+    return NULL;
+
+  key.name = (char *) name;
+  return hash_lookup (route_map_hash, &key);
 }
 
 /* Lookup route map.  If there isn't route map create one and return
@@ -314,6 +382,8 @@ route_map_index_delete (struct route_map_index *index, int notify)
   while ((rule = index->set_list.head) != NULL)
     route_map_rule_delete (&index->set_list, rule);
 
+  route_map_compiled_free (index->map);
+
   /* Remove index from route map list. */
   if (index->next)
     index->next->prev = index->prev;
@@ -399,6 +469,8 @@ route_map_index_add (struct route_map *map, enum route_map_type type,
       point->prev = index;
     }
 
+  route_map_compiled_free (map);
+
   /* Execute event hook. */
   if (route_map_master.event_hook)
     (*route_map_master.event_hook) (RMAP_EVENT_INDEX_ADDED,
@@ -584,6 +656,7 @@ route_map_add_match (struct route_map_index *index, const char *match_name,
 
   /* Add new route match rule to linked list. */
   route_map_rule_add (&index->match_list, rule);
+  route_map_compiled_free (index->map);
 
   /* Execute event hook. */
   if (route_map_master.event_hook)
@@ -612,6 +685,7 @@ route_map_delete_match (struct route_map_index *index, const char *match_name,
 	(rulecmp (rule->rule_str, match_arg) == 0 || match_arg == NULL))
       {
 	route_map_rule_delete (&index->match_list, rule);
+	route_map_compiled_free (index->map);
 	/* Execute event hook. */
 	if (route_map_master.event_hook)
 	  (*route_map_master.event_hook) (RMAP_EVENT_MATCH_DELETED,
@@ -671,6 +745,7 @@ route_map_add_set (struct route_map_index *index, const char *set_name,
 
   /* Add new route match rule to linked list. */
   route_map_rule_add (&index->set_list, rule);
+  route_map_compiled_free (index->map);
 
   /* Execute event hook. */
   if (route_map_master.event_hook)
@@ -698,6 +773,7 @@ route_map_delete_set (struct route_map_index *index, const char *set_name,
          (rulecmp (rule->rule_str, set_arg) == 0 || set_arg == NULL))
       {
         route_map_rule_delete (&index->set_list, rule);
+	route_map_compiled_free (index->map);
 	/* Execute event hook. */
 	if (route_map_master.event_hook)
 	  (*route_map_master.event_hook) (RMAP_EVENT_SET_DELETED,
@@ -754,32 +830,78 @@ route_map_delete_set (struct route_map_index *index, const char *set_name,
    We need to make sure our route-map processing matches the above
 */
 
-static route_map_result_t
-route_map_apply_match (struct route_map_rule_list *match_list,
-                       struct prefix *prefix, route_map_object_t type,
-                       void *object)
+/* Flatten the map's indexes and rules into one allocation. */
+static struct route_map_compiled *
+route_map_compile (struct route_map *map)
 {
-  route_map_result_t ret = RMAP_NOMATCH;
-  struct route_map_rule *match;
+  struct route_map_compiled *compiled;
+  struct route_map_compiled_index *cindex;
+  struct route_map_compiled_rule *crule;
+  struct route_map_index *index;
+  struct route_map_rule *rule;
+  unsigned int n_index = 0, n_rules = 0;
 
+  for (index = map->head; index; index = index->next)
+    {
+      n_index++;
+      for (rule = index->match_list.head; rule; rule = rule->next)
+	n_rules++;
+      for (rule = index->set_list.head; rule; rule = rule->next)
+	n_rules++;
+    }
+
+  compiled = XCALLOC (MTYPE_ROUTE_MAP_COMPILED,
+		      sizeof (struct route_map_compiled)
+		      + n_index * sizeof (struct route_map_compiled_index)
+		      + n_rules * sizeof (struct route_map_compiled_rule));
+  compiled->n_index = n_index;
+  compiled->index = (struct route_map_compiled_index *) (compiled + 1);
+  compiled->rules = (struct route_map_compiled_rule *)
+    (compiled->index + n_index);
+
+  cindex = compiled->index;
+  crule = compiled->rules;
+  for (index = map->head; index; index = index->next, cindex++)
+    {
+      cindex->index = index;
+      cindex->match_start = crule - compiled->rules;
+      for (rule = index->match_list.head; rule; rule = rule->next, crule++)
+	{
+	  crule->func_apply = rule->cmd->func_apply;
+	  crule->value = rule->value;
+	  cindex->n_match++;
+	}
+      for (rule = index->set_list.head; rule; rule = rule->next, crule++)
+	{
+	  crule->func_apply = rule->cmd->func_apply;
+	  crule->value = rule->value;
+	  cindex->n_set++;
+	}
+    }
+
+  map->compiled = compiled;
+  return compiled;
+}
+
+static route_map_result_t
+route_map_apply_match (struct route_map_compiled_rule *match,
+                       unsigned int n_match, struct prefix *prefix,
+                       route_map_object_t type, void *object)
+{
+  route_map_result_t ret = RMAP_MATCH;
+  unsigned int i;
 
   /* Check all match rule and if there is no match rule, go to the
      set statement. */
-  if (!match_list->head)
-    ret = RMAP_MATCH;
-  else
+  for (i = 0; i < n_match; i++)
     {
-      for (match = match_list->head; match; match = match->next)
-        {
-          /* Try each match statement in turn, If any do not return
-             RMAP_MATCH, return, otherwise continue on to next match
-             statement. All match statements must match for end-result
-             to be a match. */
-          ret = (*match->cmd->func_apply) (match->value, prefix,
-                                           type, object);
-          if (ret != RMAP_MATCH)
-            return ret;
-        }
+      /* Try each match statement in turn, If any do not return
+         RMAP_MATCH, return, otherwise continue on to next match
+         statement. All match statements must match for end-result
+         to be a match. */
+      ret = (*match[i].func_apply) (match[i].value, prefix, type, object);
+      if (ret != RMAP_MATCH)
+        return ret;
     }
   return ret;
 }
@@ -789,10 +911,14 @@ route_map_result_t
 route_map_apply (struct route_map *map, struct prefix *prefix,
                  route_map_object_t type, void *object)
 {
-  static int recursion = 0;
+  /* Per thread, so a compiled map may be applied from several threads. */
+  static __thread int recursion = 0;
   int ret = 0;
+  struct route_map_compiled *compiled;
+  struct route_map_compiled_index *cindex;
+  struct route_map_compiled_rule *set;
   struct route_map_index *index;
-  struct route_map_rule *set;
+  unsigned int i, j;
 
   if (recursion > RMAP_RECURSION_LIMIT)
     {
@@ -806,10 +932,16 @@ route_map_apply (struct route_map *map, struct prefix *prefix,
   if (map == NULL)
     return RMAP_DENYMATCH;
 
-  for (index = map->head; index; index = index->next)
+  compiled = map->compiled ? map->compiled : route_map_compile (map);
+
+  for (i = 0; i < compiled->n_index; i++)
     {
+      cindex = &compiled->index[i];
+      index = cindex->index;
+
       /* Apply this index. */
-      ret = route_map_apply_match (&index->match_list, prefix, type, object);
+      ret = route_map_apply_match (&compiled->rules[cindex->match_start],
+                                   cindex->n_match, prefix, type, object);
 
       /* Now we apply the matrix from above */
       if (ret == RMAP_NOMATCH)
@@ -821,9 +953,10 @@ route_map_apply (struct route_map *map, struct prefix *prefix,
             /* 'action' */
             {
               /* permit+match must execute sets */
-              for (set = index->set_list.head; set; set = set->next)
-                ret = (*set->cmd->func_apply) (set->value, prefix,
-                                               type, object);
+              set = &compiled->rules[cindex->match_start + cindex->n_match];
+              for (j = 0; j < cindex->n_set; j++)
+                ret = (*set[j].func_apply) (set[j].value, prefix,
+                                            type, object);
 
               /* Call another route-map if available */
               if (index->nextrm)
@@ -852,15 +985,12 @@ route_map_apply (struct route_map *map, struct prefix *prefix,
                   case RMAP_GOTO:
                     {
                       /* Find the next clause to jump to */
-                      struct route_map_index *next = index->next;
                       int nextpref = index->nextpref;
 
-                      while (next && next->pref < nextpref)
-                        {
-                          index = next;
-                          next = next->next;
-                        }
-                      if (next == NULL)
+                      while (i + 1 < compiled->n_index
+                             && compiled->index[i + 1].index->pref < nextpref)
+                        i++;
+                      if (i + 1 == compiled->n_index)
                         {
                           /* No clauses match! */
                           return ret;
@@ -879,6 +1009,23 @@ route_map_apply (struct route_map *map, struct prefix *prefix,
   return RMAP_DENYMATCH;
 }
 
+/* Apply route map to a batch of objects.  The map is looked up and
+   compiled once for the whole batch. */
+void
+route_map_apply_many (struct route_map *map, struct prefix **prefixes,
+                      route_map_object_t type, void **objects,
+                      route_map_result_t *results, unsigned int n)
+{
+  unsigned int i;
+
+  if (map && map->compiled == NULL)
+    route_map_compile (map);
+
+  for (i = 0; i < n; i++)
+    results[i] = route_map_apply (map, prefixes[i], type,
+                                  objects ? objects[i] : NULL);
+}
+
 void
 route_map_add_hook (void (*func) (const char *))
 {
@@ -903,6 +1050,9 @@ route_map_init (void)
   /* Make vector for match and set. */
   route_match_vec = vector_init (1);
   route_set_vec = vector_init (1);
+
+  if (route_map_hash == NULL)
+    route_map_hash = hash_create (route_map_hash_key, route_map_hash_cmp);
 }
 
 void
@@ -912,6 +1062,13 @@ route_map_finish (void)
   route_match_vec = NULL;
   vector_free (route_set_vec);
   route_set_vec = NULL;
+
+  if (route_map_hash)
+    {
+      hash_clean (route_map_hash, NULL);
+      hash_free (route_map_hash);
+      route_map_hash = NULL;
+    }
 }
 
 /* VTY related functions. */
@@ -137,6 +137,8 @@ struct route_map_index
   struct route_map_index *prev;
 };
 
+struct route_map_compiled;
+
 /* Route map list structure. */
 struct route_map
 {
@@ -147,6 +149,10 @@ struct route_map
   struct route_map_index *head;
   struct route_map_index *tail;
 
+  /* Flattened copy of the rules used by route_map_apply (), rebuilt on
+     the first apply after any index, match or set change. */
+  struct route_map_compiled *compiled;
+
   /* Make linked list. */
   struct route_map *next;
   struct route_map *prev;
@@ -192,6 +198,15 @@ extern route_map_result_t route_map_apply (struct route_map *map,
                                            route_map_object_t object_type,
                                            void *object);
 
+/* Apply route map to n objects in one call.  results[i] receives the
+   result for prefixes[i] and objects[i]. */
+extern void route_map_apply_many (struct route_map *map,
+                                  struct prefix **prefixes,
+                                  route_map_object_t object_type,
+                                  void **objects,
+                                  route_map_result_t *results,
+                                  unsigned int n);
+
 extern void route_map_add_hook (void (*func) (const char *));
 extern void route_map_delete_hook (void (*func) (const char *));
 extern void route_map_event_hook (void (*func) (route_map_event_t, const char *));
@@ -0,0 +1,213 @@
+/* Route map lookup and evaluation microbenchmark.
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This file is part of GNU Zebra.
+ *
+ * GNU Zebra is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2, or (at your
+ * option) any later version.
+ *
+ * GNU Zebra is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNU Zebra; see the file COPYING.  If not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/* Times route_map_lookup_by_name() with 1k, 10k and 100k route maps
+   configured, and route_map_apply() against route_map_apply_many() for
+   a map of 100 sequences, checking that both give the same results.
+   Build with "make routemap_bench". */
+
+#include <zebra.h>
+
+#include "memory.h"
+#include "prefix.h"
+#include "routemap.h"
+
+#define LOOKUPS 100000
+#define ROUTES  100000
+#define SEQUENCES 100
+
+static const int map_counts[] = { 1000, 10000, 100000 };
+
+/* "match prefix-len N": match routes of at least N bits. */
+static route_map_result_t
+match_prefix_len (void *rule, struct prefix *p, route_map_object_t type,
+		  void *object)
+{
+  return p->prefixlen >= *(int *) rule ? RMAP_MATCH : RMAP_NOMATCH;
+}
+
+static void *
+match_prefix_len_compile (const char *arg)
+{
+  int *len = XMALLOC (MTYPE_ROUTE_MAP_COMPILED, sizeof (int));
+
+  *len = atoi (arg);
+  return len;
+}
+
+static void
+match_prefix_len_free (void *rule)
+{
+  XFREE (MTYPE_ROUTE_MAP_COMPILED, rule);
+}
+
+static struct route_map_rule_cmd match_prefix_len_cmd =
+{
+  "prefix-len",
+  match_prefix_len,
+  match_prefix_len_compile,
+  match_prefix_len_free
+};
+
+/* "set counter": count how many sets ran against the object. */
+static route_map_result_t
+set_counter (void *rule, struct prefix *p, route_map_object_t type,
+	     void *object)
+{
+  if (object)
+    (*(int *) object)++;
+  return RMAP_OKAY;
+}
+
+static struct route_map_rule_cmd set_counter_cmd =
+{
+  "counter",
+  set_counter,
+  NULL,
+  NULL
+};
+
+static double
+elapsed (struct timeval *start)
+{
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (now.tv_sec - start->tv_sec) * 1000.0
+    + (now.tv_usec - start->tv_usec) / 1000.0;
+}
+
+static void
+bench_lookup (int count)
+{
+  struct timeval start;
+  char name[32];
+  int i, found = 0;
+
+  for (i = 0; i < count; i++)
+    {
+      snprintf (name, sizeof (name), "rmap-%d-%d", count, i);
+      route_map_get (name);
+    }
+
+  gettimeofday (&start, NULL);
+  for (i = 0; i < LOOKUPS; i++)
+    {
+      snprintf (name, sizeof (name), "rmap-%d-%d", count, i % count);
+      if (route_map_lookup_by_name (name))
+	found++;
+    }
+  printf ("%7d maps: %d lookups in %.1f ms, %d found\n",
+	  count, LOOKUPS, elapsed (&start), found);
+}
+
+static int
+bench_apply (void)
+{
+  struct route_map *map;
+  struct route_map_index *index;
+  struct prefix *routes, **prefixes;
+  route_map_result_t *results;
+  int *single, *batch;
+  void **objects;
+  struct timeval start;
+  double single_ms, batch_ms;
+  char arg[16];
+  int i, mismatch = 0;
+
+  map = route_map_get ("bench-apply");
+  for (i = 0; i < SEQUENCES; i++)
+    {
+      /* Later sequences match shorter prefixes, so most routes walk a
+	 good part of the map before they hit. */
+      index = route_map_index_get (map, i % 7 ? RMAP_PERMIT : RMAP_DENY,
+				   (i + 1) * 10);
+      snprintf (arg, sizeof (arg), "%d", 32 - i * 32 / SEQUENCES);
+      route_map_add_match (index, "prefix-len", arg);
+      route_map_add_set (index, "counter", NULL);
+      if (i % 3 == 0)
+	index->exitpolicy = RMAP_NEXT;
+    }
+
+  routes = calloc (ROUTES, sizeof (struct prefix));
+  prefixes = calloc (ROUTES, sizeof (struct prefix *));
+  objects = calloc (ROUTES, sizeof (void *));
+  results = calloc (ROUTES, sizeof (route_map_result_t));
+  single = calloc (ROUTES, sizeof (int));
+  batch = calloc (ROUTES, sizeof (int));
+  for (i = 0; i < ROUTES; i++)
+    {
+      routes[i].family = AF_INET;
+      routes[i].prefixlen = random () % (IPV4_MAX_BITLEN + 1);
+      routes[i].u.prefix4.s_addr = htonl (random ());
+      apply_mask (&routes[i]);
+      prefixes[i] = &routes[i];
+      objects[i] = &batch[i];
+    }
+
+  gettimeofday (&start, NULL);
+  for (i = 0; i < ROUTES; i++)
+    if (route_map_apply (route_map_lookup_by_name ("bench-apply"),
+			 &routes[i], RMAP_BGP, &single[i]) != RMAP_MATCH)
+      single[i] = -single[i] - 1;
+  single_ms = elapsed (&start);
+
+  gettimeofday (&start, NULL);
+  route_map_apply_many (route_map_lookup_by_name ("bench-apply"), prefixes,
+			RMAP_BGP, objects, results, ROUTES);
+  batch_ms = elapsed (&start);
+
+  for (i = 0; i < ROUTES; i++)
+    {
+      if (results[i] != RMAP_MATCH)
+	batch[i] = -batch[i] - 1;
+      if (batch[i] != single[i])
+	mismatch++;
+    }
+
+  printf ("%d routes, %d sequences: apply %.1f ms, apply_many %.1f ms, "
+	  "%d mismatches\n", ROUTES, SEQUENCES, single_ms, batch_ms, mismatch);
+
+  free (routes);
+  free (prefixes);
+  free (objects);
+  free (results);
+  free (single);
+  free (batch);
+  route_map_delete (map);
+  return mismatch;
+}
+
+int
+main (int argc, char **argv)
+{
+  unsigned int i;
+
+  route_map_init ();
+  route_map_install_match (&match_prefix_len_cmd);
+  route_map_install_set (&set_counter_cmd);
+
+  srandom (1);
+  for (i = 0; i < ZEBRA_NUM_OF (map_counts); i++)
+    bench_lookup (map_counts[i]);
+
+  return bench_apply () ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+# -*- coding: utf-8 -*-
+
+# (c) Copyright 2016 Hewlett Packard Enterprise Development LP
+#
+# GNU Zebra is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation; either version 2, or (at your option) any
+# later version.
+#
+# GNU Zebra is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Zebra; see the file COPYING.  If not, write to the Free
+# Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+# 02111-1307, USA.
+
+import re
+
+TOPOLOGY = """
+# +-------+
+# |  sw1  |
+# +-------+
+
+# Nodes
+[type=openswitch name="Switch 1"] sw1
+"""
+
+
+def cache_stats(sw):
+    values = {}
+    for line in sw("show cli authorization-cache").splitlines():
+        if ":" in line:
+            name, _, rest = line.partition(":")
+            values[name.strip()] = int(re.findall(r"\d+", rest)[0])
+    return values
+
+
+def enable_requests(sw, count, message):
+    # "enable" count more times after the one vtysh runs when it starts, in
+    # a single vtysh and so with a single cache.  Returns how many times
+    # the servers were asked, from the debug message of each request, and
+    # how many times the command was refused.
+    out = sw("vtysh -n -v vtysh_command:console:dbg %s 2>&1"
+             % " ".join(["-c enable"] * count), shell="bash")
+    return out.count(message), out.count("Cannot execute command.")
+
+
+def set_authorization(sw, prio, groups):
+    sw("ovs-vsctl set AAA_Server_Group_Prio %s "
+       "authorization_group_prios='%s'" % (prio, groups), shell="bash")
+
+
+def test_vtysh_ct_authorization_cache(topology, step):
+    sw1 = topology.get("sw1")
+
+    step("1-Repeated commands are authorized from the cache")
+    before = cache_stats(sw1)
+    sw1("show hostname")
+    sw1("show hostname")
+    after = cache_stats(sw1)
+    assert after["Hits"] > before["Hits"]
+    assert after["Cached decisions"] > 0
+    assert after["Allowed commands kept"] == 60
+
+    step("2-An AAA change drops the decisions and sets the TTL")
+    sw1("ovs-vsctl set system . aaa:tacacs_author_cache_ttl=0",
+        shell="bash")
+    out = cache_stats(sw1)
+    assert out["Flushed on AAA changes"] > after["Flushed on AAA changes"]
+    assert out["Allowed commands kept"] == 0
+    sw1("show hostname")
+    sw1("show hostname")
+    assert cache_stats(sw1)["Cached decisions"] == 0
+
+    sw1("ovs-vsctl remove system . aaa tacacs_author_cache_ttl",
+        shell="bash")
+
+    sw1("configure terminal")
+    sw1("tacacs-server host 127.0.0.1 timeout 1")
+    sw1("aaa group server tacacs_plus sg_down")
+    sw1("server 127.0.0.1")
+    sw1("exit")
+    sw1("aaa group server tacacs_plus sg_empty")
+    sw1("end")
+    sw1("ovs-vsctl set system . aaa:tacacs_author_cache_negative_ttl=300",
+        shell="bash")
+    prio = sw1("ovs-vsctl --bare --columns=_uuid list AAA_Server_Group_Prio",
+               shell="bash").split()[0]
+    saved = sw1("ovs-vsctl get AAA_Server_Group_Prio %s "
+                "authorization_group_prios" % prio, shell="bash").strip()
+
+    step("3-A denied command is asked for once and denied from the cache")
+    group = sw1("ovs-vsctl --bare --columns=_uuid find AAA_Server_Group "
+                "group_name=sg_empty", shell="bash").strip()
+    set_authorization(sw1, prio, "{0=%s}" % group)
+    message = "Failed to get the sorted tacacs server list"
+    requests_1, denied_1 = enable_requests(sw1, 1, message)
+    requests_3, denied_3 = enable_requests(sw1, 3, message)
+    assert requests_1 > 0
+    assert requests_3 == requests_1
+    assert denied_3 == denied_1 + 2
+
+    step("4-Connection errors are not cached")
+    group = sw1("ovs-vsctl --bare --columns=_uuid find AAA_Server_Group "
+                "group_name=sg_down", shell="bash").strip()
+    set_authorization(sw1, prio, "{0=%s}" % group)
+    message = "Did not receive valid authorization response"
+    requests_1, denied_1 = enable_requests(sw1, 1, message)
+    requests_3, denied_3 = enable_requests(sw1, 3, message)
+    assert requests_1 > 0
+    assert requests_3 == requests_1 + 2
+    assert denied_3 == denied_1 + 2
+
+    set_authorization(sw1, prio, saved)
+    sw1("ovs-vsctl remove system . aaa tacacs_author_cache_negative_ttl",
+        shell="bash")
+    sw1("configure terminal")
+    sw1("no aaa group server tacacs_plus sg_empty")
+    sw1("no aaa group server tacacs_plus sg_down")
+    sw1("no tacacs-server host 127.0.0.1")
+    sw1("end")
@@ -561,6 +561,48 @@ def delete_bgp_ip_prefix_list_word_deny_any(step):
     assert plist_deleted is True
 
 
+def prefix_list_seqs(dump):
+    seqs = []
+    for line in dump.split('\n'):
+        words = line.split()
+        if len(words) > 1 and words[0] == "seq":
+            seqs.append(int(words[1]))
+    return seqs
+
+
+def validate_show_ip_prefix_list_word_prefix_lookups(step):
+    step("Test to validate show ip prefix-list word prefix, first-match "
+         "and longer lookups")
+    s1 = dutarray[0]
+    s1("configure terminal")
+    s1("ip prefix-list lookup seq 5 permit 10.0.0.0/8")
+    s1("ip prefix-list lookup seq 10 permit 10.1.0.0/16")
+    s1("ip prefix-list lookup seq 15 deny 10.1.2.0/24")
+    s1("ip prefix-list lookup seq 20 permit 10.2.0.0/16")
+    s1("ip prefix-list lookup seq 25 permit 192.168.1.0/24")
+    s1("ip prefix-list lookup seq 30 permit 10.1.0.0/16 ge 20 le 24")
+    s1("end")
+
+    dump = s1("show ip prefix-list lookup 10.1.0.0/16")
+    assert prefix_list_seqs(dump) == [10, 30]
+    dump = s1("show ip prefix-list lookup 10.1.0.0/16 first-match")
+    assert prefix_list_seqs(dump) == [10]
+    # Longer lists the entries under 10.1.0.0/16 only, not every entry
+    # with a prefix length of 16 or more.
+    dump = s1("show ip prefix-list lookup 10.1.0.0/16 longer")
+    assert prefix_list_seqs(dump) == [10, 15, 30]
+    dump = s1("show ip prefix-list lookup 10.1.2.0/24 longer")
+    assert prefix_list_seqs(dump) == [15]
+    dump = s1("show ip prefix-list lookup 10.3.0.0/16 longer")
+    assert prefix_list_seqs(dump) == []
+    dump = s1("show ip prefix-list lookup 10.0.0.0/8 longer")
+    assert prefix_list_seqs(dump) == [5, 10, 15, 20, 30]
+
+    s1("configure terminal")
+    s1("no ip prefix-list lookup")
+    s1("end")
+
+
 @mark.gate
 def test_vtysh_ct_bgp_ip_prefix_cli(topology, step):
     ops1 = topology.get("ops1")
@@ -603,3 +645,4 @@ def test_vtysh_ct_bgp_ip_prefix_cli(topology, step):
     add_bgp_ip_prefix_list_deny_prefix_any(step)
     delete_bgp_ip_prefix_list_deny_prefix_any(step)
     delete_bgp_ip_prefix_list_word_deny_any(step)
+    validate_show_ip_prefix_list_word_prefix_lookups(step)
@@ -0,0 +1,143 @@
+# -*- coding: utf-8 -*-
+# (C) Copyright 2016 Hewlett Packard Enterprise Development LP
+# All Rights Reserved.
+#
+#    Licensed under the Apache License, Version 2.0 (the "License"); you may
+#    not use this file except in compliance with the License. You may obtain
+#    a copy of the License at
+#
+#         http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+#    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+#    License for the specific language governing permissions and limitations
+#    under the License.
+#
+##########################################################################
+
+"""
+OpenSwitch Test for bulk provisioning of BGP neighbors. Prints the time
+taken to configure and display a large number of neighbors.
+"""
+
+from time import time
+
+TOPOLOGY = """
+# +-------+
+# |  ops1 |
+# +-------+
+
+# Nodes
+[type=openswitch name="OpenSwitch 1"] ops1
+"""
+
+bgp_asn = "1"
+bgp_router_id = "9.0.0.1"
+peer_group = "scalePeerGroup"
+
+num_neighbors = 1000
+cmds_per_batch = 100
+
+
+def neighbor_address(i):
+    return "10.%d.%d.1" % (i // 250, i % 250)
+
+
+def run_batch(dut, cmds):
+    args = " ".join("-c '%s'" % cmd for cmd in
+                    ["configure terminal", "router bgp %s" % bgp_asn] + cmds)
+    return dut("vtysh %s" % args, shell="bash")
+
+
+def provision(dut, step, what, cmds):
+    start = time()
+    for i in range(0, len(cmds), cmds_per_batch):
+        run_batch(dut, cmds[i:i + cmds_per_batch])
+    elapsed = time() - start
+    step("%s: %d commands in %.2f s" % (what, len(cmds), elapsed))
+
+
+def configure_bgp(dut, step):
+    step("Configuring BGP router %s..." % bgp_asn)
+    dut("configure terminal")
+    dut("router bgp %s" % bgp_asn)
+    dut("bgp router-id %s" % bgp_router_id)
+    dut("neighbor %s peer-group" % peer_group)
+    dut("end")
+
+
+def provision_neighbors(dut, step):
+    addrs = [neighbor_address(i) for i in range(num_neighbors)]
+
+    provision(dut, step, "remote-as",
+              ["neighbor %s remote-as 2" % a for a in addrs])
+    provision(dut, step, "description",
+              ["neighbor %s description scale-%d" % (a, i)
+               for i, a in enumerate(addrs)])
+    provision(dut, step, "peer-group",
+              ["neighbor %s peer-group %s" % (a, peer_group) for a in addrs])
+
+
+def verify_neighbors(dut, step):
+    start = time()
+    out = dut("vtysh -c 'show running-config'", shell="bash")
+    step("show running-config: %.2f s" % (time() - start))
+
+    assert "neighbor %s peer-group" % peer_group in out
+    for i in (0, num_neighbors // 2, num_neighbors - 1):
+        a = neighbor_address(i)
+        assert "neighbor %s remote-as 2" % a in out
+        assert "neighbor %s description scale-%d" % (a, i) in out
+        assert "neighbor %s peer-group %s" % (a, peer_group) in out
+    assert out.count("remote-as 2") == num_neighbors
+
+    start = time()
+    out = dut("vtysh -c 'show bgp neighbors %s'" %
+              neighbor_address(num_neighbors - 1), shell="bash")
+    step("show bgp neighbors <peer>: %.2f s" % (time() - start))
+    assert neighbor_address(num_neighbors - 1) in out
+
+
+def verify_lookups(dut, step):
+    step("Neighbor and peer-group lookups after bulk changes...")
+    last = neighbor_address(num_neighbors - 1)
+
+    out = run_batch(dut, ["neighbor %s remote-as 3" % last])
+    assert "Bound to peer group %s already, cannot change remote-as" % \
+        peer_group in out
+    out = run_batch(dut, ["neighbor %s peer-group noSuchGroup" % last])
+    assert "Configure the peer-group first." in out
+    out = run_batch(dut, ["neighbor noSuchGroup remote-as 2"])
+    assert "Create the peer-group first" in out
+
+    # Removing and adding neighbors back must be seen by the next lookups.
+    run_batch(dut, ["no neighbor %s" % last,
+                    "neighbor %s remote-as 4" % last])
+    out = dut("vtysh -c 'show running-config'", shell="bash")
+    assert "neighbor %s remote-as 4" % last in out
+    assert "neighbor %s peer-group %s" % (last, peer_group) not in out
+    assert out.count("remote-as 2") == num_neighbors - 1
+    first = neighbor_address(0)
+    assert "neighbor %s peer-group %s" % (first, peer_group) in out
+
+    out = dut("vtysh -c 'show bgp neighbors %s'" % last, shell="bash")
+    assert last in out
+
+
+def unconfigure_bgp(dut, step):
+    step("Removing BGP router %s..." % bgp_asn)
+    dut("configure terminal")
+    dut("no router bgp %s" % bgp_asn)
+    dut("end")
+
+
+def test_vtysh_ct_bgp_neighbor_scale(topology, step):
+    ops1 = topology.get("ops1")
+    assert ops1 is not None
+
+    configure_bgp(ops1, step)
+    provision_neighbors(ops1, step)
+    verify_neighbors(ops1, step)
+    verify_lookups(ops1, step)
+    unconfigure_bgp(ops1, step)
@@ -231,6 +231,94 @@ def unconfigure_routemap_match(dut, step):
         print("### Test to unconfigure Route-Map match commands FAILED! ###")
 
 
+def simulate_counts(dump):
+    counts = {}
+    for line in dump.splitlines():
+        for name in ("Accepted", "Modified", "Rejected", "By prefix-list"):
+            if line.strip().startswith(name + " "):
+                counts[name] = int(line.split(":")[1])
+    return counts
+
+
+def simulate_result(dump, network):
+    for line in dump.splitlines():
+        if line.startswith(network + " "):
+            return line.split(None, 2)[1:]
+    return None
+
+
+def simulate_routemap(dut, step):
+    step("Test to simulate a Route-Map over the BGP routing table")
+
+    dut("configure terminal")
+    dut("ip prefix-list SIM_PL seq 10 permit 10.1.0.0/16 le 24")
+    dut("route-map r2 permit 10")
+    dut("match ip address prefix-list SIM_PL")
+    dut("set metric 20")
+    dut("exit")
+    dut("route-map r2 permit 20")
+    dut("match community 100")
+    dut("set metric 30")
+    dut("end")
+
+    base = simulate_counts(dut("test route-map r2"))
+    base_filtered = simulate_counts(dut("test route-map r2 prefix-list "
+                                        "SIM_PL"))
+
+    vrf = dut("ovs-vsctl --bare --columns=_uuid find VRF name=vrf_default",
+              shell="bash").strip()
+    routes = [("10.1.1.0/24", 5), ("10.1.2.0/24", 20), ("10.2.0.0/16", 5)]
+    ops = []
+    for prefix, metric in routes:
+        ops.append('{"op": "insert", "table": "BGP_Route", "row": '
+                   '{"prefix": "%s", "address_family": "ipv4", '
+                   '"sub_address_family": "unicast", "metric": %d, '
+                   '"vrf": ["uuid", "%s"]}}' % (prefix, metric, vrf))
+    dut("ovsdb-client transact '[\"OpenSwitch\", {}]'".format(
+        ", ".join(ops)), shell="bash")
+
+    try:
+        dump = dut("test route-map r2")
+        assert "Route-map r2 tested against" in dump
+        assert "Nothing was written to the database." in dump
+        assert "Sequence 20: match community is not simulated, " \
+               "the sequence never matches" in dump
+        counts = simulate_counts(dump)
+        assert counts["Accepted"] == base["Accepted"] + 2
+        assert counts["Modified"] == base["Modified"] + 1
+        assert counts["Rejected"] == base["Rejected"] + 1
+        # Sequence 10 sets the metric of the routes of SIM_PL, the
+        # unsupported match keeps sequence 20 from accepting the rest.
+        assert simulate_result(dump, "10.1.1.0/24") == \
+            ["permit", "metric 5 -> 20"]
+        assert simulate_result(dump, "10.1.2.0/24") is None
+        assert simulate_result(dump, "10.2.0.0/16") == ["deny"]
+
+        dump = dut("test route-map r2 prefix-list SIM_PL")
+        counts = simulate_counts(dump)
+        assert counts["Accepted"] == base_filtered["Accepted"] + 2
+        assert counts["Rejected"] == base_filtered["Rejected"] + 1
+        assert counts["By prefix-list"] == \
+            base_filtered["By prefix-list"] + 1
+        assert simulate_result(dump, "10.2.0.0/16") == ["filtered"]
+    finally:
+        for prefix, metric in routes:
+            dut("ovs-vsctl --if-exists destroy BGP_Route "
+                "$(ovs-vsctl --bare --columns=_uuid find BGP_Route "
+                "prefix=%s)" % prefix, shell="bash")
+
+    dump = dut("show running-config")
+    assert "route-map r2 permit 10" in dump
+
+    dump = dut("test route-map r3")
+    assert "Route-map r3 not found" in dump
+
+    dut("configure terminal")
+    dut("no route-map r2")
+    dut("no ip prefix-list SIM_PL")
+    dut("end")
+
+
 def test_vtysh_ct_bgp_router_cli(topology, step):
     ops1 = topology.get("ops1")
     assert ops1 is not None
@@ -242,3 +330,4 @@ def test_vtysh_ct_bgp_router_cli(topology, step):
     unconfigure_bgp_network(ops1, step)
     configure_routemap_match(ops1, step)
     unconfigure_routemap_match(ops1, step)
+    simulate_routemap(ops1, step)
@@ -0,0 +1,59 @@
+# -*- coding: utf-8 -*-
+
+# (c) Copyright 2016 Hewlett Packard Enterprise Development LP
+#
+# GNU Zebra is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation; either version 2, or (at your option) any
+# later version.
+#
+# GNU Zebra is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Zebra; see the file COPYING.  If not, write to the Free
+# Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+# 02111-1307, USA.
+
+import re
+
+TOPOLOGY = """
+# +-------+
+# |  sw1  |
+# +-------+
+
+# Nodes
+[type=openswitch name="Switch 1"] sw1
+"""
+
+
+def footprint(output):
+    values = {}
+    for line in output.splitlines():
+        if ":" in line:
+            name, _, rest = line.partition(":")
+            values[name.strip()] = [int(n) for n in re.findall(r"\d+", rest)]
+    return values
+
+
+def test_vtysh_ct_command_footprint(topology, step):
+    sw1 = topology.get("sw1")
+
+    step("1-Shared strings and tokens are reported")
+    out = footprint(sw1("show cli command-footprint"))
+    parsed, elements = out["Parsed commands"]
+    assert 0 < parsed < elements
+    strings, string_refs, string_bytes = out["Pooled strings"]
+    assert 0 < strings < string_refs
+    tokens, token_refs = out["Shared tokens"]
+    assert 0 < tokens < token_refs
+    assert out["Saved by sharing"][0] > 0
+
+    step("2-Commands are parsed as they are used")
+    sw1("show vlan")
+    sw1("show ip route")
+    after = footprint(sw1("show cli command-footprint"))
+    assert after["Parsed commands"][0] >= parsed
+    assert after["Parsed commands"][1] == elements
@@ -0,0 +1,87 @@
+# -*- coding: utf-8 -*-
+
+# (c) Copyright 2016 Hewlett Packard Enterprise Development LP
+#
+# GNU Zebra is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation; either version 2, or (at your option) any
+# later version.
+#
+# GNU Zebra is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Zebra; see the file COPYING.  If not, write to the Free
+# Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+# 02111-1307, USA.
+
+
+from time import sleep
+
+# VTYSH_OVSDB_TABLES_IDLE_TIMEOUT, in seconds.
+tables_idle_timeout = 120
+
+TOPOLOGY = """
+# +-------+
+# |  sw1  |
+# +-------+
+
+# Nodes
+[type=openswitch name="Switch 1"] sw1
+"""
+
+
+def footprint_section(output, title):
+    lines = [line.strip() for line in output.splitlines()]
+    if title not in lines:
+        return None
+    section = lines[lines.index(title) + 1:]
+    for i, line in enumerate(section):
+        if not line.strip():
+            return "\n".join(section[:i])
+    return "\n".join(section)
+
+
+def footprint_row(output, table):
+    for line in output.splitlines():
+        fields = line.split()
+        if fields and fields[0] == table:
+            return [int(field) for field in fields[1:]]
+    return None
+
+
+def test_vtysh_ct_idl_footprint(topology, step):
+    sw1 = topology.get("sw1")
+
+    step("1-Replicated tables are reported")
+    out = sw1("show cli idl-footprint")
+    assert "Session IDL" in out
+    system = footprint_row(out, "System")
+    assert system is not None
+    assert system[0] == 1
+    assert system[1] > 0 and system[2] > 0
+
+    step("2-BGP routes are only replicated on demand")
+    assert footprint_row(out, "BGP_Route") is None
+    assert "On-demand tables IDL" not in out
+    sw1("show ip bgp")
+    out = sw1("show cli idl-footprint")
+    assert "On-demand tables IDL" in out
+
+    step("3-The on-demand IDL only replicates the columns of the group")
+    on_demand = footprint_section(out, "On-demand tables IDL")
+    assert on_demand is not None
+    assert footprint_row(on_demand, "System") is None
+    assert footprint_row(on_demand, "Port") is None
+    assert footprint_row(on_demand, "Interface") is None
+    vrf = footprint_row(on_demand, "VRF")
+    assert vrf is not None
+    assert vrf[1] <= 2
+
+    step("4-The on-demand IDL is dropped once the group is idle")
+    sleep(tables_idle_timeout + 5)
+    out = sw1("show cli idl-footprint")
+    assert "Session IDL" in out
+    assert "On-demand tables IDL" not in out
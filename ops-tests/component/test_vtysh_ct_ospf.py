@@ -20,6 +20,7 @@
 OpenSwitch Test for switchd related configurations.
 """
 
+import re
 
 TOPOLOGY = """
 # +-------+
@@ -89,6 +90,167 @@ def norunningconfigtest(dut):
     assert 'network 10.0.0.0/24 area 0.0.0.100' not in cmdout
 
 
+def databasestatisticstest(dut):
+    dut("router ospf")
+    dut("router-id 1.2.3.4")
+    cmdout = dut("do show ip ospf database statistics")
+    assert 'Link State Database Statistics' in cmdout
+    assert 'Total LSAs' in cmdout
+    assert '3600 (MaxAge)' in cmdout
+    dut("no router-id")
+
+
+def routeprefixtest(dut):
+    dut("router ospf")
+    for cmd in ("do show ip ospf route 10.0.0.0/24",
+                "do show ip ospf route 10.0.0.1"):
+        cmdout = dut(cmd)
+        assert 'Unknown command' not in cmdout
+        assert '10.0.0.0' not in cmdout
+
+
+def ospf_rows_transact(dut, ops):
+    dut("ovsdb-client transact '[\"OpenSwitch\", {}]'".format(
+        ", ".join(ops)), shell='bash')
+
+
+def lookupnullrowtest(dut):
+    # An OSPF_Interface with no Interface row of its name, holding a
+    # neighbor that has no router id yet.
+    dut("router ospf")
+    dut("network 10.0.0.0/24 area 100")
+    ospf_rows_transact(dut, [
+        '{"op": "insert", "table": "OSPF_Neighbor", "row": {}, '
+        '"uuid-name": "nbr"}',
+        '{"op": "insert", "table": "OSPF_Interface", '
+        '"row": {"name": "ospf_ct_if", '
+        '"neighbors": ["set", [["named-uuid", "nbr"]]]}, '
+        '"uuid-name": "intf"}',
+        '{"op": "mutate", "table": "OSPF_Area", "where": [], '
+        '"mutations": [["ospf_interfaces", "insert", '
+        '["set", [["named-uuid", "intf"]]]]]}'])
+
+    cmdout = dut("do show ip ospf interface ospf_ct_if")
+    assert 'Interface name ospf_ct_if is not present.' in cmdout
+
+    cmdout = dut("do show ip ospf neighbor 1.1.1.1")
+    assert 'Neighbor ID' in cmdout
+    assert '1.1.1.1' not in cmdout
+    cmdout = dut("do show ip ospf neighbor 1.1.1.1 detail")
+    assert '1.1.1.1' not in cmdout
+
+    # vtysh is still there, and the lookups follow the rows going away.
+    intf = dut("ovs-vsctl --bare --columns=_uuid find OSPF_Interface "
+               "name=ospf_ct_if", shell='bash').strip()
+    areas = dut("ovs-vsctl --bare --columns=_uuid list OSPF_Area",
+                shell='bash').split()
+    for area in areas:
+        dut("ovs-vsctl remove OSPF_Area {} ospf_interfaces {}".format(
+            area, intf), shell='bash')
+    dut("ovs-vsctl --if-exists destroy OSPF_Interface {}".format(intf),
+        shell='bash')
+    cmdout = dut("do show ip ospf interface ospf_ct_if")
+    assert 'ospf_ct_if' not in cmdout
+    dut("no network 10.0.0.0/24 area 100")
+
+
+def areainterfacecounttest(dut):
+    # "show ip ospf" reads the area from the on-demand IDL, which must
+    # hold the interfaces of the area for them to be counted.
+    dut("router ospf")
+    dut("router-id 1.2.3.4")
+    dut("network 10.0.0.0/24 area 100")
+    ospf_rows_transact(dut, [
+        '{"op": "insert", "table": "OSPF_Interface", '
+        '"row": {"name": "ospf_ct_count_if"}, "uuid-name": "intf"}',
+        '{"op": "mutate", "table": "OSPF_Area", "where": [], '
+        '"mutations": [["ospf_interfaces", "insert", '
+        '["set", [["named-uuid", "intf"]]]]]}'])
+
+    try:
+        cmdout = dut("do show ip ospf")
+        totals = [int(total) for total in
+                  re.findall(r'Number of interfaces in this area: '
+                             r'Total: (\d+)', cmdout)]
+        assert totals
+        assert all(total > 0 for total in totals)
+    finally:
+        intf = dut("ovs-vsctl --bare --columns=_uuid find OSPF_Interface "
+                   "name=ospf_ct_count_if", shell='bash').strip()
+        areas = dut("ovs-vsctl --bare --columns=_uuid list OSPF_Area",
+                    shell='bash').split()
+        for area in areas:
+            dut("ovs-vsctl remove OSPF_Area {} ospf_interfaces {}".format(
+                area, intf), shell='bash')
+        dut("ovs-vsctl --if-exists destroy OSPF_Interface {}".format(intf),
+            shell='bash')
+
+    dut("no network 10.0.0.0/24 area 100")
+    dut("no router-id")
+
+
+def ospf_route_prefixes(cmdout):
+    # The prefixes of the network routes, in display order.
+    prefixes = []
+    for line in cmdout.splitlines():
+        words = line.split()
+        if words and words[0] == 'N':
+            prefixes.append(words[2] if words[1] == 'IA' else words[1])
+    return prefixes
+
+
+def routeordertest(dut):
+    # Network routes of one area, listed out of order in the database.
+    dut("router ospf")
+    dut("network 10.0.0.0/24 area 100")
+    routes = [('intra_area', '10.3.0.0/16'), ('intra_area', '10.1.0.0/24'),
+              ('inter_area', '10.2.0.0/24'), ('intra_area', '10.1.0.0/16')]
+    ops = []
+    for i, (path_type, prefix) in enumerate(routes):
+        ops.append('{"op": "insert", "table": "OSPF_Route", '
+                   '"row": {"prefix": "%s", "path_type": "%s", '
+                   '"route_info": ["map", [["area_id", "100"], '
+                   '["cost", "10"]]]}, "uuid-name": "route%d"}'
+                   % (prefix, path_type, i))
+    for column, path_type in (('intra_area_ospf_routes', 'intra_area'),
+                              ('inter_area_ospf_routes', 'inter_area')):
+        ops.append('{"op": "mutate", "table": "OSPF_Area", "where": [], '
+                   '"mutations": [["%s", "insert", ["set", [%s]]]]}'
+                   % (column, ", ".join(
+                       '["named-uuid", "route%d"]' % i
+                       for i, route in enumerate(routes)
+                       if route[0] == path_type)))
+    ospf_rows_transact(dut, ops)
+
+    try:
+        # Inter area routes first, then intra area ones, each in prefix
+        # order.
+        cmdout = dut("do show ip ospf route")
+        assert ospf_route_prefixes(cmdout) == \
+            ['10.2.0.0/24', '10.1.0.0/16', '10.1.0.0/24', '10.3.0.0/16']
+
+        cmdout = dut("do show ip ospf route 10.1.0.0/24")
+        assert ospf_route_prefixes(cmdout) == ['10.1.0.0/24']
+        cmdout = dut("do show ip ospf route 10.1.0.5")
+        assert ospf_route_prefixes(cmdout) == ['10.1.0.0/24']
+        cmdout = dut("do show ip ospf route 10.1.7.1")
+        assert ospf_route_prefixes(cmdout) == ['10.1.0.0/16']
+        cmdout = dut("do show ip ospf route 10.1.0.0/20")
+        assert 'Network not in table' in cmdout
+        cmdout = dut("do show ip ospf route 10.9.0.1")
+        assert 'Network not in table' in cmdout
+    finally:
+        areas = dut("ovs-vsctl --bare --columns=_uuid list OSPF_Area",
+                    shell='bash').split()
+        for area in areas:
+            dut("ovs-vsctl clear OSPF_Area {} intra_area_ospf_routes "
+                "inter_area_ospf_routes".format(area), shell='bash')
+
+    cmdout = dut("do show ip ospf route 10.1.0.0/24")
+    assert '10.1.0.0/24' not in cmdout
+    dut("no network 10.0.0.0/24 area 100")
+
+
 def test_vtysh_ct_ospf(topology, step):
     ops1 = topology.get("ops1")
     assert ops1 is not None
@@ -102,3 +264,8 @@ def test_vtysh_ct_ospf(topology, step):
     unsetnetworkareaidtest(ops1)
     runningconfigtest(ops1)
     norunningconfigtest(ops1)
+    databasestatisticstest(ops1)
+    routeprefixtest(ops1)
+    lookupnullrowtest(ops1)
+    areainterfacecounttest(ops1)
+    routeordertest(ops1)
@@ -0,0 +1,94 @@
+# -*- coding: utf-8 -*-
+
+# (c) Copyright 2016 Hewlett Packard Enterprise Development LP
+#
+# GNU Zebra is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation; either version 2, or (at your option) any
+# later version.
+#
+# GNU Zebra is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Zebra; see the file COPYING.  If not, write to the Free
+# Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+# 02111-1307, USA.
+
+TOPOLOGY = """
+# +-------+
+# |  sw1  |
+# +-------+
+
+# Nodes
+[type=openswitch name="Switch 1"] sw1
+"""
+
+plugins_dir = "/usr/lib/cli/plugins"
+manifests_dir = "/usr/lib/cli/manifests"
+enable_node = "ENABLE_NODE"
+debug = "vtysh -v cli_plugins:console:dbg"
+
+
+def plugin_log(sw1, command):
+    return sw1("%s -c '%s' 2>&1" % (debug, command), shell="bash")
+
+
+def logged(out, message, name):
+    return any(message in line and name in line for line in out.splitlines())
+
+
+def test_vtysh_ct_plugin_manifest(topology, step):
+    sw1 = topology.get("sw1")
+
+    step("1-Write the manifest of a plugin with a show command")
+    plugins = sw1("ls %s/*.so" % plugins_dir, shell="bash").split()
+    plugin = None
+    for candidate in plugins:
+        status = sw1("vtysh --plugin-manifest=%s > /tmp/ct.manifest "
+                     "2> /tmp/ct.err; echo $?" % candidate,
+                     shell="bash").strip()
+        if status != "0":
+            err = sw1("cat /tmp/ct.err", shell="bash")
+            assert "vtysh_ovsdb_add_columns" in err
+            continue
+        out = sw1("cat /tmp/ct.manifest", shell="bash")
+        assert "# Generated by vtysh --plugin-manifest" in out
+        if "command %s show" % enable_node in out.splitlines():
+            plugin = candidate
+            break
+    assert plugin is not None
+    name = plugin.split("/")[-1].split(".")[0]
+    manifest = "%s/%s.manifest" % (manifests_dir, name)
+    before = sw1("vtysh -c 'show running-config'", shell="bash")
+
+    try:
+        sw1("mkdir -p %s" % manifests_dir, shell="bash")
+        sw1("cp /tmp/ct.manifest %s" % manifest, shell="bash")
+
+        step("2-The plugin is deferred while none of its commands is used")
+        out = plugin_log(sw1, "configure terminal")
+        assert logged(out, "Deferred plugin library", name)
+        assert not logged(out, "Loaded plugin library", name)
+
+        step("3-The plugin is loaded by its first command")
+        out = plugin_log(sw1, "show")
+        assert logged(out, "Deferred plugin library", name)
+        assert logged(out, "Loaded plugin library", name)
+
+        step("4-The running-config is the same")
+        after = sw1("vtysh -c 'show running-config'", shell="bash")
+        assert after == before
+
+        step("5-A manifest naming an unknown node is ignored")
+        sw1("sed -i 's/^command %s /command NO_SUCH_NODE /' %s"
+            % (enable_node, manifest), shell="bash")
+        out = plugin_log(sw1, "configure terminal")
+        assert logged(out, "Ignoring invalid manifest", name)
+        assert logged(out, "Loaded plugin library", name)
+    finally:
+        step("6-Remove the manifest")
+        sw1("rm -f %s /tmp/ct.manifest /tmp/ct.err" % manifest,
+            shell="bash")
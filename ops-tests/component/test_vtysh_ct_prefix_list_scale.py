@@ -0,0 +1,142 @@
+# -*- coding: utf-8 -*-
+# (C) Copyright 2016 Hewlett Packard Enterprise Development LP
+# All Rights Reserved.
+#
+#    Licensed under the Apache License, Version 2.0 (the "License"); you may
+#    not use this file except in compliance with the License. You may obtain
+#    a copy of the License at
+#
+#         http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+#    WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+#    License for the specific language governing permissions and limitations
+#    under the License.
+#
+##########################################################################
+
+"""
+OpenSwitch Test for large prefix-lists. Prints the time taken to display
+and to look up prefixes in a prefix-list of 50000 entries.
+"""
+
+from time import time
+
+TOPOLOGY = """
+# +-------+
+# |  ops1 |
+# +-------+
+
+# Nodes
+[type=openswitch name="OpenSwitch 1"] ops1
+"""
+
+plist_name = "scalePrefixList"
+num_entries = 50000
+entries_per_txn = 500
+num_lookups = 100
+
+# Prints an OVSDB transaction adding entries c * n + 1 to c * n + n to
+# the prefix-list name.  Entry s permits 10.<s / 256>.<s % 256>.0/24.
+txn_awk = (
+    'BEGIN { printf "[\\"OpenSwitch\\""; m = ""; '
+    'for (i = 0; i < n; i++) { s = c * n + i + 1; '
+    'printf ",{\\"op\\":\\"insert\\",\\"table\\":\\"Prefix_List_Entry\\",'
+    '\\"row\\":{\\"action\\":\\"permit\\",'
+    '\\"prefix\\":\\"10.%d.%d.0/24\\"},\\"uuid-name\\":\\"e%d\\"}", '
+    'int(s / 256), s % 256, i; '
+    'm = m sprintf("%s[%d,[\\"named-uuid\\",\\"e%d\\"]]", '
+    'i ? "," : "", s, i) } '
+    'printf ",{\\"op\\":\\"mutate\\",\\"table\\":\\"Prefix_List\\",'
+    '\\"where\\":[[\\"name\\",\\"==\\",\\"%s\\"]],'
+    '\\"mutations\\":[[\\"prefix_list_entries\\",\\"insert\\",'
+    '[\\"map\\",[%s]]]]}]", name, m }')
+
+
+def entry_prefix(s):
+    return "10.%d.%d.0/24" % (s // 256, s % 256)
+
+
+def vtysh(dut, *cmds):
+    args = " ".join("-c '%s'" % cmd for cmd in cmds)
+    return dut("vtysh %s" % args, shell="bash")
+
+
+def timed(dut, step, what, *cmds):
+    start = time()
+    out = vtysh(dut, *cmds)
+    step("%s: %.2f s" % (what, time() - start))
+    return out
+
+
+def provision(dut, step):
+    # The entries are written straight to the database, in transactions
+    # small enough for the command line of ovsdb-client.
+    vtysh(dut, "configure terminal",
+          "ip prefix-list %s seq %d deny any" % (plist_name,
+                                                  num_entries + 1))
+    start = time()
+    dut("for c in $(seq 0 %d); do ovsdb-client transact "
+        "\"$(awk -v c=$c -v n=%d -v name=%s '%s')\" > /dev/null; done"
+        % (num_entries // entries_per_txn - 1, entries_per_txn,
+           plist_name, txn_awk), shell="bash")
+    step("%d entries written in %.2f s" % (num_entries, time() - start))
+
+
+def verify_show(dut, step):
+    out = timed(dut, step, "show ip prefix-list summary",
+                "show ip prefix-list summary %s" % plist_name)
+    assert "count: %d, sequences: 1 - %d" % (num_entries + 1,
+                                              num_entries + 1) in out
+
+    out = timed(dut, step, "show ip prefix-list",
+                "show ip prefix-list %s" % plist_name)
+    assert out.count(" permit 10.") == num_entries
+    assert "seq %d permit %s" % (num_entries, entry_prefix(num_entries)) \
+        in out
+
+
+def verify_lookups(dut, step):
+    s = num_entries // 2
+    out = timed(dut, step, "show ip prefix-list <prefix>",
+                "show ip prefix-list %s %s" % (plist_name, entry_prefix(s)))
+    assert "seq %d permit %s" % (s, entry_prefix(s)) in out
+    assert out.count("seq ") == 1
+
+    out = timed(dut, step, "show ip prefix-list <prefix> first-match",
+                "show ip prefix-list %s %s first-match"
+                % (plist_name, entry_prefix(s)))
+    assert out.count("seq ") == 1
+
+    # The 256 entries of 10.<s / 256>.0.0/16.
+    out = timed(dut, step, "show ip prefix-list <prefix> longer",
+                "show ip prefix-list %s 10.%d.0.0/16 longer"
+                % (plist_name, s // 256))
+    seqs = [int(line.split()[1]) for line in out.splitlines()
+            if line.strip().startswith("seq ")]
+    first = (s // 256) * 256
+    assert seqs == list(range(max(first, 1), first + 256))
+
+    # The list is compiled once per session, later lookups reuse it.
+    lookups = ["show ip prefix-list %s %s" % (plist_name, entry_prefix(i))
+               for i in range(1, num_entries, num_entries // num_lookups)]
+    out = timed(dut, step, "%d lookups in one session" % len(lookups),
+                *lookups)
+    assert out.count("seq ") == len(lookups)
+
+
+def unprovision(dut, step):
+    vtysh(dut, "configure terminal", "no ip prefix-list %s" % plist_name)
+    out = vtysh(dut, "show ip prefix-list %s" % plist_name)
+    assert "seq " not in out
+
+
+def test_vtysh_ct_prefix_list_scale(topology, step):
+    ops1 = topology.get("ops1")
+    assert ops1 is not None
+
+    provision(ops1, step)
+    verify_show(ops1, step)
+    verify_lookups(ops1, step)
+    unprovision(ops1, step)
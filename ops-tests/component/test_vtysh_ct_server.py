@@ -0,0 +1,99 @@
+# -*- coding: utf-8 -*-
+
+# (c) Copyright 2016 Hewlett Packard Enterprise Development LP
+#
+# GNU Zebra is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation; either version 2, or (at your option) any
+# later version.
+#
+# GNU Zebra is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Zebra; see the file COPYING.  If not, write to the Free
+# Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+# 02111-1307, USA.
+
+from time import sleep
+
+TOPOLOGY = """
+# +-------+
+# |  sw1  |
+# +-------+
+
+# Nodes
+[type=openswitch name="Switch 1"] sw1
+"""
+
+server_socket = "/var/run/openvswitch/vtysh-server.ctl"
+
+
+def client(sw, *cmds, **kwargs):
+    args = " ".join("-c '%s'" % cmd for cmd in cmds)
+    cmd = "vtysh-client %s; echo status=$?" % args
+    user = kwargs.get("user")
+    if user:
+        cmd = "su %s -s /bin/bash -c \"%s\"" % (user, cmd.replace("$", "\\$"))
+    return sw(cmd, shell="bash")
+
+
+def test_vtysh_ct_server(topology, step):
+    sw1 = topology.get("sw1")
+
+    step("1-Start the command server")
+    sw1("vtysh --server > /dev/null 2>&1 &", shell="bash")
+    for _ in range(30):
+        out = sw1("ls %s" % server_socket, shell="bash")
+        if "No such file" not in out:
+            break
+        sleep(1)
+    assert "No such file" not in out
+
+    step("2-Run a configuration batch through the server")
+    out = client(sw1, "configure terminal", "hostname srv-test")
+    assert "status=0" in out
+    out = sw1("vtysh -c 'show hostname'", shell="bash")
+    assert "srv-test" in out
+
+    step("3-Show output and status come back to the client")
+    out = client(sw1, "show hostname")
+    assert "srv-test" in out
+    assert "status=0" in out
+    out = client(sw1, "show hostname", "bogus command", "show hostname")
+    assert "% Unknown command." in out
+    assert "status=1" in out
+
+    step("4-Every request starts in the enable node")
+    out = client(sw1, "configure terminal")
+    assert "status=0" in out
+    out = client(sw1, "vlan 2-3")
+    assert "status=1" in out
+
+    step("5-Requests run as the user that connected")
+    out = client(sw1, "show hostname", user="admin")
+    assert "admin does not have the required permissions" in out
+    assert "status=1" in out
+    out = client(sw1, "show hostname", user="netop")
+    assert "srv-test" in out
+    assert "status=0" in out
+    out = sw1("su netop -s /bin/bash -c 'ovs-appctl -t %s vtysh/exit'"
+              % server_socket, shell="bash")
+    assert "Permission denied" in out
+    out = sw1("ls -l %s" % server_socket, shell="bash")
+    assert "srw-rw-rw-" in out
+
+    step("6-Exit does not stop the server")
+    for cmd in ("exit", "quit"):
+        out = client(sw1, cmd, user="netop")
+        assert "cannot be left with exit" in out
+        assert "status=1" in out
+    out = client(sw1, "show hostname", user="netop")
+    assert "srv-test" in out
+    assert "status=0" in out
+
+    step("7-Stop the server")
+    client(sw1, "configure terminal", "no hostname srv-test")
+    sw1("ovs-appctl -t %s vtysh/exit" % server_socket, shell="bash")
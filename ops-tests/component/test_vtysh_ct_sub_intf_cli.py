@@ -92,6 +92,12 @@ def test_subintf_cli(topology, step):
     out = sw1("do show running-config")
     assert "encapsulation dot1Q 100" in out
 
+    # subinterfaces of a parent are listed by subinterface number
+    out = sw1("do show interface 4 subinterface brief")
+    positions = [out.find("4.%d " % i) for i in (2, 3, 4, 8)]
+    assert -1 not in positions
+    assert positions == sorted(positions)
+
     sw1("interface 4")
     sw1('no routing')
     sw1('no shutdown')
@@ -0,0 +1,68 @@
+# -*- coding: utf-8 -*-
+
+# (c) Copyright 2016 Hewlett Packard Enterprise Development LP
+#
+# GNU Zebra is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation; either version 2, or (at your option) any
+# later version.
+#
+# GNU Zebra is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Zebra; see the file COPYING.  If not, write to the Free
+# Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+# 02111-1307, USA.
+
+TOPOLOGY = """
+# +-------+
+# |  sw1  |
+# +-------+
+
+# Nodes
+[type=openswitch name="Switch 1"] sw1
+"""
+
+
+def test_vtysh_ct_vlan_range(topology, step):
+    sw1 = topology.get("sw1")
+    step("1-Create a range of VLANs in one command")
+    sw1("configure terminal")
+    sw1("vlan 2-20")
+    return_ = sw1("do show running-config")
+    for vlan in (2, 11, 20):
+        assert "vlan {}".format(vlan) in return_
+    assert "vlan 21" not in return_
+
+    step("2-Existing VLANs in the range are kept")
+    return_ = sw1("vlan 15-25")
+    assert "Invalid" not in return_
+    return_ = sw1("do show running-config")
+    assert "vlan 25" in return_
+
+    step("3-A single VLAN still enters the VLAN context")
+    sw1("vlan 30")
+    return_ = sw1("do show running-config")
+    assert "vlan 30" in return_
+
+    step("4-A VLAN deleted in between is created again")
+    sw1("exit")
+    sw1("no vlan 25")
+    return_ = sw1("do show running-config")
+    assert "vlan 25" not in return_
+    sw1("vlan 20-25")
+    return_ = sw1("do show running-config")
+    assert "vlan 25" in return_
+
+    step("5-A range overlapping existing VLANs creates each VLAN once")
+    return_ = sw1("vlan 18-28")
+    assert "Invalid" not in return_
+    lines = [line.strip() for line in
+             sw1("do show running-config").splitlines()]
+    for vlan in range(18, 29):
+        assert lines.count("vlan {}".format(vlan)) == 1
+    assert "vlan 29" not in lines
+    sw1("end")
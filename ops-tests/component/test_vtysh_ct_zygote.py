@@ -0,0 +1,101 @@
+# -*- coding: utf-8 -*-
+
+# (c) Copyright 2016 Hewlett Packard Enterprise Development LP
+#
+# GNU Zebra is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by the
+# Free Software Foundation; either version 2, or (at your option) any
+# later version.
+#
+# GNU Zebra is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with GNU Zebra; see the file COPYING.  If not, write to the Free
+# 02111-1307, USA.
+
+from time import sleep
+
+TOPOLOGY = """
+# +-------+
+# |  sw1  |
+# +-------+
+
+# Nodes
+[type=openswitch name="Switch 1"] sw1
+"""
+
+zygote_socket = "/var/run/openvswitch/vtysh-zygote.sock"
+zygote_log = "/tmp/vtysh-zygote.log"
+login_out = "/tmp/vtysh-zygote-login.out"
+
+
+def login(sw, user, cmds, wait):
+    # An interactive login of user on a pseudo terminal, in the background.
+    # The commands are typed after wait seconds.
+    typed = "; ".join(["true"] + ["sleep 1; echo '%s'" % cmd
+                                  for cmd in cmds])
+    sw("su %s -s /bin/bash -c \"(sleep %d; %s) | script -qfc vtysh "
+       "/dev/null\" > %s 2>&1 &" % (user, wait, typed, login_out),
+       shell="bash")
+
+
+def session_pid(sw):
+    out = sw("pgrep -P $(pgrep -f 'vtysh --zygote')", shell="bash")
+    pids = out.split()
+    assert len(pids) == 1
+    return pids[0]
+
+
+def test_vtysh_ct_zygote(topology, step):
+    sw1 = topology.get("sw1")
+
+    step("1-Start the zygote")
+    sw1("vtysh --zygote -v vtysh_zygote:console:info > %s 2>&1 &"
+        % zygote_log, shell="bash")
+    for _ in range(30):
+        out = sw1("ls %s" % zygote_socket, shell="bash")
+        if "No such file" not in out:
+            break
+        sleep(1)
+    assert "No such file" not in out
+
+    step("2-A login is served by a session of the zygote")
+    uid = sw1("id -u netop", shell="bash").strip()
+    login(sw1, "netop", ["show hostname", "exit"], 5)
+    sleep(2)
+    pid = session_pid(sw1)
+
+    step("3-The session runs as the user of the login")
+    out = sw1("grep Uid: /proc/%s/status" % pid, shell="bash")
+    assert out.split()[1:] == [uid] * 4
+    out = sw1("cat /proc/%s/loginuid" % pid, shell="bash").strip()
+    log = sw1("cat %s" % zygote_log, shell="bash")
+    assert out == uid or "Cannot set the login uid to %s" % uid in log
+
+    step("4-The session leads its own session on the login terminal")
+    out = sw1("ps -o sid=,tty= -p %s" % pid, shell="bash").split()
+    assert out[0] == pid
+    assert out[1] != "?"
+
+    step("5-Commands typed on the terminal run in the session")
+    sleep(6)
+    out = sw1("cat %s" % login_out, shell="bash")
+    assert "Unknown command" not in out
+    hostname = sw1("vtysh -c 'show hostname'", shell="bash").strip()
+    assert hostname in out
+    out = sw1("pgrep -P $(pgrep -f 'vtysh --zygote')", shell="bash")
+    assert pid not in out.split()
+
+    step("6-A user that may not use vtysh is turned away")
+    login(sw1, "admin", [], 0)
+    sleep(3)
+    out = sw1("cat %s" % login_out, shell="bash")
+    assert "admin does not have the required permissions" in out
+
+    step("7-Stop the zygote")
+    sw1("pkill -f 'vtysh --zygote'", shell="bash")
+    sw1("rm -f %s %s %s" % (zygote_socket, zygote_log, login_out),
+        shell="bash")
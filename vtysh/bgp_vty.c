@@ -55,6 +55,9 @@
 #include "lib/plist.h"
 #include "lib/regex-gnu.h"
 #include "vrf-utils.h"
+#include "vtysh/utils/plist_vtysh_utils.h"
+#include "vtysh/utils/rmap_sim_vtysh_utils.h"
+#include "vtysh/utils/bgp_nbr_vtysh_utils.h"
 
 extern struct ovsdb_idl *idl;
 
@@ -250,22 +253,6 @@ bgp_regcomp (const char *regstr)
     return regex;
 }
 
-/*
- *Find the prefix length
-*/
-int
-prefix_len(char *prefix)
-{
-    char *temp = (char *)malloc(sizeof(prefix));
-    int length = 0;
-    strcpy(temp, prefix);
-    strtok(temp, "/");
-    strcpy(temp,strtok(NULL,"/"));
-    length = atoi(temp);
-    free(temp);
-    return length;
-}
-
 /*
  * Depending on the outcome of the db transaction, returns
  * the appropriate value for the cli command execution.
@@ -408,14 +395,7 @@ find_matching_neighbor_or_peer_group_object(bool is_peer_group,
                                             ovs_bgpr,
                                             const char *name)
 {
-    int i = 0;
-/* Correct type, now match its parent bgp router and name. */
-    for (i = 0; i < ovs_bgpr->n_bgp_neighbors; i++) {
-        if (ovs_bgpr &&
-           (0 == strcmp(ovs_bgpr->key_bgp_neighbors[i], name)))
-        return ovs_bgpr->value_bgp_neighbors[i];
-    }
-    return NULL;
+    return bgp_nbr_index_find(ovs_bgpr, name);
 }
 
 /*
@@ -638,13 +618,7 @@ char *
 get_bgp_neighbor_name_from_bgp_router(const struct ovsrec_bgp_router *ovs_bgpr,
                                       const char *name)
 {
-    int i = 0;
-    /* Correct type, now match its parent bgp router and name. */
-    for (i = 0; i < ovs_bgpr->n_bgp_neighbors; i++) {
-        if (ovs_bgpr && (0 == strcmp(ovs_bgpr->key_bgp_neighbors[i], name)))
-            return ovs_bgpr->key_bgp_neighbors[i];
-        }
-    return NULL;
+    return CONST_CAST(char *, bgp_nbr_index_find_name(ovs_bgpr, name));
 }
 
 
@@ -910,6 +884,30 @@ DEFUN(vtysh_show_ip_bgp_route_map,
     return 0;
 }
 
+DEFUN_TABLES(vtysh_test_route_map,
+      vtysh_test_route_map_cmd,
+      "test route-map WORD",
+      "Evaluate a policy without applying it\n"
+      "Run a route-map over the BGP routing table\n"
+      "Route map tag\n",
+      CMD_TABLES_BGP_RIB)
+{
+    return rmap_sim_run(vty, argv[0], NULL);
+}
+
+DEFUN_TABLES(vtysh_test_route_map_prefix_list,
+      vtysh_test_route_map_prefix_list_cmd,
+      "test route-map WORD prefix-list WORD",
+      "Evaluate a policy without applying it\n"
+      "Run a route-map over the BGP routing table\n"
+      "Route map tag\n"
+      "Filter the routes through a prefix-list first\n"
+      "Name of a prefix list\n",
+      CMD_TABLES_BGP_RIB)
+{
+    return rmap_sim_run(vty, argv[0], argv[1]);
+}
+
 
 /*
  * Function to get BGP router-id: if router-id is configured at BGP
@@ -939,12 +937,13 @@ get_bgp_router_id(const struct ovsrec_bgp_router *bgp_row)
 }
 
 
-DEFUN(vtysh_show_ip_bgp,
+DEFUN_TABLES(vtysh_show_ip_bgp,
       vtysh_show_ip_bgp_cmd,
       "show ip bgp",
       SHOW_STR
       IP_STR
-      BGP_STR)
+      BGP_STR,
+      CMD_TABLES_BGP_RIB)
 {
     const struct ovsrec_bgp_router *bgp_row = NULL;
 
@@ -1149,24 +1148,26 @@ bgp_show_route(char *vrf_name, struct vty *vty, const char *view_name,
     return CMD_SUCCESS;
 }
 
-DEFUN(vtysh_show_ip_bgp_route,
+DEFUN_TABLES(vtysh_show_ip_bgp_route,
       vtysh_show_ip_bgp_route_cmd,
       "show ip bgp A.B.C.D",
       SHOW_STR
       IP_STR
       BGP_STR
-      "Network in the BGP routing table to display\n")
+      "Network in the BGP routing table to display\n",
+      CMD_TABLES_BGP_RIB)
 {
     return bgp_show_route (NULL, vty, NULL, argv[0], AFI_IP, SAFI_UNICAST);
 }
 
-DEFUN(vtysh_show_ip_bgp_prefix,
+DEFUN_TABLES(vtysh_show_ip_bgp_prefix,
       vtysh_show_ip_bgp_prefix_cmd,
       "show ip bgp A.B.C.D/M",
       SHOW_STR
       IP_STR
       BGP_STR
-      "IP prefix <network>/<length>, e.g., 35.0.0.0/8\n")
+      "IP prefix <network>/<length>, e.g., 35.0.0.0/8\n",
+      CMD_TABLES_BGP_RIB)
 {
     return bgp_show_route (NULL, vty, NULL, argv[0], AFI_IP, SAFI_UNICAST);
 }
@@ -2675,6 +2676,7 @@ bgp_neighbor_peer_group_insert_to_bgp_router(const struct ovsrec_bgp_router *
                                         bgp_neighbor_peer_group_list,
                                         (bgp_router_context->n_bgp_neighbors +
                                         1));
+    bgp_nbr_index_written(bgp_router_context);
     free(bgp_neighbor_peer_name_list);
     free(bgp_neighbor_peer_group_list);
 }
@@ -2697,8 +2699,7 @@ cli_neighbor_remote_as_cmd_execute(char *vrf_name, struct vty *vty,
     const struct ovsrec_bgp_neighbor *ovs_bgp_neighbor, *ovs_peer_grp;
     struct ovsdb_idl_txn *txn;
     bool update_all_peers = false;
-    char *name;
-    int i = 0;
+    const char *name;
 
     START_DB_TXN(txn);
 
@@ -2720,15 +2721,11 @@ cli_neighbor_remote_as_cmd_execute(char *vrf_name, struct vty *vty,
     if (ovs_bgp_neighbor) {
         if (ovs_bgp_neighbor->bgp_peer_group) {
         char error_message[128];
-        name = xmalloc(sizeof(*bgp_router_context->key_bgp_neighbors));
-        for (i = 0; i < bgp_router_context->n_bgp_neighbors; i++) {
-            if (bgp_router_context->value_bgp_neighbors[i] == ovs_bgp_neighbor){
-                name = bgp_router_context->key_bgp_neighbors[i];
-            }
-        }
-        sprintf(error_message, "%% Bound to peer group %s already, "
-                "cannot change remote-as\n",name);
-        free(name);
+        name = bgp_nbr_index_name_of(bgp_router_context,
+                                     ovs_bgp_neighbor->bgp_peer_group);
+        snprintf(error_message, sizeof error_message,
+                 "%% Bound to peer group %s already, "
+                 "cannot change remote-as\n", name ? name : "");
         ABORT_DB_TXN(txn, error_message);
         }
     } else {
@@ -2939,6 +2936,7 @@ bgp_neighbor_remove_for_matching_peer_group_from_bgp_router(
                                         bgp_neighbor_peer_group_list,
                                         (bgp_router_context->n_bgp_neighbors -
                                         1));
+    bgp_nbr_index_written(bgp_router_context);
     free(bgp_neighbor_peer_name_list);
     free(bgp_neighbor_peer_group_list);
 }
@@ -2973,6 +2971,7 @@ bgp_neighbor_peer_group_remove_from_bgp_router(const struct ovsrec_bgp_router *
                                         bgp_neighbor_peer_group_list,
                                         (bgp_router_context->n_bgp_neighbors -
                                         1));
+    bgp_nbr_index_written(bgp_router_context);
     free(bgp_neighbor_peer_name_list);
     free(bgp_neighbor_peer_group_list);
 }
@@ -9623,13 +9622,14 @@ cli_show_bgp_summary_vty_execute(struct vty *vty, int afi, int safi)
     return CMD_SUCCESS;
 }
 
-DEFUN(show_ip_bgp_summary,
+DEFUN_TABLES(show_ip_bgp_summary,
       show_ip_bgp_summary_cmd,
       "show ip bgp summary",
       SHOW_STR
       IP_STR
       BGP_STR
-      "Summary of BGP neighbor status\n")
+      "Summary of BGP neighbor status\n",
+      CMD_TABLES_BGP_RIB)
 {
     return cli_bgp_show_summary_vty_execute(vty,AFI_IP, SAFI_UNICAST);
 }
@@ -9689,23 +9689,25 @@ DEFUN(show_ip_bgp_vpnv4_rd_summary,
 }
 
 #ifdef HAVE_IPV6
-DEFUN(show_bgp_summary,
+DEFUN_TABLES(show_bgp_summary,
       show_bgp_summary_cmd,
       "show bgp summary",
       SHOW_STR
       BGP_STR
-      "Summary of BGP neighbor status\n")
+      "Summary of BGP neighbor status\n",
+      CMD_TABLES_BGP_RIB)
 {
     return cli_show_bgp_summary_vty_execute(vty, 0, 0);
 }
 
-ALIAS(show_bgp_summary,
+ALIAS_ATTR(show_bgp_summary,
       show_bgp_ipv6_summary_cmd,
       "show bgp ipv6 summary",
       SHOW_STR
       BGP_STR
       "Address family\n"
-      "Summary of BGP neighbor status\n")
+      "Summary of BGP neighbor status\n",
+      CMD_ATTR_TABLES(CMD_TABLES_BGP_RIB))
 
 DEFUN(show_bgp_ipv6_safi_summary,
       show_bgp_ipv6_safi_summary_cmd,
@@ -9747,12 +9749,13 @@ DEFUN(show_ipv6_mbgp_summary,
     return CMD_SUCCESS;
 }
 
-DEFUN(show_ipv6_bgp,
+DEFUN_TABLES(show_ipv6_bgp,
       show_ipv6_bgp_cmd,
       "show ipv6 bgp",
       SHOW_STR
       IPV6_STR
-      BGP_STR)
+      BGP_STR,
+      CMD_TABLES_BGP_RIB)
 {
     const struct ovsrec_bgp_router *bgp_row = NULL;
 
@@ -9892,20 +9895,21 @@ show_bgp_router_neighbors(struct vty *vty,
                           const struct ovsrec_bgp_router *ovs_bgp_router,
                           const char *peer)
 {
+    const char *name;
     int i = 0;
 
-    /*
-     * If entry IS a neighbor (not a peer group) and
-     * belongs to the specified router, display it provided
-     * neighbor filter (peer) is taken into account.
-     */
-    for (i = 0; i < ovs_bgp_router->n_bgp_neighbors; i++) {
-        if((NULL == peer) ||
-           (peer && (0 == strcmp(ovs_bgp_router->key_bgp_neighbors[i],
-                                 peer)))) {
-            show_one_bgp_neighbor(vty, ovs_bgp_router->key_bgp_neighbors[i],
-                                  ovs_bgp_router->value_bgp_neighbors[i]);
+    if (peer) {
+        name = bgp_nbr_index_find_name(ovs_bgp_router, peer);
+        if (name) {
+            show_one_bgp_neighbor(vty, CONST_CAST(char *, name),
+                                  bgp_nbr_index_find(ovs_bgp_router, peer));
         }
+        return;
+    }
+
+    for (i = 0; i < ovs_bgp_router->n_bgp_neighbors; i++) {
+        show_one_bgp_neighbor(vty, ovs_bgp_router->key_bgp_neighbors[i],
+                              ovs_bgp_router->value_bgp_neighbors[i]);
     }
 }
 
@@ -10437,6 +10441,8 @@ bgp_vty_init(void)
     install_element(ENABLE_NODE, &vtysh_show_ip_bgp_route_cmd);
     install_element(ENABLE_NODE, &vtysh_show_ip_bgp_prefix_cmd);
     install_element(ENABLE_NODE, &vtysh_show_ip_bgp_route_map_cmd);
+    install_element(ENABLE_NODE, &vtysh_test_route_map_cmd);
+    install_element(ENABLE_NODE, &vtysh_test_route_map_prefix_list_cmd);
 
     /* Install bgp top node. */
     install_node(&bgp_ipv4_unicast_node, NULL);
@@ -13235,546 +13241,143 @@ ALIAS(no_set_community,
       "Community number in aa:nn format or "
       "local-AS|no-advertise|no-export|internet or additive\n")
 
+/*
+ * Print the header of a prefix-list for the show prefix-list commands.
+ */
+static void
+show_prefix_list_header(afi_t afi, const struct ovsrec_prefix_list *row,
+                        bool detail, bool summary)
+{
+    const char *afi_str = (afi == AFI_IP6) ? "ipv6" : "ip";
+    bool description = (afi == AFI_IP6) && row->description
+                       && strlen(row->description) != 0;
+
+    if (detail || summary) {
+        vty_out(vty, "%s prefix-list %s:%s", afi_str, row->name, VTY_NEWLINE);
+        if (description) {
+            vty_out(vty, "%3sDescription: %s%s", "", row->description,
+                    VTY_NEWLINE);
+        }
+        vty_out(vty, "%3scount: %lu, sequences: %lu - %lu%s", "",
+                row->n_prefix_list_entries,
+                row->key_prefix_list_entries[0],
+                row->key_prefix_list_entries[row->n_prefix_list_entries - 1],
+                VTY_NEWLINE);
+    } else {
+        vty_out(vty, "%s prefix-list %s: %lu entries%s", afi_str, row->name,
+                row->n_prefix_list_entries, VTY_NEWLINE);
+        if (description) {
+            vty_out(vty, "%3sDescription: %s%s", "", row->description,
+                    VTY_NEWLINE);
+        }
+    }
+}
+
+/*
+ * Print one prefix-list entry as "seq N action prefix [ge X] [le Y]".
+ */
+static void
+show_prefix_list_entry(const struct plist_cache_entry *entry)
+{
+    const struct ovsrec_prefix_list_entry *row = entry->row;
+
+    if (entry->any || (entry->ge == 0 && entry->le == 0)) {
+        vty_out(vty, "%3sseq %lu %s %s%s", "", entry->seq, row->action,
+                row->prefix, VTY_NEWLINE);
+    } else if (entry->le == 0) {
+        vty_out(vty, "%3sseq %lu %s %s ge %lu%s", "", entry->seq,
+                row->action, row->prefix, entry->ge, VTY_NEWLINE);
+    } else if (entry->ge == 0) {
+        vty_out(vty, "%3sseq %lu %s %s le %lu%s", "", entry->seq,
+                row->action, row->prefix, entry->le, VTY_NEWLINE);
+    } else {
+        vty_out(vty, "%3sseq %lu %s %s ge %lu le %lu%s", "", entry->seq,
+                row->action, row->prefix, entry->ge, entry->le, VTY_NEWLINE);
+    }
+}
+
+/*
+ * Show entries of the prefix-list 'name' that carry exactly 'prefix', or
+ * that are equal to or more specific than it when 'longer' is set.
+ */
+static void
+show_prefix_list_prefix(afi_t afi, const char *name, int64_t seq,
+                        const char *prefix, bool first_match, bool longer)
+{
+    const struct plist_cache_list *list;
+    const struct plist_cache_entry *entry;
+    const struct plist_cache_entry **matches;
+    struct prefix p;
+    size_t i, n;
+
+    list = plist_cache_lookup(name);
+    if (!list || str2prefix(prefix, &p) <= 0
+        || family2afi(p.family) != afi) {
+        return;
+    }
+
+    if (longer) {
+        n = plist_cache_collect_longer(list, &p, &matches);
+        for (i = 0; i < n; i++) {
+            show_prefix_list_entry(matches[i]);
+        }
+        free(matches);
+        return;
+    }
+
+    for (entry = plist_cache_lookup_exact(list, &p); entry;
+         entry = entry->next_same_prefix) {
+        if (entry->seq == seq || seq == 0) {
+            show_prefix_list_entry(entry);
+            if (first_match) {
+                break;
+            }
+        }
+    }
+}
+
 int
 show_prefix_list(afi_t afi, const char *name,
             const char *seqnum, bool detail, bool summary,
-            char *prefix, bool first_match, bool longer, int plen)
+            const char *prefix, bool first_match, bool longer)
 {
-    const struct ovsrec_prefix_list *ovs_prefix_list = NULL;
-    struct in6_addr addrv6;
-    int j = 0;
-    char *temp_prefix;
+    const struct plist_cache_list *list;
+    const struct plist_cache_entry *entry;
     bool first;
     int64_t seq = 0;
-    int len = 0;
+    size_t i, j, n_lists;
+
     if(seqnum) {
         seq = strtoll(seqnum, NULL, 10);
     }
-    OVSREC_PREFIX_LIST_FOR_EACH(ovs_prefix_list, idl) {
-        first = false;
-        for (j = 0; j < ovs_prefix_list->n_prefix_list_entries; j++) {
-            if (ovs_prefix_list->name) {
-                temp_prefix = (char *)malloc(sizeof(ovs_prefix_list->
-                                  value_prefix_list_entries[j]->prefix));
-                strcpy(temp_prefix, ovs_prefix_list->
-                           value_prefix_list_entries[j]->prefix);
-                strtok(temp_prefix,"/");
-
-                if (strcmp(ovs_prefix_list->
-                        value_prefix_list_entries[j]->prefix,"any") == 0
-                        || (ovs_prefix_list->
-                        value_prefix_list_entries[j]->ge[0] == 0
-                        && ovs_prefix_list->
-                        value_prefix_list_entries[j]->le[0] == 0 )) {
-
-                    if (ovs_prefix_list->
-                        value_prefix_list_entries[j]->le[0] == 128
-                        && (!strcmp(name,ovs_prefix_list->name)
-                        || strlen(name) == 0)) {
-                        if(afi == AFI_IP6) {
-                            if (!first && seq == 0 && (detail || summary)) {
-                                vty_out(vty,"ipv6 prefix-list %s:%s",
-                                       ovs_prefix_list->name,VTY_NEWLINE);
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                                vty_out(vty,"%3scount: %lu,"
-                                       " sequences: %lu - %lu%s","",
-                                       ovs_prefix_list->n_prefix_list_entries,
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[0],
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[ovs_prefix_list->
-                                       n_prefix_list_entries - 1],
-                                       VTY_NEWLINE);
-                                first = true;
-                            } else if (!first && seq == 0 && !detail
-                                       && !summary) {
-                                vty_out(vty,"ipv6 prefix-list %s: %lu entries%s",
-                                     ovs_prefix_list->name,
-                                     ovs_prefix_list->n_prefix_list_entries,
-                                     VTY_NEWLINE);
-                                first = true;
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                            } if ((ovs_prefix_list->
-                                key_prefix_list_entries[j] == seq || seq == 0)
-                                && (!summary)) {
-                                vty_out(vty,"%3sseq %lu %s %s%s","",
-                                     ovs_prefix_list->
-                                     key_prefix_list_entries[j],
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->action,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix,
-                                     VTY_NEWLINE);
-                            }
-                        }
-                    } else if (inet_pton(AF_INET6,temp_prefix,&addrv6) == 1
-                               && (!strcmp(name,ovs_prefix_list->name) ||
-                                  strlen(name) == 0)) {
-                        len = prefix_len(ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix);
-                        if (afi == AFI_IP6 ) {
-                            if (!first && seq == 0 && (detail || summary)
-                                && strlen(prefix) == 0) {
-                                vty_out(vty,"ipv6 prefix-list %s:%s",
-                                       ovs_prefix_list->name,VTY_NEWLINE);
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                                vty_out(vty,"%3scount: %lu,"
-                                       " sequences: %lu - %lu%s","",
-                                       ovs_prefix_list->n_prefix_list_entries,
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[0],
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[ovs_prefix_list->
-                                       n_prefix_list_entries - 1],
-                                       VTY_NEWLINE);
-                                first = true;
-                            } else if (!first && seq == 0 && !detail && !summary
-                                      && strlen(prefix) == 0) {
-                                vty_out(vty,"ipv6 prefix-list %s: %lu entries%s",
-                                        ovs_prefix_list->name,
-                                        ovs_prefix_list->n_prefix_list_entries,
-                                        VTY_NEWLINE);
-                                first = true;
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                            } if ((ovs_prefix_list->
-                                key_prefix_list_entries[j] == seq || seq == 0)
-                                && (!summary) && (!strcmp(ovs_prefix_list->
-                                value_prefix_list_entries[j]->prefix,prefix)
-                                || strlen(prefix) == 0) && (!longer)){
-                                vty_out(vty,"%3sseq %lu %s %s%s","",
-                                     ovs_prefix_list->
-                                     key_prefix_list_entries[j],
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->action,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix,
-                                     VTY_NEWLINE);
-                                if (first_match) {
-                                    break;
-                                }
-                            } if (longer) {
-                                len = prefix_len(ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix);
-                                if (len >= plen) {
-                                vty_out(vty,"%3sseq %lu %s %s%s","",
-                                     ovs_prefix_list->
-                                     key_prefix_list_entries[j],
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->action,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix,
-                                     VTY_NEWLINE);
-                                }
-                            }
-                        }
-                    } else {
-                        if (afi == AFI_IP
-                            && (!strcmp(name,ovs_prefix_list->name)
-                            || strlen(name) == 0)) {
-                            if (!first && seq == 0 && (detail || summary)) {
-                                vty_out(vty,"ip prefix-list %s:%s",
-                                       ovs_prefix_list->name,VTY_NEWLINE);
-                                vty_out(vty,"%3scount: %lu,"
-                                       " sequences: %lu - %lu%s","",
-                                       ovs_prefix_list->n_prefix_list_entries,
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[0],
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[ovs_prefix_list->
-                                       n_prefix_list_entries - 1],
-                                       VTY_NEWLINE);
-                                first = true;
-                            } else if (!first && seq == 0 && !detail
-                                       && !summary) {
-                                vty_out(vty,"ip prefix-list %s: %lu entries%s",
-                                        ovs_prefix_list->name,
-                                        ovs_prefix_list->n_prefix_list_entries,
-                                        VTY_NEWLINE);
-                                first = true;
-                            } if ((ovs_prefix_list->
-                                key_prefix_list_entries[j] == seq || seq == 0)
-                                && (!summary)) {
-                                vty_out(vty,"%3sseq %lu %s %s%s","",
-                                     ovs_prefix_list->
-                                     key_prefix_list_entries[j],
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->action,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix,
-                                     VTY_NEWLINE);
-                            }
-                        }
-                    }
-                } else if (strcmp(ovs_prefix_list->
-                               value_prefix_list_entries[j]->prefix,"any") != 0
-                               && ovs_prefix_list->
-                               value_prefix_list_entries[j]->le[0] == 0 ) {
-
-                    if (inet_pton(AF_INET6,temp_prefix,&addrv6) == 1
-                            && (!strcmp(name,ovs_prefix_list->name)
-                            || strlen(name) == 0)) {
-                        if (afi == AFI_IP6) {
-                            if (!first && seq == 0 && (detail || summary)
-                                && strlen(prefix) == 0) {
-                                vty_out(vty,"ipv6 prefix-list %s:%s",
-                                       ovs_prefix_list->name,VTY_NEWLINE);
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                                vty_out(vty,"%3scount: %lu,"
-                                       " sequences: %lu - %lu%s","",
-                                       ovs_prefix_list->n_prefix_list_entries,
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[0],
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[ovs_prefix_list->
-                                       n_prefix_list_entries - 1],
-                                       VTY_NEWLINE);
-                                first = true;
-                            } else if (!first && seq == 0 && !detail && !summary
-                                     && strlen(prefix) == 0) {
-                                vty_out(vty,"ipv6 prefix-list %s: %lu entries%s",
-                                        ovs_prefix_list->name,
-                                        ovs_prefix_list->n_prefix_list_entries,
-                                        VTY_NEWLINE);
-                                first = true;
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                            } if ((ovs_prefix_list->
-                                key_prefix_list_entries[j] == seq || seq == 0)
-                                && (!summary) && (!strcmp(ovs_prefix_list->
-                                value_prefix_list_entries[j]->prefix,prefix)
-                                || strlen(prefix) == 0) && (!longer)){
-                                vty_out(vty,"%3sseq %lu %s %s ge %lu%s","",
-                                     ovs_prefix_list->
-                                     key_prefix_list_entries[j],
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->action,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->ge[0],
-                                     VTY_NEWLINE);
-                                if (first_match) {
-                                    break;
-                                }
-                            }
-                           if (longer) {
-                                len = prefix_len(ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix);
-                                if (len >= plen) {
-                                vty_out(vty,"%3sseq %lu %s %s ge %lu%s","",
-                                     ovs_prefix_list->
-                                     key_prefix_list_entries[j],
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->action,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->ge[0],
-                                     VTY_NEWLINE);
-                                }
-                           }
-                        }
-                    } else {
-                        if (afi == AFI_IP
-                            && (!strcmp(name,ovs_prefix_list->name)
-                            || strlen(name) == 0)) {
-                            if (!first && seq == 0 && (detail || summary)) {
-                                vty_out(vty,"ip prefix-list %s:%s",
-                                       ovs_prefix_list->name,VTY_NEWLINE);
-                                vty_out(vty,"%3scount: %lu,"
-                                       " sequences: %lu - %lu%s","",
-                                       ovs_prefix_list->n_prefix_list_entries,
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[0],
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[ovs_prefix_list->
-                                       n_prefix_list_entries - 1],
-                                       VTY_NEWLINE);
-                                first = true;
-                            } else if (!first && seq == 0 && !detail
-                                       && !summary) {
-                                vty_out(vty,"ip prefix-list %s: %lu entries%s",
-                                     ovs_prefix_list->name,
-                                     ovs_prefix_list->n_prefix_list_entries,
-                                     VTY_NEWLINE);
-                                first = true;
-                            } if ((ovs_prefix_list->
-                                key_prefix_list_entries[j] == seq || seq == 0)
-                                && (!summary)) {
-                                vty_out(vty,"%3sseq %lu %s %s ge %lu%s","",
-                                     ovs_prefix_list->
-                                     key_prefix_list_entries[j],
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->action,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix,
-                                     ovs_prefix_list->
-                                     value_prefix_list_entries[j]->ge[0],
-                                     VTY_NEWLINE);
-                            }
-                        }
-                    }
-                } else if (strcmp(ovs_prefix_list->
-                               value_prefix_list_entries[j]->prefix,"any") != 0
-                               && ovs_prefix_list->
-                               value_prefix_list_entries[j]->ge[0] == 0 ) {
-                    if (inet_pton(AF_INET6,temp_prefix,&addrv6) == 1
-                            && (!strcmp(name,ovs_prefix_list->name)
-                            || strlen(name) == 0)) {
-                        if (afi == AFI_IP6) {
-                            if (!first && seq == 0 && (detail || summary)
-                                && strlen(prefix) == 0) {
-                                vty_out(vty,"ipv6 prefix-list %s:%s",
-                                       ovs_prefix_list->name,VTY_NEWLINE);
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                                vty_out(vty,"%3scount: %lu,"
-                                       " sequences: %lu - %lu%s","",
-                                       ovs_prefix_list->n_prefix_list_entries,
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[0],
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[ovs_prefix_list->
-                                       n_prefix_list_entries - 1],
-                                       VTY_NEWLINE);
-                                first = true;
-                            } else if (!first && seq == 0 && !detail && !summary
-                                      && strlen(prefix) == 0) {
-                                vty_out(vty,"ipv6 prefix-list %s: %lu entries%s",
-                                        ovs_prefix_list->name,
-                                        ovs_prefix_list->n_prefix_list_entries,
-                                        VTY_NEWLINE);
-                                first = true;
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                            } if ((ovs_prefix_list->
-                                key_prefix_list_entries[j] == seq || seq == 0)
-                                && (!summary) && (!strcmp(ovs_prefix_list->
-                                value_prefix_list_entries[j]->prefix,prefix)
-                                || strlen(prefix) == 0) && (!longer)) {
-                                vty_out(vty,"%3sseq %lu %s %s le %lu%s","",
-                                    ovs_prefix_list->
-                                    key_prefix_list_entries[j],
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->action,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->prefix,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->le[0],
-                                    VTY_NEWLINE);
-                                if (first_match) {
-                                    break;
-                                }
-
-                            } if (longer) {
-                                len = prefix_len(ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix);
-                                if (len >= plen) {
-                                vty_out(vty,"%3sseq %lu %s %s le %lu%s","",
-                                    ovs_prefix_list->
-                                    key_prefix_list_entries[j],
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->action,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->prefix,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->le[0],
-                                    VTY_NEWLINE);
-                                }
-                            }
-                        }
-                    } else {
-                        if (afi == AFI_IP
-                            && (!strcmp(name,ovs_prefix_list->name)
-                            || strlen(name) == 0)) {
-                            if (!first && seq == 0 && (detail || summary)) {
-                                vty_out(vty,"ip prefix-list %s:%s",
-                                       ovs_prefix_list->name,VTY_NEWLINE);
-                                vty_out(vty,"%3scount: %lu,"
-                                       " sequences: %lu - %lu%s","",
-                                       ovs_prefix_list->n_prefix_list_entries,
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[0],
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[ovs_prefix_list->
-                                       n_prefix_list_entries - 1],
-                                       VTY_NEWLINE);
-                                first = true;
-                            } else if (!first && seq == 0 && !detail
-                                && !summary) {
-                                vty_out(vty,"ip prefix-list %s: %lu entries%s",
-                                        ovs_prefix_list->name,
-                                        ovs_prefix_list->n_prefix_list_entries,
-                                        VTY_NEWLINE);
-                                first = true;
-                            } if ((ovs_prefix_list->
-                                key_prefix_list_entries[j] == seq || seq == 0)
-                                && (!summary)) {
-                                vty_out(vty,"%3sseq %lu %s %s le %lu%s","",
-                                    ovs_prefix_list->
-                                    key_prefix_list_entries[j],
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->action,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->prefix,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->le[0],
-                                    VTY_NEWLINE);
-                            }
-                        }
-                    }
-                } else {
-                    if (inet_pton(AF_INET6,temp_prefix,&addrv6) == 1
-                            && (!strcmp(name,ovs_prefix_list->name)
-                            || strlen(name) == 0)) {
-                        if (afi == AFI_IP6) {
-                            if (!first && seq == 0 && (detail ||summary)
-                                && strlen(prefix) == 0) {
-                                vty_out(vty,"ipv6 prefix-list %s:%s",
-                                       ovs_prefix_list->name,VTY_NEWLINE);
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                                vty_out(vty,"%3scount: %lu,"
-                                       " sequences: %lu - %lu%s","",
-                                       ovs_prefix_list->n_prefix_list_entries,
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[0],
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[ovs_prefix_list->
-                                       n_prefix_list_entries - 1],
-                                       VTY_NEWLINE);
-                                first = true;
-                            } else if (!first && seq == 0 && !detail && !summary
-                                      && strlen(prefix) == 0) {
-                                vty_out(vty,"ipv6 prefix-list %s: %lu entries%s",
-                                        ovs_prefix_list->name,
-                                        ovs_prefix_list->n_prefix_list_entries,
-                                        VTY_NEWLINE);
-                                first = true;
-                                if(strlen(ovs_prefix_list->description) !=0 ) {
-                                    vty_out(vty,"%3sDescription: %s%s","",
-                                            ovs_prefix_list->description,
-                                            VTY_NEWLINE);
-                                }
-                            } if ((ovs_prefix_list->
-                                key_prefix_list_entries[j] == seq || seq == 0)
-                                && (!summary)  && (!strcmp(ovs_prefix_list->
-                                value_prefix_list_entries[j]->prefix,prefix)
-                                || strlen(prefix) == 0) && (!longer)) {
-                                vty_out(vty,"%3sseq %lu %s %s ge %lu le %lu%s","",
-                                    ovs_prefix_list->
-                                    key_prefix_list_entries[j],
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->action,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->prefix,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->ge[0],
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->le[0],
-                                    VTY_NEWLINE);
-                                if (first_match) {
-                                    break;
-                                }
-                            } if (longer) {
-                                len = prefix_len(ovs_prefix_list->
-                                     value_prefix_list_entries[j]->prefix);
-                                if (len >= plen) {
-                                vty_out(vty,"%3sseq %lu %s %s ge %lu le %lu%s","",
-                                    ovs_prefix_list->
-                                    key_prefix_list_entries[j],
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->action,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->prefix,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->ge[0],
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->le[0],
-                                    VTY_NEWLINE);
-                                }
-                            }
-                        }
-                    } else {
-                        if (afi == AFI_IP
-                            && (!strcmp(name,ovs_prefix_list->name)
-                            || strlen(name) == 0)) {
-                            if (!first && seq == 0 && (detail || summary)) {
-                                vty_out(vty,"ip prefix-list %s:%s",
-                                       ovs_prefix_list->name,VTY_NEWLINE);
-                                vty_out(vty,"%3scount: %lu,"
-                                       " sequences: %lu - %lu%s","",
-                                       ovs_prefix_list->n_prefix_list_entries,
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[0],
-                                       ovs_prefix_list->
-                                       key_prefix_list_entries[ovs_prefix_list->
-                                       n_prefix_list_entries - 1],
-                                       VTY_NEWLINE);
-                                first = true;
-                            } else if (!first && seq == 0 && !detail
-                                       && !summary) {
-                                vty_out(vty,"ip prefix-list %s: %lu entries%s",
-                                        ovs_prefix_list->name,
-                                        ovs_prefix_list->n_prefix_list_entries,
-                                        VTY_NEWLINE);
-                                first = true;
-                            } if (( ovs_prefix_list->
-                                key_prefix_list_entries[j] == seq || seq == 0)
-                                && (!summary)) {
-                                vty_out(vty,"%3sseq %lu %s %s ge %lu le %lu%s","",
-                                    ovs_prefix_list->
-                                    key_prefix_list_entries[j],
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->action,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->prefix,
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->ge[0],
-                                    ovs_prefix_list->
-                                    value_prefix_list_entries[j]->le[0],
-                                    VTY_NEWLINE);
-                            }
-                        }
 
-                    }
-                }
-                free(temp_prefix);
+    plist_cache_refresh();
+
+    if (strlen(prefix) != 0) {
+        show_prefix_list_prefix(afi, name, seq, prefix, first_match, longer);
+        return 0;
+    }
+
+    n_lists = strlen(name) ? 1 : plist_cache_count();
+    for (i = 0; i < n_lists; i++) {
+        list = strlen(name) ? plist_cache_lookup(name) : plist_cache_get(i);
+        if (!list) {
+            break;
+        }
+        first = false;
+        for (j = 0; j < list->n_entries; j++) {
+            entry = &list->entries[j];
+            if (entry->afi != afi) {
+                continue;
+            }
+            if (!first && seq == 0) {
+                show_prefix_list_header(afi, list->row, detail, summary);
+                first = true;
+            }
+            if ((entry->seq == seq || seq == 0) && (!summary)) {
+                show_prefix_list_entry(entry);
             }
         }
-
     }
     return 0;
 }
@@ -13791,7 +13394,7 @@ DEFUN(show_ip_prefix_list,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP, "", NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -13808,7 +13411,7 @@ DEFUN(show_ipv6_prefix_list,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP6, "", NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -13825,7 +13428,7 @@ DEFUN(show_ip_prefix_list_name,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP, argv[0], NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -13842,7 +13445,7 @@ DEFUN(show_ipv6_prefix_list_name,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP6, argv[0], NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -13861,7 +13464,7 @@ DEFUN(show_ip_prefix_list_name_seq,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP, argv[0], argv[1], detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -13880,7 +13483,7 @@ DEFUN(show_ipv6_prefix_list_name_seq,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP6, argv[0], argv[1], detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -13898,7 +13501,7 @@ DEFUN(show_ip_prefix_list_detail_name,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP, argv[0], NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 
 }
@@ -13916,7 +13519,7 @@ DEFUN(show_ipv6_prefix_list_detail,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP6, "", NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 DEFUN(show_ipv6_prefix_list_detail_name,
@@ -13933,7 +13536,7 @@ DEFUN(show_ipv6_prefix_list_detail_name,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP6, argv[0], NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 
 }
@@ -13953,7 +13556,7 @@ DEFUN(show_ip_prefix_list_summary_name,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP, argv[0], NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -13970,7 +13573,7 @@ DEFUN(show_ipv6_prefix_list_summary,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP6, "", NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
     return CMD_SUCCESS;
 
 
@@ -13989,7 +13592,63 @@ DEFUN(show_ipv6_prefix_list_summary_name,
     bool first_match = false;
     bool longer = false;
     show_prefix_list(AFI_IP6, argv[0], NULL, detail, summary, "",
-                     first_match, longer, 0);
+                     first_match, longer);
+    return CMD_SUCCESS;
+}
+
+DEFUN(show_ip_prefix_list_prefix,
+       show_ip_prefix_list_prefix_cmd,
+       "show ip prefix-list WORD A.B.C.D/M",
+       SHOW_STR
+       IP_STR
+       PREFIX_LIST_STR
+       "Name of a prefix list\n"
+       "IP prefix <network>/<length>, e.g., 35.0.0.0/8\n")
+{
+    bool detail = false;
+    bool summary = false;
+    bool first_match = false;
+    bool longer = false;
+    show_prefix_list(AFI_IP, argv[0], NULL, detail, summary, argv[1],
+                     first_match, longer);
+    return CMD_SUCCESS;
+}
+
+DEFUN(show_ip_prefix_list_prefix_first_match,
+       show_ip_prefix_list_prefix_first_match_cmd,
+       "show ip prefix-list WORD A.B.C.D/M first-match",
+       SHOW_STR
+       IP_STR
+       PREFIX_LIST_STR
+       "Name of a prefix list\n"
+       "IP prefix <network>/<length>, e.g., 35.0.0.0/8\n"
+       "First matched prefix\n")
+{
+    bool detail = false;
+    bool summary = false;
+    bool first_match = true;
+    bool longer = false;
+    show_prefix_list(AFI_IP, argv[0], NULL, detail, summary, argv[1],
+                     first_match, longer);
+    return CMD_SUCCESS;
+}
+
+DEFUN(show_ip_prefix_list_prefix_longer,
+       show_ip_prefix_list_prefix_longer_cmd,
+       "show ip prefix-list WORD A.B.C.D/M longer",
+       SHOW_STR
+       IP_STR
+       PREFIX_LIST_STR
+       "Name of a prefix list\n"
+       "IP prefix <network>/<length>, e.g., 35.0.0.0/8\n"
+       "Lookup longer prefix\n")
+{
+    bool detail = false;
+    bool summary = false;
+    bool first_match = false;
+    bool longer = true;
+    show_prefix_list(AFI_IP, argv[0], NULL, detail, summary, argv[1],
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -14006,8 +13665,8 @@ DEFUN(show_ipv6_prefix_list_prefix,
     bool summary = false;
     bool first_match = false;
     bool longer = false;
-    show_prefix_list(AFI_IP6, argv[0], NULL, detail, summary, (char *)argv[1],
-                     first_match, longer, 0);
+    show_prefix_list(AFI_IP6, argv[0], NULL, detail, summary, argv[1],
+                     first_match, longer);
     return CMD_SUCCESS;
 
 }
@@ -14026,8 +13685,8 @@ DEFUN(show_ipv6_prefix_list_prefix_first_match,
     bool summary = false;
     bool first_match = true;
     bool longer = false;
-    show_prefix_list(AFI_IP6, argv[0], NULL, detail, summary, (char *)argv[1],
-                     first_match, longer, 0);
+    show_prefix_list(AFI_IP6, argv[0], NULL, detail, summary, argv[1],
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -14045,8 +13704,8 @@ DEFUN(show_ipv6_prefix_list_prefix_longer,
     bool summary = false;
     bool first_match = true;
     bool longer = true;
-    show_prefix_list(AFI_IP6, argv[0], NULL, detail, summary, (char *)argv[1],
-                      first_match, longer, prefix_len((char *)argv[1]));
+    show_prefix_list(AFI_IP6, argv[0], NULL, detail, summary, argv[1],
+                     first_match, longer);
     return CMD_SUCCESS;
 }
 
@@ -14778,6 +14437,9 @@ void policy_vty_init(void)
     install_element(ENABLE_NODE, &show_ip_prefix_list_summary_name_cmd);
     install_element(ENABLE_NODE, &show_ipv6_prefix_list_summary_cmd);
     install_element(ENABLE_NODE, &show_ipv6_prefix_list_summary_name_cmd);
+    install_element(ENABLE_NODE, &show_ip_prefix_list_prefix_cmd);
+    install_element(ENABLE_NODE, &show_ip_prefix_list_prefix_first_match_cmd);
+    install_element(ENABLE_NODE, &show_ip_prefix_list_prefix_longer_cmd);
     install_element(ENABLE_NODE, &show_ipv6_prefix_list_prefix_cmd);
     install_element(ENABLE_NODE, &show_ipv6_prefix_list_prefix_first_match_cmd);
     install_element(ENABLE_NODE, &show_ipv6_prefix_list_prefix_longer_cmd);
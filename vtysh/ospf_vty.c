@@ -55,6 +55,9 @@
 #include "lib/plist.h"
 #include "lib/libospf.h"
 #include "openswitch-dflt.h"
+#include "vtysh/utils/ospf_lsdb_vtysh_utils.h"
+#include "vtysh/utils/ospf_lookup_vtysh_utils.h"
+#include "vtysh/utils/ospf_route_vtysh_utils.h"
 
 /* Making formatted timer strings. */
 #define MINUTE_IN_SECONDS   60
@@ -135,58 +138,6 @@ ospf_str_to_area_id (const char *str, struct in_addr *area_id)
   return 0;
 }
 
-/* qsort comparator function.
- */
-int
-compare_nodes_by_ip_in_numerical(const void *a_, const void *b_)
-{
-    const struct shash_node *const *a = a_;
-    const struct shash_node *const *b = b_;
-    uint i1=0,i2=0;
-
-    sscanf((*a)->name,"%d",&i1);
-    sscanf((*b)->name,"%d",&i2);
-
-    if (i1 == i2)
-        return 0;
-    else if (i1 < i2)
-        return -1;
-    else
-        return 1;
-}
-
-/*
- * Sorting function for routes
- * on success, returns sorted list of routes.
- */
-const struct shash_node **
-sort_ospf_route(const struct shash *sh)
-{
-    if (shash_is_empty(sh))
-    {
-        return NULL;
-    }
-    else
-    {
-        const struct shash_node **nodes;
-        struct shash_node *node;
-
-        size_t i, n;
-
-        n = shash_count(sh);
-        nodes = xmalloc(n * sizeof *nodes);
-        i = 0;
-        SHASH_FOR_EACH (node, sh) {
-            if(node != NULL)
-                nodes[i++] = node;
-        }
-        ovs_assert(i == n);
-
-        qsort(nodes, n, sizeof *nodes, compare_nodes_by_ip_in_numerical);
-        return nodes;
-    }
-}
-
 /* Function to get the statistics from neighbor table. */
 int64_t
 ospf_get_statistics_from_neighbor(const struct ovsrec_ospf_neighbor *
@@ -491,8 +442,11 @@ ospf_area_remove_from_router(
     }
 
     if (is_present == true)
+    {
         ovsrec_ospf_router_set_areas(ospf_router_row, area, area_list,
                                    (ospf_router_row->n_areas - 1));
+        ospf_lookup_areas_written();
+    }
 
     SAFE_FREE(area);
     SAFE_FREE(area_list);
@@ -1032,17 +986,7 @@ ospf_area_lookup_by_area_id(
                             const struct ovsrec_ospf_router *router_row,
                             int64_t area_id)
 {
-    int i = 0;
-
-    for (i = 0; i < router_row->n_areas; i++)
-    {
-        if (router_row->key_areas[i] == area_id)
-        {
-            return router_row->value_areas[i];
-        }
-    }
-
-    return NULL;
+    return ospf_lookup_area(router_row, area_id);
 }
 
 /* Set the default values for the area row. */
@@ -1125,6 +1069,7 @@ ospf_area_insert_to_router(const struct ovsrec_ospf_router *ospf_router_row,
                         CONST_CAST(struct ovsrec_ospf_area *, area_row);
     ovsrec_ospf_router_set_areas(ospf_router_row, area, area_list,
                                (ospf_router_row->n_areas + 1));
+    ospf_lookup_areas_written();
 
     SAFE_FREE(area);
     SAFE_FREE(area_list);
@@ -2059,11 +2004,7 @@ static int ospf_interval_cmd_execute(const char* ifname,
     OSPF_START_DB_TXN(ospf_router_txn);
 
     /* Get the interface row for the interface name passed. */
-    OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
-    {
-        if (strcmp(ospf_interface_row->name, ifname) == 0)
-            break;
-    }
+    ospf_interface_row = ospf_lookup_ospf_interface(ifname);
 
     if (ospf_interface_row == NULL)
     {
@@ -2240,13 +2181,12 @@ ospf_vl_interface_one_row_print(struct vty *vty,
     const struct ovsrec_ospf_area *ospf_area_row = NULL;
     const struct ovsrec_ospf_router *ospf_router_row = NULL;
     const struct ovsrec_ospf_neighbor *ospf_nbr_row = NULL;
-    int i, j, n_adjacent_nbrs = 0;
+    int j, n_adjacent_nbrs = 0;
     int64_t area_id = 0, router_id = 0, intervals = 0;
     int64_t dr_id = 0, bdr_id = 0, dr_if_addr = 0, bdr_if_addr = 0;
     const char *val = NULL;
     bool is_dr_present = false;
     bool is_bdr_present = false;
-    bool is_present = false;
     const struct ovsrec_vrf *vrf_row;
     int instance_id = 1;
     char timebuf[OSPF_TIME_SIZE];
@@ -2274,33 +2214,12 @@ ospf_vl_interface_one_row_print(struct vty *vty,
         return;
     }
 
-    OVSREC_OSPF_AREA_FOR_EACH(ospf_area_row, idl)
-    {
-        for (j = 0; j < ospf_area_row->n_ospf_interfaces; j++)
-        {
-            if (strcmp(ospf_area_row->ospf_interfaces[j]->name,ospf_interface_row->name) == 0)
-            {
-                is_present = true;
-                break;
-            }
-        }
-        if (is_present == true)
-            break;
-    }
+    ospf_area_row = ospf_lookup_interface_area(ospf_interface_row->name);
 
     /* Get the area id from the router table */
-    if ((ospf_area_row != NULL) &&
-        (strcmp(ospf_area_row->ospf_interfaces[j]->name, ospf_interface_row->name) == 0) &&
-        (ospf_router_row != NULL))
+    if ((ospf_area_row != NULL) && (ospf_router_row != NULL))
     {
-        for (i = 0; i < ospf_router_row->n_areas; i++)
-        {
-            if (ospf_router_row->value_areas[i] == ospf_area_row)
-            {
-                area_id = ospf_router_row->key_areas[i];
-                break;
-            }
-        }
+        ospf_lookup_area_id(ospf_router_row, ospf_area_row, &area_id);
     }
     else
     {
@@ -2787,13 +2706,12 @@ ospf_interface_one_row_print(struct vty *vty,const char* ifname,
     const struct ovsrec_ospf_area *ospf_area_row = NULL;
     const struct ovsrec_ospf_router *ospf_router_row = NULL;
     const struct ovsrec_ospf_neighbor *ospf_nbr_row = NULL;
-    int i, j, n_adjacent_nbrs = 0;
+    int j, n_adjacent_nbrs = 0;
     int64_t area_id = 0, router_id = 0, intervals = 0;
     int64_t dr_id = 0, bdr_id = 0, dr_if_addr = 0, bdr_if_addr = 0;
     const char *val = NULL;
     bool is_dr_present = false;
     bool is_bdr_present = false;
-    bool is_present = false;
     const struct ovsrec_vrf *vrf_row;
     int instance_id = 1;
     char timebuf[OSPF_TIME_SIZE];
@@ -2811,45 +2729,19 @@ ospf_interface_one_row_print(struct vty *vty,const char* ifname,
     port_row = ospf_interface_row->port;
 
     /* Get the interface row for the interface name passed. */
-    OVSREC_INTERFACE_FOR_EACH(interface_row, idl)
-    {
-        if (strcmp(interface_row->name, ifname) == 0)
-            break;
-    }
-
-    if (strcmp(interface_row->name, ifname) != 0)
+    interface_row = ospf_lookup_interface(ifname);
+    if (interface_row == NULL)
     {
         vty_out(vty, "Interface name %s is not present.%s", ifname, VTY_NEWLINE);
         return;
     }
 
-    OVSREC_OSPF_AREA_FOR_EACH(ospf_area_row, idl)
-    {
-        for (j = 0; j < ospf_area_row->n_ospf_interfaces; j++)
-        {
-            if (strcmp(ospf_area_row->ospf_interfaces[j]->name, ifname) == 0)
-            {
-                is_present = true;
-                break;
-            }
-        }
-        if (is_present == true)
-            break;
-    }
+    ospf_area_row = ospf_lookup_interface_area(ifname);
 
     /* Get the area id from the router table */
-    if ((ospf_area_row != NULL) &&
-        (strcmp(ospf_area_row->ospf_interfaces[j]->name, ifname) == 0) &&
-        (ospf_router_row != NULL))
+    if ((ospf_area_row != NULL) && (ospf_router_row != NULL))
     {
-        for (i = 0; i < ospf_router_row->n_areas; i++)
-        {
-            if (ospf_router_row->value_areas[i] == ospf_area_row)
-            {
-                area_id = ospf_router_row->key_areas[i];
-                break;
-            }
-        }
+        ospf_lookup_area_id(ospf_router_row, ospf_area_row, &area_id);
     }
     else
     {
@@ -3153,11 +3045,9 @@ ospf_ip_router_interface_show(const char* ifname)
     if (ifname != NULL)
     {
         /* Print interface details for the interface name passed. */
-        OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
-        {
-            if (strcmp(ospf_interface_row->name, ifname) == 0)
-                ospf_interface_one_row_print(vty, ifname, ospf_interface_row);
-        }
+        ospf_interface_row = ospf_lookup_ospf_interface(ifname);
+        if (ospf_interface_row)
+            ospf_interface_one_row_print(vty, ifname, ospf_interface_row);
     }
     else
     {
@@ -3234,7 +3124,7 @@ ospf_neighbor_one_row_print(
     const struct ovsrec_vrf *vrf_row = NULL;
     const struct ovsrec_ospf_interface *interface_row = NULL;
     const struct ovsrec_port *port_row = NULL;
-    int instance_id = 1, j;
+    int instance_id = 1;
     const char *val = NULL;
     struct in_addr id;
     int ret;
@@ -3312,27 +3202,21 @@ ospf_neighbor_one_row_print(
     else
         vty_out (vty, "%-15s ", "null");
 
-    /* Get the interface row for the interface name passed. */
-    OVSREC_OSPF_INTERFACE_FOR_EACH(interface_row, idl)
+    /* Get the interface row the neighbor belongs to. */
+    interface_row = ospf_lookup_neighbor_interface(ospf_nbr_row);
+    if (interface_row)
     {
-        for (j = 0; j < interface_row->n_neighbors; j++)
-        {
-            if (interface_row->neighbors[j] == ospf_nbr_row)
-            {
-               if (!interface_row->ospf_vlink) {
-                    port_row = interface_row->port;
-                    snprintf(show_str, OSPF_SHOW_STR_LEN, "%s:%s",
-                             interface_row->name,
-                            port_row->ip4_address);
-                }
-                else
-                    snprintf(show_str, OSPF_SHOW_STR_LEN, "%s",
-                             interface_row->name);
-                vty_out (vty, "%-20s ", show_str);
-                is_present = true;
-                break;
-            }
+        if (!interface_row->ospf_vlink) {
+            port_row = interface_row->port;
+            snprintf(show_str, OSPF_SHOW_STR_LEN, "%s:%s",
+                     interface_row->name,
+                     port_row->ip4_address);
         }
+        else
+            snprintf(show_str, OSPF_SHOW_STR_LEN, "%s",
+                     interface_row->name);
+        vty_out (vty, "%-20s ", show_str);
+        is_present = true;
     }
 
     /* This condition should not occur, as this would mean we have nbr without matching
@@ -3361,13 +3245,13 @@ ospf_neighbor_one_row_detail_print(
     const struct ovsrec_vrf *vrf_row = NULL;
     const struct ovsrec_ospf_interface *interface_row = NULL;
     const struct ovsrec_ospf_area *area_row = NULL;
-    int instance_id = 1, i= 0, j = 0;
+    int instance_id = 1;
+    int64_t area_id = 0;
     const char *val = NULL;
     struct in_addr id;
     int ret;
     char show_str[OSPF_SHOW_STR_LEN];
     char timebuf[OSPF_TIME_SIZE];
-    bool is_present = false;
     char area_str[OSPF_SHOW_STR_LEN];
 
     memset (&id, 0, sizeof (struct in_addr));
@@ -3426,49 +3310,16 @@ ospf_neighbor_one_row_detail_print(
 
     vty_out(vty, "%s", VTY_NEWLINE);
 
-    /* Get the matching interface row */
-    is_present = false;
-    OVSREC_OSPF_INTERFACE_FOR_EACH(interface_row, idl)
-    {
-        for (i = 0; i < interface_row->n_neighbors; i++)
-        {
-            if (interface_row->neighbors[i] == ospf_nbr_row)
-            {
-                is_present = true;
-                break;
-            }
-        }
-        if (is_present)
-            break;
-    }
-
-    is_present = false;
-    /* Get the matching area row */
-    OVSREC_OSPF_AREA_FOR_EACH(area_row, idl)
-    {
-        for(i = 0; i< area_row->n_ospf_interfaces; i++)
-        {
-            if (area_row->ospf_interfaces[i] == interface_row)
-            {
-                is_present = true;
-                break;
-            }
-        }
-
-        if (is_present)
-            break;
-    }
+    /* Get the matching interface and area rows */
+    interface_row = ospf_lookup_neighbor_interface(ospf_nbr_row);
+    if (interface_row)
+        area_row = ospf_lookup_interface_area(interface_row->name);
 
-    is_present = false;
-    for(j =0; j< ospf_router_row->n_areas; j++)
+    if (area_row &&
+        ospf_lookup_area_id(ospf_router_row, area_row, &area_id))
     {
-        if (ospf_router_row->value_areas[j] == area_row)
-        {
-            OSPF_IP_STRING_CONVERT(area_str, \
-                                   ntohl(ospf_router_row->key_areas[j]));
-            vty_out (vty, "    In the area %s ", area_str);
-            break;
-        }
+        OSPF_IP_STRING_CONVERT(area_str, ntohl(area_id));
+        vty_out (vty, "    In the area %s ", area_str);
     }
 
     if (area_row)
@@ -3565,39 +3416,34 @@ ospf_neighbor_one_row_detail_print(
 
 void
 ospf_ip_router_neighbor_detail_show(const char* ifname,
-                                             int nbr_id,
+                                             int64_t nbr_id,
                                              bool all_flag)
 {
     const struct ovsrec_ospf_neighbor *ospf_nbr_row = NULL;
+    const struct ovsrec_ospf_neighbor **nbrs = NULL;
     const struct ovsrec_ospf_interface *ospf_interface_row = NULL;
+    size_t n_nbrs = 0;
 
     if (ifname != NULL)
     {
         /* Print neighbor details for the interface name passed. */
-        OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
+        ospf_interface_row = ospf_lookup_ospf_interface(ifname);
+        if (ospf_interface_row)
         {
-            if (strcmp(ospf_interface_row->name, ifname) == 0)
+            for(int i = 0; i < ospf_interface_row->n_neighbors; i++)
             {
-                for(int i = 0; i < ospf_interface_row->n_neighbors; i++)
-                {
-                    ospf_nbr_row = ospf_interface_row->neighbors[i];
-                    ospf_neighbor_one_row_detail_print(ospf_nbr_row, all_flag);
-                }
+                ospf_nbr_row = ospf_interface_row->neighbors[i];
+                ospf_neighbor_one_row_detail_print(ospf_nbr_row, all_flag);
             }
         }
     }
     else if (nbr_id != 0)
     {
         /* Print all the neighbor entries matching the nbr id present */
-        OVSREC_OSPF_NEIGHBOR_FOR_EACH(ospf_nbr_row, idl)
+        nbrs = ospf_lookup_neighbors_by_router_id(nbr_id, &n_nbrs);
+        for (size_t i = 0; i < n_nbrs; i++)
         {
-            for (int i = 0; i < ospf_nbr_row->n_nbr_router_id; i++)
-            {
-                if (ospf_nbr_row->nbr_router_id[i] == nbr_id)
-                {
-                    ospf_neighbor_one_row_detail_print(ospf_nbr_row, all_flag);
-                }
-            }
+            ospf_neighbor_one_row_detail_print(nbrs[i], all_flag);
         }
     }
     else
@@ -3631,7 +3477,9 @@ ospf_ip_router_neighbor_show(const char* ifname,
                                      bool all_flag)
 {
     const struct ovsrec_ospf_neighbor *ospf_nbr_row = NULL;
+    const struct ovsrec_ospf_neighbor **nbrs = NULL;
     const struct ovsrec_ospf_interface *ospf_interface_row = NULL;
+    size_t n_nbrs = 0;
     int i =0;
 
     /* Print the header */
@@ -3640,31 +3488,27 @@ ospf_ip_router_neighbor_show(const char* ifname,
     if (ifname != NULL)
     {
         /* Print neighbor details for the interface name passed. */
-        OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
+        ospf_interface_row = ospf_lookup_ospf_interface(ifname);
+        if (ospf_interface_row)
         {
-            if (strcmp(ospf_interface_row->name, ifname) == 0)
+            for(i = 0; i < ospf_interface_row->n_neighbors; i++)
             {
-                for(i = 0; i < ospf_interface_row->n_neighbors; i++)
-                {
-                    ospf_nbr_row = ospf_interface_row->neighbors[i];
-                    ospf_neighbor_one_row_print(ospf_interface_row,
-                                                ospf_nbr_row, all_flag);
-                }
+                ospf_nbr_row = ospf_interface_row->neighbors[i];
+                ospf_neighbor_one_row_print(ospf_interface_row,
+                                            ospf_nbr_row, all_flag);
             }
         }
     }
     else if (nbr_id != 0)
     {
         /* Print all the neighbor entries matching the nbr id present */
-        OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
+        nbrs = ospf_lookup_neighbors_by_router_id(nbr_id, &n_nbrs);
+        for(i = 0; i < n_nbrs; i++)
         {
-            for(i = 0; i < ospf_interface_row->n_neighbors; i++)
-            {
-                ospf_nbr_row = ospf_interface_row->neighbors[i];
-                if (nbr_id == *ospf_nbr_row->nbr_router_id)
-                    ospf_neighbor_one_row_print(ospf_interface_row,
-                                                ospf_nbr_row, all_flag);
-            }
+            ospf_interface_row = ospf_lookup_neighbor_interface(nbrs[i]);
+            if (ospf_interface_row)
+                ospf_neighbor_one_row_print(ospf_interface_row,
+                                            nbrs[i], all_flag);
         }
     }
     else
@@ -3900,300 +3744,181 @@ ospf_running_config_show()
 }
 
 static void
-ospf_route_network_show(const struct ovsrec_ospf_router *router_row)
+ospf_route_area_str(const struct ovsrec_ospf_route *route_row, char *area_str)
 {
-    const struct ovsrec_ospf_route *route_row = NULL;
-    const struct ovsrec_ospf_area *area_row = NULL;
-    int i = 0, j = 0, area_id = 0, count = 0;
-    int64_t cost = OSPF_DEFAULT_COST;
-    char area_str[OSPF_SHOW_STR_LEN];
-    struct shash sorted_ospf_net_route;
-    const struct shash_node **nodes = NULL;
-    const char *port_ip_str;
-
-    memset(area_str,'\0', OSPF_SHOW_STR_LEN);
-
-    vty_out (vty, "============ OSPF network routing table ============%s",
-         VTY_NEWLINE);
-
-    shash_init(&sorted_ospf_net_route);
+    int area_id = smap_get_int(&route_row->route_info,
+                               OSPF_KEY_ROUTE_AREA_ID, 0);
 
-    OVSREC_OSPF_AREA_FOR_EACH(area_row, idl)
+    if (area_id != 0)
     {
-        /* Print inter area routes. */
-        for (i = 0; i < area_row->n_inter_area_ospf_routes; i++)
-        {
-            route_row = area_row->inter_area_ospf_routes[i];
-            port_ip_str = route_row->prefix;
-            shash_add(&sorted_ospf_net_route, port_ip_str, (void *)route_row);
-        }
-
-        if (!shash_is_empty(&sorted_ospf_net_route))
-        {
-            count = shash_count(&sorted_ospf_net_route);
-            nodes = sort_ospf_route(&sorted_ospf_net_route);
-        }
-        else
-        {
-            count = 0;
-        }
-
-        for (int idx = 0; idx < count; idx++)
-        {
-            route_row = (const struct ovsrec_ospf_route *)nodes[idx]->data;
-            area_id = smap_get_int(&route_row->route_info,
-                                   OSPF_KEY_ROUTE_AREA_ID, 0);
-            if (area_id != 0)
-            {
-                OSPF_IP_STRING_CONVERT(area_str, ntohl(area_id));
-            }
-            else
-            {
-                strncpy(area_str, "0.0.0.0", OSPF_SHOW_STR_LEN - 1);
-            }
-
-            cost = smap_get_int(&route_row->route_info,
-                                OSPF_KEY_ROUTE_COST, OSPF_DEFAULT_COST);
-            vty_out (vty, "N IA %-18s    [%lu] area: %s%s", route_row->prefix,
-                     cost, area_str, VTY_NEWLINE);
-            for(j = 0; j < route_row->n_paths; j++)
-                vty_out (vty, "%24s   %s%s", "", route_row->paths[j],
-                         VTY_NEWLINE);
-        }
-
-        if (!shash_is_empty(&sorted_ospf_net_route))
-        {
-            shash_clear(&sorted_ospf_net_route);
-        }
-        SAFE_FREE(nodes);
-
-        /* Print intra area routes. */
-        for (i = 0; i < area_row->n_intra_area_ospf_routes; i++)
-        {
-            route_row = area_row->intra_area_ospf_routes[i];
-            port_ip_str = route_row->prefix;
-            shash_add(&sorted_ospf_net_route, port_ip_str, (void *)route_row);
-        }
-
-        if (!shash_is_empty(&sorted_ospf_net_route))
-        {
-            count = shash_count(&sorted_ospf_net_route);
-            nodes = sort_ospf_route(&sorted_ospf_net_route);
-        }
-        else
-        {
-            count = 0;
-        }
-
-        for (int idx = 0; idx < count; idx++)
-        {
-            route_row = (const struct ovsrec_ospf_route *)nodes[idx]->data;
-            area_id = smap_get_int(&route_row->route_info,
-                                   OSPF_KEY_ROUTE_AREA_ID, 0);
-            if (area_id != 0)
-            {
-                OSPF_IP_STRING_CONVERT(area_str, ntohl(area_id));
-            }
-            else
-            {
-                strncpy(area_str, "0.0.0.0", OSPF_SHOW_STR_LEN - 1);
-            }
-
-            cost = smap_get_int(&route_row->route_info,
-                                OSPF_KEY_ROUTE_COST, OSPF_DEFAULT_COST);
-            vty_out (vty, "N    %-18s    [%lu] area: %s%s", route_row->prefix,
-                     cost, area_str, VTY_NEWLINE);
-            for(j = 0; j < route_row->n_paths; j++)
-                vty_out (vty, "%24s   %s%s", "", route_row->paths[j],
-                         VTY_NEWLINE);
-        }
-
-        if (!shash_is_empty(&sorted_ospf_net_route))
-        {
-            shash_clear(&sorted_ospf_net_route);
-        }
-        SAFE_FREE(nodes);
+        OSPF_IP_STRING_CONVERT(area_str, ntohl(area_id));
+    }
+    else
+    {
+        strncpy(area_str, "0.0.0.0", OSPF_SHOW_STR_LEN - 1);
     }
-    shash_destroy(&sorted_ospf_net_route);
-
-    vty_out (vty, "%s", VTY_NEWLINE);
 }
 
+static void
+ospf_route_network_print(const struct ospf_route_entry *entry)
+{
+    const struct ovsrec_ospf_route *route_row = entry->row;
+    int64_t cost = OSPF_DEFAULT_COST;
+    char area_str[OSPF_SHOW_STR_LEN];
+
+    memset(area_str,'\0', OSPF_SHOW_STR_LEN);
+    ospf_route_area_str(route_row, area_str);
+    cost = smap_get_int(&route_row->route_info,
+                        OSPF_KEY_ROUTE_COST, OSPF_DEFAULT_COST);
+    vty_out (vty, "N %s %-18s    [%lu] area: %s%s",
+             entry->inter_area ? "IA" : "  ", route_row->prefix,
+             cost, area_str, VTY_NEWLINE);
+}
 
 static void
-ospf_route_router_show(const struct ovsrec_ospf_router *router_row)
+ospf_route_router_print(const struct ospf_route_entry *entry)
 {
-    const struct ovsrec_ospf_route *route_row = NULL;
-    const struct ovsrec_ospf_area *area_row = NULL;
-    int i = 0, j = 0, area_id = 0, count = 0;
+    const struct ovsrec_ospf_route *route_row = entry->row;
     int64_t cost = OSPF_DEFAULT_COST;
     char area_str[OSPF_SHOW_STR_LEN];
     const char *abr = NULL;
     const char *asbr = NULL;
-    struct shash sorted_ospf_route;
-    const struct shash_node **nodes = NULL;
-    const char *port_ip_str;
 
     memset(area_str,'\0', OSPF_SHOW_STR_LEN);
+    ospf_route_area_str(route_row, area_str);
+    cost = smap_get_int(&route_row->route_info,
+                        OSPF_KEY_ROUTE_COST, OSPF_DEFAULT_COST);
+    abr = smap_get(&route_row->route_info, OSPF_KEY_ROUTE_TYPE_ABR);
+    asbr = smap_get(&route_row->route_info, OSPF_KEY_ROUTE_TYPE_ASBR);
+
+    vty_out (vty, "R    %-15s    %s [%lu] area: %s%s%s%s",
+             route_row->prefix,
+             !strcmp(route_row->path_type,
+             OSPF_PATH_TYPE_STRING_INTER_AREA) ? "IA" : "  ",
+             cost, area_str,
+             (abr && !strcmp(abr, "true")) ? ", ABR" : "",
+             (asbr && !strcmp(asbr, "true")) ? ", ASBR" : "",
+             VTY_NEWLINE);
+}
 
-    vty_out (vty, "============ OSPF router routing table =============%s",
-         VTY_NEWLINE);
+static void
+ospf_route_external_print(const struct ospf_route_entry *entry)
+{
+    const struct ovsrec_ospf_route *route_row = entry->row;
+    int64_t cost = OSPF_DEFAULT_COST;
+    const char *val = NULL;
 
-    shash_init(&sorted_ospf_route);
-    OVSREC_OSPF_AREA_FOR_EACH(area_row, idl)
-    {
-        /* Print inter area routes. */
-        for (i = 0; i < area_row->n_router_ospf_routes; i++)
-        {
-            route_row = area_row->router_ospf_routes[i];
-            port_ip_str = route_row->prefix;
-            shash_add(&sorted_ospf_route, port_ip_str, (void *)route_row);
-        }
-    }
+    val = smap_get(&route_row->route_info,
+                            OSPF_KEY_ROUTE_EXT_TYPE);
+    cost = smap_get_int(&route_row->route_info,
+                        OSPF_KEY_ROUTE_COST, OSPF_DEFAULT_COST);
 
-    if (!shash_is_empty(&sorted_ospf_route))
+    if(val && !strcmp(val, OSPF_EXT_TYPE_STRING_TYPE1))
     {
-        count = shash_count(&sorted_ospf_route);
-        nodes = sort_ospf_route(&sorted_ospf_route);
+        vty_out (vty, "N E1 %-18s    [%lu] tag: %u%s",
+                 route_row->prefix,
+                 cost,
+                 smap_get_int(&route_row->route_info,
+                              OSPF_KEY_ROUTE_EXT_TAG, 0),
+                 VTY_NEWLINE);
     }
-    else
+    else if(val && !strcmp(val, OSPF_EXT_TYPE_STRING_TYPE2))
     {
-        count = 0;
+        vty_out (vty, "N E2 %-18s    [%lu/%u] tag: %u%s",
+                 route_row->prefix, cost,
+                 smap_get_int(&route_row->route_info,
+                              OSPF_KEY_ROUTE_TYPE2_COST,
+                              OSPF_ROUTE_TYPE2_COST_DEFAULT),
+                 smap_get_int(&route_row->route_info,
+                              OSPF_KEY_ROUTE_EXT_TAG, 0),
+                 VTY_NEWLINE);
     }
+}
 
-    for (int idx = 0; idx < count; idx++)
-    {
-        route_row = (const struct ovsrec_ospf_route *)nodes[idx]->data;
-        area_id = smap_get_int(&route_row->route_info,
-                               OSPF_KEY_ROUTE_AREA_ID, 0);
-        if (area_id != 0)
-        {
-            OSPF_IP_STRING_CONVERT(area_str, ntohl(area_id));
-        }
-        else
-        {
-            strncpy(area_str, "0.0.0.0", OSPF_SHOW_STR_LEN - 1);
-        }
-
-        cost = smap_get_int(&route_row->route_info,
-                            OSPF_KEY_ROUTE_COST, OSPF_DEFAULT_COST);
-        abr = smap_get(&route_row->route_info, OSPF_KEY_ROUTE_TYPE_ABR);
-        asbr = smap_get(&route_row->route_info, OSPF_KEY_ROUTE_TYPE_ASBR);
+static const struct {
+    const char *title;
+    void (*print)(const struct ospf_route_entry *entry);
+} ospf_route_kinds[OSPF_ROUTE_KIND_MAX] = {
+    [OSPF_ROUTE_KIND_NETWORK] =
+        { "============ OSPF network routing table ============",
+          ospf_route_network_print },
+    [OSPF_ROUTE_KIND_ROUTER] =
+        { "============ OSPF router routing table =============",
+          ospf_route_router_print },
+    [OSPF_ROUTE_KIND_EXTERNAL] =
+        { "============ OSPF external routing table ===========",
+          ospf_route_external_print },
+};
 
-        vty_out (vty, "R    %-15s    %s [%lu] area: %s%s%s%s",
-                 route_row->prefix,
-                 !strcmp(route_row->path_type,
-                 OSPF_PATH_TYPE_STRING_INTER_AREA) ? "IA" : "  ",
-                 cost, area_str,
-                 (abr && !strcmp(abr, "true")) ? ", ABR" : "",
-                 (asbr && !strcmp(asbr, "true")) ? ", ASBR" : "",
-                 VTY_NEWLINE);
+/* Print the routes starting at entry that share its prefix. */
+static void
+ospf_route_entries_show(enum ospf_route_kind kind,
+                        const struct ospf_route_entry *entry)
+{
+    int j = 0;
 
-        for(j = 0; j < route_row->n_paths; j++)
-            vty_out (vty, "%24s   %s%s", "", route_row->paths[j],
-                    VTY_NEWLINE);
+    for (; entry; entry = entry->next_same_prefix)
+    {
+        ospf_route_kinds[kind].print(entry);
+        for(j = 0; j < entry->row->n_paths; j++)
+            vty_out (vty, "%24s   %s%s", "", entry->row->paths[j],
+                     VTY_NEWLINE);
     }
-    SAFE_FREE(nodes);
-    shash_destroy(&sorted_ospf_route);
-
-    vty_out (vty, "%s", VTY_NEWLINE);
 }
 
+/*
+ * Print the routes of one kind straight from the route view: the network
+ * routes area by area, inter area first, each route list in prefix order.
+ * With p, print only the routes of prefix p.
+ */
 static void
-ospf_route_external_show(const struct ovsrec_ospf_router *router_row)
+ospf_route_kind_show(enum ospf_route_kind kind, const struct prefix *p)
 {
-    const struct ovsrec_ospf_route *route_row = NULL;
-    int i = 0, j = 0, area_id = 0, count = 0;
-    int64_t cost = OSPF_DEFAULT_COST;
-    char area_str[OSPF_SHOW_STR_LEN];
-    const char *val = NULL;
-    struct shash sorted_ospf_ext_route;
-    const struct shash_node **nodes = NULL;
-    const char *port_ip_str;
-
-    memset(area_str,'\0', OSPF_SHOW_STR_LEN);
-
-    vty_out (vty, "============ OSPF external routing table ===========%s",
-         VTY_NEWLINE);
+    const struct ospf_route_view *views;
+    struct route_node *node;
+    size_t n_views, i;
 
-    shash_init(&sorted_ospf_ext_route);
-    for (i = 0; i < router_row->n_ext_ospf_routes; i++)
-    {
-        route_row = router_row->ext_ospf_routes[i];
-        port_ip_str = route_row->prefix;
-        shash_add(&sorted_ospf_ext_route, port_ip_str, (void *)route_row);
-    }
+    vty_out (vty, "%s%s", ospf_route_kinds[kind].title, VTY_NEWLINE);
 
-    if (!shash_is_empty(&sorted_ospf_ext_route))
-    {
-        count = shash_count(&sorted_ospf_ext_route);
-        nodes = sort_ospf_route(&sorted_ospf_ext_route);
-    }
-    else
+    n_views = ospf_route_views(&views);
+    for (i = 0; i < n_views; i++)
     {
-        count = 0;
-    }
+        if (views[i].kind != kind)
+            continue;
 
-    /* Print inter area routes. */
-    for (int idx = 0; idx < count; idx++)
-    {
-        route_row = (const struct ovsrec_ospf_route *)nodes[idx]->data;
-        area_id = smap_get_int(&route_row->route_info,
-                               OSPF_KEY_ROUTE_AREA_ID, 0);
-        if (area_id != 0)
+        if (p)
         {
-            OSPF_IP_STRING_CONVERT(area_str, ntohl(area_id));
+            ospf_route_entries_show(kind,
+                                    ospf_route_view_lookup(&views[i], p));
         }
         else
         {
-            strncpy(area_str, "0.0.0.0", OSPF_SHOW_STR_LEN - 1);
+            for (node = route_top(views[i].table); node;
+                 node = route_next(node))
+                ospf_route_entries_show(kind, node->info);
+            ospf_route_entries_show(kind, views[i].unparsed);
         }
+    }
 
-        val = smap_get(&route_row->route_info,
-                                OSPF_KEY_ROUTE_EXT_TYPE);
-        cost = smap_get_int(&route_row->route_info,
-                            OSPF_KEY_ROUTE_COST, OSPF_DEFAULT_COST);
-
-        if(!strcmp(val, OSPF_EXT_TYPE_STRING_TYPE1))
-        {
-            vty_out (vty, "N E1 %-18s    [%lu] tag: %u%s",
-                     route_row->prefix,
-                     cost,
-                     smap_get_int(&route_row->route_info,
-                                  OSPF_KEY_ROUTE_EXT_TAG, 0),
-                     VTY_NEWLINE);
-        }
-        else if(!strcmp(val, OSPF_EXT_TYPE_STRING_TYPE2))
-        {
-            vty_out (vty, "N E2 %-18s    [%lu/%u] tag: %u%s",
-                     route_row->prefix, cost,
-                     smap_get_int(&route_row->route_info,
-                                  OSPF_KEY_ROUTE_TYPE2_COST,
-                                  OSPF_ROUTE_TYPE2_COST_DEFAULT),
-                     smap_get_int(&route_row->route_info,
-                                  OSPF_KEY_ROUTE_EXT_TAG, 0),
-                     VTY_NEWLINE);
-        }
-
-        for(j = 0; j < route_row->n_paths; j++)
-        {
-            vty_out (vty, "%24s   %s%s", "", route_row->paths[j],
-                     VTY_NEWLINE);
-        }
-    }
-    SAFE_FREE(nodes);
-    shash_destroy(&sorted_ospf_ext_route);
-
-    vty_out (vty, "%s", VTY_NEWLINE);
-}
-
+    vty_out (vty, "%s", VTY_NEWLINE);
+}
 
+/*
+ * Show the OSPF routes.  With p, show only the routes of prefix p or, with
+ * longest_match, of the most specific prefix covering p.
+ */
 static int
-ospf_ip_route_show()
+ospf_ip_route_show(const struct prefix *p, bool longest_match)
 {
     const struct ovsrec_ospf_router *ospf_router_row = NULL;
     const struct ovsrec_vrf *vrf_row = NULL;
+    const struct ospf_route_view *views;
+    struct prefix match[OSPF_ROUTE_KIND_MAX];
     int instance_tag = 1;
+    bool found = false;
+    bool kind_found;
+    size_t n_views, i;
+    int kind;
 
     vrf_row = ospf_get_vrf_by_name(DEFAULT_VRF_NAME);
 
@@ -4212,18 +3937,40 @@ ospf_ip_route_show()
         return CMD_SUCCESS;
     }
 
+    ospf_route_view_refresh(ospf_router_row);
+    if (p)
+    {
+        /* The prefix shown for each kind of route: p itself or the most
+         * specific prefix of that kind covering it. */
+        n_views = ospf_route_views(&views);
+        for (kind = 0; kind < OSPF_ROUTE_KIND_MAX; kind++)
+        {
+            kind_found = longest_match
+                         && ospf_route_view_match(kind, p, &match[kind]);
+            if (!kind_found)
+            {
+                prefix_copy(&match[kind], p);
+                for (i = 0; i < n_views && !kind_found; i++)
+                    kind_found =
+                        views[i].kind == kind
+                        && ospf_route_view_lookup(&views[i], p) != NULL;
+            }
+            found |= kind_found;
+        }
+        if (!found)
+        {
+            vty_out (vty, "%% Network not in table%s", VTY_NEWLINE);
+            return CMD_WARNING;
+        }
+    }
+
     vty_out(vty, "%s%s%s%s",
             "Codes: N - Network, R - Router, IA - Inter Area,", VTY_NEWLINE,
             "       E1 - External Type 1, E2 - External Type 2", VTY_NEWLINE);
 
-    /* Show Network routes. */
-    ospf_route_network_show (ospf_router_row);
-
-    /* Show Router routes. */
-    ospf_route_router_show (ospf_router_row);
-
-    /* Show AS External routes. */
-    ospf_route_external_show (ospf_router_row);
+    /* Show Network, Router and AS External routes. */
+    for (kind = 0; kind < OSPF_ROUTE_KIND_MAX; kind++)
+        ospf_route_kind_show(kind, p ? &match[kind] : NULL);
 
     return CMD_SUCCESS;
 
@@ -4574,11 +4321,7 @@ ospf_interface_priority_cmd_execute(const char* ifname,
     OSPF_START_DB_TXN(ospf_router_txn);
 
     /* Get the interface row for the interface name passed. */
-    OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
-    {
-        if (strcmp(ospf_interface_row->name, ifname) == 0)
-            break;
-    }
+    ospf_interface_row = ospf_lookup_ospf_interface(ifname);
 
     if (ospf_interface_row == NULL)
     {
@@ -4644,11 +4387,7 @@ ospf_interface_mtu_ignore_cmd_execute(const char* ifname,
     OSPF_START_DB_TXN(ospf_router_txn);
 
     /* Get the interface row for the interface name passed. */
-    OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
-    {
-        if (strcmp(ospf_interface_row->name, ifname) == 0)
-            break;
-    }
+    ospf_interface_row = ospf_lookup_ospf_interface(ifname);
 
     if (ospf_interface_row == NULL)
     {
@@ -4708,11 +4447,7 @@ ospf_interface_cost_cmd_execute(const char* ifname,
     OSPF_START_DB_TXN(ospf_router_txn);
 
     /* Get the interface row for the interface name passed. */
-    OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
-    {
-        if (strcmp(ospf_interface_row->name, ifname) == 0)
-            break;
-    }
+    ospf_interface_row = ospf_lookup_ospf_interface(ifname);
 
     if (ospf_interface_row == NULL)
     {
@@ -4775,11 +4510,7 @@ ospf_interface_network_cmd_execute(const char* ifname,
     OSPF_START_DB_TXN(ospf_router_txn);
 
     /* Get the interface row for the interface name passed. */
-    OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
-    {
-        if (strcmp(ospf_interface_row->name, ifname) == 0)
-            break;
-    }
+    ospf_interface_row = ospf_lookup_ospf_interface(ifname);
 
     if (ospf_interface_row == NULL)
     {
@@ -5097,11 +4828,7 @@ ospf_interface_auth_cmd_execute(const char* ifname,
     OSPF_START_DB_TXN(ospf_router_txn);
 
     /* Get the interface row for the interface name passed. */
-    OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
-    {
-        if (strcmp(ospf_interface_row->name, ifname) == 0)
-            break;
-    }
+    ospf_interface_row = ospf_lookup_ospf_interface(ifname);
 
     if (ospf_interface_row == NULL)
     {
@@ -5389,11 +5116,7 @@ ospf_interface_auth_key_cmd_execute(const char* ifname, bool no_flag,
     OSPF_START_DB_TXN(ospf_router_txn);
 
     /* Get the interface row for the interface name passed. */
-    OVSREC_OSPF_INTERFACE_FOR_EACH(ospf_interface_row, idl)
-    {
-        if (strcmp(ospf_interface_row->name, ifname) == 0)
-            break;
-    }
+    ospf_interface_row = ospf_lookup_ospf_interface(ifname);
 
     if (ospf_interface_row == NULL)
     {
@@ -5893,12 +5616,13 @@ DEFUN(ospf_timers_no_lsa_group_pacing,
                                               OSPF_LSA_GROUP_PACING_DEFAULT);
 }
 
-DEFUN (cli_ip_ospf_show,
+DEFUN_TABLES (cli_ip_ospf_show,
        cli_ip_ospf_show_cmd,
        "show ip ospf",
        SHOW_STR
        IP_STR
-       OSPF_STR)
+       OSPF_STR,
+       CMD_TABLES_OSPF_LSDB)
 {
     ospf_ip_router_show();
     return CMD_SUCCESS;
@@ -6111,6 +5835,31 @@ void ospf_area_header_print(const struct ovsrec_ospf_area * ospf_area_row,
 }
 
 
+/*
+Function to print the LSAs of a type shown under an area, filtered
+by advertising router and/or link state id, using the LSDB index
+*/
+static void
+ospf_lsdb_detail_show_matching(const struct ovsrec_ospf_router *router_row,
+                               int64_t area_id, int type,
+                               const uint32_t *adv_router,
+                               const uint32_t *ls_id)
+{
+    const struct ospf_lsdb_entry *entries;
+    size_t n, j;
+
+    if (adv_router)
+        entries = ospf_lsdb_find_adv_router(router_row, area_id, type,
+                                            *adv_router, ls_id, &n);
+    else if (ls_id)
+        entries = ospf_lsdb_find_ls_id(router_row, area_id, type, *ls_id, &n);
+    else
+        return;
+
+    for (j = 0; j < n; j++)
+        ospf_lsa_detail_show(entries[j].lsa);
+}
+
 /*Function to print the database summary.*/
 static void
 ospf_lsa_database_detail_show(int type, const char* link_id)
@@ -6122,8 +5871,12 @@ ospf_lsa_database_detail_show(int type, const char* link_id)
    char area_str[OSPF_SHOW_STR_LEN];
    const char *val = NULL;
    int64_t instance_tag = 1;
+   uint32_t ls_id;
+   bool link_id_valid;
    int i, j;
 
+   link_id_valid = ospf_lsdb_addr_parse(link_id, &ls_id);
+
    vrf_row = ospf_get_vrf_by_name(DEFAULT_VRF_NAME);
    router_row = ospf_router_lookup_by_instance_id(vrf_row, instance_tag);
    if (router_row == NULL)
@@ -6208,204 +5961,58 @@ ospf_lsa_database_detail_show(int type, const char* link_id)
               break;
        }
 
+       if(link_id)
+       {
+           if (link_id_valid)
+           {
+               ospf_lsdb_detail_show_matching(router_row,
+                                              router_row->key_areas[i], type,
+                                              NULL, &ls_id);
+           }
+           continue;
+       }
+
        switch(type)
        {
            case OSPF_LSA_LSA_TYPE_TYPE1_ROUTER_LSA:
-           {
                for(j = 0; j < area_row->n_router_lsas; j++)
-               {
-                   if(link_id)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->router_lsas[j]->ls_id));
-                        if((strcmp(area_str, link_id)) == 0)
-                        {
-                            ospf_lsa_detail_show(area_row->router_lsas[j]);
-                        }
-                   }
-                   else
-                   {
-                       ospf_lsa_detail_show(area_row->router_lsas[j]);
-                   }
-               }
+                   ospf_lsa_detail_show(area_row->router_lsas[j]);
                break;
-           }
            case OSPF_LSA_LSA_TYPE_TYPE2_NETWORK_LSA:
-          {
                for(j = 0; j < area_row->n_network_lsas; j++)
-               {
-                   if(link_id)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->network_lsas[j]->ls_id));
-                        if((strcmp(area_str, link_id)) == 0)
-                        {
-                             ospf_lsa_detail_show(area_row->network_lsas[j]);
-                        }
-                    }
-                    else
-                   {
-                        ospf_lsa_detail_show(area_row->network_lsas[j]);
-                   }
-               }
+                   ospf_lsa_detail_show(area_row->network_lsas[j]);
                break;
-          }
-
            case OSPF_LSA_LSA_TYPE_TYPE3_ABR_SUMMARY_LSA:
-           {
                for(j = 0; j < area_row->n_abr_summary_lsas; j++)
-               {
-                   if(link_id)
-                   {
-                         OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->abr_summary_lsas[j]->ls_id));
-                         if((strcmp(area_str, link_id)) == 0)
-                        {
-                             ospf_lsa_detail_show
-                                    (area_row->abr_summary_lsas[j]);
-                        }
-                   }
-                   else
-                   {
-                       ospf_lsa_detail_show(area_row->abr_summary_lsas[j]);
-                   }
-               }
+                   ospf_lsa_detail_show(area_row->abr_summary_lsas[j]);
                break;
-           }
-
            case OSPF_LSA_LSA_TYPE_TYPE4_ASBR_SUMMARY_LSA:
-           {
                for(j = 0; j < area_row->n_asbr_summary_lsas; j++)
-               {
-                    if(link_id)
-                    {
-                            OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->asbr_summary_lsas[j]->ls_id));
-                            if((strcmp(area_str, link_id)) == 0)
-                            {
-                                ospf_lsa_detail_show
-                                    (area_row->asbr_summary_lsas[j]);
-                            }
-                     }
-                     else
-                    {
-                       ospf_lsa_detail_show(area_row->asbr_summary_lsas[j]);
-                   }
-               }
+                   ospf_lsa_detail_show(area_row->asbr_summary_lsas[j]);
                break;
-           }
-
-            case OSPF_LSA_LSA_TYPE_TYPE5_AS_EXTERNAL_LSA:
-           {
+           case OSPF_LSA_LSA_TYPE_TYPE5_AS_EXTERNAL_LSA:
                for(j = 0; j < router_row->n_as_ext_lsas; j++)
-               {
-                    if(link_id)
-                    {
-                           OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(router_row->as_ext_lsas[j]->ls_id));
-                            if((strcmp(area_str, link_id)) == 0)
-                            {
-                                ospf_lsa_detail_show
-                                      (router_row->as_ext_lsas[j]);
-                            }
-                    }
-                    else
-                    {
-                        ospf_lsa_detail_show(router_row->as_ext_lsas[j]);
-                    }
-             }
-             break;
-           }
-
-            case OSPF_LSA_LSA_TYPE_TYPE7_NSSA_LSA:
-           {
+                   ospf_lsa_detail_show(router_row->as_ext_lsas[j]);
+               break;
+           case OSPF_LSA_LSA_TYPE_TYPE7_NSSA_LSA:
                for(j = 0; j < area_row->n_as_nssa_lsas; j++)
-               {
-                   if(link_id)
-                   {
-                          OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->as_nssa_lsas[j]->ls_id));
-                            if((strcmp(area_str, link_id)) == 0)
-                            {
-                                ospf_lsa_detail_show
-                                      (area_row->as_nssa_lsas[j]);
-                            }
-                   }
-                   else
-                   {
-                       ospf_lsa_detail_show(area_row->as_nssa_lsas[j]);
-                   }
-               }
+                   ospf_lsa_detail_show(area_row->as_nssa_lsas[j]);
                break;
-           }
-
            case OSPF_LSA_LSA_TYPE_TYPE9_OPAQUE_LINK_LSA:
-           {
                for(j = 0; j < area_row->n_opaque_link_lsas; j++)
-               {
-                     if(link_id)
-                    {
-                            OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->opaque_link_lsas[j]->ls_id));
-                            if((strcmp(area_str, link_id)) == 0)
-                            {
-                                ospf_lsa_detail_show
-                                     (area_row->opaque_link_lsas[j]);
-                            }
-                        }
-                   else
-                   {
-                          ospf_lsa_detail_show(area_row->opaque_link_lsas[j]);
-                   }
-              }
-              break;
-           }
-
+                   ospf_lsa_detail_show(area_row->opaque_link_lsas[j]);
+               break;
            case OSPF_LSA_LSA_TYPE_TYPE10_OPAQUE_AREA_LSA:
-           {
                for(j = 0; j < area_row->n_opaque_area_lsas; j++)
-               {
-                    if(link_id)
-                       {
-                            OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->opaque_area_lsas[j]->ls_id));
-                            if((strcmp(area_str, link_id)) == 0)
-                            {
-                                ospf_lsa_detail_show
-                                    (area_row->opaque_area_lsas[j]);
-                            }
-                        }
-                   else
-                   {
-                       ospf_lsa_detail_show(area_row->opaque_area_lsas[j]);
-                   }
-               }
+                   ospf_lsa_detail_show(area_row->opaque_area_lsas[j]);
                break;
-           }
            case OSPF_LSA_LSA_TYPE_TYPE11_OPAQUE_AS_LSA:
-          {
                for(j = 0; j < router_row->n_opaque_as_lsas; j++)
-               {
-                   if(link_id)
-                       {
-                            OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(router_row->opaque_as_lsas[j]->ls_id));
-                            if((strcmp(area_str, link_id)) == 0)
-                            {
-                                ospf_lsa_detail_show
-                                    (router_row->opaque_as_lsas[j]);
-                            }
-                        }
-                   else
-                   {
-                       ospf_lsa_detail_show(router_row->opaque_as_lsas[j]);
-                   }
-               }
+                   ospf_lsa_detail_show(router_row->opaque_as_lsas[j]);
                break;
-           }
            default:
                break;
-         }
+       }
     }
 }
 
@@ -6414,11 +6021,12 @@ ospf_ip_maxage_detail_show()
 {
     const struct ovsrec_ospf_router *router_row = NULL;
     const struct ovsrec_ospf_lsa  *lsa_row = NULL;
+    const struct ospf_lsdb_age *maxage_lsas;
     const struct ovsrec_vrf *vrf_row = NULL;
     char area_str[OSPF_SHOW_STR_LEN];
     const char *val = NULL;
-    int64_t ls_age = 0;
     int64_t instance_tag = 1;
+    size_t i, n;
 
     vrf_row = ospf_get_vrf_by_name(DEFAULT_VRF_NAME);
     router_row = ospf_router_lookup_by_instance_id(vrf_row, instance_tag);
@@ -6441,44 +6049,120 @@ ospf_ip_maxage_detail_show()
     vty_out (vty, "%s           MaxAge Link States:%s%s",
                VTY_NEWLINE, VTY_NEWLINE, VTY_NEWLINE);
 
-    OVSREC_OSPF_LSA_FOR_EACH(lsa_row, idl)
+    maxage_lsas = ospf_lsdb_born_before(router_row,
+                                        time(NULL) - OSPF_MAX_LSA_AGE, &n);
+    for (i = 0; i < n; i++)
     {
-        OSPF_LSA_AGE_GET(lsa_row->ls_birth_time, ls_age);
-        if (ls_age >= OSPF_MAX_LSA_AGE)
+        lsa_row = maxage_lsas[i].lsa;
+        if(lsa_row->lsa_type)
         {
-            if(lsa_row->lsa_type)
-            {
-                 vty_out (vty, "  Link type: %s%s",
-                     ospf_lsa_type_print(lsa_row->lsa_type), VTY_NEWLINE);
-            }
-            if(lsa_row->ls_id)
-            {
-                OSPF_IP_STRING_CONVERT(area_str, ntohl(lsa_row->ls_id));
-                vty_out (vty, "  Link State ID: %s%s",
-                              area_str, VTY_NEWLINE);
-            }
-            else
-            {
-                vty_out (vty, "  Link State ID: %s%s",
-                          OSPF_DEFAULT_NULL_STR, VTY_NEWLINE);
-            }
-            if(lsa_row->adv_router)
-            {
-                OSPF_IP_STRING_CONVERT(area_str, ntohl(lsa_row->adv_router));
-                vty_out (vty, "  Advertising Router: %s%s",
-                           area_str,VTY_NEWLINE);
-            }
-            else
-            {
-                vty_out (vty, "   Advertising Router: %s%s",
-                                        OSPF_DEFAULT_NULL_STR, VTY_NEWLINE);
-            }
-            vty_out(vty, "%s", VTY_NEWLINE);
+             vty_out (vty, "  Link type: %s%s",
+                 ospf_lsa_type_print(lsa_row->lsa_type), VTY_NEWLINE);
+        }
+        if(lsa_row->ls_id)
+        {
+            OSPF_IP_STRING_CONVERT(area_str, ntohl(lsa_row->ls_id));
+            vty_out (vty, "  Link State ID: %s%s",
+                          area_str, VTY_NEWLINE);
         }
+        else
+        {
+            vty_out (vty, "  Link State ID: %s%s",
+                      OSPF_DEFAULT_NULL_STR, VTY_NEWLINE);
+        }
+        if(lsa_row->adv_router)
+        {
+            OSPF_IP_STRING_CONVERT(area_str, ntohl(lsa_row->adv_router));
+            vty_out (vty, "  Advertising Router: %s%s",
+                       area_str,VTY_NEWLINE);
+        }
+        else
+        {
+            vty_out (vty, "   Advertising Router: %s%s",
+                                    OSPF_DEFAULT_NULL_STR, VTY_NEWLINE);
+        }
+        vty_out(vty, "%s", VTY_NEWLINE);
+    }
+}
+
+static void
+ospf_ip_database_statistics_show()
+{
+    const struct ovsrec_ospf_router *router_row = NULL;
+    const struct ovsrec_vrf *vrf_row = NULL;
+    size_t histogram[OSPF_MAX_LSA_AGE / OSPF_LSA_AGE_BUCKET + 1];
+    size_t n_buckets = ARRAY_SIZE(histogram);
+    size_t total, refresh_due = 0;
+    const char *val = NULL;
+    int64_t instance_tag = 1;
+    char age_str[OSPF_SHOW_STR_LEN];
+    size_t i;
+
+    vrf_row = ospf_get_vrf_by_name(DEFAULT_VRF_NAME);
+    router_row = ospf_router_lookup_by_instance_id(vrf_row, instance_tag);
+    if (router_row == NULL)
+    {
+        vty_out (vty, " OSPF Routing Process not enabled%s", VTY_NEWLINE);
+        return;
     }
+    val = smap_get(&router_row->router_id, OSPF_KEY_ROUTER_ID_VAL);
+    if(val)
+    {
+        vty_out (vty, "%s       OSPF Router with ID (%s)%s%s", VTY_NEWLINE,
+                 val, VTY_NEWLINE, VTY_NEWLINE);
+    }
+    else
+    {
+        vty_out (vty, "%s       OSPF Router%s%s", VTY_NEWLINE,
+                 VTY_NEWLINE, VTY_NEWLINE);
+    }
+
+    /* The last bucket holds the LSAs that reached MaxAge. */
+    total = ospf_lsdb_age_histogram(router_row, time(NULL),
+                                    OSPF_LSA_AGE_BUCKET, histogram,
+                                    n_buckets);
+    for (i = OSPF_LS_REFRESH_TIME / OSPF_LSA_AGE_BUCKET;
+         i < n_buckets - 1; i++)
+    {
+        refresh_due += histogram[i];
+    }
+
+    vty_out (vty, "           Link State Database Statistics%s%s",
+             VTY_NEWLINE, VTY_NEWLINE);
+    vty_out (vty, "  %-28s : %zu%s", "Total LSAs", total, VTY_NEWLINE);
+    vty_out (vty, "  %-28s : %zu%s", "MaxAge LSAs",
+             histogram[n_buckets - 1], VTY_NEWLINE);
+    vty_out (vty, "  %-28s : %zu%s", "LSAs past LSRefreshTime",
+             refresh_due, VTY_NEWLINE);
+    vty_out (vty, "%s  %-16s %s%s", VTY_NEWLINE, "Age (seconds)", "LSAs",
+             VTY_NEWLINE);
+    vty_out (vty, "  --------------------------%s", VTY_NEWLINE);
+    for (i = 0; i < n_buckets - 1; i++)
+    {
+        snprintf(age_str, OSPF_SHOW_STR_LEN, "%zu-%zu",
+                 i * OSPF_LSA_AGE_BUCKET, (i + 1) * OSPF_LSA_AGE_BUCKET - 1);
+        vty_out (vty, "  %-16s %zu%s", age_str, histogram[i], VTY_NEWLINE);
+    }
+    snprintf(age_str, OSPF_SHOW_STR_LEN, "%d (MaxAge)", OSPF_MAX_LSA_AGE);
+    vty_out (vty, "  %-16s %zu%s", age_str, histogram[n_buckets - 1],
+             VTY_NEWLINE);
+}
+
+DEFUN_TABLES(cli_show_ip_ospf_database_statistics,
+      cli_show_ip_ospf_database_statistics_cmd,
+      "show ip ospf database statistics",
+      SHOW_STR
+      IP_STR
+      OSPF_STR
+      "Database summary\n"
+      "LSA counts by age\n",
+      CMD_TABLES_OSPF_LSDB)
+{
+    ospf_ip_database_statistics_show();
+    return CMD_SUCCESS;
 }
 
-DEFUN(cli_ip_ospf_database,
+DEFUN_TABLES(cli_ip_ospf_database,
        cli_ip_ospf_database_type_id_cmd,
        "show ip ospf database (" OSPF_LSA_TYPES_CMD_STR "|max-age)" ,
        SHOW_STR
@@ -6487,7 +6171,8 @@ DEFUN(cli_ip_ospf_database,
        "Database summary\n"
        OSPF_LSA_TYPES_DESC
        "LSAs in MaxAge list\n"
-       )
+       ,
+       CMD_TABLES_OSPF_LSDB)
 {
     if(argv[0] && !strcmp(argv[0], "router" ))
         ospf_lsa_database_detail_show
@@ -6524,7 +6209,7 @@ DEFUN(cli_ip_ospf_database,
     return CMD_SUCCESS;
 }
 
-DEFUN(cli_ip_ospf_database_id,
+DEFUN_TABLES(cli_ip_ospf_database_id,
          cli_ip_ospf_database_type_link_id_cmd,
          "show ip ospf database (" OSPF_LSA_TYPES_CMD_STR ") A.B.C.D" ,
          SHOW_STR
@@ -6533,7 +6218,8 @@ DEFUN(cli_ip_ospf_database_id,
          "Database summary\n"
          OSPF_LSA_TYPES_DESC
          "Link State ID (as an IPv4 address)\n"
-        )
+        ,
+         CMD_TABLES_OSPF_LSDB)
 {
      if(argv[0] && !strcmp(argv[0], "router" ))
          ospf_lsa_database_detail_show
@@ -6581,7 +6267,9 @@ ospf_print_self_originate_link_states(int type)
    char area_str[OSPF_SHOW_STR_LEN];
    const char *val = NULL;
    int64_t instance_tag = 1;
-   int i, j;
+   uint32_t router_id;
+   bool router_id_valid;
+   int i;
 
    vrf_row = ospf_get_vrf_by_name(DEFAULT_VRF_NAME);
    router_row = ospf_router_lookup_by_instance_id(vrf_row, instance_tag);
@@ -6592,6 +6280,7 @@ ospf_print_self_originate_link_states(int type)
    }
 
    val = smap_get(&router_row->router_id, OSPF_KEY_ROUTER_ID_VAL);
+   router_id_valid = ospf_lsdb_addr_parse(val, &router_id);
    if(val)
    {
       vty_out (vty, "%s       OSPF Router with ID (%s)%s%s", VTY_NEWLINE,
@@ -6666,174 +6355,17 @@ ospf_print_self_originate_link_states(int type)
            default:
               break;
     }
-       switch(type)
+       if (router_id_valid)
        {
-           case OSPF_LSA_LSA_TYPE_TYPE1_ROUTER_LSA:
-           {
-               for(j = 0; j < area_row->n_router_lsas; j++)
-               {
-                    if(val)
-                    {
-                         OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->router_lsas[j]->adv_router));
-                          if((strcmp(area_str, val)) == 0)
-                          {
-                              ospf_lsa_detail_show(area_row->router_lsas[j]);
-                          }
-                    }
-                }
-                break;
-            }
-           case OSPF_LSA_LSA_TYPE_TYPE2_NETWORK_LSA:
-          {
-               for(j = 0; j < area_row->n_network_lsas; j++)
-               {
-                   if(val)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->network_lsas[j]->adv_router));
-                        if((strcmp(area_str, val)) == 0)
-                        {
-                             ospf_lsa_detail_show(area_row->network_lsas[j]);
-                        }
-                    }
-                }
-                break;
-           }
-
-           case OSPF_LSA_LSA_TYPE_TYPE3_ABR_SUMMARY_LSA:
-           {
-               for(j = 0; j < area_row->n_abr_summary_lsas; j++)
-               {
-                   if(val)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->abr_summary_lsas[j]->adv_router));
-                         if((strcmp(area_str, val)) == 0)
-                        {
-                             ospf_lsa_detail_show
-                                    (area_row->abr_summary_lsas[j]);
-                        }
-                    }
-                }
-                break;
-            }
-
-           case OSPF_LSA_LSA_TYPE_TYPE4_ASBR_SUMMARY_LSA:
-           {
-               for(j = 0; j < area_row->n_asbr_summary_lsas; j++)
-               {
-                  if(val)
-                  {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->asbr_summary_lsas[j]->adv_router));
-                        if((strcmp(area_str, val)) == 0)
-                        {
-                             ospf_lsa_detail_show
-                                  (area_row->asbr_summary_lsas[j]);
-                         }
-                    }
-                }
-                break;
-            }
-
-           case OSPF_LSA_LSA_TYPE_TYPE5_AS_EXTERNAL_LSA:
-           {
-               for(j = 0; j < router_row->n_as_ext_lsas; j++)
-               {
-                    if(val)
-                    {
-                         OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(router_row->as_ext_lsas[j]->adv_router));
-                         if((strcmp(area_str, val)) == 0)
-                         {
-                              ospf_lsa_detail_show
-                                      (router_row->as_ext_lsas[j]);
-                         }
-                     }
-                }
-                break;
-            }
-
-            case OSPF_LSA_LSA_TYPE_TYPE7_NSSA_LSA:
-           {
-               for(j = 0; j < area_row->n_as_nssa_lsas; j++)
-               {
-                   if(val)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->as_nssa_lsas[j]->adv_router));
-                         if((strcmp(area_str, val)) == 0)
-                         {
-                              ospf_lsa_detail_show
-                                      (area_row->as_nssa_lsas[j]);
-                         }
-                    }
-                }
-                break;
-            }
-
-           case OSPF_LSA_LSA_TYPE_TYPE9_OPAQUE_LINK_LSA:
-           {
-               for(j = 0; j < area_row->n_opaque_link_lsas; j++)
-               {
-                   if(val)
-                   {
-                         OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->opaque_link_lsas[j]->adv_router));
-                         if((strcmp(area_str, val)) == 0)
-                         {
-                              ospf_lsa_detail_show
-                                     (area_row->opaque_link_lsas[j]);
-                         }
-                    }
-               }
-               break;
-           }
-
-           case OSPF_LSA_LSA_TYPE_TYPE10_OPAQUE_AREA_LSA:
-           {
-               for(j = 0; j < area_row->n_opaque_area_lsas; j++)
-               {
-                   if(val)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->opaque_area_lsas[j]->adv_router));
-                        if((strcmp(area_str, val)) == 0)
-                        {
-                             ospf_lsa_detail_show
-                                    (area_row->opaque_area_lsas[j]);
-                        }
-                    }
-                }
-                break;
-            }
-           case OSPF_LSA_LSA_TYPE_TYPE11_OPAQUE_AS_LSA:
-          {
-               for(j = 0; j < router_row->n_opaque_as_lsas; j++)
-               {
-                   if(val)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(router_row->opaque_as_lsas[j]->adv_router));
-                        if((strcmp(area_str, val)) == 0)
-                        {
-                              ospf_lsa_detail_show
-                                    (router_row->opaque_as_lsas[j]);
-                         }
-                    }
-                }
-                break;
-           }
-
-           default:
-               break;
-         }
+           ospf_lsdb_detail_show_matching(router_row,
+                                          router_row->key_areas[i], type,
+                                          &router_id, NULL);
+       }
     }
 }
 
 
-DEFUN(cli_ip_ospf_database_self_originate,
+DEFUN_TABLES(cli_ip_ospf_database_self_originate,
          cli_ip_ospf_database_self_originate_cmd,
        "show ip ospf database (" OSPF_LSA_TYPES_CMD_STR ") self-originate",
        SHOW_STR
@@ -6841,7 +6373,8 @@ DEFUN(cli_ip_ospf_database_self_originate,
        OSPF_STR
        "Database summary\n"
        OSPF_LSA_TYPES_DESC
-       "Self-originated link states\n")
+       "Self-originated link states\n",
+         CMD_TABLES_OSPF_LSDB)
 {
      if(argv[0] && !strcmp(argv[0], "router" ))
          ospf_print_self_originate_link_states
@@ -6888,9 +6421,10 @@ ospf_print_self_originate_match_link_id(int type, const char* link_id)
    const struct ovsrec_vrf *vrf_row = NULL;
    char area_str[OSPF_SHOW_STR_LEN];
    const char *val = NULL;
-   char ls_str[OSPF_SHOW_STR_LEN];
    int64_t instance_tag = 1;
-   int i, j;
+   uint32_t router_id, ls_id;
+   bool router_id_valid, link_id_valid;
+   int i;
 
    vrf_row = ospf_get_vrf_by_name(DEFAULT_VRF_NAME);
    router_row = ospf_router_lookup_by_instance_id(vrf_row, instance_tag);
@@ -6901,6 +6435,8 @@ ospf_print_self_originate_match_link_id(int type, const char* link_id)
    }
 
    val = smap_get(&router_row->router_id, OSPF_KEY_ROUTER_ID_VAL);
+   router_id_valid = ospf_lsdb_addr_parse(val, &router_id);
+   link_id_valid = ospf_lsdb_addr_parse(link_id, &ls_id);
    if(val)
    {
       vty_out (vty, "%s       OSPF Router with ID (%s)%s%s", VTY_NEWLINE,
@@ -6975,201 +6511,17 @@ ospf_print_self_originate_match_link_id(int type, const char* link_id)
            default:
               break;
     }
-       switch(type)
+       if (router_id_valid && link_id_valid)
        {
-           case OSPF_LSA_LSA_TYPE_TYPE1_ROUTER_LSA:
-           {
-               for(j = 0; j < area_row->n_router_lsas; j++)
-               {
-                    OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->router_lsas[j]->adv_router));
-                    OSPF_IP_STRING_CONVERT(ls_str,
-                                ntohl(area_row->router_lsas[j]->ls_id));
-                    if(val)
-                    {
-                         if(((strcmp(area_str, val)) == 0) &&
-                                       (strcmp(link_id, ls_str) == 0))
-                         {
-                              ospf_lsa_detail_show(area_row->router_lsas[j]);
-                         }
-                    }
-                }
-                break;
-            }
-           case OSPF_LSA_LSA_TYPE_TYPE2_NETWORK_LSA:
-           {
-               for(j = 0; j < area_row->n_network_lsas; j++)
-               {
-                    OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->network_lsas[j]->adv_router));
-                    OSPF_IP_STRING_CONVERT(ls_str,
-                                ntohl(area_row->network_lsas[j]->ls_id));
-                    if(val)
-                    {
-                         if(((strcmp(area_str, val)) == 0) &&
-                                         (strcmp(link_id, ls_str) == 0))
-                         {
-                              ospf_lsa_detail_show(area_row->network_lsas[j]);
-                         }
-                     }
-                }
-                break;
-            }
-
-           case OSPF_LSA_LSA_TYPE_TYPE3_ABR_SUMMARY_LSA:
-           {
-               for(j = 0; j < area_row->n_abr_summary_lsas; j++)
-               {
-                     OSPF_IP_STRING_CONVERT(area_str,
-                            ntohl(area_row->abr_summary_lsas[j]->adv_router));
-                     OSPF_IP_STRING_CONVERT(ls_str,
-                            ntohl(area_row->abr_summary_lsas[j]->ls_id));
-                     if(val)
-                     {
-                          if(((strcmp(area_str, val)) == 0) &&
-                                      (strcmp(link_id, ls_str) == 0))
-                          {
-                               ospf_lsa_detail_show
-                                     (area_row->abr_summary_lsas[j]);
-                          }
-                      }
-                 }
-                 break;
-             }
-
-           case OSPF_LSA_LSA_TYPE_TYPE4_ASBR_SUMMARY_LSA:
-           {
-               for(j = 0; j < area_row->n_asbr_summary_lsas; j++)
-               {
-                   if(val)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                          ntohl(area_row->asbr_summary_lsas[j]->adv_router));
-                        OSPF_IP_STRING_CONVERT(ls_str,
-                          ntohl(area_row->asbr_summary_lsas[j]->ls_id));
-                        if(((strcmp(area_str, val)) == 0) &&
-                                     (strcmp(link_id, ls_str) == 0))
-                        {
-                              ospf_lsa_detail_show
-                                    (area_row->asbr_summary_lsas[j]);
-                        }
-                    }
-               }
-               break;
-           }
-
-            case OSPF_LSA_LSA_TYPE_TYPE5_AS_EXTERNAL_LSA:
-           {
-               for(j = 0; j < router_row->n_as_ext_lsas; j++)
-               {
-                   if(val)
-                   {
-                         OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(router_row->as_ext_lsas[j]->adv_router));
-                         OSPF_IP_STRING_CONVERT(ls_str,
-                                ntohl(router_row->as_ext_lsas[j]->ls_id));
-                          if(((strcmp(area_str, val)) == 0) &&
-                                     (strcmp(link_id, ls_str) == 0))
-                          {
-                                ospf_lsa_detail_show
-                                      (router_row->as_ext_lsas[j]);
-                          }
-                    }
-               }
-               break;
-             }
-
-            case OSPF_LSA_LSA_TYPE_TYPE7_NSSA_LSA:
-           {
-               for(j = 0; j < area_row->n_as_nssa_lsas; j++)
-               {
-                    if(val)
-                    {
-                          OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->as_nssa_lsas[j]->adv_router));
-                          OSPF_IP_STRING_CONVERT(ls_str,
-                                ntohl(area_row->as_nssa_lsas[j]->ls_id));
-                          if(((strcmp(area_str, val)) == 0) &&
-                                     (strcmp(link_id, ls_str) == 0))
-                          {
-                               ospf_lsa_detail_show
-                                      (area_row->as_nssa_lsas[j]);
-                          }
-                     }
-               }
-               break;
-           }
-
-           case OSPF_LSA_LSA_TYPE_TYPE9_OPAQUE_LINK_LSA:
-           {
-                for(j = 0; j < area_row->n_opaque_link_lsas; j++)
-                {
-                    if(val)
-                    {
-                         OSPF_IP_STRING_CONVERT(area_str,
-                            ntohl(area_row->opaque_link_lsas[j]->adv_router));
-                         OSPF_IP_STRING_CONVERT(ls_str,
-                            ntohl(area_row->opaque_link_lsas[j]->ls_id));
-                         if(((strcmp(area_str, val)) == 0) &&
-                                     (strcmp(link_id, ls_str) == 0))
-                         {
-                              ospf_lsa_detail_show
-                                     (area_row->opaque_link_lsas[j]);
-                         }
-                     }
-                 }
-                 break;
-             }
-
-           case OSPF_LSA_LSA_TYPE_TYPE10_OPAQUE_AREA_LSA:
-           {
-               for(j = 0; j < area_row->n_opaque_area_lsas; j++)
-               {
-                   if(val)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                           ntohl(area_row->opaque_area_lsas[j]->adv_router));
-                        OSPF_IP_STRING_CONVERT(ls_str,
-                           ntohl(area_row->opaque_area_lsas[j]->ls_id));
-                        if(((strcmp(area_str, val)) == 0) &&
-                                     (strcmp(link_id, ls_str) == 0))
-                        {
-                             ospf_lsa_detail_show
-                                    (area_row->opaque_area_lsas[j]);
-                        }
-                    }
-                }
-               break;
-            }
-           case OSPF_LSA_LSA_TYPE_TYPE11_OPAQUE_AS_LSA:
-          {
-               for(j = 0; j < router_row->n_opaque_as_lsas; j++)
-               {
-                   if(val)
-                   {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                           ntohl(router_row->opaque_as_lsas[j]->adv_router));
-                        OSPF_IP_STRING_CONVERT(ls_str,
-                           ntohl(router_row->opaque_as_lsas[j]->ls_id));
-                        if(((strcmp(area_str, val)) == 0) &&
-                                     (strcmp(link_id, ls_str) == 0))
-                        {
-                             ospf_lsa_detail_show
-                                    (router_row->opaque_as_lsas[j]);
-                         }
-                    }
-               }
-               break;
-            }
-
-           default:
-               break;
-         }
+           ospf_lsdb_detail_show_matching(router_row,
+                                          router_row->key_areas[i], type,
+                                          &router_id, &ls_id);
+       }
     }
 }
 
 
-DEFUN (cli_show_ip_ospf_database_self,
+DEFUN_TABLES (cli_show_ip_ospf_database_self,
        cli_show_ip_ospf_database_type_id_self_originate_cmd,
        "show ip ospf database (" OSPF_LSA_TYPES_CMD_STR ") A.B.C.D self-originate",
        SHOW_STR
@@ -7178,7 +6530,8 @@ DEFUN (cli_show_ip_ospf_database_self,
        "Database summary\n"
        OSPF_LSA_TYPES_DESC
        "Link State ID (as an IPv4 address)\n"
-       "Self-originated link states\n")
+       "Self-originated link states\n",
+       CMD_TABLES_OSPF_LSDB)
 {
     if(argv[0] && !strcmp(argv[0], "router" ))
         ospf_print_self_originate_match_link_id
@@ -7568,14 +6921,15 @@ ospf_ip_database_show_self_originate()
 
 }
 
-DEFUN (cli_show_ip_ospf_database_self_originate,
+DEFUN_TABLES (cli_show_ip_ospf_database_self_originate,
        cli_show_ip_ospf_database_cmd_self_originate,
        "show ip ospf database self-originate",
        SHOW_STR
        IP_STR
        OSPF_STR
        "Database summary\n"
-       "Self-originated link states\n")
+       "Self-originated link states\n",
+       CMD_TABLES_OSPF_LSDB)
 {
      ospf_ip_database_show_self_originate();
      return CMD_SUCCESS;
@@ -7594,7 +6948,11 @@ ospf_adv_router_display(int type, const char* adv_router)
     char area_str[OSPF_SHOW_STR_LEN];
     const char *val = NULL;
     int64_t instance_tag = 1;
-    int i, j;
+    uint32_t adv_router_id;
+    bool adv_router_valid;
+    int i;
+
+    adv_router_valid = ospf_lsdb_addr_parse(adv_router, &adv_router_id);
 
     vrf_row = ospf_get_vrf_by_name(DEFAULT_VRF_NAME);
     router_row = ospf_router_lookup_by_instance_id(vrf_row, instance_tag);
@@ -7679,139 +7037,16 @@ ospf_adv_router_display(int type, const char* adv_router)
              default:
                  break;
          }
-         switch(type)
+         if (adv_router_valid)
          {
-             case OSPF_LSA_LSA_TYPE_TYPE1_ROUTER_LSA:
-             {
-                 for(j = 0; j < area_row->n_router_lsas; j++)
-                 {
-                     OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->router_lsas[j]->adv_router));
-                     if((strcmp(area_str, adv_router)) == 0)
-                     {
-                         ospf_lsa_detail_show(area_row->router_lsas[j]);
-                     }
-                 }
-                 break;
-             }
-             case OSPF_LSA_LSA_TYPE_TYPE2_NETWORK_LSA:
-             {
-                 for(j = 0; j < area_row->n_network_lsas; j++)
-                 {
-                     OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->network_lsas[j]->adv_router));
-                     if((strcmp(area_str, adv_router)) == 0)
-                     {
-                         ospf_lsa_detail_show(area_row->network_lsas[j]);
-                     }
-                 }
-                 break;
-             }
-             case OSPF_LSA_LSA_TYPE_TYPE3_ABR_SUMMARY_LSA:
-             {
-                 for(j = 0; j < area_row->n_abr_summary_lsas; j++)
-                 {
-                      OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->abr_summary_lsas[j]->adv_router));
-                      if((strcmp(area_str, adv_router)) == 0)
-                      {
-                             ospf_lsa_detail_show
-                                    (area_row->abr_summary_lsas[j]);
-                      }
-                 }
-                 break;
-             }
-             case OSPF_LSA_LSA_TYPE_TYPE4_ASBR_SUMMARY_LSA:
-             {
-                 for(j = 0; j < area_row->n_asbr_summary_lsas; j++)
-                 {
-                       OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->asbr_summary_lsas[j]->adv_router));
-                       if((strcmp(area_str, adv_router)) == 0)
-                       {
-                              ospf_lsa_detail_show
-                                   (area_row->asbr_summary_lsas[j]);
-                       }
-                 }
-                 break;
-             }
-             case OSPF_LSA_LSA_TYPE_TYPE5_AS_EXTERNAL_LSA:
-             {
-                 for(j = 0; j < router_row->n_as_ext_lsas; j++)
-                 {
-                        OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(router_row->as_ext_lsas[j]->adv_router));
-                        if((strcmp(area_str, adv_router)) == 0)
-                        {
-                               ospf_lsa_detail_show
-                                      (router_row->as_ext_lsas[j]);
-                         }
-                }
-                break;
-             }
-             case OSPF_LSA_LSA_TYPE_TYPE7_NSSA_LSA:
-             {
-                 for(j = 0; j < area_row->n_as_nssa_lsas; j++)
-                 {
-                         OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->as_nssa_lsas[j]->adv_router));
-                         if((strcmp(area_str, adv_router)) == 0)
-                         {
-                                ospf_lsa_detail_show
-                                      (area_row->as_nssa_lsas[j]);
-                         }
-                 }
-                 break;
-             }
-             case OSPF_LSA_LSA_TYPE_TYPE9_OPAQUE_LINK_LSA:
-             {
-                 for(j = 0; j < area_row->n_opaque_link_lsas; j++)
-                 {
-                          OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->opaque_link_lsas[j]->adv_router));
-                          if((strcmp(area_str, adv_router)) == 0)
-                          {
-                                ospf_lsa_detail_show
-                                     (area_row->opaque_link_lsas[j]);
-                          }
-                 }
-                 break;
-             }
-             case OSPF_LSA_LSA_TYPE_TYPE10_OPAQUE_AREA_LSA:
-             {
-                 for(j = 0; j < area_row->n_opaque_area_lsas; j++)
-                 {
-                          OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(area_row->opaque_area_lsas[j]->adv_router));
-                          if((strcmp(area_str, adv_router)) == 0)
-                          {
-                               ospf_lsa_detail_show
-                                    (area_row->opaque_area_lsas[j]);
-                          }
-                  }
-                  break;
-            }
-            case OSPF_LSA_LSA_TYPE_TYPE11_OPAQUE_AS_LSA:
-            {
-                  for(j = 0; j < router_row->n_opaque_as_lsas; j++)
-                  {
-                          OSPF_IP_STRING_CONVERT(area_str,
-                                ntohl(router_row->opaque_as_lsas[j]->adv_router));
-                          if((strcmp(area_str, adv_router)) == 0)
-                          {
-                               ospf_lsa_detail_show
-                                    (router_row->opaque_as_lsas[j]);
-                          }
-                 }
-                 break;
-            }
-            default:
-                break;
-        }
+             ospf_lsdb_detail_show_matching(router_row,
+                                            router_row->key_areas[i], type,
+                                            &adv_router_id, NULL);
+         }
     }
 }
 
-DEFUN(show_ip_ospf_database,
+DEFUN_TABLES(show_ip_ospf_database,
        show_ip_ospf_database_type_id_adv_router_cmd,
        "show ip ospf database (" OSPF_LSA_TYPES_CMD_STR ") adv-router A.B.C.D",
        SHOW_STR
@@ -7820,7 +7055,8 @@ DEFUN(show_ip_ospf_database,
        "Database summary\n"
        OSPF_LSA_TYPES_DESC
        "Advertising Router link states\n"
-       "Advertising Router (as an IPv4 address)\n")
+       "Advertising Router (as an IPv4 address)\n",
+       CMD_TABLES_OSPF_LSDB)
 {
 
     if(argv[0] && !strcmp(argv[0], "router" ))
@@ -8057,13 +7293,14 @@ ospf_ip_database_show()
 
 }
 
-DEFUN (cli_show_ip_ospf_database,
+DEFUN_TABLES (cli_show_ip_ospf_database,
        cli_show_ip_ospf_database_cmd,
        "show ip ospf database",
        SHOW_STR
        IP_STR
        OSPF_STR
-       "Database summary\n")
+       "Database summary\n",
+       CMD_TABLES_OSPF_LSDB)
 {
      ospf_ip_database_show();
      return CMD_SUCCESS;
@@ -8308,15 +7545,56 @@ DEFUN (cli_ip_ospf_nbr_nbrid_detail_show,
 }
 
 
-DEFUN (cli_ip_ospf_route_show,
+DEFUN_TABLES (cli_ip_ospf_route_show,
        cli_ip_ospf_route_show_cmd,
        "show ip ospf route",
        SHOW_STR
        IP_STR
        OSPF_STR
-       ROUTE_STR)
+       ROUTE_STR,
+       CMD_TABLES_OSPF_LSDB)
+{
+    return ospf_ip_route_show(NULL, false);
+}
+
+DEFUN_TABLES (cli_ip_ospf_route_prefix_show,
+       cli_ip_ospf_route_prefix_show_cmd,
+       "show ip ospf route A.B.C.D/M",
+       SHOW_STR
+       IP_STR
+       OSPF_STR
+       ROUTE_STR
+       "IP prefix <network>/<length>, e.g., 35.0.0.0/8\n",
+       CMD_TABLES_OSPF_LSDB)
 {
-    return ospf_ip_route_show();
+    struct prefix p;
+
+    if (str2prefix_ipv4(argv[0], (struct prefix_ipv4 *)&p) <= 0)
+    {
+        vty_out (vty, "%% Malformed prefix%s", VTY_NEWLINE);
+        return CMD_WARNING;
+    }
+    return ospf_ip_route_show(&p, false);
+}
+
+DEFUN_TABLES (cli_ip_ospf_route_addr_show,
+       cli_ip_ospf_route_addr_show_cmd,
+       "show ip ospf route A.B.C.D",
+       SHOW_STR
+       IP_STR
+       OSPF_STR
+       ROUTE_STR
+       "Network in the OSPF routing table to display\n",
+       CMD_TABLES_OSPF_LSDB)
+{
+    struct prefix p;
+
+    if (str2prefix_ipv4(argv[0], (struct prefix_ipv4 *)&p) <= 0)
+    {
+        vty_out (vty, "%% Malformed address%s", VTY_NEWLINE);
+        return CMD_WARNING;
+    }
+    return ospf_ip_route_show(&p, true);
 }
 
 
@@ -9932,8 +9210,11 @@ ospf_vty_init(void)
     install_element(ENABLE_NODE, &cli_ip_ospf_nbr_nbrid_detail_all_show_cmd);
     install_element(ENABLE_NODE, &cli_ip_ospf_nbr_nbrid_detail_show_cmd);
     install_element(ENABLE_NODE, &cli_ip_ospf_route_show_cmd);
+    install_element(ENABLE_NODE, &cli_ip_ospf_route_prefix_show_cmd);
+    install_element(ENABLE_NODE, &cli_ip_ospf_route_addr_show_cmd);
     install_element(ENABLE_NODE, &cli_ip_ospf_database_type_id_cmd);
     install_element(ENABLE_NODE, &cli_show_ip_ospf_database_cmd);
+    install_element(ENABLE_NODE, &cli_show_ip_ospf_database_statistics_cmd);
     install_element(ENABLE_NODE, &cli_ip_ospf_database_type_link_id_cmd);
     install_element(ENABLE_NODE, &show_ip_ospf_database_type_id_adv_router_cmd);
     install_element(ENABLE_NODE, &cli_ip_ospf_database_self_originate_cmd);
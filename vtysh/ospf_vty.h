@@ -216,6 +216,8 @@ cli_command_result (enum ovsdb_idl_txn_status status)
 }
 
 #define OSPF_MAX_LSA_AGE    3600
+#define OSPF_LS_REFRESH_TIME 1800
+#define OSPF_LSA_AGE_BUCKET 300  /* Width of the database statistics age buckets. */
 #define OSPF_LSA_AGE(LSA_BIRTH, LSA_AGE)                                      \
 {                                                                             \
     int64_t time_1 = time(NULL);                                              \
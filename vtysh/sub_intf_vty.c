@@ -53,6 +53,7 @@
 #include "vtysh/utils/vlan_vtysh_utils.h"
 #include "vtysh/utils/intf_vtysh_utils.h"
 #include "vtysh/utils/l3_vtysh_utils.h"
+#include "vtysh/utils/sub_intf_vtysh_utils.h"
 
 VLOG_DEFINE_THIS_MODULE (vtysh_sub_intf_cli);
 extern struct ovsdb_idl *idl;
@@ -86,44 +87,38 @@ DEFUN (cli_sub_intf_shutdown,
         return CMD_OVSDB_FAILURE;
     }
 
-    OVSREC_INTERFACE_FOR_EACH(row, idl)
+    row = sub_intf_index_interface((char*)vty->index);
+    if (row)
     {
-        if (strcmp(row->name, (char*)vty->index) == 0)
-        {
-            smap_clone(&smap_user_config, &row->user_config);
+        smap_clone(&smap_user_config, &row->user_config);
 
-            if (vty_flags & CMD_FLAG_NO_CMD)
-            {
-                smap_replace(&smap_user_config,
-                        INTERFACE_USER_CONFIG_MAP_ADMIN,
-                        OVSREC_INTERFACE_USER_CONFIG_ADMIN_UP);
-            }
-            else
-            {
-                smap_remove(&smap_user_config,
-                        INTERFACE_USER_CONFIG_MAP_ADMIN);
-            }
-            ovsrec_interface_set_user_config(row, &smap_user_config);
-            smap_destroy(&smap_user_config);
-            break;
+        if (vty_flags & CMD_FLAG_NO_CMD)
+        {
+            smap_replace(&smap_user_config,
+                    INTERFACE_USER_CONFIG_MAP_ADMIN,
+                    OVSREC_INTERFACE_USER_CONFIG_ADMIN_UP);
+        }
+        else
+        {
+            smap_remove(&smap_user_config,
+                    INTERFACE_USER_CONFIG_MAP_ADMIN);
         }
+        ovsrec_interface_set_user_config(row, &smap_user_config);
+        smap_destroy(&smap_user_config);
     }
 
-    OVSREC_PORT_FOR_EACH(port_row, idl)
+    port_row = sub_intf_index_port((char*)vty->index);
+    if (port_row)
     {
-        if (strcmp(port_row->name, (char*)vty->index) == 0)
+        if (vty_flags & CMD_FLAG_NO_CMD)
         {
-            if (vty_flags & CMD_FLAG_NO_CMD)
-            {
-                ovsrec_port_set_admin(port_row,
-                        OVSREC_INTERFACE_ADMIN_STATE_UP);
-            }
-            else
-            {
-                ovsrec_port_set_admin(port_row,
-                        OVSREC_INTERFACE_ADMIN_STATE_DOWN);
-            }
-            break;
+            ovsrec_port_set_admin(port_row,
+                    OVSREC_INTERFACE_ADMIN_STATE_UP);
+        }
+        else
+        {
+            ovsrec_port_set_admin(port_row,
+                    OVSREC_INTERFACE_ADMIN_STATE_DOWN);
         }
     }
 
@@ -168,23 +163,21 @@ DEFUN  (cli_encapsulation_dot1Q_vlan,
         return CMD_OVSDB_FAILURE;
     }
 
-    OVSREC_INTERFACE_FOR_EACH(tmp_row, idl)
+    if (check_internal_vlan(atoi(argv[0])) == 0)
     {
-        if (check_internal_vlan(atoi(argv[0])) == 0)
-        {
-           vty_out(vty, "Error : Vlan ID is an internal vlan.%s",
-                   VTY_NEWLINE);
-           cli_do_config_abort(status_txn);
-           return CMD_SUCCESS;
-        }
+       vty_out(vty, "Error : Vlan ID is an internal vlan.%s",
+               VTY_NEWLINE);
+       cli_do_config_abort(status_txn);
+       return CMD_SUCCESS;
     }
 
-    OVSREC_INTERFACE_FOR_EACH(tmp_row, idl)
+    row = sub_intf_index_interface((char*)vty->index);
+    if (row == NULL)
     {
-        if (strcmp(tmp_row->name, (char*)vty->index) == 0)
-        {
-            row = tmp_row;
-        }
+        vty_out(vty, "Interface %s not found.%s", (char*)vty->index,
+                VTY_NEWLINE);
+        cli_do_config_abort(status_txn);
+        return CMD_SUCCESS;
     }
 
     if (row->n_subintf_parent > 0)
@@ -192,26 +185,20 @@ DEFUN  (cli_encapsulation_dot1Q_vlan,
         parent_intf_row = row->value_subintf_parent[0];
     }
 
-    OVSREC_INTERFACE_FOR_EACH(tmp_row, idl)
+    tmp_row = sub_intf_index_encapsulation(parent_intf_row, atoi(argv[0]));
+    if (tmp_row && tmp_row != row)
     {
-        if (strcmp(tmp_row->name, (char*)vty->index) != 0)
-        {
-            if ((tmp_row->n_subintf_parent > 0)
-                    && (tmp_row->value_subintf_parent[0] == parent_intf_row)
-                    && (tmp_row->key_subintf_parent[0] == atoi(argv[0])))
-            {
-                vty_out(vty, "Encapsulation VLAN is already"
-                        " configured on interface %s. %s",
-                        tmp_row->name, VTY_NEWLINE);
-                cli_do_config_abort(status_txn);
-                return CMD_SUCCESS;
-            }
-        }
+        vty_out(vty, "Encapsulation VLAN is already"
+                " configured on interface %s. %s",
+                tmp_row->name, VTY_NEWLINE);
+        cli_do_config_abort(status_txn);
+        return CMD_SUCCESS;
     }
 
     if (vty_flags & CMD_FLAG_NO_CMD)
     {
-        if (row->key_subintf_parent[0] == atoi(argv[0])) {
+        if ((row->n_subintf_parent > 0)
+                && (row->key_subintf_parent[0] == atoi(argv[0]))) {
             enc_vlan = 0;
         }
         else {
@@ -283,7 +270,6 @@ sub_intf_config_ip (const char *if_name, const char *ip4)
     const struct ovsrec_port *port_row = NULL;
     struct ovsdb_idl_txn *status_txn = NULL;
     enum ovsdb_idl_txn_status status;
-    bool port_found;
     bool secondary = false;
 
     if (!is_valid_ip_address(ip4))
@@ -301,16 +287,8 @@ sub_intf_config_ip (const char *if_name, const char *ip4)
         return CMD_SUCCESS;
     }
 
-    OVSREC_PORT_FOR_EACH(port_row, idl)
-    {
-        if (strcmp(port_row->name, if_name) == 0)
-        {
-            port_found = true;
-            break;
-        }
-    }
-
-    if (!port_found)
+    port_row = sub_intf_index_port(if_name);
+    if (port_row == NULL)
     {
         vty_out(vty, "Port %s not found.%s", if_name, VTY_NEWLINE);
         return CMD_SUCCESS;
@@ -389,7 +367,6 @@ DEFUN (cli_sub_intf_del_ip4,
     const struct ovsrec_port *port_row = NULL;
     struct ovsdb_idl_txn *status_txn = NULL;
     enum ovsdb_idl_txn_status status;
-    bool port_found = false;
     const char *if_name = (char*)vty->index;
     char ip4[IP_ADDRESS_LENGTH];
 
@@ -398,16 +375,8 @@ DEFUN (cli_sub_intf_del_ip4,
         sprintf(ip4,"%s",argv[0]);
     }
 
-    OVSREC_PORT_FOR_EACH(port_row, idl)
-    {
-        if (strcmp(port_row->name, if_name) == 0)
-        {
-            port_found = true;
-            break;
-        }
-    }
-
-    if (!port_found)
+    port_row = sub_intf_index_port(if_name);
+    if (port_row == NULL)
     {
         vty_out(vty,"Port %s not found.%s", if_name, VTY_NEWLINE);
         return CMD_OVSDB_FAILURE;
@@ -890,17 +859,11 @@ DEFUN (cli_intf_show_subintferface_ifname,
         brief = true;
     }
 
-    OVSREC_INTERFACE_FOR_EACH(ifrow, idl)
+    ifrow = sub_intf_index_interface(argv[0]);
+    if (ifrow &&
+        (strcmp(ifrow->type, OVSREC_INTERFACE_TYPE_VLANSUBINT) == 0))
     {
-        if (strcmp(ifrow->type, OVSREC_INTERFACE_TYPE_VLANSUBINT) != 0)
-        {
-            continue;
-        }
-        if (strcmp(ifrow->name, argv[0]) != 0)
-        {
-            continue;
-        }
-        if (!known_intf && brief)
+        if (brief)
         {
             display_subinterface_brief_header();
         }
@@ -923,14 +886,9 @@ DEFUN (cli_intf_show_subintferface_if_all,
         "Show subinterfaces configured on this interface\n"
         "Show brief info of interface\n")
 {
-    const struct ovsrec_interface *ifrow = NULL;
-    char intf_name[MAX_IFNAME_LENGTH] = {0};
-    char *subif_prefix = NULL;
-    struct shash sorted_interfaces;
+    const struct ovsrec_interface **subintfs;
     bool brief = false;
-    const struct shash_node **nodes;
-    int idx, count;
-    bool known_intf = false;
+    size_t idx, count;
     const char *parent_intf = NULL;
 
     if (argv[0] != NULL) {
@@ -946,34 +904,10 @@ DEFUN (cli_intf_show_subintferface_if_all,
         brief = true;
     }
 
-    shash_init(&sorted_interfaces);
-
-    /* Only collect sub-interfaces of the parent interface specified
-     * by argv[0] */
-    memset(intf_name, '\0', sizeof(intf_name));
-    OVSREC_INTERFACE_FOR_EACH(ifrow, idl)
-    {
-        if (strcmp(ifrow->type, OVSREC_INTERFACE_TYPE_VLANSUBINT) != 0)
-        {
-            continue;
-        }
-
-        /* extract the parent interface from sub-interface name */
-        strncpy(intf_name, ifrow->name, sizeof(intf_name)-1);
-        subif_prefix = strtok(intf_name, ".");
-        if (strcmp(subif_prefix,parent_intf) != 0)
-        {
-            continue;
-        }
-
-        shash_add(&sorted_interfaces, ifrow->name, (void *)ifrow);
-    }
-
-
-    nodes = sort_sub_interfaces(&sorted_interfaces);
-    count = shash_count(&sorted_interfaces);
-
-    if (count <= 0) {
+    /* Sub-interfaces of the parent interface specified by argv[0],
+     * ordered by sub-interface number. */
+    subintfs = sub_intf_index_children(parent_intf, &count);
+    if (count == 0) {
         vty_out (vty, "No sub-interfaces configured for interface %s%s",
                 parent_intf, VTY_NEWLINE);
         return CMD_ERR_NOTHING_TODO;
@@ -985,22 +919,8 @@ DEFUN (cli_intf_show_subintferface_if_all,
 
     for (idx = 0; idx < count; idx++)
     {
-        ifrow = (const struct ovsrec_interface *)nodes[idx]->data;
-        if (!known_intf && brief)
-        {
-            display_subinterface_brief_header();
-        }
-
-        cli_show_subinterface_row(ifrow, brief);
-        known_intf = true;
+        cli_show_subinterface_row(subintfs[idx], brief);
     }
-    if (!known_intf && argv[0])
-    {
-        vty_out(vty,"%% Unknown interface%s", VTY_NEWLINE);
-    }
-
-    shash_destroy(&sorted_interfaces);
-    free(nodes);
 
     return CMD_SUCCESS;
 }
@@ -1031,15 +951,13 @@ create_sub_interface(const char* subifname)
     enum ovsdb_idl_txn_status status_txn;
     static char ifnumber[MAX_IFNAME_LENGTH]={0};
     const struct ovsrec_vrf *default_vrf_row = NULL;
-    const struct ovsrec_vrf *vrf_row = NULL;
     struct ovsrec_interface  **val_subintf_parent;
     struct ovsrec_port **ports = NULL;
     int64_t *key_subintf_parent;
-    bool port_found = false, parent_intf_found = false;
     char phy_intf[MAX_IFNAME_LENGTH];
     char sub_intf[MAX_IFNAME_LENGTH];
     long long int sub_intf_number;
-    int max_sub_intf = 0;
+    size_t n_subintfs = 0;
     int new_size = 1;
     int i = 0;
 
@@ -1076,40 +994,24 @@ create_sub_interface(const char* subifname)
 
     sprintf(sub_intf, "%lld", sub_intf_number);
 
-    OVSREC_PORT_FOR_EACH(port_row, idl)
+    if (sub_intf_index_port(ifnumber) != NULL)
     {
-        if (strcmp(port_row->name, ifnumber) == 0)
-        {
-            vty->index = ifnumber;
-            vty->node = SUB_INTERFACE_NODE;
-            return CMD_SUCCESS;
-        }
+        vty->index = ifnumber;
+        vty->node = SUB_INTERFACE_NODE;
+        return CMD_SUCCESS;
     }
 
-    OVSREC_INTERFACE_FOR_EACH(intf_row, idl)
+    sub_intf_index_children(phy_intf, &n_subintfs);
+    if (n_subintfs >= MAX_SUB_INTF_COUNT)
     {
-        if (strcmp(intf_row->name, phy_intf) == 0)
-        {
-            parent_intf_row = intf_row;
-            parent_intf_found = true;
-        }
-        if (strcmp(intf_row->type, OVSREC_INTERFACE_TYPE_VLANSUBINT) == 0)
-        {
-            if (strncmp (intf_row->name, phy_intf, strlen(phy_intf)) == 0)
-            {
-                max_sub_intf++;
-                if (max_sub_intf >= MAX_SUB_INTF_COUNT)
-                {
-                    vty_out(vty, "Cannot create subinterface. "
-                            "Max limit reached for parent interface %s.%s",
-                            phy_intf,VTY_NEWLINE);
-                    return CMD_SUCCESS;
-                }
-            }
-        }
+        vty_out(vty, "Cannot create subinterface. "
+                "Max limit reached for parent interface %s.%s",
+                phy_intf,VTY_NEWLINE);
+        return CMD_SUCCESS;
     }
 
-    if (!parent_intf_found)
+    parent_intf_row = sub_intf_index_interface(phy_intf);
+    if (parent_intf_row == NULL)
     {
         vty_out (vty, "Parent interface does not exist.%s", VTY_NEWLINE);
         return CMD_SUCCESS;
@@ -1123,122 +1025,92 @@ create_sub_interface(const char* subifname)
         return CMD_SUCCESS;
     }
 
-    OVSREC_PORT_FOR_EACH(port_row, idl)
+    txn = cli_do_config_start();
+    if (txn == NULL)
     {
-        if (strcmp(port_row->name, ifnumber) == 0)
-        {
-            port_found = true;
-            if(port_row->n_interfaces > 1)
-            {
-                vty_out(vty, "Subinterface is not supported on LAG.%s",
-                        VTY_NEWLINE);
-                return CMD_SUCCESS;
-            }
-            break;
-        }
+        VLOG_DBG("Transaction creation failed by %s.%s",
+                " cli_do_config_start()", VTY_NEWLINE);
+        cli_do_config_abort(txn);
+        return CMD_OVSDB_FAILURE;
     }
 
-    if (!port_found)
-    {
-        txn = cli_do_config_start();
-        if (txn == NULL)
-        {
-            VLOG_DBG("Transaction creation failed by %s.%s",
-                    " cli_do_config_start()", VTY_NEWLINE);
-            cli_do_config_abort(txn);
-            return CMD_OVSDB_FAILURE;
-        }
-
-        /* Adding an interface  table entry. */
-        intf_row = ovsrec_interface_insert(txn);
-        ovsrec_interface_set_name(intf_row, ifnumber);
-        ovsrec_interface_set_type(intf_row, OVSREC_INTERFACE_TYPE_VLANSUBINT);
+    /* Adding an interface  table entry. */
+    intf_row = ovsrec_interface_insert(txn);
+    ovsrec_interface_set_name(intf_row, ifnumber);
+    ovsrec_interface_set_type(intf_row, OVSREC_INTERFACE_TYPE_VLANSUBINT);
 
-        /* Set the parent interface & encapsulation vlan id. */
-        key_subintf_parent = xmalloc(sizeof(int64_t) * new_size);
-        if (key_subintf_parent != NULL)
-        {
-           val_subintf_parent = xmalloc(sizeof(struct ovsrec_interface *)
-                   * new_size);
-           if (val_subintf_parent != NULL)
-           {
-              key_subintf_parent[0] = 0;
-              val_subintf_parent[0] = (struct ovsrec_interface *)parent_intf_row;
-
-              ovsrec_interface_set_subintf_parent(intf_row, key_subintf_parent,
-                      val_subintf_parent, new_size);
+    /* Set the parent interface & encapsulation vlan id. */
+    key_subintf_parent = xmalloc(sizeof(int64_t) * new_size);
+    if (key_subintf_parent != NULL)
+    {
+       val_subintf_parent = xmalloc(sizeof(struct ovsrec_interface *)
+               * new_size);
+       if (val_subintf_parent != NULL)
+       {
+          key_subintf_parent[0] = 0;
+          val_subintf_parent[0] = (struct ovsrec_interface *)parent_intf_row;
 
-              free(val_subintf_parent);
-           }
-           free(key_subintf_parent);
-        }
+          ovsrec_interface_set_subintf_parent(intf_row, key_subintf_parent,
+                  val_subintf_parent, new_size);
 
-        /* Create parent port row, if not present. */
-        port_row = port_check_and_add (phy_intf, true, true, txn);
+          free(val_subintf_parent);
+       }
+       free(key_subintf_parent);
+    }
 
-        /* Create port table entry. */
-        port_row = ovsrec_port_insert(txn);
-        ovsrec_port_set_name(port_row, ifnumber);
+    /* Create parent port row, if not present. */
+    port_row = port_check_and_add (phy_intf, true, true, txn);
 
-        /* Adding a port to the corresponding interface. */
-        iface_list = xmalloc(sizeof(struct ovsrec_interface));
-        if (iface_list != NULL)
-        {
-           iface_list[0] = (struct ovsrec_interface *)intf_row;
-           ovsrec_port_set_interfaces(port_row, iface_list, 1);
-           free(iface_list);
-        }
+    /* Create port table entry. */
+    port_row = ovsrec_port_insert(txn);
+    ovsrec_port_set_name(port_row, ifnumber);
 
-        OVSREC_VRF_FOR_EACH (vrf_row, idl)
-        {
-            if (strcmp(vrf_row->name, DEFAULT_VRF_NAME) == 0) {
-                default_vrf_row = vrf_row;
-                break;
-            }
-        }
+    /* Adding a port to the corresponding interface. */
+    iface_list = xmalloc(sizeof(struct ovsrec_interface));
+    if (iface_list != NULL)
+    {
+       iface_list[0] = (struct ovsrec_interface *)intf_row;
+       ovsrec_port_set_interfaces(port_row, iface_list, 1);
+       free(iface_list);
+    }
 
-        if (default_vrf_row == NULL)
-        {
-            assert(0);
-            VLOG_DBG("Couldn't fetch default VRF row. Function=%s, Line=%d.%s",
-                    __func__, __LINE__, VTY_NEWLINE);
-            cli_do_config_abort(txn);
-            return CMD_OVSDB_FAILURE;
-        }
+    default_vrf_row = sub_intf_index_vrf(DEFAULT_VRF_NAME);
+    if (default_vrf_row == NULL)
+    {
+        assert(0);
+        VLOG_DBG("Couldn't fetch default VRF row. Function=%s, Line=%d.%s",
+                __func__, __LINE__, VTY_NEWLINE);
+        cli_do_config_abort(txn);
+        return CMD_OVSDB_FAILURE;
+    }
 
-        ports = xmalloc(sizeof *default_vrf_row->ports *
-                (default_vrf_row->n_ports + 1));
-        if (ports != NULL)
-        {
-           for (i = 0; i < default_vrf_row->n_ports; i++)
-           {
-               ports[i] = default_vrf_row->ports[i];
-           }
-           ports[default_vrf_row->n_ports] =
-               CONST_CAST(struct ovsrec_port*, port_row);
-           ovsrec_vrf_set_ports(default_vrf_row, ports,
-                   default_vrf_row->n_ports + 1);
-           free(ports);
-        }
+    ports = xmalloc(sizeof *default_vrf_row->ports *
+            (default_vrf_row->n_ports + 1));
+    if (ports != NULL)
+    {
+       for (i = 0; i < default_vrf_row->n_ports; i++)
+       {
+           ports[i] = default_vrf_row->ports[i];
+       }
+       ports[default_vrf_row->n_ports] =
+           CONST_CAST(struct ovsrec_port*, port_row);
+       ovsrec_vrf_set_ports(default_vrf_row, ports,
+               default_vrf_row->n_ports + 1);
+       free(ports);
+    }
 
-        status_txn = cli_do_config_finish(txn);
+    status_txn = cli_do_config_finish(txn);
 
-        if (status_txn == TXN_SUCCESS || status_txn == TXN_UNCHANGED)
-        {
-            vty->index = ifnumber;
-            vty->node = SUB_INTERFACE_NODE;
-            return CMD_SUCCESS;
-        }
-        else
-        {
-            VLOG_ERR(OVSDB_TXN_COMMIT_ERROR);
-            return CMD_OVSDB_FAILURE;
-        }
-    }
-    else
+    if (status_txn == TXN_SUCCESS || status_txn == TXN_UNCHANGED)
     {
         vty->index = ifnumber;
         vty->node = SUB_INTERFACE_NODE;
+        return CMD_SUCCESS;
+    }
+    else
+    {
+        VLOG_ERR(OVSDB_TXN_COMMIT_ERROR);
+        return CMD_OVSDB_FAILURE;
     }
 
     return CMD_SUCCESS;
@@ -1266,23 +1138,15 @@ delete_sub_intf(const char *sub_intf_name)
 {
     const struct ovsrec_vrf *vrf_row = NULL;
     const struct ovsrec_port *sub_intf_port_row = NULL;
-    const struct ovsrec_interface *if_row = NULL, *interface_row = NULL;
+    const struct ovsrec_interface *interface_row = NULL;
 
     struct ovsrec_port **ports;
-    int k=0, n=0, i=0;
+    int n=0, i=0;
     struct ovsdb_idl_txn* status_txn = NULL;
     enum ovsdb_idl_txn_status status;
-    bool port_found = false;
 
     /* Find the interface table entry and delete it. */
-    OVSREC_INTERFACE_FOR_EACH(if_row, idl)
-    {
-        if (strcmp(if_row->name, sub_intf_name) == 0)
-        {
-            interface_row = if_row;
-            break;
-        }
-    }
+    interface_row = sub_intf_index_interface(sub_intf_name);
     if (NULL == interface_row)
     {
         vty_out(vty, "Interface does not exist.%s", VTY_NEWLINE);
@@ -1306,15 +1170,8 @@ delete_sub_intf(const char *sub_intf_name)
     ovsrec_interface_delete(interface_row);
 
     /* Find the port table entry and delete it. */
-    OVSREC_PORT_FOR_EACH(sub_intf_port_row, idl)
-    {
-        if (strcmp(sub_intf_port_row->name, sub_intf_name) == 0)
-        {
-            port_found = true;
-        }
-    }
-
-    if (!port_found)
+    sub_intf_port_row = sub_intf_index_port(sub_intf_name);
+    if (sub_intf_port_row == NULL)
     {
         /* Commit the interface row deletion and return. */
         status = cli_do_config_finish(status_txn);
@@ -1332,27 +1189,21 @@ delete_sub_intf(const char *sub_intf_name)
     }
 
     /* Check if the given sub interface port is part of VRF. */
-    OVSREC_VRF_FOR_EACH (vrf_row, idl)
+    vrf_row = sub_intf_index_port_vrf(sub_intf_name);
+    if (vrf_row != NULL)
     {
-        for (k = 0; k < vrf_row->n_ports; k++)
+        ports = xmalloc(sizeof *vrf_row->ports * vrf_row->n_ports);
+        if (ports != NULL)
         {
-            sub_intf_port_row = vrf_row->ports[k];
-            if (strcmp(sub_intf_port_row->name, sub_intf_name) == 0)
-            {
-                ports = xmalloc(sizeof *vrf_row->ports * (vrf_row->n_ports-1));
-                if (ports != NULL)
-                {
-                   for (i = n = 0; i < vrf_row->n_ports; i++)
-                   {
-                       if (vrf_row->ports[i] != sub_intf_port_row)
-                       {
-                           ports[n++] = vrf_row->ports[i];
-                       }
-                   }
-                   ovsrec_vrf_set_ports(vrf_row, ports, n);
-                   free(ports);
+           for (i = n = 0; i < vrf_row->n_ports; i++)
+           {
+               if (vrf_row->ports[i] != sub_intf_port_row)
+               {
+                   ports[n++] = vrf_row->ports[i];
                }
-            }
+           }
+           ovsrec_vrf_set_ports(vrf_row, ports, n);
+           free(ports);
         }
     }
 
@@ -31,6 +31,25 @@
 
 VLOG_DEFINE_THIS_MODULE(audit_log_utils);
 
+/* User the configuration changes are logged for, instead of the remote
+ * user of the session. */
+static char *audit_user = NULL;
+
+/*-----------------------------------------------------------------------------
+  | Function : audit_log_user_set
+  | Responsibility : Log the following configuration changes for user, or for
+  |                  the remote user of the session if user is NULL.
+  | Parameters :
+  |     const char *user              : Name of the user
+  | Return : void
+  -----------------------------------------------------------------------------*/
+void
+audit_log_user_set(const char *user)
+{
+    free(audit_user);
+    audit_user = user ? strdup(user) : NULL;
+}
+
 /*-----------------------------------------------------------------------------
   | Function : audit_log_user_msg
   | Responsibility : Used to concatenate the "op" and "cfgdata" value.
@@ -48,7 +67,8 @@ audit_log_user_msg(char *op, const char *cfgdata, char *hostname, int result)
 {
     char aubuf[MAX_CFGDATA_LEN];
     char *cfg;
-    const char *remote_user = getenv(REMOTE_USER_ENV);
+    const char *remote_user = audit_user ? audit_user
+                                         : getenv(REMOTE_USER_ENV);
 
     strcat(strcpy(aubuf, op), " ");
 
@@ -34,5 +34,6 @@
 #define REMOTE_USER_ENV    "RUSER"
 
 void audit_log_user_msg(char *op, const char *cfgdata, char *hostname, int result);
+void audit_log_user_set(const char *user);
 extern int audit_fd;
 #endif
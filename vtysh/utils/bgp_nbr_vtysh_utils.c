@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ * File: bgp_nbr_vtysh_utils.c
+ * Responsibility : Index of the bgp_neighbors map of every BGP_Router row,
+ *                  by neighbor address / peer-group name and by neighbor
+ *                  row.  The index of a router is rebuilt when the IDL
+ *                  change tracking reports the router, or one of its
+ *                  neighbors, as modified, or when the map is written by
+ *                  the current transaction.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "ovsdb-idl.h"
+#include "shash.h"
+#include "util.h"
+#include "bgp_nbr_vtysh_utils.h"
+#include "vtysh/vtysh_ovsdb_if.h"
+
+extern struct ovsdb_idl *idl;
+
+struct bgp_nbr_index_row {
+    const struct ovsrec_bgp_neighbor *row;
+    size_t pos;
+};
+
+struct bgp_nbr_index {
+    struct bgp_nbr_index *next;
+    const struct ovsrec_bgp_router *router;
+    bool stale;                      /* Rebuild before the next lookup. */
+    bool written;                    /* Map written by a transaction... */
+    unsigned int written_txn;        /* ...that had this txn seqno. */
+    size_t n;                        /* Entries of the map. */
+    struct shash by_name;            /* Name -> position. */
+    struct bgp_nbr_index_row *by_row; /* Sorted by neighbor row. */
+    size_t *peer_groups;             /* Positions of the peer-groups. */
+    size_t n_peer_groups;
+};
+
+/* The indexes of the routers of the main IDL and of the on-demand tables
+ * IDL, the rows of one are not those of the other. */
+static struct bgp_nbr_cache {
+    struct bgp_nbr_index *indexes;
+    unsigned int generation;         /* vtysh_ovsdb_tables_generation(). */
+} bgp_nbr_caches[2];
+
+static void
+bgp_nbr_index_clear(struct bgp_nbr_index *index)
+{
+    shash_destroy(&index->by_name);
+    free(index->by_row);
+    free(index->peer_groups);
+    index->by_row = NULL;
+    index->peer_groups = NULL;
+    index->n_peer_groups = 0;
+}
+
+static int
+bgp_nbr_index_row_cmp(const void *a_, const void *b_)
+{
+    const struct bgp_nbr_index_row *a = a_;
+    const struct bgp_nbr_index_row *b = b_;
+    uintptr_t ra = (uintptr_t) a->row, rb = (uintptr_t) b->row;
+
+    return ra < rb ? -1 : ra > rb;
+}
+
+static void
+bgp_nbr_index_build(struct bgp_nbr_index *index)
+{
+    const struct ovsrec_bgp_router *router = index->router;
+    size_t i;
+
+    index->n = router->n_bgp_neighbors;
+    index->stale = false;
+    shash_init(&index->by_name);
+    index->by_row = xmalloc(MAX(index->n, 1) * sizeof *index->by_row);
+    index->peer_groups = xmalloc(MAX(index->n, 1)
+                                 * sizeof *index->peer_groups);
+    for (i = 0; i < index->n; i++) {
+        const struct ovsrec_bgp_neighbor *nbr = router->value_bgp_neighbors[i];
+
+        shash_add_once(&index->by_name, router->key_bgp_neighbors[i],
+                       (void *) (uintptr_t) i);
+        index->by_row[i].row = nbr;
+        index->by_row[i].pos = i;
+        if (nbr->is_peer_group && *nbr->is_peer_group) {
+            index->peer_groups[index->n_peer_groups++] = i;
+        }
+    }
+    qsort(index->by_row, index->n, sizeof *index->by_row,
+          bgp_nbr_index_row_cmp);
+}
+
+static bool
+bgp_nbr_index_has_row(const struct bgp_nbr_index *index,
+                      const struct ovsrec_bgp_neighbor *neighbor)
+{
+    struct bgp_nbr_index_row key;
+
+    key.row = neighbor;
+    return bsearch(&key, index->by_row, index->n, sizeof *index->by_row,
+                   bgp_nbr_index_row_cmp) != NULL;
+}
+
+/* The cache of the IDL idl points to, emptied if that IDL was replaced. */
+static struct bgp_nbr_cache *
+bgp_nbr_cache_get(void)
+{
+    unsigned int generation = vtysh_ovsdb_tables_generation();
+    struct bgp_nbr_cache *cache = &bgp_nbr_caches[generation != 0];
+    struct bgp_nbr_index *index, *next;
+
+    if (cache->generation != generation) {
+        for (index = cache->indexes; index; index = next) {
+            next = index->next;
+            bgp_nbr_index_clear(index);
+            free(index);
+        }
+        cache->indexes = NULL;
+        cache->generation = generation;
+    }
+    return cache;
+}
+
+/* Marks the indexes of the routers and neighbors changed in idl stale.  Run
+ * by vtysh_ovsdb_track_run(). */
+static void
+bgp_nbr_index_track(void)
+{
+    struct bgp_nbr_cache *cache = bgp_nbr_cache_get();
+    const struct ovsrec_bgp_router *router;
+    const struct ovsrec_bgp_neighbor *nbr;
+    struct bgp_nbr_index **indexp, *index;
+
+    if (!cache->indexes) {
+        return;
+    }
+
+    OVSREC_BGP_ROUTER_FOR_EACH_TRACKED (router, idl) {
+        for (indexp = &cache->indexes; *indexp; indexp = &(*indexp)->next) {
+            index = *indexp;
+            if (index->router != router) {
+                continue;
+            }
+            if (ovsrec_bgp_router_is_deleted(router)) {
+                *indexp = index->next;
+                bgp_nbr_index_clear(index);
+                free(index);
+            } else {
+                index->stale = true;
+            }
+            break;
+        }
+    }
+
+    /* A neighbor may become a peer-group.  Removing or adding a neighbor
+     * changes the map of its router. */
+    OVSREC_BGP_NEIGHBOR_FOR_EACH_TRACKED (nbr, idl) {
+        if (ovsrec_bgp_neighbor_is_deleted(nbr)) {
+            continue;
+        }
+        for (index = cache->indexes; index; index = index->next) {
+            if (!index->stale && bgp_nbr_index_has_row(index, nbr)) {
+                index->stale = true;
+            }
+        }
+    }
+}
+
+/* Follows the changes of the columns the indexes are built from. */
+void
+bgp_nbr_index_init(void)
+{
+    ovsdb_idl_track_add_column(idl, &ovsrec_bgp_router_col_bgp_neighbors);
+    ovsdb_idl_track_add_column(idl, &ovsrec_bgp_neighbor_col_is_peer_group);
+    vtysh_ovsdb_track_register(bgp_nbr_index_track);
+}
+
+/*
+ * Return the up to date index of the router.  Must be called with the IDL
+ * lock held.
+ */
+static struct bgp_nbr_index *
+bgp_nbr_index_get(const struct ovsrec_bgp_router *router)
+{
+    struct bgp_nbr_index **indexp, *index;
+    struct bgp_nbr_cache *cache;
+
+    vtysh_ovsdb_track_run();
+    cache = bgp_nbr_cache_get();
+
+    /* The rows written by a transaction take back their contents when it
+     * ends, and the rows it inserted are freed, without a tracked change:
+     * drop the indexes built for them. */
+    for (indexp = &cache->indexes; *indexp; ) {
+        index = *indexp;
+        if (index->written
+            && index->written_txn != vtysh_ovsdb_txn_seqno()) {
+            *indexp = index->next;
+            bgp_nbr_index_clear(index);
+            free(index);
+        } else {
+            indexp = &index->next;
+        }
+    }
+
+    for (index = cache->indexes; index; index = index->next) {
+        if (index->router == router) {
+            if (index->stale) {
+                bgp_nbr_index_clear(index);
+                bgp_nbr_index_build(index);
+            }
+            return index;
+        }
+    }
+
+    index = xzalloc(sizeof *index);
+    index->router = router;
+    bgp_nbr_index_build(index);
+    index->next = cache->indexes;
+    cache->indexes = index;
+    return index;
+}
+
+/*
+ * The transaction of the command set the bgp_neighbors map of the router:
+ * its index is rebuilt for the new map, and dropped once the transaction
+ * ends.
+ */
+void
+bgp_nbr_index_written(const struct ovsrec_bgp_router *router)
+{
+    struct bgp_nbr_index *index = bgp_nbr_index_get(router);
+
+    index->stale = true;
+    index->written = true;
+    index->written_txn = vtysh_ovsdb_txn_seqno();
+}
+
+static bool
+bgp_nbr_index_lookup(const struct ovsrec_bgp_router *router,
+                     const char *name, size_t *pos)
+{
+    struct shash_node *node;
+
+    if (!router || !name) {
+        return false;
+    }
+    node = shash_find(&bgp_nbr_index_get(router)->by_name, name);
+    if (!node) {
+        return false;
+    }
+    *pos = (uintptr_t) node->data;
+    return true;
+}
+
+/*
+ * Find the neighbor or peer-group of the router called name: an IP
+ * address for a neighbor, a user defined name for a peer-group.
+ */
+const struct ovsrec_bgp_neighbor *
+bgp_nbr_index_find(const struct ovsrec_bgp_router *router, const char *name)
+{
+    size_t pos;
+
+    return bgp_nbr_index_lookup(router, name, &pos)
+           ? router->value_bgp_neighbors[pos] : NULL;
+}
+
+/* Same as bgp_nbr_index_find(), but return the router's copy of the key. */
+const char *
+bgp_nbr_index_find_name(const struct ovsrec_bgp_router *router,
+                        const char *name)
+{
+    size_t pos;
+
+    return bgp_nbr_index_lookup(router, name, &pos)
+           ? router->key_bgp_neighbors[pos] : NULL;
+}
+
+/* Return the name the router knows the neighbor or peer-group by. */
+const char *
+bgp_nbr_index_name_of(const struct ovsrec_bgp_router *router,
+                      const struct ovsrec_bgp_neighbor *neighbor)
+{
+    struct bgp_nbr_index *index;
+    struct bgp_nbr_index_row key, *found;
+
+    if (!router || !neighbor) {
+        return NULL;
+    }
+    index = bgp_nbr_index_get(router);
+    key.row = neighbor;
+    found = bsearch(&key, index->by_row, index->n, sizeof *index->by_row,
+                    bgp_nbr_index_row_cmp);
+    return found ? router->key_bgp_neighbors[found->pos] : NULL;
+}
+
+/*
+ * Return the positions in the router's bgp_neighbors map of its
+ * peer-groups, in map order, and store their number in *n.
+ */
+const size_t *
+bgp_nbr_index_peer_groups(const struct ovsrec_bgp_router *router, size_t *n)
+{
+    struct bgp_nbr_index *index = bgp_nbr_index_get(router);
+
+    *n = index->n_peer_groups;
+    return index->peer_groups;
+}
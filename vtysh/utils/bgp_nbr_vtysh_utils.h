@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: bgp_nbr_vtysh_utils.h
+ *
+ * Purpose: This file contains the per BGP router neighbor and peer-group
+ *          index used by the BGP neighbor commands.
+ */
+
+#ifndef _BGP_NBR_VTY_UTILS_H
+#define _BGP_NBR_VTY_UTILS_H
+
+#include <stddef.h>
+#include "vswitch-idl.h"
+
+void bgp_nbr_index_init(void);
+void bgp_nbr_index_written(const struct ovsrec_bgp_router *router);
+const struct ovsrec_bgp_neighbor *
+bgp_nbr_index_find(const struct ovsrec_bgp_router *router, const char *name);
+const char *
+bgp_nbr_index_find_name(const struct ovsrec_bgp_router *router,
+                        const char *name);
+const char *
+bgp_nbr_index_name_of(const struct ovsrec_bgp_router *router,
+                      const struct ovsrec_bgp_neighbor *neighbor);
+const size_t *
+bgp_nbr_index_peer_groups(const struct ovsrec_bgp_router *router, size_t *n);
+
+#endif  /*_BGP_NBR_VTY_UTILS_H */
@@ -0,0 +1,457 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ * File: ospf_lookup_vtysh_utils.c
+ * Responsibility : Maps from interface name to Interface, OSPF_Interface
+ *                  and the OSPF_Area holding it, from OSPF_Neighbor to its
+ *                  OSPF_Interface, from neighbor router-id to OSPF_Neighbor
+ *                  rows, and between area id and OSPF_Area for an
+ *                  OSPF_Router.  The maps are rebuilt when the IDL change
+ *                  tracking reports a change of the rows or columns they
+ *                  are built from, so status and statistics updates leave
+ *                  them alone; the area maps also when the router's areas
+ *                  column is rewritten by the current transaction, and
+ *                  when that transaction ends.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "ovsdb-idl.h"
+#include "shash.h"
+#include "util.h"
+#include "ospf_lookup_vtysh_utils.h"
+#include "vtysh/vtysh_ovsdb_if.h"
+
+extern struct ovsdb_idl *idl;
+
+struct ospf_lookup_nbr_intf {
+    const struct ovsrec_ospf_neighbor *nbr;
+    const struct ovsrec_ospf_interface *intf;
+};
+
+struct ospf_lookup_router_id {
+    int64_t router_id;
+    size_t pos;
+    const struct ovsrec_ospf_neighbor *nbr;
+};
+
+struct ospf_lookup_area_id {
+    int64_t area_id;
+    const struct ovsrec_ospf_area *area;
+};
+
+static struct {
+    bool valid;
+    bool stale;                         /* A tracked change hit the maps. */
+    unsigned int generation;
+    struct shash interfaces;            /* Name -> Interface. */
+    struct shash ospf_interfaces;       /* Name -> OSPF_Interface. */
+    struct shash interface_areas;       /* Name -> OSPF_Area. */
+    struct ospf_lookup_nbr_intf *nbr_intfs;     /* Sorted by neighbor. */
+    size_t n_nbr_intfs;
+    int64_t *router_ids;                /* Sorted. */
+    const struct ovsrec_ospf_neighbor **router_id_nbrs; /* Same order. */
+    size_t n_router_ids;
+} lookup;
+
+static struct {
+    const struct ovsrec_ospf_router *router;
+    bool stale;
+    bool written;                       /* Areas set by the current txn. */
+    unsigned int written_txn;           /* vtysh_ovsdb_txn_seqno() then. */
+    unsigned int generation;
+    size_t n;
+    struct ospf_lookup_area_id *by_id;   /* Sorted by area id. */
+    struct ospf_lookup_area_id *by_area; /* Sorted by area row. */
+} areas;
+
+static int
+ospf_lookup_ptr_cmp(const void *a, const void *b)
+{
+    uintptr_t pa = (uintptr_t) a, pb = (uintptr_t) b;
+
+    return pa < pb ? -1 : pa > pb;
+}
+
+static int
+ospf_lookup_nbr_intf_cmp(const void *a_, const void *b_)
+{
+    const struct ospf_lookup_nbr_intf *a = a_;
+    const struct ospf_lookup_nbr_intf *b = b_;
+
+    return ospf_lookup_ptr_cmp(a->nbr, b->nbr);
+}
+
+static int
+ospf_lookup_router_id_cmp(const void *a_, const void *b_)
+{
+    const struct ospf_lookup_router_id *a = a_;
+    const struct ospf_lookup_router_id *b = b_;
+
+    if (a->router_id != b->router_id) {
+        return a->router_id < b->router_id ? -1 : 1;
+    }
+    return a->pos < b->pos ? -1 : a->pos > b->pos;
+}
+
+static int
+ospf_lookup_area_id_cmp(const void *a_, const void *b_)
+{
+    const struct ospf_lookup_area_id *a = a_;
+    const struct ospf_lookup_area_id *b = b_;
+
+    return a->area_id < b->area_id ? -1 : a->area_id > b->area_id;
+}
+
+static int
+ospf_lookup_area_cmp(const void *a_, const void *b_)
+{
+    const struct ospf_lookup_area_id *a = a_;
+    const struct ospf_lookup_area_id *b = b_;
+
+    return ospf_lookup_ptr_cmp(a->area, b->area);
+}
+
+static void
+ospf_lookup_clear(void)
+{
+    if (lookup.valid) {
+        shash_destroy(&lookup.interfaces);
+        shash_destroy(&lookup.ospf_interfaces);
+        shash_destroy(&lookup.interface_areas);
+    }
+    free(lookup.nbr_intfs);
+    free(lookup.router_ids);
+    free(lookup.router_id_nbrs);
+    lookup.nbr_intfs = NULL;
+    lookup.router_ids = NULL;
+    lookup.router_id_nbrs = NULL;
+    lookup.n_nbr_intfs = lookup.n_router_ids = 0;
+}
+
+static void
+ospf_lookup_build(void)
+{
+    const struct ovsrec_interface *intf_row;
+    const struct ovsrec_ospf_interface *ospf_intf_row;
+    const struct ovsrec_ospf_neighbor *nbr_row;
+    const struct ovsrec_ospf_area *area_row;
+    struct ospf_lookup_router_id *ids = NULL;
+    size_t allocated = 0, n_ids = 0, pos = 0;
+    size_t i;
+
+    shash_init(&lookup.interfaces);
+    shash_init(&lookup.ospf_interfaces);
+    shash_init(&lookup.interface_areas);
+
+    OVSREC_INTERFACE_FOR_EACH (intf_row, idl) {
+        shash_add_once(&lookup.interfaces, intf_row->name, intf_row);
+    }
+
+    OVSREC_OSPF_AREA_FOR_EACH (area_row, idl) {
+        for (i = 0; i < area_row->n_ospf_interfaces; i++) {
+            shash_add_once(&lookup.interface_areas,
+                           area_row->ospf_interfaces[i]->name, area_row);
+        }
+    }
+
+    OVSREC_OSPF_INTERFACE_FOR_EACH (ospf_intf_row, idl) {
+        shash_add_once(&lookup.ospf_interfaces, ospf_intf_row->name,
+                       ospf_intf_row);
+        for (i = 0; i < ospf_intf_row->n_neighbors; i++) {
+            if (lookup.n_nbr_intfs >= allocated) {
+                lookup.nbr_intfs = x2nrealloc(lookup.nbr_intfs, &allocated,
+                                              sizeof *lookup.nbr_intfs);
+            }
+            lookup.nbr_intfs[lookup.n_nbr_intfs].nbr =
+                ospf_intf_row->neighbors[i];
+            lookup.nbr_intfs[lookup.n_nbr_intfs++].intf = ospf_intf_row;
+        }
+    }
+    if (lookup.n_nbr_intfs) {
+        /* A neighbor row belongs to a single interface, so the order of
+         * equal keys does not matter. */
+        qsort(lookup.nbr_intfs, lookup.n_nbr_intfs,
+              sizeof *lookup.nbr_intfs, ospf_lookup_nbr_intf_cmp);
+    }
+
+    allocated = 0;
+    OVSREC_OSPF_NEIGHBOR_FOR_EACH (nbr_row, idl) {
+        for (i = 0; i < nbr_row->n_nbr_router_id; i++) {
+            if (n_ids >= allocated) {
+                ids = x2nrealloc(ids, &allocated, sizeof *ids);
+            }
+            ids[n_ids].router_id = nbr_row->nbr_router_id[i];
+            ids[n_ids].pos = pos++;
+            ids[n_ids++].nbr = nbr_row;
+        }
+    }
+    if (n_ids) {
+        qsort(ids, n_ids, sizeof *ids, ospf_lookup_router_id_cmp);
+    }
+    lookup.router_ids = xmalloc(MAX(n_ids, 1) * sizeof *lookup.router_ids);
+    lookup.router_id_nbrs = xmalloc(MAX(n_ids, 1)
+                                    * sizeof *lookup.router_id_nbrs);
+    for (i = 0; i < n_ids; i++) {
+        lookup.router_ids[i] = ids[i].router_id;
+        lookup.router_id_nbrs[i] = ids[i].nbr;
+    }
+    lookup.n_router_ids = n_ids;
+    free(ids);
+}
+
+/* Marks the maps stale for the tracked changes of the rows and columns
+ * they are built from.  Run by vtysh_ovsdb_track_run(). */
+static void
+ospf_lookup_track(void)
+{
+    const struct ovsrec_interface *intf_row;
+    const struct ovsrec_ospf_interface *ospf_intf_row;
+    const struct ovsrec_ospf_neighbor *nbr_row;
+    const struct ovsrec_ospf_area *area_row;
+    const struct ovsrec_ospf_router *router_row;
+    unsigned int generation = vtysh_ovsdb_tables_generation();
+
+    if (lookup.valid && lookup.generation == generation && !lookup.stale) {
+        OVSREC_INTERFACE_FOR_EACH_TRACKED (intf_row, idl) {
+            if (ovsrec_interface_is_new(intf_row)
+                || ovsrec_interface_is_deleted(intf_row)
+                || ovsrec_interface_is_updated(intf_row,
+                                               OVSREC_INTERFACE_COL_NAME)) {
+                lookup.stale = true;
+                break;
+            }
+        }
+        OVSREC_OSPF_INTERFACE_FOR_EACH_TRACKED (ospf_intf_row, idl) {
+            if (ovsrec_ospf_interface_is_new(ospf_intf_row)
+                || ovsrec_ospf_interface_is_deleted(ospf_intf_row)
+                || ovsrec_ospf_interface_is_updated(
+                       ospf_intf_row, OVSREC_OSPF_INTERFACE_COL_NAME)
+                || ovsrec_ospf_interface_is_updated(
+                       ospf_intf_row, OVSREC_OSPF_INTERFACE_COL_NEIGHBORS)) {
+                lookup.stale = true;
+                break;
+            }
+        }
+        OVSREC_OSPF_NEIGHBOR_FOR_EACH_TRACKED (nbr_row, idl) {
+            if (ovsrec_ospf_neighbor_is_new(nbr_row)
+                || ovsrec_ospf_neighbor_is_deleted(nbr_row)
+                || ovsrec_ospf_neighbor_is_updated(
+                       nbr_row, OVSREC_OSPF_NEIGHBOR_COL_NBR_ROUTER_ID)) {
+                lookup.stale = true;
+                break;
+            }
+        }
+        OVSREC_OSPF_AREA_FOR_EACH_TRACKED (area_row, idl) {
+            if (ovsrec_ospf_area_is_new(area_row)
+                || ovsrec_ospf_area_is_deleted(area_row)
+                || ovsrec_ospf_area_is_updated(
+                       area_row, OVSREC_OSPF_AREA_COL_OSPF_INTERFACES)) {
+                lookup.stale = true;
+                break;
+            }
+        }
+    }
+
+    if (areas.by_id && areas.generation == generation && !areas.stale) {
+        OVSREC_OSPF_ROUTER_FOR_EACH_TRACKED (router_row, idl) {
+            if (router_row == areas.router) {
+                areas.stale = true;
+            }
+        }
+    }
+}
+
+/* Follows the changes of the columns the maps are built from. */
+void
+ospf_lookup_init(void)
+{
+    ovsdb_idl_track_add_column(idl, &ovsrec_interface_col_name);
+    ovsdb_idl_track_add_column(idl, &ovsrec_ospf_interface_col_name);
+    ovsdb_idl_track_add_column(idl, &ovsrec_ospf_interface_col_neighbors);
+    ovsdb_idl_track_add_column(idl, &ovsrec_ospf_neighbor_col_nbr_router_id);
+    ovsdb_idl_track_add_column(idl, &ovsrec_ospf_area_col_ospf_interfaces);
+    ovsdb_idl_track_add_column(idl, &ovsrec_ospf_router_col_areas);
+    vtysh_ovsdb_track_register(ospf_lookup_track);
+}
+
+/* Must be called with the IDL lock held. */
+static void
+ospf_lookup_refresh(void)
+{
+    unsigned int generation = vtysh_ovsdb_tables_generation();
+
+    vtysh_ovsdb_track_run();
+    if (lookup.valid && !lookup.stale && lookup.generation == generation) {
+        return;
+    }
+    ospf_lookup_clear();
+    ospf_lookup_build();
+    lookup.stale = false;
+    lookup.generation = generation;
+    lookup.valid = true;
+}
+
+/* Find the Interface row called ifname. */
+const struct ovsrec_interface *
+ospf_lookup_interface(const char *ifname)
+{
+    ospf_lookup_refresh();
+    return ifname ? shash_find_data(&lookup.interfaces, ifname) : NULL;
+}
+
+/* Find the OSPF_Interface row called ifname. */
+const struct ovsrec_ospf_interface *
+ospf_lookup_ospf_interface(const char *ifname)
+{
+    ospf_lookup_refresh();
+    return ifname ? shash_find_data(&lookup.ospf_interfaces, ifname) : NULL;
+}
+
+/* Find the OSPF_Area whose ospf_interfaces holds the interface ifname. */
+const struct ovsrec_ospf_area *
+ospf_lookup_interface_area(const char *ifname)
+{
+    ospf_lookup_refresh();
+    return ifname ? shash_find_data(&lookup.interface_areas, ifname) : NULL;
+}
+
+/* Find the OSPF_Interface whose neighbors holds nbr. */
+const struct ovsrec_ospf_interface *
+ospf_lookup_neighbor_interface(const struct ovsrec_ospf_neighbor *nbr)
+{
+    struct ospf_lookup_nbr_intf key, *found;
+
+    ospf_lookup_refresh();
+    key.nbr = nbr;
+    found = bsearch(&key, lookup.nbr_intfs, lookup.n_nbr_intfs,
+                    sizeof *lookup.nbr_intfs, ospf_lookup_nbr_intf_cmp);
+    return found ? found->intf : NULL;
+}
+
+/*
+ * Return the OSPF_Neighbor rows that have router_id in nbr_router_id, in
+ * table order, and store their number in *n.
+ */
+const struct ovsrec_ospf_neighbor **
+ospf_lookup_neighbors_by_router_id(int64_t router_id, size_t *n)
+{
+    size_t lo = 0, hi, mid, first;
+
+    ospf_lookup_refresh();
+    hi = lookup.n_router_ids;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (lookup.router_ids[mid] < router_id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    first = lo;
+    while (lo < lookup.n_router_ids && lookup.router_ids[lo] == router_id) {
+        lo++;
+    }
+    *n = lo - first;
+    return lookup.router_id_nbrs + first;
+}
+
+static void
+ospf_lookup_areas_refresh(const struct ovsrec_ospf_router *router)
+{
+    unsigned int generation = vtysh_ovsdb_tables_generation();
+    size_t i;
+
+    vtysh_ovsdb_track_run();
+    /* A transaction takes back the areas it wrote when it ends, without a
+     * tracked change. */
+    if (areas.written && areas.written_txn != vtysh_ovsdb_txn_seqno()) {
+        areas.written = false;
+        areas.stale = true;
+    }
+    if (areas.by_id && !areas.stale && areas.router == router
+        && areas.generation == generation) {
+        return;
+    }
+
+    free(areas.by_id);
+    free(areas.by_area);
+    areas.router = router;
+    areas.stale = false;
+    areas.generation = generation;
+    areas.n = router->n_areas;
+    areas.by_id = xmalloc(MAX(areas.n, 1) * sizeof *areas.by_id);
+    for (i = 0; i < areas.n; i++) {
+        areas.by_id[i].area_id = router->key_areas[i];
+        areas.by_id[i].area = router->value_areas[i];
+    }
+    areas.by_area = xmemdup(areas.by_id, MAX(areas.n, 1)
+                                         * sizeof *areas.by_area);
+    qsort(areas.by_id, areas.n, sizeof *areas.by_id,
+          ospf_lookup_area_id_cmp);
+    qsort(areas.by_area, areas.n, sizeof *areas.by_area,
+          ospf_lookup_area_cmp);
+}
+
+/* The transaction of the command set the areas of an OSPF_Router: the
+ * area maps are rebuilt for the new areas, and once the transaction
+ * ends. */
+void
+ospf_lookup_areas_written(void)
+{
+    areas.stale = true;
+    areas.written = true;
+    areas.written_txn = vtysh_ovsdb_txn_seqno();
+}
+
+/* Get the area row matching the area id from the OSPF_Router row. */
+struct ovsrec_ospf_area *
+ospf_lookup_area(const struct ovsrec_ospf_router *router, int64_t area_id)
+{
+    struct ospf_lookup_area_id key, *found;
+
+    if (!router) {
+        return NULL;
+    }
+    ospf_lookup_areas_refresh(router);
+    key.area_id = area_id;
+    found = bsearch(&key, areas.by_id, areas.n, sizeof *areas.by_id,
+                    ospf_lookup_area_id_cmp);
+    return found ? CONST_CAST(struct ovsrec_ospf_area *, found->area) : NULL;
+}
+
+/* Get the id the OSPF_Router row knows the area row by. */
+bool
+ospf_lookup_area_id(const struct ovsrec_ospf_router *router,
+                    const struct ovsrec_ospf_area *area, int64_t *area_id)
+{
+    struct ospf_lookup_area_id key, *found;
+
+    if (!router || !area) {
+        return false;
+    }
+    ospf_lookup_areas_refresh(router);
+    key.area = area;
+    found = bsearch(&key, areas.by_area, areas.n, sizeof *areas.by_area,
+                    ospf_lookup_area_cmp);
+    if (!found) {
+        return false;
+    }
+    *area_id = found->area_id;
+    return true;
+}
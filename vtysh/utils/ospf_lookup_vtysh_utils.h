@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: ospf_lookup_vtysh_utils.h
+ *
+ * Purpose: This file contains the OSPF interface, neighbor and area
+ *          lookups used by the OSPF commands.
+ */
+
+#ifndef _OSPF_LOOKUP_VTY_UTILS_H
+#define _OSPF_LOOKUP_VTY_UTILS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "vswitch-idl.h"
+
+void ospf_lookup_init(void);
+const struct ovsrec_interface *ospf_lookup_interface(const char *ifname);
+const struct ovsrec_ospf_interface *
+ospf_lookup_ospf_interface(const char *ifname);
+const struct ovsrec_ospf_area *ospf_lookup_interface_area(const char *ifname);
+const struct ovsrec_ospf_interface *
+ospf_lookup_neighbor_interface(const struct ovsrec_ospf_neighbor *nbr);
+const struct ovsrec_ospf_neighbor **
+ospf_lookup_neighbors_by_router_id(int64_t router_id, size_t *n);
+struct ovsrec_ospf_area *
+ospf_lookup_area(const struct ovsrec_ospf_router *router, int64_t area_id);
+void ospf_lookup_areas_written(void);
+bool ospf_lookup_area_id(const struct ovsrec_ospf_router *router,
+                         const struct ovsrec_ospf_area *area,
+                         int64_t *area_id);
+
+#endif  /*_OSPF_LOOKUP_VTY_UTILS_H */
@@ -0,0 +1,648 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ * File: ospf_lsdb_vtysh_utils.c
+ * Responsibility : Index of the LSAs of an OSPF_Router row, sorted by
+ *                  (area, type, advertising router, link state id) and by
+ *                  (area, type, link state id, advertising router), plus
+ *                  the OSPF_LSA rows sorted by birth time for the MaxAge and
+ *                  age reports.  Filtered database queries binary search the
+ *                  index instead of formatting and comparing every LSA.  The
+ *                  LSA lists of an area, or of the router, fill one range of
+ *                  each sorted array, which is replaced when the IDL change
+ *                  tracking reports that area or the router as modified.
+ *                  Tracked OSPF_LSA inserts, deletes and birth time changes
+ *                  move single entries of the birth time order.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include "hmap.h"
+#include "ovsdb-idl.h"
+#include "openswitch-idl.h"
+#include "util.h"
+#include "uuid.h"
+#include "ospf_lsdb_vtysh_utils.h"
+#include "vtysh/vtysh_ovsdb_if.h"
+
+extern struct ovsdb_idl *idl;
+
+/* An area of the router the index holds the LSA lists of. */
+struct ospf_lsdb_area {
+    uint32_t area_id;
+    const struct ovsrec_ospf_area *row;
+};
+
+/* The birth time an OSPF_LSA row has in by_age, which a deleted row no
+ * longer shows. */
+struct ospf_lsdb_lsa {
+    struct hmap_node node;      /* In lsdb.lsas, by row UUID. */
+    const struct ovsrec_ospf_lsa *row;
+    int64_t birth_time;
+};
+
+struct ospf_lsdb {
+    bool valid;
+    unsigned int generation;    /* vtysh_ovsdb_tables_generation(). */
+    const struct ovsrec_ospf_router *router;
+    struct ospf_lsdb_area *areas;
+    size_t n_areas;
+    struct ospf_lsdb_entry *by_adv_router;
+    struct ospf_lsdb_entry *by_ls_id;
+    size_t n;
+    size_t allocated;           /* Of by_adv_router and of by_ls_id. */
+    struct hmap lsas;           /* Every OSPF_LSA row, ospf_lsdb_lsa. */
+    struct ospf_lsdb_age *by_age;
+    size_t n_by_age;
+    size_t allocated_by_age;
+};
+
+static struct ospf_lsdb lsdb = {
+    .lsas = HMAP_INITIALIZER(&lsdb.lsas),
+};
+
+/* Parse a dotted quad into a host byte order address. */
+bool
+ospf_lsdb_addr_parse(const char *str, uint32_t *addr)
+{
+    struct in_addr in;
+
+    if (!str || !inet_aton(str, &in)) {
+        return false;
+    }
+    *addr = ntohl(in.s_addr);
+    return true;
+}
+
+/* Column values hold the address in network byte order. */
+static uint32_t
+ospf_lsdb_column_addr(int64_t value)
+{
+    return ntohl((uint32_t) value);
+}
+
+static bool
+ospf_lsdb_type_is_as_scoped(int type)
+{
+    return type == OSPF_LSA_LSA_TYPE_TYPE5_AS_EXTERNAL_LSA
+           || type == OSPF_LSA_LSA_TYPE_TYPE11_OPAQUE_AS_LSA;
+}
+
+#define OSPF_LSDB_CMP(A, B) if ((A) != (B)) return (A) < (B) ? -1 : 1
+
+static int
+ospf_lsdb_cmp_adv_router(const void *a_, const void *b_)
+{
+    const struct ospf_lsdb_entry *a = a_;
+    const struct ospf_lsdb_entry *b = b_;
+
+    OSPF_LSDB_CMP(a->area_id, b->area_id);
+    OSPF_LSDB_CMP(a->type, b->type);
+    OSPF_LSDB_CMP(a->adv_router, b->adv_router);
+    OSPF_LSDB_CMP(a->ls_id, b->ls_id);
+    OSPF_LSDB_CMP(a->pos, b->pos);
+    return 0;
+}
+
+static int
+ospf_lsdb_cmp_ls_id(const void *a_, const void *b_)
+{
+    const struct ospf_lsdb_entry *a = a_;
+    const struct ospf_lsdb_entry *b = b_;
+
+    OSPF_LSDB_CMP(a->area_id, b->area_id);
+    OSPF_LSDB_CMP(a->type, b->type);
+    OSPF_LSDB_CMP(a->ls_id, b->ls_id);
+    OSPF_LSDB_CMP(a->adv_router, b->adv_router);
+    OSPF_LSDB_CMP(a->pos, b->pos);
+    return 0;
+}
+
+static int
+ospf_lsdb_cmp_age(const void *a_, const void *b_)
+{
+    const struct ospf_lsdb_age *a = a_;
+    const struct ospf_lsdb_age *b = b_;
+
+    OSPF_LSDB_CMP(a->birth_time, b->birth_time);
+    OSPF_LSDB_CMP((uintptr_t) a->lsa, (uintptr_t) b->lsa);
+    return 0;
+}
+
+/* Return the number of by_age entries that compare lower than key. */
+static size_t
+ospf_lsdb_age_pos(const struct ospf_lsdb_age *key)
+{
+    size_t lo = 0, hi = lsdb.n_by_age, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (ospf_lsdb_cmp_age(&lsdb.by_age[mid], key) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static struct ospf_lsdb_lsa *
+ospf_lsdb_lsa_find(const struct ovsrec_ospf_lsa *row)
+{
+    struct ospf_lsdb_lsa *lsa;
+
+    HMAP_FOR_EACH_WITH_HASH (lsa, node, uuid_hash(&row->header_.uuid),
+                             &lsdb.lsas) {
+        if (lsa->row == row) {
+            return lsa;
+        }
+    }
+    return NULL;
+}
+
+static void
+ospf_lsdb_age_insert(const struct ovsrec_ospf_lsa *row, int64_t birth_time)
+{
+    struct ospf_lsdb_age age = { birth_time, row };
+    size_t pos = ospf_lsdb_age_pos(&age);
+
+    if (lsdb.n_by_age >= lsdb.allocated_by_age) {
+        lsdb.by_age = x2nrealloc(lsdb.by_age, &lsdb.allocated_by_age,
+                                 sizeof *lsdb.by_age);
+    }
+    memmove(&lsdb.by_age[pos + 1], &lsdb.by_age[pos],
+            (lsdb.n_by_age - pos) * sizeof *lsdb.by_age);
+    lsdb.by_age[pos] = age;
+    lsdb.n_by_age++;
+}
+
+static void
+ospf_lsdb_age_remove(const struct ovsrec_ospf_lsa *row, int64_t birth_time)
+{
+    struct ospf_lsdb_age age = { birth_time, row };
+    size_t pos = ospf_lsdb_age_pos(&age);
+
+    if (pos < lsdb.n_by_age && lsdb.by_age[pos].lsa == row) {
+        lsdb.n_by_age--;
+        memmove(&lsdb.by_age[pos], &lsdb.by_age[pos + 1],
+                (lsdb.n_by_age - pos) * sizeof *lsdb.by_age);
+    }
+}
+
+static void
+ospf_lsdb_clear_age(void)
+{
+    struct ospf_lsdb_lsa *lsa;
+
+    HMAP_FOR_EACH_POP (lsa, node, &lsdb.lsas) {
+        free(lsa);
+    }
+    lsdb.n_by_age = 0;
+}
+
+/* The MaxAge list covers every LSA in the table, as it always has. */
+static void
+ospf_lsdb_build_age(void)
+{
+    const struct ovsrec_ospf_lsa *row;
+    struct ospf_lsdb_lsa *lsa;
+
+    ospf_lsdb_clear_age();
+    OVSREC_OSPF_LSA_FOR_EACH (row, idl) {
+        lsa = xmalloc(sizeof *lsa);
+        lsa->row = row;
+        lsa->birth_time = row->ls_birth_time;
+        hmap_insert(&lsdb.lsas, &lsa->node, uuid_hash(&row->header_.uuid));
+
+        if (lsdb.n_by_age >= lsdb.allocated_by_age) {
+            lsdb.by_age = x2nrealloc(lsdb.by_age, &lsdb.allocated_by_age,
+                                     sizeof *lsdb.by_age);
+        }
+        lsdb.by_age[lsdb.n_by_age].birth_time = row->ls_birth_time;
+        lsdb.by_age[lsdb.n_by_age++].lsa = row;
+    }
+    if (lsdb.n_by_age) {
+        qsort(lsdb.by_age, lsdb.n_by_age, sizeof *lsdb.by_age,
+              ospf_lsdb_cmp_age);
+    }
+}
+
+/* Moves the by_age entry of row, which the change tracking reports as
+ * inserted, modified or deleted. */
+static void
+ospf_lsdb_track_age(const struct ovsrec_ospf_lsa *row)
+{
+    struct ospf_lsdb_lsa *lsa = ospf_lsdb_lsa_find(row);
+
+    if (ovsrec_ospf_lsa_is_deleted(row)) {
+        if (lsa) {
+            ospf_lsdb_age_remove(row, lsa->birth_time);
+            hmap_remove(&lsdb.lsas, &lsa->node);
+            free(lsa);
+        }
+    } else if (!lsa) {
+        lsa = xmalloc(sizeof *lsa);
+        lsa->row = row;
+        lsa->birth_time = row->ls_birth_time;
+        hmap_insert(&lsdb.lsas, &lsa->node, uuid_hash(&row->header_.uuid));
+        ospf_lsdb_age_insert(row, lsa->birth_time);
+    } else if (lsa->birth_time != row->ls_birth_time) {
+        ospf_lsdb_age_remove(row, lsa->birth_time);
+        lsa->birth_time = row->ls_birth_time;
+        ospf_lsdb_age_insert(row, lsa->birth_time);
+    }
+}
+
+/* Return the first entry of sorted[0..n) that compares greater than key,
+ * or greater or equal to it when or_equal is set. */
+static size_t
+ospf_lsdb_bound(const struct ospf_lsdb_entry *sorted, size_t n,
+                const struct ospf_lsdb_entry *key, bool or_equal,
+                int (*cmp)(const void *, const void *))
+{
+    size_t lo = 0, hi = n, mid;
+    int c;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        c = cmp(&sorted[mid], key);
+        if (c < 0 || (c == 0 && !or_equal)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/* Keys bounding the entries of the LSAs of type shown under area_id, a
+ * host byte order address. */
+static void
+ospf_lsdb_key_init(struct ospf_lsdb_entry *min, struct ospf_lsdb_entry *max,
+                   uint32_t area_id, int type)
+{
+    min->area_id = ospf_lsdb_type_is_as_scoped(type) ? 0 : area_id;
+    min->type = type;
+    min->adv_router = min->ls_id = 0;
+    min->pos = 0;
+    min->lsa = NULL;
+    *max = *min;
+    max->adv_router = max->ls_id = UINT32_MAX;
+    max->pos = SIZE_MAX;
+}
+
+/* Replaces the range of sorted[0..n) between min and max by entries.  The
+ * array must have room for n_entries more. */
+static void
+ospf_lsdb_splice(struct ospf_lsdb_entry *sorted,
+                 const struct ospf_lsdb_entry *min,
+                 const struct ospf_lsdb_entry *max,
+                 const struct ospf_lsdb_entry *entries, size_t n_entries,
+                 int (*cmp)(const void *, const void *))
+{
+    size_t first = ospf_lsdb_bound(sorted, lsdb.n, min, true, cmp);
+    size_t last = ospf_lsdb_bound(sorted, lsdb.n, max, false, cmp);
+
+    memmove(&sorted[first + n_entries], &sorted[last],
+            (lsdb.n - last) * sizeof *sorted);
+    memcpy(&sorted[first], entries, n_entries * sizeof *sorted);
+}
+
+/* Makes the index hold lsas as the LSAs of type shown under area_id. */
+static void
+ospf_lsdb_sync_list(uint32_t area_id, int type,
+                    struct ovsrec_ospf_lsa **lsas, size_t n_lsas)
+{
+    struct ospf_lsdb_entry min, max, *entries;
+    size_t first, last;
+    size_t i;
+
+    ospf_lsdb_key_init(&min, &max, area_id, type);
+    first = ospf_lsdb_bound(lsdb.by_adv_router, lsdb.n, &min, true,
+                            ospf_lsdb_cmp_adv_router);
+    last = ospf_lsdb_bound(lsdb.by_adv_router, lsdb.n, &max, false,
+                           ospf_lsdb_cmp_adv_router);
+    if (first == last && !n_lsas) {
+        return;
+    }
+
+    while (lsdb.allocated < lsdb.n + n_lsas) {
+        size_t allocated = lsdb.allocated;
+
+        lsdb.by_adv_router = x2nrealloc(lsdb.by_adv_router, &allocated,
+                                        sizeof *lsdb.by_adv_router);
+        lsdb.by_ls_id = xrealloc(lsdb.by_ls_id,
+                                 allocated * sizeof *lsdb.by_ls_id);
+        lsdb.allocated = allocated;
+    }
+
+    entries = xmalloc(MAX(n_lsas, 1) * sizeof *entries);
+    for (i = 0; i < n_lsas; i++) {
+        entries[i].area_id = min.area_id;
+        entries[i].type = type;
+        entries[i].adv_router = ospf_lsdb_column_addr(lsas[i]->adv_router);
+        entries[i].ls_id = ospf_lsdb_column_addr(lsas[i]->ls_id);
+        entries[i].pos = i;
+        entries[i].lsa = lsas[i];
+    }
+
+    qsort(entries, n_lsas, sizeof *entries, ospf_lsdb_cmp_adv_router);
+    ospf_lsdb_splice(lsdb.by_adv_router, &min, &max, entries, n_lsas,
+                     ospf_lsdb_cmp_adv_router);
+    qsort(entries, n_lsas, sizeof *entries, ospf_lsdb_cmp_ls_id);
+    ospf_lsdb_splice(lsdb.by_ls_id, &min, &max, entries, n_lsas,
+                     ospf_lsdb_cmp_ls_id);
+    lsdb.n += n_lsas - (last - first);
+    free(entries);
+}
+
+/* Makes the index hold the LSA lists of area, or none if area is NULL, for
+ * the area area_id. */
+static void
+ospf_lsdb_sync_area(uint32_t area_id, const struct ovsrec_ospf_area *area)
+{
+    const struct {
+        int type;
+        struct ovsrec_ospf_lsa **lsas;
+        size_t n_lsas;
+    } lists[] = {
+        { OSPF_LSA_LSA_TYPE_TYPE1_ROUTER_LSA,
+          area ? area->router_lsas : NULL,
+          area ? area->n_router_lsas : 0 },
+        { OSPF_LSA_LSA_TYPE_TYPE2_NETWORK_LSA,
+          area ? area->network_lsas : NULL,
+          area ? area->n_network_lsas : 0 },
+        { OSPF_LSA_LSA_TYPE_TYPE3_ABR_SUMMARY_LSA,
+          area ? area->abr_summary_lsas : NULL,
+          area ? area->n_abr_summary_lsas : 0 },
+        { OSPF_LSA_LSA_TYPE_TYPE4_ASBR_SUMMARY_LSA,
+          area ? area->asbr_summary_lsas : NULL,
+          area ? area->n_asbr_summary_lsas : 0 },
+        { OSPF_LSA_LSA_TYPE_TYPE7_NSSA_LSA,
+          area ? area->as_nssa_lsas : NULL,
+          area ? area->n_as_nssa_lsas : 0 },
+        { OSPF_LSA_LSA_TYPE_TYPE9_OPAQUE_LINK_LSA,
+          area ? area->opaque_link_lsas : NULL,
+          area ? area->n_opaque_link_lsas : 0 },
+        { OSPF_LSA_LSA_TYPE_TYPE10_OPAQUE_AREA_LSA,
+          area ? area->opaque_area_lsas : NULL,
+          area ? area->n_opaque_area_lsas : 0 },
+    };
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(lists); i++) {
+        ospf_lsdb_sync_list(area_id, lists[i].type, lists[i].lsas,
+                            lists[i].n_lsas);
+    }
+}
+
+static bool
+ospf_lsdb_area_in(const struct ospf_lsdb_area *area,
+                  const struct ospf_lsdb_area *areas, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        if (areas[i].area_id == area->area_id && areas[i].row == area->row) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Follows the areas and the AS scoped LSA lists of lsdb.router: only the
+ * areas added, removed or replaced have their lists synced. */
+static void
+ospf_lsdb_sync_router(void)
+{
+    const struct ovsrec_ospf_router *router = lsdb.router;
+    struct ospf_lsdb_area *areas;
+    size_t i;
+
+    areas = xmalloc(MAX(router->n_areas, 1) * sizeof *areas);
+    for (i = 0; i < router->n_areas; i++) {
+        areas[i].area_id = ospf_lsdb_column_addr(router->key_areas[i]);
+        areas[i].row = router->value_areas[i];
+    }
+    for (i = 0; i < lsdb.n_areas; i++) {
+        if (!ospf_lsdb_area_in(&lsdb.areas[i], areas, router->n_areas)) {
+            ospf_lsdb_sync_area(lsdb.areas[i].area_id, NULL);
+        }
+    }
+    for (i = 0; i < router->n_areas; i++) {
+        if (!ospf_lsdb_area_in(&areas[i], lsdb.areas, lsdb.n_areas)) {
+            ospf_lsdb_sync_area(areas[i].area_id, areas[i].row);
+        }
+    }
+    free(lsdb.areas);
+    lsdb.areas = areas;
+    lsdb.n_areas = router->n_areas;
+
+    ospf_lsdb_sync_list(0, OSPF_LSA_LSA_TYPE_TYPE5_AS_EXTERNAL_LSA,
+                        router->as_ext_lsas, router->n_as_ext_lsas);
+    ospf_lsdb_sync_list(0, OSPF_LSA_LSA_TYPE_TYPE11_OPAQUE_AS_LSA,
+                        router->opaque_as_lsas, router->n_opaque_as_lsas);
+}
+
+/* Empties the area part of the index. */
+static void
+ospf_lsdb_clear_router(void)
+{
+    lsdb.router = NULL;
+    lsdb.n = 0;
+    free(lsdb.areas);
+    lsdb.areas = NULL;
+    lsdb.n_areas = 0;
+}
+
+/* Applies the OSPF changes tracked in idl to the index.  Run by
+ * vtysh_ovsdb_track_run(). */
+static void
+ospf_lsdb_track(void)
+{
+    const struct ovsrec_ospf_router *router;
+    const struct ovsrec_ospf_area *area;
+    const struct ovsrec_ospf_lsa *lsa;
+    size_t i;
+
+    if (!lsdb.valid || lsdb.generation != vtysh_ovsdb_tables_generation()) {
+        return;
+    }
+
+    OVSREC_OSPF_LSA_FOR_EACH_TRACKED (lsa, idl) {
+        ospf_lsdb_track_age(lsa);
+    }
+
+    if (!lsdb.router) {
+        return;
+    }
+    OVSREC_OSPF_ROUTER_FOR_EACH_TRACKED (router, idl) {
+        if (router != lsdb.router) {
+            continue;
+        }
+        if (ovsrec_ospf_router_is_deleted(router)) {
+            ospf_lsdb_clear_router();
+            return;
+        }
+        ospf_lsdb_sync_router();
+    }
+    OVSREC_OSPF_AREA_FOR_EACH_TRACKED (area, idl) {
+        if (ovsrec_ospf_area_is_deleted(area)) {
+            continue;
+        }
+        for (i = 0; i < lsdb.n_areas; i++) {
+            if (lsdb.areas[i].row == area) {
+                ospf_lsdb_sync_area(lsdb.areas[i].area_id, area);
+            }
+        }
+    }
+}
+
+void
+ospf_lsdb_init(void)
+{
+    vtysh_ovsdb_track_register(ospf_lsdb_track);
+}
+
+/* Must be called with the IDL lock held. */
+static void
+ospf_lsdb_refresh(const struct ovsrec_ospf_router *router)
+{
+    unsigned int generation = vtysh_ovsdb_tables_generation();
+
+    vtysh_ovsdb_track_run();
+    if (!lsdb.valid || lsdb.generation != generation) {
+        ospf_lsdb_clear_router();
+        ospf_lsdb_build_age();
+        lsdb.generation = generation;
+        lsdb.valid = true;
+    }
+    if (lsdb.router != router) {
+        ospf_lsdb_clear_router();
+        lsdb.router = router;
+        if (router) {
+            ospf_lsdb_sync_router();
+        }
+    }
+}
+
+static const struct ospf_lsdb_entry *
+ospf_lsdb_range(const struct ospf_lsdb_entry *sorted,
+                const struct ospf_lsdb_entry *min,
+                const struct ospf_lsdb_entry *max,
+                int (*cmp)(const void *, const void *), size_t *n)
+{
+    size_t first = ospf_lsdb_bound(sorted, lsdb.n, min, true, cmp);
+    size_t last = ospf_lsdb_bound(sorted, lsdb.n, max, false, cmp);
+
+    *n = last > first ? last - first : 0;
+    return sorted + first;
+}
+
+/*
+ * Return the LSAs of the given type advertised by adv_router, and with the
+ * given link state id if ls_id is not NULL, that a database display shows
+ * under the area identified by the OSPF_Router areas key area_id.  AS
+ * scoped LSAs are shown under every area.  Stores their number in *n.
+ */
+const struct ospf_lsdb_entry *
+ospf_lsdb_find_adv_router(const struct ovsrec_ospf_router *router,
+                          int64_t area_id, int type, uint32_t adv_router,
+                          const uint32_t *ls_id, size_t *n)
+{
+    struct ospf_lsdb_entry min, max;
+
+    ospf_lsdb_refresh(router);
+    ospf_lsdb_key_init(&min, &max, ospf_lsdb_column_addr(area_id), type);
+    min.adv_router = max.adv_router = adv_router;
+    if (ls_id) {
+        min.ls_id = max.ls_id = *ls_id;
+    }
+    return ospf_lsdb_range(lsdb.by_adv_router, &min, &max,
+                           ospf_lsdb_cmp_adv_router, n);
+}
+
+/* Same as ospf_lsdb_find_adv_router() for a link state id of any router. */
+const struct ospf_lsdb_entry *
+ospf_lsdb_find_ls_id(const struct ovsrec_ospf_router *router,
+                     int64_t area_id, int type, uint32_t ls_id, size_t *n)
+{
+    struct ospf_lsdb_entry min, max;
+
+    ospf_lsdb_refresh(router);
+    ospf_lsdb_key_init(&min, &max, ospf_lsdb_column_addr(area_id), type);
+    min.ls_id = max.ls_id = ls_id;
+    return ospf_lsdb_range(lsdb.by_ls_id, &min, &max, ospf_lsdb_cmp_ls_id, n);
+}
+
+/* Return the number of by_age entries born at or before birth_time. */
+static size_t
+ospf_lsdb_age_bound(int64_t birth_time)
+{
+    size_t lo = 0, hi = lsdb.n_by_age, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (lsdb.by_age[mid].birth_time <= birth_time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/*
+ * Return the OSPF_LSA rows born at or before birth_time, oldest first, and
+ * store their number in *n.
+ */
+const struct ospf_lsdb_age *
+ospf_lsdb_born_before(const struct ovsrec_ospf_router *router,
+                      int64_t birth_time, size_t *n)
+{
+    ospf_lsdb_refresh(router);
+    *n = ospf_lsdb_age_bound(birth_time);
+    return lsdb.by_age;
+}
+
+/*
+ * Count the OSPF_LSA rows by age at time now.  histogram[i] gets the LSAs
+ * aged [i * bucket_secs, (i + 1) * bucket_secs) and the last bucket every
+ * LSA aged n_buckets - 1 bucket widths or more.  Returns the total.
+ */
+size_t
+ospf_lsdb_age_histogram(const struct ovsrec_ospf_router *router, int64_t now,
+                        int64_t bucket_secs, size_t *histogram,
+                        size_t n_buckets)
+{
+    size_t younger, older;
+    size_t i;
+
+    ospf_lsdb_refresh(router);
+    younger = lsdb.n_by_age;
+    for (i = 0; i + 1 < n_buckets; i++) {
+        older = ospf_lsdb_age_bound(now - (int64_t) (i + 1) * bucket_secs);
+        histogram[i] = younger - older;
+        younger = older;
+    }
+    if (n_buckets) {
+        histogram[n_buckets - 1] = younger;
+    }
+    return lsdb.n_by_age;
+}
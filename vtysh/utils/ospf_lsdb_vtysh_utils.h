@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: ospf_lsdb_vtysh_utils.h
+ *
+ * Purpose: This file contains the OSPF link state database index used by
+ *          the filtered show ip ospf database commands.
+ */
+
+#ifndef _OSPF_LSDB_VTY_UTILS_H
+#define _OSPF_LSDB_VTY_UTILS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "vswitch-idl.h"
+
+/* One LSA of the database.  Addresses are kept in host byte order. */
+struct ospf_lsdb_entry {
+    uint32_t area_id;           /* 0 for AS scoped LSAs. */
+    int type;                   /* OSPF_LSA_LSA_TYPE_*. */
+    uint32_t adv_router;
+    uint32_t ls_id;
+    size_t pos;                 /* Position in the OSPF_Area/Router list. */
+    const struct ovsrec_ospf_lsa *lsa;
+};
+
+/* An OSPF_LSA row and its birth time, oldest first. */
+struct ospf_lsdb_age {
+    int64_t birth_time;
+    const struct ovsrec_ospf_lsa *lsa;
+};
+
+void ospf_lsdb_init(void);
+bool ospf_lsdb_addr_parse(const char *str, uint32_t *addr);
+const struct ospf_lsdb_entry *
+ospf_lsdb_find_adv_router(const struct ovsrec_ospf_router *router,
+                          int64_t area_id, int type, uint32_t adv_router,
+                          const uint32_t *ls_id, size_t *n);
+const struct ospf_lsdb_entry *
+ospf_lsdb_find_ls_id(const struct ovsrec_ospf_router *router,
+                     int64_t area_id, int type, uint32_t ls_id, size_t *n);
+const struct ospf_lsdb_age *
+ospf_lsdb_born_before(const struct ovsrec_ospf_router *router,
+                      int64_t birth_time, size_t *n);
+size_t ospf_lsdb_age_histogram(const struct ovsrec_ospf_router *router,
+                               int64_t now, int64_t bucket_secs,
+                               size_t *histogram, size_t n_buckets);
+
+#endif  /*_OSPF_LSDB_VTY_UTILS_H */
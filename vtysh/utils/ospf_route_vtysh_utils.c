@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ * File: ospf_route_vtysh_utils.c
+ * Responsibility : Prefix ordered view of the OSPF network, router and
+ *                  external routes.  Each route list is kept in a radix
+ *                  tree, so show commands walk the routes in prefix order
+ *                  and look a single prefix up without sorting or copying
+ *                  the route table.  The network routes stay grouped by
+ *                  area.  The view is rebuilt when the IDL change tracking
+ *                  reports routes added or removed or a route list
+ *                  rewritten; cost and path updates are read in place.
+ */
+
+#include <stdlib.h>
+#include "ovsdb-idl.h"
+#include "util.h"
+#include "ospf_route_vtysh_utils.h"
+#include "vtysh/vtysh_ovsdb_if.h"
+
+extern struct ovsdb_idl *idl;
+
+static struct {
+    bool valid;
+    bool stale;                         /* A tracked change hit the view. */
+    unsigned int generation;
+    const struct ovsrec_ospf_router *router;
+    struct ospf_route_view *views;      /* In display order. */
+    size_t n_views, allocated_views;
+} ospf_routes;
+
+static void
+ospf_route_view_clear(void)
+{
+    size_t i;
+
+    for (i = 0; i < ospf_routes.n_views; i++) {
+        if (ospf_routes.views[i].table) {
+            route_table_finish(ospf_routes.views[i].table);
+        }
+        free(ospf_routes.views[i].entries);
+    }
+    ospf_routes.n_views = 0;
+}
+
+/* Adds a view of kind holding the n_rows routes of rows. */
+static void
+ospf_route_view_add(enum ospf_route_kind kind,
+                    const struct ovsrec_ospf_area *area,
+                    struct ovsrec_ospf_route **rows, size_t n_rows,
+                    bool inter_area)
+{
+    struct ospf_route_view *view;
+    struct ospf_route_entry *entry;
+    size_t i;
+
+    if (ospf_routes.n_views >= ospf_routes.allocated_views) {
+        ospf_routes.views = x2nrealloc(ospf_routes.views,
+                                       &ospf_routes.allocated_views,
+                                       sizeof *ospf_routes.views);
+    }
+    view = &ospf_routes.views[ospf_routes.n_views++];
+    view->kind = kind;
+    view->area = area;
+    view->entries = xmalloc((n_rows ? n_rows : 1) * sizeof *view->entries);
+    view->n_entries = n_rows;
+    view->table = NULL;
+    view->unparsed = NULL;
+    for (i = 0; i < n_rows; i++) {
+        entry = &view->entries[i];
+        entry->row = rows[i];
+        entry->inter_area = inter_area;
+        entry->next_same_prefix = NULL;
+    }
+}
+
+/* Adds the n_rows routes of rows to the last view. */
+static void
+ospf_route_view_append(struct ovsrec_ospf_route **rows, size_t n_rows)
+{
+    struct ospf_route_view *view =
+        &ospf_routes.views[ospf_routes.n_views - 1];
+    struct ospf_route_entry *entry;
+    size_t i;
+
+    view->entries = xrealloc(view->entries,
+                             (view->n_entries + n_rows + 1)
+                             * sizeof *view->entries);
+    for (i = 0; i < n_rows; i++) {
+        entry = &view->entries[view->n_entries++];
+        entry->row = rows[i];
+        entry->inter_area = false;
+        entry->next_same_prefix = NULL;
+    }
+}
+
+static void
+ospf_route_view_build(struct ospf_route_view *view)
+{
+    struct ospf_route_entry *entry;
+    struct route_node *node;
+    struct prefix p;
+    size_t i;
+
+    view->table = route_table_init();
+
+    /* Walking backwards keeps every same-prefix chain in table order. */
+    for (i = view->n_entries; i-- > 0; ) {
+        entry = &view->entries[i];
+        if (!entry->row->prefix || str2prefix(entry->row->prefix, &p) <= 0) {
+            entry->next_same_prefix = view->unparsed;
+            view->unparsed = entry;
+            continue;
+        }
+        apply_mask(&p);
+        node = route_node_get(view->table, &p);
+        entry->next_same_prefix = node->info;
+        node->info = entry;
+    }
+}
+
+/* Marks the view stale for the tracked changes of the route lists and of
+ * the route prefixes.  Run by vtysh_ovsdb_track_run(). */
+static void
+ospf_route_view_track(void)
+{
+    const struct ovsrec_ospf_route *route_row;
+    const struct ovsrec_ospf_area *area_row;
+    const struct ovsrec_ospf_router *router_row;
+
+    if (!ospf_routes.valid || ospf_routes.stale
+        || ospf_routes.generation != vtysh_ovsdb_tables_generation()) {
+        return;
+    }
+    OVSREC_OSPF_ROUTE_FOR_EACH_TRACKED (route_row, idl) {
+        if (ovsrec_ospf_route_is_new(route_row)
+            || ovsrec_ospf_route_is_deleted(route_row)
+            || ovsrec_ospf_route_is_updated(route_row,
+                                            OVSREC_OSPF_ROUTE_COL_PREFIX)) {
+            ospf_routes.stale = true;
+            return;
+        }
+    }
+    OVSREC_OSPF_AREA_FOR_EACH_TRACKED (area_row, idl) {
+        if (ovsrec_ospf_area_is_new(area_row)
+            || ovsrec_ospf_area_is_deleted(area_row)
+            || ovsrec_ospf_area_is_updated(
+                   area_row, OVSREC_OSPF_AREA_COL_INTER_AREA_OSPF_ROUTES)
+            || ovsrec_ospf_area_is_updated(
+                   area_row, OVSREC_OSPF_AREA_COL_INTRA_AREA_OSPF_ROUTES)
+            || ovsrec_ospf_area_is_updated(
+                   area_row, OVSREC_OSPF_AREA_COL_ROUTER_OSPF_ROUTES)) {
+            ospf_routes.stale = true;
+            return;
+        }
+    }
+    OVSREC_OSPF_ROUTER_FOR_EACH_TRACKED (router_row, idl) {
+        if (router_row == ospf_routes.router) {
+            ospf_routes.stale = true;
+            return;
+        }
+    }
+}
+
+/* Follows the changes of the route lists, tracked by the on-demand tables
+ * IDL the route commands run on. */
+void
+ospf_route_view_init(void)
+{
+    vtysh_ovsdb_track_register(ospf_route_view_track);
+}
+
+/*
+ * Rebuild the view if a tracked change hit it since the last call.  Must
+ * be called with the IDL lock held.
+ */
+void
+ospf_route_view_refresh(const struct ovsrec_ospf_router *router)
+{
+    const struct ovsrec_ospf_area *area_row;
+    unsigned int generation;
+    size_t i;
+
+    vtysh_ovsdb_track_run();
+    generation = vtysh_ovsdb_tables_generation();
+    if (ospf_routes.valid && !ospf_routes.stale
+        && ospf_routes.generation == generation
+        && ospf_routes.router == router) {
+        return;
+    }
+
+    /* The network routes of each area, inter area first, then the router
+     * routes of every area and the external routes. */
+    ospf_route_view_clear();
+    OVSREC_OSPF_AREA_FOR_EACH (area_row, idl) {
+        ospf_route_view_add(OSPF_ROUTE_KIND_NETWORK, area_row,
+                            area_row->inter_area_ospf_routes,
+                            area_row->n_inter_area_ospf_routes, true);
+        ospf_route_view_add(OSPF_ROUTE_KIND_NETWORK, area_row,
+                            area_row->intra_area_ospf_routes,
+                            area_row->n_intra_area_ospf_routes, false);
+    }
+    ospf_route_view_add(OSPF_ROUTE_KIND_ROUTER, NULL, NULL, 0, false);
+    OVSREC_OSPF_AREA_FOR_EACH (area_row, idl) {
+        ospf_route_view_append(area_row->router_ospf_routes,
+                               area_row->n_router_ospf_routes);
+    }
+    ospf_route_view_add(OSPF_ROUTE_KIND_EXTERNAL, NULL,
+                        router ? router->ext_ospf_routes : NULL,
+                        router ? router->n_ext_ospf_routes : 0, false);
+    for (i = 0; i < ospf_routes.n_views; i++) {
+        ospf_route_view_build(&ospf_routes.views[i]);
+    }
+
+    ospf_routes.router = router;
+    ospf_routes.generation = generation;
+    ospf_routes.stale = false;
+    ospf_routes.valid = true;
+}
+
+/* Sets *views to the route lists in display order and returns how many. */
+size_t
+ospf_route_views(const struct ospf_route_view **views)
+{
+    *views = ospf_routes.views;
+    return ospf_routes.n_views;
+}
+
+/*
+ * Return the first route of view whose prefix is exactly p.  Further
+ * routes with the same prefix follow through next_same_prefix.
+ */
+const struct ospf_route_entry *
+ospf_route_view_lookup(const struct ospf_route_view *view,
+                       const struct prefix *p)
+{
+    const struct ospf_route_entry *entry;
+    struct route_node *node;
+    struct prefix key;
+
+    if (!view->table) {
+        return NULL;
+    }
+    prefix_copy(&key, p);
+    apply_mask(&key);
+    node = route_node_lookup(view->table, &key);
+    if (!node) {
+        return NULL;
+    }
+    entry = node->info;
+    route_unlock_node(node);
+    return entry;
+}
+
+/*
+ * Find the most specific prefix covering p among the routes of kind, in
+ * any of its route lists.  Returns false if there is none.
+ */
+bool
+ospf_route_view_match(enum ospf_route_kind kind, const struct prefix *p,
+                      struct prefix *match)
+{
+    const struct ospf_route_view *view;
+    struct route_node *node;
+    struct prefix key;
+    bool found = false;
+    size_t i;
+
+    prefix_copy(&key, p);
+    apply_mask(&key);
+    for (i = 0; i < ospf_routes.n_views; i++) {
+        view = &ospf_routes.views[i];
+        if (view->kind != kind || !view->table) {
+            continue;
+        }
+        node = route_node_match(view->table, &key);
+        if (!node) {
+            continue;
+        }
+        if (!found || node->p.prefixlen > match->prefixlen) {
+            prefix_copy(match, &node->p);
+            found = true;
+        }
+        route_unlock_node(node);
+    }
+    return found;
+}
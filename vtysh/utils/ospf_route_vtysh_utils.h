@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: ospf_route_vtysh_utils.h
+ *
+ * Purpose: This file contains the prefix ordered view of the OSPF routes
+ *          used by the show ip ospf route commands.
+ */
+
+#ifndef _OSPF_ROUTE_VTY_UTILS_H
+#define _OSPF_ROUTE_VTY_UTILS_H
+
+#include <stdbool.h>
+#include "zebra.h"
+#include "prefix.h"
+#include "table.h"
+#include "vswitch-idl.h"
+
+enum ospf_route_kind {
+    OSPF_ROUTE_KIND_NETWORK,
+    OSPF_ROUTE_KIND_ROUTER,
+    OSPF_ROUTE_KIND_EXTERNAL,
+    OSPF_ROUTE_KIND_MAX
+};
+
+/* One OSPF_Route row. */
+struct ospf_route_entry {
+    const struct ovsrec_ospf_route *row;
+    bool inter_area;            /* Network route from inter_area_ospf_routes. */
+    /* Next entry with the same prefix, in table order. */
+    struct ospf_route_entry *next_same_prefix;
+};
+
+/* The routes of one route list: the inter area or the intra area network
+ * routes of an area, the router routes of every area, or the external
+ * routes.  The info pointer of a table node is the first entry carrying
+ * that prefix.  Rows whose prefix does not parse are kept apart, in table
+ * order, so a full display still shows them. */
+struct ospf_route_view {
+    enum ospf_route_kind kind;
+    const struct ovsrec_ospf_area *area;    /* Network routes only. */
+    struct ospf_route_entry *entries;
+    size_t n_entries;
+    struct route_table *table;
+    struct ospf_route_entry *unparsed;
+};
+
+void ospf_route_view_init(void);
+void ospf_route_view_refresh(const struct ovsrec_ospf_router *router);
+size_t ospf_route_views(const struct ospf_route_view **views);
+const struct ospf_route_entry *
+ospf_route_view_lookup(const struct ospf_route_view *view,
+                       const struct prefix *p);
+bool ospf_route_view_match(enum ospf_route_kind kind, const struct prefix *p,
+                           struct prefix *match);
+
+#endif  /*_OSPF_ROUTE_VTY_UTILS_H */
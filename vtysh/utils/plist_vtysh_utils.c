@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ * File: plist_vtysh_utils.c
+ * Responsibility : Compiled view of the Prefix_List and Prefix_List_Entry
+ *                  tables.  The view is rebuilt only when either table
+ *                  changes, so show commands do not reparse prefix strings
+ *                  on every call.
+ */
+
+#include <stdlib.h>
+#include "ovsdb-idl.h"
+#include "shash.h"
+#include "util.h"
+#include "plist_vtysh_utils.h"
+#include "vtysh/vtysh_ovsdb_if.h"
+
+extern struct ovsdb_idl *idl;
+
+static struct plist_cache_list *plist_cache;
+static size_t plist_cache_n;
+static struct shash plist_cache_by_name = SHASH_INITIALIZER(&plist_cache_by_name);
+static unsigned int plist_cache_seqno;
+static unsigned int plist_cache_generation;
+static bool plist_cache_valid = false;
+
+static void
+plist_cache_clear(void)
+{
+    size_t i;
+    int afi;
+
+    for (i = 0; i < plist_cache_n; i++) {
+        for (afi = 0; afi < AFI_MAX; afi++) {
+            if (plist_cache[i].table[afi]) {
+                route_table_finish(plist_cache[i].table[afi]);
+            }
+        }
+        free(plist_cache[i].entries);
+    }
+    free(plist_cache);
+    plist_cache = NULL;
+    plist_cache_n = 0;
+    shash_clear(&plist_cache_by_name);
+}
+
+/*
+ * Parse one Prefix_List_Entry row.  "any" entries carry le 128 when they
+ * were configured for IPv6 and le 32 for IPv4.
+ */
+static bool
+plist_cache_entry_compile(struct plist_cache_entry *entry, int64_t seq,
+                          const struct ovsrec_prefix_list_entry *row)
+{
+    memset(entry, 0, sizeof *entry);
+    entry->seq = seq;
+    entry->row = row;
+    entry->ge = row->n_ge ? row->ge[0] : 0;
+    entry->le = row->n_le ? row->le[0] : 0;
+
+    if (!strcmp(row->prefix, "any")) {
+        entry->any = true;
+        if (entry->le == IPV6_MAX_BITLEN) {
+            entry->afi = AFI_IP6;
+            return str2prefix("::/0", &entry->prefix) > 0;
+        }
+        entry->afi = AFI_IP;
+        return str2prefix("0.0.0.0/0", &entry->prefix) > 0;
+    }
+
+    if (str2prefix(row->prefix, &entry->prefix) <= 0) {
+        entry->afi = AFI_IP;
+        return false;
+    }
+    apply_mask(&entry->prefix);
+    entry->afi = family2afi(entry->prefix.family);
+    return true;
+}
+
+static void
+plist_cache_list_compile(struct plist_cache_list *list,
+                         const struct ovsrec_prefix_list *row)
+{
+    struct route_node *node;
+    size_t i;
+
+    list->row = row;
+    list->n_entries = row->n_prefix_list_entries;
+    list->entries = xcalloc(list->n_entries ? list->n_entries : 1,
+                            sizeof *list->entries);
+
+    /* IDL map keys are sorted, so the entries end up in sequence order.
+     * Walking backwards keeps every same-prefix chain in that order. */
+    for (i = list->n_entries; i-- > 0; ) {
+        struct plist_cache_entry *entry = &list->entries[i];
+
+        if (!plist_cache_entry_compile(entry,
+                                       row->key_prefix_list_entries[i],
+                                       row->value_prefix_list_entries[i])) {
+            continue;
+        }
+        if (!list->table[entry->afi]) {
+            list->table[entry->afi] = route_table_init();
+        }
+        node = route_node_get(list->table[entry->afi], &entry->prefix);
+        entry->next_same_prefix = node->info;
+        node->info = entry;
+    }
+}
+
+/*
+ * Rebuild the cache if the Prefix_List or Prefix_List_Entry table changed
+ * since the last call.  Must be called with the IDL lock held.
+ */
+void
+plist_cache_refresh(void)
+{
+    const struct ovsrec_prefix_list *row;
+    unsigned int seqno;
+    unsigned int generation;
+    size_t n = 0;
+
+    seqno = ovsrec_prefix_list_get_seqno(idl)
+            + ovsrec_prefix_list_entry_get_seqno(idl);
+    generation = vtysh_ovsdb_tables_generation();
+    if (plist_cache_valid && seqno == plist_cache_seqno
+        && generation == plist_cache_generation
+        && (plist_cache_n != 0) == (ovsrec_prefix_list_first(idl) != NULL)) {
+        return;
+    }
+
+    plist_cache_clear();
+    OVSREC_PREFIX_LIST_FOR_EACH(row, idl) {
+        n++;
+    }
+    plist_cache = xcalloc(n ? n : 1, sizeof *plist_cache);
+    OVSREC_PREFIX_LIST_FOR_EACH(row, idl) {
+        struct plist_cache_list *list = &plist_cache[plist_cache_n++];
+
+        plist_cache_list_compile(list, row);
+        if (row->name) {
+            shash_add_once(&plist_cache_by_name, row->name, list);
+        }
+    }
+    plist_cache_seqno = seqno;
+    plist_cache_generation = generation;
+    plist_cache_valid = true;
+}
+
+size_t
+plist_cache_count(void)
+{
+    return plist_cache_n;
+}
+
+const struct plist_cache_list *
+plist_cache_get(size_t idx)
+{
+    return idx < plist_cache_n ? &plist_cache[idx] : NULL;
+}
+
+const struct plist_cache_list *
+plist_cache_lookup(const char *name)
+{
+    return shash_find_data(&plist_cache_by_name, name);
+}
+
+/*
+ * Return the lowest sequence entry whose prefix is exactly p.  Further
+ * entries with the same prefix follow through next_same_prefix.
+ */
+const struct plist_cache_entry *
+plist_cache_lookup_exact(const struct plist_cache_list *list,
+                         const struct prefix *p)
+{
+    struct route_table *table;
+    struct route_node *node;
+    struct prefix key;
+    const struct plist_cache_entry *entry;
+
+    table = list->table[family2afi(p->family)];
+    if (!table) {
+        return NULL;
+    }
+    prefix_copy(&key, p);
+    apply_mask(&key);
+    node = route_node_lookup(table, &key);
+    if (!node) {
+        return NULL;
+    }
+    entry = node->info;
+    route_unlock_node(node);
+    return entry;
+}
+
+static int
+plist_cache_entry_cmp(const void *a_, const void *b_)
+{
+    const struct plist_cache_entry *const *a = a_;
+    const struct plist_cache_entry *const *b = b_;
+
+    return (*a)->seq < (*b)->seq ? -1 : (*a)->seq > (*b)->seq;
+}
+
+/*
+ * Collect every entry whose prefix is equal to or more specific than p,
+ * sorted by sequence number.  The caller frees *entries.
+ */
+size_t
+plist_cache_collect_longer(const struct plist_cache_list *list,
+                           const struct prefix *p,
+                           const struct plist_cache_entry ***entries)
+{
+    struct route_table *table;
+    struct route_node *node, *start;
+    const struct plist_cache_entry *entry;
+    struct prefix key;
+    size_t n = 0, allocated = 0;
+
+    *entries = NULL;
+    table = list->table[family2afi(p->family)];
+    if (!table) {
+        return 0;
+    }
+    prefix_copy(&key, p);
+    apply_mask(&key);
+
+    /* Descend to the root of the sub-trie covered by key. */
+    start = table->top;
+    while (start && start->p.prefixlen < key.prefixlen
+           && prefix_match(&start->p, &key)) {
+        start = start->link[prefix_bit(&key.u.prefix, start->p.prefixlen)];
+    }
+    if (!start || !prefix_match(&key, &start->p)) {
+        return 0;
+    }
+
+    route_lock_node(start);
+    for (node = start; node; node = route_next_until(node, start)) {
+        for (entry = node->info; entry; entry = entry->next_same_prefix) {
+            if (n >= allocated) {
+                *entries = x2nrealloc(*entries, &allocated, sizeof **entries);
+            }
+            (*entries)[n++] = entry;
+        }
+    }
+    if (n > 1) {
+        qsort(*entries, n, sizeof **entries, plist_cache_entry_cmp);
+    }
+    return n;
+}
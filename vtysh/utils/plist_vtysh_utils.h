@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: plist_vtysh_utils.h
+ *
+ * Purpose: This file contains the compiled prefix-list cache used by the
+ *          show prefix-list commands.
+ */
+
+#ifndef _PLIST_VTY_UTILS_H
+#define _PLIST_VTY_UTILS_H
+
+#include <stdbool.h>
+#include "zebra.h"
+#include "prefix.h"
+#include "table.h"
+#include "vswitch-idl.h"
+
+/* One Prefix_List_Entry row, parsed into binary form. */
+struct plist_cache_entry {
+    int64_t seq;
+    const struct ovsrec_prefix_list_entry *row;
+    afi_t afi;
+    bool any;
+    struct prefix prefix;
+    int64_t ge;
+    int64_t le;
+    /* Next entry (in sequence order) with the same prefix. */
+    struct plist_cache_entry *next_same_prefix;
+};
+
+/* One Prefix_List row; entries are kept in sequence order. */
+struct plist_cache_list {
+    const struct ovsrec_prefix_list *row;
+    struct plist_cache_entry *entries;
+    size_t n_entries;
+    /* Per address family trie of entry prefixes.  The info pointer of a
+     * node is the lowest sequence entry carrying that prefix. */
+    struct route_table *table[AFI_MAX];
+};
+
+void plist_cache_refresh(void);
+size_t plist_cache_count(void);
+const struct plist_cache_list *plist_cache_get(size_t idx);
+const struct plist_cache_list *plist_cache_lookup(const char *name);
+
+const struct plist_cache_entry *
+plist_cache_lookup_exact(const struct plist_cache_list *list,
+                         const struct prefix *p);
+size_t
+plist_cache_collect_longer(const struct plist_cache_list *list,
+                           const struct prefix *p,
+                           const struct plist_cache_entry ***entries);
+
+#endif  /*_PLIST_VTY_UTILS_H */
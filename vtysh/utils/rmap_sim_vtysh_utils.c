@@ -0,0 +1,798 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ * File: rmap_sim_vtysh_utils.c
+ * Responsibility : Route-map what-if simulator.  A Route_Map row and the
+ *                  prefix-lists are loaded into the lib/routemap.c and
+ *                  lib/plist.c evaluators, and every BGP_Route row is run
+ *                  through them on a private copy of its attributes.
+ *                  Nothing is written back to the database.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "plist_vtysh_utils.h"
+#include "command.h"
+#include "ovsdb-idl.h"
+#include "openswitch-idl.h"
+#include "plist.h"
+#include "routemap.h"
+#include "smap.h"
+#include "timeval.h"
+#include "util.h"
+#include "vswitch-idl.h"
+#include "rmap_sim_vtysh_utils.h"
+
+extern struct ovsdb_idl *idl;
+
+#define RMAP_SIM_MAX_WORKERS    8
+#define RMAP_SIM_MIN_CHUNK      4096
+#define RMAP_SIM_SAMPLES        10
+#define RMAP_SIM_DEFAULT_WEIGHT 32768
+
+/* Path attributes a route-map can match on or change. */
+struct rmap_sim_attr {
+    int64_t metric;
+    int64_t local_pref;
+    int64_t weight;
+    char origin;
+    const char *aspath;
+    const char *community;
+    /* Set when the string was allocated by a set rule. */
+    bool own_aspath;
+    bool own_community;
+};
+
+struct rmap_sim_route {
+    const char *network;
+    struct prefix prefix;
+    struct rmap_sim_attr before;
+    struct rmap_sim_attr after;
+    bool filtered;
+    bool permitted;
+};
+
+/* Slice of the route snapshot evaluated by one worker thread. */
+struct rmap_sim_chunk {
+    struct rmap_sim_route *routes;
+    size_t n_routes;
+    struct route_map *map;
+    bool filter;
+    struct prefix_list *filter_list[AFI_MAX];
+};
+
+/* Match rules.  The rule names are the Route_Map_Entry match keys. */
+
+/* The prefix-list of a "prefix_list" match, looked up once when the rule
+ * is compiled: the lists are loaded before the route-map and the workers
+ * then go straight to the list trie for every route.  A list that does
+ * not exist never matches. */
+struct rmap_sim_plist {
+    struct prefix_list *plist;
+};
+
+static route_map_result_t
+rmap_sim_match_plist(void *rule, struct prefix *p,
+                     route_map_object_t type, void *object)
+{
+    struct rmap_sim_plist *match = rule;
+
+    if (!match->plist) {
+        return RMAP_NOMATCH;
+    }
+    return prefix_list_check(match->plist, p) == PREFIX_DENY ? RMAP_NOMATCH
+                                                             : RMAP_MATCH;
+}
+
+static void *
+rmap_sim_compile_plist(afi_t afi, const char *arg)
+{
+    struct rmap_sim_plist *match = xmalloc(sizeof *match);
+
+    match->plist = prefix_list_lookup(afi, arg);
+    return match;
+}
+
+static void *
+rmap_sim_compile_ip_plist(const char *arg)
+{
+    return rmap_sim_compile_plist(AFI_IP, arg);
+}
+
+static void *
+rmap_sim_compile_ipv6_plist(const char *arg)
+{
+    return rmap_sim_compile_plist(AFI_IP6, arg);
+}
+
+static void *
+rmap_sim_compile_str(const char *arg)
+{
+    return xstrdup(arg);
+}
+
+static void *
+rmap_sim_compile_int(const char *arg)
+{
+    int64_t *value;
+    char *end;
+    long long num;
+
+    num = strtoll(arg, &end, 10);
+    if (end == arg || *end != '\0') {
+        return NULL;
+    }
+    value = xmalloc(sizeof *value);
+    *value = num;
+    return value;
+}
+
+/* Map "igp", "egp" and "incomplete" to the BGP_Route origin code. */
+static void *
+rmap_sim_compile_origin(const char *arg)
+{
+    char *code;
+
+    if (strcmp(arg, "igp") && strcmp(arg, "egp")
+        && strcmp(arg, "incomplete")) {
+        return NULL;
+    }
+    code = xmalloc(sizeof *code);
+    *code = strcmp(arg, "incomplete") ? arg[0] : '?';
+    return code;
+}
+
+static void
+rmap_sim_free(void *rule)
+{
+    free(rule);
+}
+
+static route_map_result_t
+rmap_sim_match_metric(void *rule, struct prefix *p,
+                      route_map_object_t type, void *object)
+{
+    struct rmap_sim_attr *attr = object;
+
+    return attr->metric == *(int64_t *) rule ? RMAP_MATCH : RMAP_NOMATCH;
+}
+
+static route_map_result_t
+rmap_sim_match_origin(void *rule, struct prefix *p,
+                      route_map_object_t type, void *object)
+{
+    struct rmap_sim_attr *attr = object;
+
+    return attr->origin == *(char *) rule ? RMAP_MATCH : RMAP_NOMATCH;
+}
+
+static struct route_map_rule_cmd rmap_sim_match_cmds[] = {
+    { "prefix_list", rmap_sim_match_plist,
+      rmap_sim_compile_ip_plist, rmap_sim_free },
+    { "ipv6_prefix_list", rmap_sim_match_plist,
+      rmap_sim_compile_ipv6_plist, rmap_sim_free },
+    { "metric", rmap_sim_match_metric,
+      rmap_sim_compile_int, rmap_sim_free },
+    { "origin", rmap_sim_match_origin,
+      rmap_sim_compile_origin, rmap_sim_free },
+};
+
+/* Stands in for a match the simulator cannot evaluate.  A route the
+ * router might reject must not be reported as accepted, so the sequence
+ * holding such a match never matches. */
+#define RMAP_SIM_UNSUPPORTED "unsupported"
+
+static route_map_result_t
+rmap_sim_match_unsupported(void *rule, struct prefix *p,
+                           route_map_object_t type, void *object)
+{
+    return RMAP_NOMATCH;
+}
+
+static struct route_map_rule_cmd rmap_sim_unsupported_cmd = {
+    RMAP_SIM_UNSUPPORTED, rmap_sim_match_unsupported, NULL, NULL,
+};
+
+/* Set rules.  The rule names are the Route_Map_Entry set keys. */
+
+/* "set metric" takes an absolute value or a +N/-N adjustment. */
+struct rmap_sim_metric {
+    char op;
+    int64_t value;
+};
+
+static void *
+rmap_sim_compile_metric(const char *arg)
+{
+    struct rmap_sim_metric *metric;
+    int64_t *value;
+    char op = '=';
+
+    if (*arg == '+' || *arg == '-') {
+        op = *arg++;
+    }
+    value = rmap_sim_compile_int(arg);
+    if (!value) {
+        return NULL;
+    }
+    metric = xmalloc(sizeof *metric);
+    metric->op = op;
+    metric->value = *value;
+    free(value);
+    return metric;
+}
+
+static route_map_result_t
+rmap_sim_set_metric(void *rule, struct prefix *p,
+                    route_map_object_t type, void *object)
+{
+    struct rmap_sim_metric *metric = rule;
+    struct rmap_sim_attr *attr = object;
+
+    if (metric->op == '+') {
+        attr->metric += metric->value;
+    } else if (metric->op == '-') {
+        attr->metric = MAX(attr->metric - metric->value, 0);
+    } else {
+        attr->metric = metric->value;
+    }
+    return RMAP_OKAY;
+}
+
+static route_map_result_t
+rmap_sim_set_local_pref(void *rule, struct prefix *p,
+                        route_map_object_t type, void *object)
+{
+    ((struct rmap_sim_attr *) object)->local_pref = *(int64_t *) rule;
+    return RMAP_OKAY;
+}
+
+static route_map_result_t
+rmap_sim_set_weight(void *rule, struct prefix *p,
+                    route_map_object_t type, void *object)
+{
+    ((struct rmap_sim_attr *) object)->weight = *(int64_t *) rule;
+    return RMAP_OKAY;
+}
+
+static route_map_result_t
+rmap_sim_set_origin(void *rule, struct prefix *p,
+                    route_map_object_t type, void *object)
+{
+    ((struct rmap_sim_attr *) object)->origin = *(char *) rule;
+    return RMAP_OKAY;
+}
+
+static void
+rmap_sim_replace_str(const char **str, bool *own, char *value)
+{
+    if (*own) {
+        free(CONST_CAST(char *, *str));
+    }
+    *str = value;
+    *own = value != NULL;
+}
+
+/* "set community" replaces the communities unless the value ends in
+ * "additive"; "none" removes them. */
+static route_map_result_t
+rmap_sim_set_community(void *rule, struct prefix *p,
+                       route_map_object_t type, void *object)
+{
+    struct rmap_sim_attr *attr = object;
+    const char *value = rule;
+    const char *additive;
+    size_t len = strlen(value);
+
+    if (!strcmp(value, "none")) {
+        rmap_sim_replace_str(&attr->community, &attr->own_community, NULL);
+        return RMAP_OKAY;
+    }
+
+    additive = len > 9 ? value + len - 9 : NULL;
+    if (additive && !strcmp(additive, " additive")) {
+        len -= 9;
+        if (attr->community && attr->community[0]) {
+            rmap_sim_replace_str(&attr->community, &attr->own_community,
+                                 xasprintf("%s %.*s", attr->community,
+                                           (int) len, value));
+            return RMAP_OKAY;
+        }
+    }
+    rmap_sim_replace_str(&attr->community, &attr->own_community,
+                         xmemdup0(value, len));
+    return RMAP_OKAY;
+}
+
+static route_map_result_t
+rmap_sim_set_aspath_prepend(void *rule, struct prefix *p,
+                            route_map_object_t type, void *object)
+{
+    struct rmap_sim_attr *attr = object;
+
+    rmap_sim_replace_str(&attr->aspath, &attr->own_aspath,
+                         attr->aspath && attr->aspath[0]
+                         ? xasprintf("%s %s", (char *) rule, attr->aspath)
+                         : xstrdup(rule));
+    return RMAP_OKAY;
+}
+
+static struct route_map_rule_cmd rmap_sim_set_cmds[] = {
+    { "metric", rmap_sim_set_metric,
+      rmap_sim_compile_metric, rmap_sim_free },
+    { "local_preference", rmap_sim_set_local_pref,
+      rmap_sim_compile_int, rmap_sim_free },
+    { "weight", rmap_sim_set_weight,
+      rmap_sim_compile_int, rmap_sim_free },
+    { "origin", rmap_sim_set_origin,
+      rmap_sim_compile_origin, rmap_sim_free },
+    { "community", rmap_sim_set_community,
+      rmap_sim_compile_str, rmap_sim_free },
+    { "as_path_prepend", rmap_sim_set_aspath_prepend,
+      rmap_sim_compile_str, rmap_sim_free },
+};
+
+static void
+rmap_sim_init(void)
+{
+    static bool initialized = false;
+    size_t i;
+
+    if (initialized) {
+        return;
+    }
+    route_map_init();
+    for (i = 0; i < ARRAY_SIZE(rmap_sim_match_cmds); i++) {
+        route_map_install_match(&rmap_sim_match_cmds[i]);
+    }
+    route_map_install_match(&rmap_sim_unsupported_cmd);
+    for (i = 0; i < ARRAY_SIZE(rmap_sim_set_cmds); i++) {
+        route_map_install_set(&rmap_sim_set_cmds[i]);
+    }
+    initialized = true;
+}
+
+/*
+ * Load every Prefix_List row into lib/plist.c, one list per address
+ * family that has entries.  The created lists are returned so that the
+ * caller can delete them once the run is over.
+ */
+static size_t
+rmap_sim_load_prefix_lists(struct prefix_list ***lists)
+{
+    const struct plist_cache_list *list;
+    const struct plist_cache_entry *entry;
+    struct prefix_list *plist;
+    struct prefix_list_entry *pentry;
+    struct prefix prefix;
+    size_t i, j, n = 0, allocated = 0;
+    int afi;
+
+    *lists = NULL;
+    plist_cache_refresh();
+    for (i = 0; i < plist_cache_count(); i++) {
+        list = plist_cache_get(i);
+        if (!list->row->name) {
+            continue;
+        }
+        for (afi = AFI_IP; afi < AFI_MAX; afi++) {
+            if (!list->table[afi]) {
+                continue;
+            }
+            plist = prefix_list_get(afi, list->row->name);
+            if (n >= allocated) {
+                *lists = x2nrealloc(*lists, &allocated, sizeof **lists);
+            }
+            (*lists)[n++] = plist;
+
+            for (j = 0; j < list->n_entries; j++) {
+                entry = &list->entries[j];
+                if (entry->afi != afi || entry->prefix.family == 0) {
+                    continue;
+                }
+                prefix = entry->prefix;
+                pentry = prefix_list_entry_make(
+                            &prefix,
+                            entry->row->action
+                            && !strcmp(entry->row->action, "deny")
+                            ? PREFIX_DENY : PREFIX_PERMIT,
+                            entry->seq, entry->le, entry->ge, entry->any);
+                prefix_list_entry_add(plist, pentry);
+            }
+        }
+    }
+    return n;
+}
+
+/*
+ * Build a lib/routemap.c map from a Route_Map row.  Must be called after
+ * rmap_sim_load_prefix_lists(), the prefix-list matches are resolved
+ * here.  A sequence with a match the simulator cannot evaluate never
+ * matches; set keys it cannot apply are left out.  Both are reported.
+ */
+static struct route_map *
+rmap_sim_load_route_map(struct vty *vty, const struct ovsrec_route_map *row)
+{
+    const struct ovsrec_route_map_entry *entry;
+    struct route_map_index *index;
+    struct route_map *map;
+    struct smap_node *node;
+    size_t i;
+    int ret;
+
+    map = route_map_lookup_by_name(row->name);
+    if (map) {
+        route_map_delete(map);
+    }
+    map = route_map_get(row->name);
+
+    for (i = 0; i < row->n_route_map_entries; i++) {
+        entry = row->value_route_map_entries[i];
+        index = route_map_index_get(map,
+                                    entry->action
+                                    && !strcmp(entry->action, "deny")
+                                    ? RMAP_DENY : RMAP_PERMIT,
+                                    row->key_route_map_entries[i]);
+
+        SMAP_FOR_EACH (node, &entry->match) {
+            ret = route_map_add_match(index, node->key, node->value);
+            if (ret == RMAP_RULE_MISSING) {
+                vty_out(vty, "%% Sequence %d: match %s is not simulated, "
+                        "the sequence never matches%s", index->pref,
+                        node->key, VTY_NEWLINE);
+            } else if (ret == RMAP_COMPILE_ERROR) {
+                vty_out(vty, "%% Sequence %d: match %s %s could not be "
+                        "parsed, the sequence never matches%s", index->pref,
+                        node->key, node->value, VTY_NEWLINE);
+            }
+            if (ret == RMAP_RULE_MISSING || ret == RMAP_COMPILE_ERROR) {
+                route_map_add_match(index, RMAP_SIM_UNSUPPORTED, NULL);
+            }
+        }
+        SMAP_FOR_EACH (node, &entry->set) {
+            ret = route_map_add_set(index, node->key, node->value);
+            if (ret == RMAP_RULE_MISSING) {
+                vty_out(vty, "%% Sequence %d: set %s is not simulated "
+                        "and was ignored%s", index->pref, node->key,
+                        VTY_NEWLINE);
+            } else if (ret == RMAP_COMPILE_ERROR) {
+                vty_out(vty, "%% Sequence %d: set %s %s could not be "
+                        "parsed and was ignored%s", index->pref, node->key,
+                        node->value, VTY_NEWLINE);
+            }
+        }
+    }
+    return map;
+}
+
+/* Copy the BGP_Route table into plain structures the workers can read
+ * without touching the IDL. */
+static size_t
+rmap_sim_snapshot_routes(struct rmap_sim_route **routes)
+{
+    const struct ovsrec_bgp_route *row;
+    struct rmap_sim_route *route;
+    const char *origin;
+    size_t n = 0;
+
+    OVSREC_BGP_ROUTE_FOR_EACH (row, idl) {
+        n++;
+    }
+    *routes = xcalloc(n ? n : 1, sizeof **routes);
+
+    n = 0;
+    OVSREC_BGP_ROUTE_FOR_EACH (row, idl) {
+        route = &(*routes)[n];
+        if (!row->prefix || str2prefix(row->prefix, &route->prefix) <= 0) {
+            continue;
+        }
+        route->network = row->prefix;
+        route->before.metric = row->n_metric ? *row->metric : 0;
+        route->before.local_pref =
+            smap_get_int(&row->path_attributes,
+                         OVSDB_BGP_ROUTE_PATH_ATTRIBUTES_LOC_PREF, 0);
+        route->before.weight =
+            smap_get_int(&row->path_attributes,
+                         OVSDB_BGP_ROUTE_PATH_ATTRIBUTES_WEIGHT,
+                         RMAP_SIM_DEFAULT_WEIGHT);
+        origin = smap_get(&row->path_attributes,
+                          OVSDB_BGP_ROUTE_PATH_ATTRIBUTES_ORIGIN);
+        route->before.origin = origin && origin[0] ? origin[0] : '?';
+        route->before.aspath =
+            smap_get(&row->path_attributes,
+                     OVSDB_BGP_ROUTE_PATH_ATTRIBUTES_AS_PATH);
+        route->before.community =
+            smap_get(&row->path_attributes,
+                     OVSDB_BGP_ROUTE_PATH_ATTRIBUTES_COMMUNITY);
+        n++;
+    }
+    return n;
+}
+
+static void *
+rmap_sim_worker(void *chunk_)
+{
+    struct rmap_sim_chunk *chunk = chunk_;
+    struct rmap_sim_route *route;
+    struct prefix **prefixes;
+    route_map_result_t *results;
+    void **objects;
+    size_t i, n = 0, size = MAX(chunk->n_routes, 1);
+
+    prefixes = xmalloc(size * sizeof *prefixes);
+    objects = xmalloc(size * sizeof *objects);
+    results = xmalloc(size * sizeof *results);
+
+    for (i = 0; i < chunk->n_routes; i++) {
+        route = &chunk->routes[i];
+        route->after = route->before;
+        if (chunk->filter
+            && prefix_list_check(
+                   chunk->filter_list[family2afi(route->prefix.family)],
+                   &route->prefix) == PREFIX_DENY) {
+            route->filtered = true;
+            continue;
+        }
+        prefixes[n] = &route->prefix;
+        objects[n] = &route->after;
+        n++;
+    }
+
+    route_map_apply_many(chunk->map, prefixes, RMAP_BGP, objects, results,
+                         n);
+
+    for (i = 0; i < n; i++) {
+        route = CONTAINER_OF(objects[i], struct rmap_sim_route, after);
+        route->permitted = results[i] != RMAP_DENYMATCH;
+    }
+
+    free(prefixes);
+    free(objects);
+    free(results);
+    return NULL;
+}
+
+/* Split the routes into chunks and evaluate them on up to
+ * RMAP_SIM_MAX_WORKERS threads.  Returns the number of workers used. */
+static int
+rmap_sim_evaluate(struct rmap_sim_route *routes, size_t n_routes,
+                  struct route_map *map, const char *plist_name)
+{
+    struct rmap_sim_chunk chunks[RMAP_SIM_MAX_WORKERS];
+    pthread_t threads[RMAP_SIM_MAX_WORKERS];
+    bool started[RMAP_SIM_MAX_WORKERS];
+    long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t per_chunk, offset = 0;
+    int n_workers, i, afi;
+
+    n_workers = MIN(MAX(n_cpus, 1), RMAP_SIM_MAX_WORKERS);
+    n_workers = MIN(n_workers, DIV_ROUND_UP(n_routes, RMAP_SIM_MIN_CHUNK));
+    n_workers = MAX(n_workers, 1);
+    per_chunk = DIV_ROUND_UP(n_routes, n_workers);
+
+    /* Compile the map up front; the workers only read it. */
+    route_map_apply_many(map, NULL, RMAP_BGP, NULL, NULL, 0);
+
+    for (i = 0; i < n_workers; i++) {
+        memset(&chunks[i], 0, sizeof chunks[i]);
+        chunks[i].routes = routes + offset;
+        chunks[i].n_routes = MIN(per_chunk, n_routes - offset);
+        chunks[i].map = map;
+        if (plist_name) {
+            chunks[i].filter = true;
+            for (afi = AFI_IP; afi < AFI_MAX; afi++) {
+                chunks[i].filter_list[afi] = prefix_list_lookup(afi,
+                                                                plist_name);
+            }
+        }
+        offset += chunks[i].n_routes;
+    }
+
+    /* The calling thread takes the first chunk itself. */
+    for (i = 1; i < n_workers; i++) {
+        started[i] = !pthread_create(&threads[i], NULL, rmap_sim_worker,
+                                     &chunks[i]);
+        if (!started[i]) {
+            rmap_sim_worker(&chunks[i]);
+        }
+    }
+    rmap_sim_worker(&chunks[0]);
+    for (i = 1; i < n_workers; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    return n_workers;
+}
+
+static bool
+rmap_sim_str_changed(const char *a, const char *b)
+{
+    return strcmp(a ? a : "", b ? b : "") != 0;
+}
+
+static bool
+rmap_sim_route_changed(const struct rmap_sim_route *route)
+{
+    const struct rmap_sim_attr *a = &route->before;
+    const struct rmap_sim_attr *b = &route->after;
+
+    return a->metric != b->metric || a->local_pref != b->local_pref
+           || a->weight != b->weight || a->origin != b->origin
+           || rmap_sim_str_changed(a->aspath, b->aspath)
+           || rmap_sim_str_changed(a->community, b->community);
+}
+
+static void
+rmap_sim_show_change(struct vty *vty, const char **sep, const char *what,
+                     const char *before, const char *after)
+{
+    vty_out(vty, "%s%s %s -> %s", *sep, what,
+            before && before[0] ? before : "(none)",
+            after && after[0] ? after : "(none)");
+    *sep = ", ";
+}
+
+static void
+rmap_sim_show_route(struct vty *vty, const struct rmap_sim_route *route)
+{
+    const struct rmap_sim_attr *a = &route->before;
+    const struct rmap_sim_attr *b = &route->after;
+    const char *sep = "";
+    char before[24], after[24];
+
+    vty_out(vty, "%-24s %-9s ", route->network,
+            route->filtered ? "filtered"
+            : route->permitted ? "permit" : "deny");
+    if (route->permitted) {
+        if (a->metric != b->metric) {
+            snprintf(before, sizeof before, "%"PRId64, a->metric);
+            snprintf(after, sizeof after, "%"PRId64, b->metric);
+            rmap_sim_show_change(vty, &sep, "metric", before, after);
+        }
+        if (a->local_pref != b->local_pref) {
+            snprintf(before, sizeof before, "%"PRId64, a->local_pref);
+            snprintf(after, sizeof after, "%"PRId64, b->local_pref);
+            rmap_sim_show_change(vty, &sep, "local-pref", before, after);
+        }
+        if (a->weight != b->weight) {
+            snprintf(before, sizeof before, "%"PRId64, a->weight);
+            snprintf(after, sizeof after, "%"PRId64, b->weight);
+            rmap_sim_show_change(vty, &sep, "weight", before, after);
+        }
+        if (a->origin != b->origin) {
+            snprintf(before, sizeof before, "%c", a->origin);
+            snprintf(after, sizeof after, "%c", b->origin);
+            rmap_sim_show_change(vty, &sep, "origin", before, after);
+        }
+        if (rmap_sim_str_changed(a->aspath, b->aspath)) {
+            rmap_sim_show_change(vty, &sep, "as-path", a->aspath, b->aspath);
+        }
+        if (rmap_sim_str_changed(a->community, b->community)) {
+            rmap_sim_show_change(vty, &sep, "community",
+                                 a->community, b->community);
+        }
+    }
+    vty_out(vty, "%s", VTY_NEWLINE);
+}
+
+/*
+ * Run Route_Map rmap_name, optionally behind prefix-list plist_name, over
+ * every BGP_Route row and report what it would accept, reject or modify.
+ * Must be called with the IDL lock held.
+ */
+int
+rmap_sim_run(struct vty *vty, const char *rmap_name, const char *plist_name)
+{
+    const struct ovsrec_route_map *row;
+    struct rmap_sim_route *routes, *route;
+    struct prefix_list **lists;
+    struct route_map *map;
+    size_t n_routes, n_lists, i;
+    size_t n_permit = 0, n_deny = 0, n_filtered = 0, n_modified = 0;
+    size_t n_samples = 0;
+    long long int start;
+    int n_workers;
+
+    OVSREC_ROUTE_MAP_FOR_EACH (row, idl) {
+        if (row->name && !strcmp(row->name, rmap_name)) {
+            break;
+        }
+    }
+    if (!row) {
+        vty_out(vty, "%% Route-map %s not found%s", rmap_name, VTY_NEWLINE);
+        return CMD_WARNING;
+    }
+    plist_cache_refresh();
+    if (plist_name && !plist_cache_lookup(plist_name)) {
+        vty_out(vty, "%% Prefix-list %s not found%s", plist_name,
+                VTY_NEWLINE);
+        return CMD_WARNING;
+    }
+
+    start = time_msec();
+    rmap_sim_init();
+    n_lists = rmap_sim_load_prefix_lists(&lists);
+    map = rmap_sim_load_route_map(vty, row);
+    n_routes = rmap_sim_snapshot_routes(&routes);
+    n_workers = rmap_sim_evaluate(routes, n_routes, map, plist_name);
+
+    for (i = 0; i < n_routes; i++) {
+        route = &routes[i];
+        if (route->filtered) {
+            n_filtered++;
+        } else if (!route->permitted) {
+            n_deny++;
+        } else {
+            n_permit++;
+            if (rmap_sim_route_changed(route)) {
+                n_modified++;
+            }
+        }
+    }
+
+    vty_out(vty, "Route-map %s%s%s tested against %"PRIuSIZE" routes "
+            "in %lld ms (%d worker%s)%s", rmap_name,
+            plist_name ? " with prefix-list " : "",
+            plist_name ? plist_name : "", n_routes,
+            time_msec() - start, n_workers, n_workers > 1 ? "s" : "",
+            VTY_NEWLINE);
+    vty_out(vty, "Nothing was written to the database.%s%s",
+            VTY_NEWLINE, VTY_NEWLINE);
+    vty_out(vty, "  Accepted           : %"PRIuSIZE"%s", n_permit,
+            VTY_NEWLINE);
+    vty_out(vty, "    Modified         : %"PRIuSIZE"%s", n_modified,
+            VTY_NEWLINE);
+    vty_out(vty, "  Rejected           : %"PRIuSIZE"%s",
+            n_deny + n_filtered, VTY_NEWLINE);
+    if (plist_name) {
+        vty_out(vty, "    By prefix-list   : %"PRIuSIZE"%s", n_filtered,
+                VTY_NEWLINE);
+    }
+
+    for (i = 0; i < n_routes && n_samples < RMAP_SIM_SAMPLES; i++) {
+        route = &routes[i];
+        if (route->permitted && !rmap_sim_route_changed(route)) {
+            continue;
+        }
+        if (!n_samples++) {
+            vty_out(vty, "%sSample of rejected and modified routes:%s",
+                    VTY_NEWLINE, VTY_NEWLINE);
+            vty_out(vty, "%-24s %-9s %s%s", "Network", "Result", "Changes",
+                    VTY_NEWLINE);
+        }
+        rmap_sim_show_route(vty, route);
+    }
+
+    for (i = 0; i < n_routes; i++) {
+        if (routes[i].after.own_aspath) {
+            free(CONST_CAST(char *, routes[i].after.aspath));
+        }
+        if (routes[i].after.own_community) {
+            free(CONST_CAST(char *, routes[i].after.community));
+        }
+    }
+    free(routes);
+    route_map_delete(map);
+    for (i = 0; i < n_lists; i++) {
+        prefix_list_delete(lists[i]);
+    }
+    free(lists);
+    return CMD_SUCCESS;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: rmap_sim_vtysh_utils.h
+ *
+ * Purpose: This file contains the route-map what-if simulator used by the
+ *          test route-map command.
+ */
+
+#ifndef _RMAP_SIM_VTY_UTILS_H
+#define _RMAP_SIM_VTY_UTILS_H
+
+#include "vty.h"
+
+int rmap_sim_run(struct vty *vty, const char *rmap_name,
+                 const char *plist_name);
+
+#endif  /*_RMAP_SIM_VTY_UTILS_H */
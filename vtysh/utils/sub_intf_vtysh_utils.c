@@ -0,0 +1,480 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ * File: sub_intf_vtysh_utils.c
+ * Responsibility : Index of the Interface, Port and VRF tables for the
+ *                  subinterface commands: rows by name, the VRF of every
+ *                  port, subinterfaces by (parent interface, encapsulation
+ *                  VLAN) and the subinterfaces of every parent, ordered by
+ *                  subinterface number.  Creating or configuring a
+ *                  subinterface then costs a few lookups instead of scans
+ *                  of every table.  The rows the IDL change tracking reports
+ *                  as inserted, modified or deleted are filed again, under
+ *                  the keys recorded for them, instead of rebuilding the
+ *                  index.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "hmap.h"
+#include "ovsdb-idl.h"
+#include "openswitch-idl.h"
+#include "shash.h"
+#include "util.h"
+#include "uuid.h"
+#include "sub_intf_vtysh_utils.h"
+#include "vtysh/vtysh_ovsdb_if.h"
+
+extern struct ovsdb_idl *idl;
+
+/* Subinterfaces of one parent, ordered by subinterface number. */
+struct sub_intf_children {
+    const struct ovsrec_interface **rows;
+    size_t n;
+    size_t allocated;
+};
+
+/* The keys an Interface, Port or VRF row is filed under.  A deleted row
+ * no longer shows its columns, so they are kept to unfile it. */
+struct sub_intf_index_row {
+    struct hmap_node node;      /* In sub_intf_index.rows, by row UUID. */
+    const struct ovsdb_idl_row *row;
+    char *name;                 /* In interfaces, ports or vrfs. */
+    char *encap;                /* In encaps, subinterfaces only. */
+    char *parent;               /* In children, subinterfaces only. */
+    char **port_names;          /* In port_vrfs, VRFs only. */
+    size_t n_port_names;
+};
+
+static struct {
+    bool valid;
+    unsigned int generation;
+    struct hmap rows;           /* struct sub_intf_index_row. */
+    struct shash interfaces;    /* Name -> Interface. */
+    struct shash ports;         /* Name -> Port. */
+    struct shash vrfs;          /* Name -> VRF. */
+    struct shash port_vrfs;     /* Port name -> VRF. */
+    struct shash encaps;        /* "parent/vlan" -> subinterface. */
+    struct shash children;      /* Parent name -> struct sub_intf_children. */
+} sub_intf_index;
+
+static void
+sub_intf_index_row_free(struct sub_intf_index_row *rec)
+{
+    size_t i;
+
+    for (i = 0; i < rec->n_port_names; i++) {
+        free(rec->port_names[i]);
+    }
+    free(rec->port_names);
+    free(rec->name);
+    free(rec->encap);
+    free(rec->parent);
+    free(rec);
+}
+
+static void
+sub_intf_index_clear(void)
+{
+    struct sub_intf_index_row *rec;
+    struct shash_node *node;
+
+    if (!sub_intf_index.valid) {
+        return;
+    }
+    HMAP_FOR_EACH_POP (rec, node, &sub_intf_index.rows) {
+        sub_intf_index_row_free(rec);
+    }
+    hmap_destroy(&sub_intf_index.rows);
+    SHASH_FOR_EACH (node, &sub_intf_index.children) {
+        struct sub_intf_children *children = node->data;
+
+        free(children->rows);
+        free(children);
+    }
+    shash_destroy(&sub_intf_index.interfaces);
+    shash_destroy(&sub_intf_index.ports);
+    shash_destroy(&sub_intf_index.vrfs);
+    shash_destroy(&sub_intf_index.port_vrfs);
+    shash_destroy(&sub_intf_index.encaps);
+    shash_destroy(&sub_intf_index.children);
+    sub_intf_index.valid = false;
+}
+
+static char *
+sub_intf_index_encap_key(const struct ovsrec_interface *parent, int64_t vlan)
+{
+    return xasprintf("%s/%"PRId64, parent->name, vlan);
+}
+
+/* Subinterface number of a "parent.number" name. */
+static unsigned long long
+sub_intf_index_number(const struct ovsrec_interface *row)
+{
+    const char *dot = strrchr(row->name, '.');
+
+    return dot ? strtoull(dot + 1, NULL, 10) : 0;
+}
+
+static int
+sub_intf_index_number_cmp(const void *a_, const void *b_)
+{
+    const struct ovsrec_interface *const *a = a_;
+    const struct ovsrec_interface *const *b = b_;
+    unsigned long long na = sub_intf_index_number(*a);
+    unsigned long long nb = sub_intf_index_number(*b);
+
+    if (na != nb) {
+        return na < nb ? -1 : 1;
+    }
+    return strcmp((*a)->name, (*b)->name);
+}
+
+/* Files row, a subinterface, under its parent and returns the parent
+ * name, or NULL if the name has no parent part. */
+static char *
+sub_intf_index_add_child(const struct ovsrec_interface *row)
+{
+    struct sub_intf_children *children;
+    const char *dot = strrchr(row->name, '.');
+    char *parent_name;
+    size_t lo, hi, mid;
+
+    if (!dot) {
+        return NULL;
+    }
+    parent_name = xmemdup0(row->name, dot - row->name);
+    children = shash_find_data(&sub_intf_index.children, parent_name);
+    if (!children) {
+        children = xzalloc(sizeof *children);
+        shash_add(&sub_intf_index.children, parent_name, children);
+    }
+
+    if (children->n >= children->allocated) {
+        children->rows = x2nrealloc(children->rows, &children->allocated,
+                                    sizeof *children->rows);
+    }
+    lo = 0;
+    hi = children->n;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (sub_intf_index_number_cmp(&children->rows[mid], &row) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    memmove(&children->rows[lo + 1], &children->rows[lo],
+            (children->n - lo) * sizeof *children->rows);
+    children->rows[lo] = row;
+    children->n++;
+    return parent_name;
+}
+
+static void
+sub_intf_index_remove_child(const char *parent_name,
+                            const struct ovsdb_idl_row *row)
+{
+    struct shash_node *node = shash_find(&sub_intf_index.children,
+                                         parent_name);
+    struct sub_intf_children *children = node ? node->data : NULL;
+    size_t i;
+
+    for (i = 0; children && i < children->n; i++) {
+        if (&children->rows[i]->header_ == row) {
+            children->n--;
+            memmove(&children->rows[i], &children->rows[i + 1],
+                    (children->n - i) * sizeof *children->rows);
+            break;
+        }
+    }
+    if (children && !children->n) {
+        free(children->rows);
+        free(children);
+        shash_delete(&sub_intf_index.children, node);
+    }
+}
+
+/* Removes key from sh if it still maps to data. */
+static void
+sub_intf_index_remove(struct shash *sh, const char *key, const void *data)
+{
+    struct shash_node *node = key ? shash_find(sh, key) : NULL;
+
+    if (node && node->data == data) {
+        shash_delete(sh, node);
+    }
+}
+
+static struct sub_intf_index_row *
+sub_intf_index_row_find(const struct ovsdb_idl_row *row)
+{
+    struct sub_intf_index_row *rec;
+
+    HMAP_FOR_EACH_WITH_HASH (rec, node, uuid_hash(&row->uuid),
+                             &sub_intf_index.rows) {
+        if (rec->row == row) {
+            return rec;
+        }
+    }
+    return NULL;
+}
+
+static struct sub_intf_index_row *
+sub_intf_index_row_add(const struct ovsdb_idl_row *row, const char *name)
+{
+    struct sub_intf_index_row *rec = xzalloc(sizeof *rec);
+
+    rec->row = row;
+    rec->name = xstrdup(name);
+    hmap_insert(&sub_intf_index.rows, &rec->node, uuid_hash(&row->uuid));
+    return rec;
+}
+
+/* Unfiles row from every key it was filed under. */
+static void
+sub_intf_index_unfile(const struct ovsdb_idl_row *row)
+{
+    struct sub_intf_index_row *rec = sub_intf_index_row_find(row);
+    size_t i;
+
+    if (!rec) {
+        return;
+    }
+    sub_intf_index_remove(&sub_intf_index.interfaces, rec->name, row);
+    sub_intf_index_remove(&sub_intf_index.ports, rec->name, row);
+    sub_intf_index_remove(&sub_intf_index.vrfs, rec->name, row);
+    sub_intf_index_remove(&sub_intf_index.encaps, rec->encap, row);
+    if (rec->parent) {
+        sub_intf_index_remove_child(rec->parent, row);
+    }
+    for (i = 0; i < rec->n_port_names; i++) {
+        sub_intf_index_remove(&sub_intf_index.port_vrfs, rec->port_names[i],
+                              row);
+    }
+    hmap_remove(&sub_intf_index.rows, &rec->node);
+    sub_intf_index_row_free(rec);
+}
+
+static void
+sub_intf_index_file_interface(const struct ovsrec_interface *intf_row)
+{
+    struct sub_intf_index_row *rec;
+
+    rec = sub_intf_index_row_add(&intf_row->header_, intf_row->name);
+    shash_replace(&sub_intf_index.interfaces, intf_row->name, intf_row);
+    if (strcmp(intf_row->type, OVSREC_INTERFACE_TYPE_VLANSUBINT)) {
+        return;
+    }
+    rec->parent = sub_intf_index_add_child(intf_row);
+    if (intf_row->n_subintf_parent > 0
+        && intf_row->value_subintf_parent[0]
+        && intf_row->key_subintf_parent[0]) {
+        rec->encap = sub_intf_index_encap_key(
+                         intf_row->value_subintf_parent[0],
+                         intf_row->key_subintf_parent[0]);
+        shash_replace(&sub_intf_index.encaps, rec->encap, intf_row);
+    }
+}
+
+static void
+sub_intf_index_file_port(const struct ovsrec_port *port_row)
+{
+    sub_intf_index_row_add(&port_row->header_, port_row->name);
+    shash_replace(&sub_intf_index.ports, port_row->name, port_row);
+}
+
+static void
+sub_intf_index_file_vrf(const struct ovsrec_vrf *vrf_row)
+{
+    struct sub_intf_index_row *rec;
+    size_t i;
+
+    rec = sub_intf_index_row_add(&vrf_row->header_, vrf_row->name);
+    shash_replace(&sub_intf_index.vrfs, vrf_row->name, vrf_row);
+    rec->port_names = xmalloc(MAX(vrf_row->n_ports, 1)
+                              * sizeof *rec->port_names);
+    for (i = 0; i < vrf_row->n_ports; i++) {
+        rec->port_names[i] = xstrdup(vrf_row->ports[i]->name);
+        shash_replace(&sub_intf_index.port_vrfs, vrf_row->ports[i]->name,
+                      vrf_row);
+    }
+    rec->n_port_names = vrf_row->n_ports;
+}
+
+static void
+sub_intf_index_build(void)
+{
+    const struct ovsrec_interface *intf_row;
+    const struct ovsrec_port *port_row;
+    const struct ovsrec_vrf *vrf_row;
+
+    hmap_init(&sub_intf_index.rows);
+    shash_init(&sub_intf_index.interfaces);
+    shash_init(&sub_intf_index.ports);
+    shash_init(&sub_intf_index.vrfs);
+    shash_init(&sub_intf_index.port_vrfs);
+    shash_init(&sub_intf_index.encaps);
+    shash_init(&sub_intf_index.children);
+
+    OVSREC_INTERFACE_FOR_EACH (intf_row, idl) {
+        sub_intf_index_file_interface(intf_row);
+    }
+    OVSREC_PORT_FOR_EACH (port_row, idl) {
+        sub_intf_index_file_port(port_row);
+    }
+    OVSREC_VRF_FOR_EACH (vrf_row, idl) {
+        sub_intf_index_file_vrf(vrf_row);
+    }
+}
+
+/* Files the Interface, Port and VRF rows the IDL change tracking reports
+ * again.  Every changed row is unfiled before any is filed, so that a row
+ * taking over the name of another one is not unfiled with it.  Run by
+ * vtysh_ovsdb_track_run(). */
+static void
+sub_intf_index_track(void)
+{
+    const struct ovsrec_interface *intf_row;
+    const struct ovsrec_port *port_row;
+    const struct ovsrec_vrf *vrf_row;
+
+    if (!sub_intf_index.valid
+        || sub_intf_index.generation != vtysh_ovsdb_tables_generation()) {
+        return;
+    }
+
+    OVSREC_INTERFACE_FOR_EACH_TRACKED (intf_row, idl) {
+        sub_intf_index_unfile(&intf_row->header_);
+    }
+    OVSREC_PORT_FOR_EACH_TRACKED (port_row, idl) {
+        sub_intf_index_unfile(&port_row->header_);
+    }
+    OVSREC_VRF_FOR_EACH_TRACKED (vrf_row, idl) {
+        sub_intf_index_unfile(&vrf_row->header_);
+    }
+
+    OVSREC_INTERFACE_FOR_EACH_TRACKED (intf_row, idl) {
+        if (!ovsrec_interface_is_deleted(intf_row)) {
+            sub_intf_index_file_interface(intf_row);
+        }
+    }
+    OVSREC_PORT_FOR_EACH_TRACKED (port_row, idl) {
+        if (!ovsrec_port_is_deleted(port_row)) {
+            sub_intf_index_file_port(port_row);
+        }
+    }
+    OVSREC_VRF_FOR_EACH_TRACKED (vrf_row, idl) {
+        if (!ovsrec_vrf_is_deleted(vrf_row)) {
+            sub_intf_index_file_vrf(vrf_row);
+        }
+    }
+}
+
+void
+sub_intf_index_init(void)
+{
+    ovsdb_idl_track_add_column(idl, &ovsrec_interface_col_name);
+    ovsdb_idl_track_add_column(idl, &ovsrec_interface_col_type);
+    ovsdb_idl_track_add_column(idl, &ovsrec_interface_col_subintf_parent);
+    ovsdb_idl_track_add_column(idl, &ovsrec_port_col_name);
+    ovsdb_idl_track_add_column(idl, &ovsrec_vrf_col_name);
+    ovsdb_idl_track_add_column(idl, &ovsrec_vrf_col_ports);
+    vtysh_ovsdb_track_register(sub_intf_index_track);
+}
+
+/* Must be called with the IDL lock held. */
+static void
+sub_intf_index_refresh(void)
+{
+    unsigned int generation = vtysh_ovsdb_tables_generation();
+
+    vtysh_ovsdb_track_run();
+    if (sub_intf_index.valid && sub_intf_index.generation == generation) {
+        return;
+    }
+    sub_intf_index_clear();
+    sub_intf_index_build();
+    sub_intf_index.generation = generation;
+    sub_intf_index.valid = true;
+}
+
+const struct ovsrec_interface *
+sub_intf_index_interface(const char *name)
+{
+    sub_intf_index_refresh();
+    return name ? shash_find_data(&sub_intf_index.interfaces, name) : NULL;
+}
+
+const struct ovsrec_port *
+sub_intf_index_port(const char *name)
+{
+    sub_intf_index_refresh();
+    return name ? shash_find_data(&sub_intf_index.ports, name) : NULL;
+}
+
+const struct ovsrec_vrf *
+sub_intf_index_vrf(const char *name)
+{
+    sub_intf_index_refresh();
+    return name ? shash_find_data(&sub_intf_index.vrfs, name) : NULL;
+}
+
+/* Get the VRF the port named port_name is attached to. */
+const struct ovsrec_vrf *
+sub_intf_index_port_vrf(const char *port_name)
+{
+    sub_intf_index_refresh();
+    return port_name ? shash_find_data(&sub_intf_index.port_vrfs, port_name)
+                     : NULL;
+}
+
+/* Get the subinterface of parent that encapsulates VLAN vlan. */
+const struct ovsrec_interface *
+sub_intf_index_encapsulation(const struct ovsrec_interface *parent,
+                             int64_t vlan)
+{
+    const struct ovsrec_interface *row;
+    char *key;
+
+    if (!parent || !vlan) {
+        return NULL;
+    }
+    sub_intf_index_refresh();
+    key = sub_intf_index_encap_key(parent, vlan);
+    row = shash_find_data(&sub_intf_index.encaps, key);
+    free(key);
+    return row;
+}
+
+/*
+ * Return the subinterfaces named "parent_name.N", ordered by N, and store
+ * their number in *n.
+ */
+const struct ovsrec_interface **
+sub_intf_index_children(const char *parent_name, size_t *n)
+{
+    const struct sub_intf_children *children;
+
+    sub_intf_index_refresh();
+    children = parent_name ? shash_find_data(&sub_intf_index.children,
+                                             parent_name)
+                           : NULL;
+    *n = children ? children->n : 0;
+    return children ? children->rows : NULL;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: sub_intf_vtysh_utils.h
+ *
+ * Purpose: This file contains the interface, port and subinterface index
+ *          used by the subinterface commands.
+ */
+
+#ifndef _SUB_INTF_VTY_UTILS_H
+#define _SUB_INTF_VTY_UTILS_H
+
+#include <stdint.h>
+#include "vswitch-idl.h"
+
+void sub_intf_index_init(void);
+const struct ovsrec_interface *sub_intf_index_interface(const char *name);
+const struct ovsrec_port *sub_intf_index_port(const char *name);
+const struct ovsrec_vrf *sub_intf_index_vrf(const char *name);
+const struct ovsrec_vrf *sub_intf_index_port_vrf(const char *port_name);
+const struct ovsrec_interface *
+sub_intf_index_encapsulation(const struct ovsrec_interface *parent,
+                             int64_t vlan);
+const struct ovsrec_interface **
+sub_intf_index_children(const char *parent_name, size_t *n);
+
+#endif  /*_SUB_INTF_VTY_UTILS_H */
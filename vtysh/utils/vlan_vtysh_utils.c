@@ -34,6 +34,9 @@
 #include "vswitch-idl.h"
 #include "ovsdb-idl.h"
 #include "smap.h"
+#include "bitmap.h"
+#include "hmap.h"
+#include "uuid.h"
 #include "openvswitch/vlog.h"
 #include "openswitch-idl.h"
 #include "utils/vlan_vtysh_utils.h"
@@ -44,6 +47,265 @@ VLOG_DEFINE_THIS_MODULE(vlan_vtysh_utils);
 
 extern struct ovsdb_idl *idl;
 
+/* Bitmaps indexed by VLAN id, so "is this VLAN used" costs a bit test
+ * instead of a scan of the VLAN, Interface and Port tables.  The rows the
+ * IDL change tracking reports as changed set or clear their own bit. */
+static struct {
+    bool valid;
+    unsigned int generation;                /* Of the IDL they index. */
+    struct hmap rows;                       /* struct vlan_bitmaps_row. */
+    unsigned long in_use[BITMAP_N_LONGS(VLAN_BITMAP_BITS)];   /* VLAN rows. */
+    unsigned long internal[BITMAP_N_LONGS(VLAN_BITMAP_BITS)]; /* L3 ports. */
+    unsigned long intf[BITMAP_N_LONGS(VLAN_BITMAP_BITS)];   /* "vlanN" rows */
+    unsigned long port[BITMAP_N_LONGS(VLAN_BITMAP_BITS)];   /* of each table. */
+    const struct ovsrec_bridge *bridge;     /* DEFAULT_BRIDGE_NAME. */
+    const struct ovsrec_vrf *vrf;           /* DEFAULT_VRF_NAME. */
+} vlan_bitmaps = {
+    .rows = HMAP_INITIALIZER(&vlan_bitmaps.rows),
+};
+
+/* A row that has a bit set, and the bits, which a deleted row no longer
+ * shows. */
+struct vlan_bitmaps_row {
+    struct hmap_node node;                  /* In vlan_bitmaps.rows. */
+    const struct ovsdb_idl_row *row;
+    unsigned long *bitmap;                  /* in_use, intf or port. */
+    int vlanid;
+    bool internal;
+};
+
+/* Returns the VLAN id of a VLAN interface name written "vlanN", as
+ * GET_VLANIF() builds it, or 0 for any other name. */
+static int
+vlan_if_id(const char *name)
+{
+    char *endptr = NULL;
+    long vlanid;
+
+    if (strncmp(name, "vlan", 4) || name[4] < '1' || name[4] > '9') {
+        return 0;
+    }
+    vlanid = strtol(name + 4, &endptr, 10);
+    if (*endptr != '\0' || vlanid >= VLAN_BITMAP_BITS - 1) {
+        return 0;
+    }
+    return vlanid;
+}
+
+static void
+vlan_bitmaps_set(const struct ovsdb_idl_row *row, unsigned long *bitmap,
+                 int vlanid, bool internal)
+{
+    struct vlan_bitmaps_row *rec = xmalloc(sizeof *rec);
+
+    rec->row = row;
+    rec->bitmap = bitmap;
+    rec->vlanid = vlanid;
+    rec->internal = internal;
+    hmap_insert(&vlan_bitmaps.rows, &rec->node, uuid_hash(&row->uuid));
+    bitmap_set1(bitmap, vlanid);
+    if (internal) {
+        bitmap_set1(vlan_bitmaps.internal, vlanid);
+    }
+}
+
+/* Clears the bits row set, if any. */
+static void
+vlan_bitmaps_clear_row(const struct ovsdb_idl_row *row)
+{
+    struct vlan_bitmaps_row *rec;
+
+    HMAP_FOR_EACH_WITH_HASH (rec, node, uuid_hash(&row->uuid),
+                             &vlan_bitmaps.rows) {
+        if (rec->row == row) {
+            bitmap_set0(rec->bitmap, rec->vlanid);
+            if (rec->internal) {
+                bitmap_set0(vlan_bitmaps.internal, rec->vlanid);
+            }
+            hmap_remove(&vlan_bitmaps.rows, &rec->node);
+            free(rec);
+            return;
+        }
+    }
+}
+
+static void
+vlan_bitmaps_add_vlan(const struct ovsrec_vlan *vlan_row)
+{
+    if (vlan_row->id <= 0 || vlan_row->id >= VLAN_BITMAP_BITS) {
+        return;
+    }
+    vlan_bitmaps_set(&vlan_row->header_, vlan_bitmaps.in_use, vlan_row->id,
+                     smap_get(&vlan_row->internal_usage,
+                              VLAN_INTERNAL_USAGE_L3PORT) != NULL);
+}
+
+static void
+vlan_bitmaps_add_name(const struct ovsdb_idl_row *row, const char *name,
+                      unsigned long *bitmap)
+{
+    int vlanid = vlan_if_id(name);
+
+    if (vlanid) {
+        vlan_bitmaps_set(row, bitmap, vlanid, false);
+    }
+}
+
+static void
+vlan_bitmaps_build(void)
+{
+    const struct ovsrec_vlan *vlan_row;
+    const struct ovsrec_interface *if_row;
+    const struct ovsrec_port *port_row;
+    const struct ovsrec_bridge *bridge_row;
+    const struct ovsrec_vrf *vrf_row;
+    struct vlan_bitmaps_row *rec;
+
+    HMAP_FOR_EACH_POP (rec, node, &vlan_bitmaps.rows) {
+        free(rec);
+    }
+    memset(vlan_bitmaps.in_use, 0, sizeof vlan_bitmaps.in_use);
+    memset(vlan_bitmaps.internal, 0, sizeof vlan_bitmaps.internal);
+    memset(vlan_bitmaps.intf, 0, sizeof vlan_bitmaps.intf);
+    memset(vlan_bitmaps.port, 0, sizeof vlan_bitmaps.port);
+    vlan_bitmaps.bridge = NULL;
+    vlan_bitmaps.vrf = NULL;
+
+    OVSREC_VLAN_FOR_EACH (vlan_row, idl) {
+        vlan_bitmaps_add_vlan(vlan_row);
+    }
+    OVSREC_INTERFACE_FOR_EACH (if_row, idl) {
+        vlan_bitmaps_add_name(&if_row->header_, if_row->name,
+                              vlan_bitmaps.intf);
+    }
+    OVSREC_PORT_FOR_EACH (port_row, idl) {
+        vlan_bitmaps_add_name(&port_row->header_, port_row->name,
+                              vlan_bitmaps.port);
+    }
+    OVSREC_BRIDGE_FOR_EACH (bridge_row, idl) {
+        if (strcmp(bridge_row->name, DEFAULT_BRIDGE_NAME) == 0) {
+            vlan_bitmaps.bridge = bridge_row;
+            break;
+        }
+    }
+    OVSREC_VRF_FOR_EACH (vrf_row, idl) {
+        if (strcmp(vrf_row->name, DEFAULT_VRF_NAME) == 0) {
+            vlan_bitmaps.vrf = vrf_row;
+            break;
+        }
+    }
+}
+
+/* Moves the bits of the rows the IDL change tracking reports.  Run by
+ * vtysh_ovsdb_track_run(). */
+static void
+vlan_bitmaps_track(void)
+{
+    const struct ovsrec_vlan *vlan_row;
+    const struct ovsrec_interface *if_row;
+    const struct ovsrec_port *port_row;
+    const struct ovsrec_bridge *bridge_row;
+    const struct ovsrec_vrf *vrf_row;
+
+    if (!vlan_bitmaps.valid
+        || vlan_bitmaps.generation != vtysh_ovsdb_tables_generation()) {
+        return;
+    }
+
+    OVSREC_VLAN_FOR_EACH_TRACKED (vlan_row, idl) {
+        vlan_bitmaps_clear_row(&vlan_row->header_);
+        if (!ovsrec_vlan_is_deleted(vlan_row)) {
+            vlan_bitmaps_add_vlan(vlan_row);
+        }
+    }
+    OVSREC_INTERFACE_FOR_EACH_TRACKED (if_row, idl) {
+        vlan_bitmaps_clear_row(&if_row->header_);
+        if (!ovsrec_interface_is_deleted(if_row)) {
+            vlan_bitmaps_add_name(&if_row->header_, if_row->name,
+                                  vlan_bitmaps.intf);
+        }
+    }
+    OVSREC_PORT_FOR_EACH_TRACKED (port_row, idl) {
+        vlan_bitmaps_clear_row(&port_row->header_);
+        if (!ovsrec_port_is_deleted(port_row)) {
+            vlan_bitmaps_add_name(&port_row->header_, port_row->name,
+                                  vlan_bitmaps.port);
+        }
+    }
+    OVSREC_BRIDGE_FOR_EACH_TRACKED (bridge_row, idl) {
+        if (ovsrec_bridge_is_deleted(bridge_row)) {
+            if (vlan_bitmaps.bridge == bridge_row) {
+                vlan_bitmaps.bridge = NULL;
+            }
+        } else if (strcmp(bridge_row->name, DEFAULT_BRIDGE_NAME) == 0) {
+            vlan_bitmaps.bridge = bridge_row;
+        }
+    }
+    OVSREC_VRF_FOR_EACH_TRACKED (vrf_row, idl) {
+        if (ovsrec_vrf_is_deleted(vrf_row)) {
+            if (vlan_bitmaps.vrf == vrf_row) {
+                vlan_bitmaps.vrf = NULL;
+            }
+        } else if (strcmp(vrf_row->name, DEFAULT_VRF_NAME) == 0) {
+            vlan_bitmaps.vrf = vrf_row;
+        }
+    }
+}
+
+/* Follows the changes of the columns the bitmaps are built from. */
+void
+vlan_bitmaps_init(void)
+{
+    ovsdb_idl_track_add_column(idl, &ovsrec_vlan_col_id);
+    ovsdb_idl_track_add_column(idl, &ovsrec_vlan_col_internal_usage);
+    ovsdb_idl_track_add_column(idl, &ovsrec_interface_col_name);
+    ovsdb_idl_track_add_column(idl, &ovsrec_port_col_name);
+    ovsdb_idl_track_add_column(idl, &ovsrec_bridge_col_name);
+    ovsdb_idl_track_add_column(idl, &ovsrec_vrf_col_name);
+    vtysh_ovsdb_track_register(vlan_bitmaps_track);
+}
+
+/* Must be called with the IDL lock held. */
+static void
+vlan_bitmaps_refresh(void)
+{
+    unsigned int generation = vtysh_ovsdb_tables_generation();
+
+    vtysh_ovsdb_track_run();
+    if (vlan_bitmaps.valid && vlan_bitmaps.generation == generation) {
+        return;
+    }
+    vlan_bitmaps_build();
+    vlan_bitmaps.generation = generation;
+    vlan_bitmaps.valid = true;
+}
+
+/* Function : vlan_is_in_use
+ * Description : Checks if a VLAN row exists for vlanid.
+ */
+bool
+vlan_is_in_use(uint16_t vlanid)
+{
+    if (vlanid >= VLAN_BITMAP_BITS) {
+        return false;
+    }
+    vlan_bitmaps_refresh();
+    return bitmap_is_set(vlan_bitmaps.in_use, vlanid);
+}
+
+/* Function : vlan_is_internal
+ * Description : Checks if vlanid is used internally for an L3 port.
+ */
+bool
+vlan_is_internal(uint16_t vlanid)
+{
+    if (vlanid >= VLAN_BITMAP_BITS) {
+        return false;
+    }
+    vlan_bitmaps_refresh();
+    return bitmap_is_set(vlan_bitmaps.internal, vlanid);
+}
+
 /*-----------------------------------------------------------------------------
 | Function : port_lookup
 | Responsibility : Lookup port table entry for interface name
@@ -73,23 +335,42 @@ const struct ovsrec_port* port_lookup(const char *if_name,
 int
 check_internal_vlan(uint16_t vlanid)
 {
-    const struct ovsrec_vlan *vlan_row = NULL;
+    if (vlan_is_internal(vlanid)) {
+        VLOG_DBG("%s This is a internal vlan = %d", __func__, vlanid);
+        return 0;
+    }
 
-    OVSREC_VLAN_FOR_EACH(vlan_row, idl)
+    return 1;
+}
+
+/* Function : vlan_if_rows_exist
+ * Description : Checks if the Interface and the Port rows of a VLAN
+ * interface exist.  Names built by GET_VLANIF() are answered from the
+ * VLAN bitmaps, any other name by looking the tables up.
+ * param in : vlan_if - Vlan interface name
+ */
+static void
+vlan_if_rows_exist(const char *vlan_if, bool *intf_exist, bool *port_exist)
+{
+    const struct ovsrec_interface *if_row = NULL;
+    int vlanid = vlan_if_id(vlan_if);
+
+    vlan_bitmaps_refresh();
+    if (vlanid) {
+        *intf_exist = bitmap_is_set(vlan_bitmaps.intf, vlanid);
+        *port_exist = bitmap_is_set(vlan_bitmaps.port, vlanid);
+        return;
+    }
+
+    *intf_exist = false;
+    OVSREC_INTERFACE_FOR_EACH(if_row, idl)
     {
-        if (smap_get(&vlan_row->internal_usage,
-                VLAN_INTERNAL_USAGE_L3PORT))
-        {
-            VLOG_DBG("%s Used internally for l3 interface", __func__);
-            /* now check if this vlan is used for creating vlan interface */
-            if (vlanid == vlan_row->id) {
-                VLOG_DBG("%s This is a internal vlan = %d", __func__, vlanid);
-                return 0;
-            }
+        if (strcmp(if_row->name, vlan_if) == 0) {
+            *intf_exist = true;
+            break;
         }
     }
-
-    return 1;
+    *port_exist = port_lookup(vlan_if, idl) != NULL;
 }
 
 /* Function : create_vlan_interface
@@ -130,21 +411,7 @@ create_vlan_interface(const char *vlan_if)
         return CMD_OVSDB_FAILURE;
     }
 
-    /*verify if interface exists */
-    OVSREC_INTERFACE_FOR_EACH(if_row, idl)
-    {
-        if (strcmp(if_row->name, vlan_if) == 0) {
-            intf_exist = true;
-        }
-    }
-
-    /*verify if port exists */
-    OVSREC_PORT_FOR_EACH(port_row, idl)
-    {
-        if (strcmp(port_row->name, vlan_if) == 0) {
-            port_exist = true;
-        }
-    }
+    vlan_if_rows_exist(vlan_if, &intf_exist, &port_exist);
 
     /* If both port and interface exists return success
        nothing to change here */
@@ -164,12 +431,7 @@ create_vlan_interface(const char *vlan_if)
     }
 
     /* Get vrf row so that we can add the port to it */
-    OVSREC_VRF_FOR_EACH (vrf_row, idl)
-    {
-        if (strcmp(vrf_row->name, DEFAULT_VRF_NAME) == 0) {
-            break;
-        }
-    }
+    vrf_row = vlan_bitmaps.vrf;
 
     if (!vrf_row) {
         VLOG_ERR("%s Error: Could not fetch VRF data.", __func__);
@@ -181,12 +443,7 @@ create_vlan_interface(const char *vlan_if)
     }
 
     /* Get Bridge row so that we can add the port to it */
-    OVSREC_BRIDGE_FOR_EACH (bridge_row, idl)
-    {
-        if (strcmp(bridge_row->name, DEFAULT_BRIDGE_NAME) == 0) {
-            break;
-        }
-    }
+    bridge_row = vlan_bitmaps.bridge;
 
     if (!bridge_row) {
         VLOG_ERR("%s Error: Could not fetch Bridge data.", __func__);
@@ -266,6 +523,102 @@ create_vlan_interface(const char *vlan_if)
 }
 
 
+/* Function : create_vlans
+ * Description : Creates a VLAN row for every VLAN in vlans that does not
+ * exist yet and adds the rows to the default bridge, all in a single
+ * transaction.  Nothing is created if one of the VLANs is outside
+ * <1-4094> or is used as an internal VLAN.
+ * param in : vlans - VLAN ids as returned by cmd_get_range_value()
+ */
+int
+create_vlans(const struct range_list *vlans)
+{
+    const struct ovsrec_bridge *bridge_row = NULL;
+    const struct ovsrec_vlan *vlan_row = NULL;
+    struct ovsrec_vlan **vlan_list;
+    struct ovsdb_idl_txn *status_txn = NULL;
+    enum ovsdb_idl_txn_status status;
+    char vlan_name[VLAN_NAME_LENGTH];
+    unsigned long vlanid;
+    size_t i, n_vlans = 0, n_new = 0;
+
+    if (!vlans || vlans->n_names) {
+        vty_out(vty, "Invalid vlan input%s", VTY_NEWLINE);
+        return CMD_WARNING;
+    }
+
+    vlan_bitmaps_refresh();
+    for (i = 0; i < vlans->n_ranges; i++) {
+        if (vlans->ranges[i].lo < 1 || vlans->ranges[i].hi > 4094) {
+            vty_out(vty, "Vlanid outside valid vlan range <1-4094>%s",
+                    VTY_NEWLINE);
+            return CMD_WARNING;
+        }
+        for (vlanid = vlans->ranges[i].lo; vlanid <= vlans->ranges[i].hi;
+             vlanid++) {
+            if (bitmap_is_set(vlan_bitmaps.internal, vlanid)) {
+                vty_out(vty, "VLAN%lu is used as an internal vlan%s",
+                        vlanid, VTY_NEWLINE);
+                return CMD_WARNING;
+            }
+            if (!bitmap_is_set(vlan_bitmaps.in_use, vlanid)) {
+                n_new++;
+            }
+        }
+    }
+    if (n_new == 0) {
+        return CMD_SUCCESS;
+    }
+
+    bridge_row = vlan_bitmaps.bridge;
+    if (!bridge_row) {
+        VLOG_ERR("%s Error: Could not fetch Bridge data.", __func__);
+        return CMD_OVSDB_FAILURE;
+    }
+
+    status_txn = cli_do_config_start();
+    if (!status_txn) {
+        VLOG_ERR(
+                "%s Got an error when trying to create a transaction"
+                " using ovsdb_idl_txn_create()", __func__);
+        cli_do_config_abort(status_txn);
+        return CMD_OVSDB_FAILURE;
+    }
+
+    vlan_list = xmalloc(sizeof *vlan_list * (bridge_row->n_vlans + n_new));
+    for (i = 0; i < bridge_row->n_vlans; i++) {
+        vlan_list[n_vlans++] = bridge_row->vlans[i];
+    }
+    for (i = 0; i < vlans->n_ranges; i++) {
+        for (vlanid = vlans->ranges[i].lo; vlanid <= vlans->ranges[i].hi;
+             vlanid++) {
+            if (bitmap_is_set(vlan_bitmaps.in_use, vlanid)) {
+                continue;
+            }
+            snprintf(vlan_name, sizeof vlan_name, "VLAN%lu", vlanid);
+            vlan_row = ovsrec_vlan_insert(status_txn);
+            ovsrec_vlan_set_id(vlan_row, vlanid);
+            ovsrec_vlan_set_name(vlan_row, vlan_name);
+            vlan_list[n_vlans++] = (struct ovsrec_vlan *)vlan_row;
+        }
+    }
+    ovsrec_bridge_set_vlans(bridge_row, vlan_list, n_vlans);
+    free(vlan_list);
+
+    status = cli_do_config_finish(status_txn);
+
+    if (status == TXN_SUCCESS || status == TXN_UNCHANGED) {
+        VLOG_DBG("%s Created %"PRIuSIZE" vlans", __func__, n_new);
+        return CMD_SUCCESS;
+    } else {
+        VLOG_ERR(
+                "%s While trying to commit transaction to DB, got a status"
+                " response : %s", __func__,
+                ovsdb_idl_txn_status_to_string(status));
+        return CMD_OVSDB_FAILURE;
+    }
+}
+
 /* Function : delete_vlan_interface
  * Description : Deletes a vlan interface. Will delete the
  * interface and port with name same as for VLAN interface.
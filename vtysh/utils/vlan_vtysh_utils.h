@@ -27,6 +27,10 @@
 
 #define DEFAULT_VLAN    1
 
+/* VLAN ids 0-4095, 0 and 4095 being reserved. */
+#define VLAN_BITMAP_BITS    4096
+#define VLAN_NAME_LENGTH    16
+
 #define VERIFY_VLAN_IFNAME(s) strncasecmp(s, "vlan", 4)
 
 #define GET_VLANIF(s, a) \
@@ -39,8 +43,14 @@
 
 const struct ovsrec_port* port_lookup(const char *if_name,
                                 const struct ovsdb_idl *idl);
+struct range_list;
+
+void vlan_bitmaps_init(void);
 int check_internal_vlan(uint16_t vlanid);
+bool vlan_is_in_use(uint16_t vlanid);
+bool vlan_is_internal(uint16_t vlanid);
 int create_vlan_interface(const char *vlan_if);
+int create_vlans(const struct range_list *vlans);
 int delete_vlan_interface(const char *vlan_if);
 bool verify_ifname(char *str);
 
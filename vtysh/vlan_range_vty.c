@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: vlan_range_vty.c
+ *
+ * Purpose:  To add the command creating VLANs in bulk.
+ */
+/****************************************************************************
+ * @ingroup cli/vtysh
+ *
+ * @file vlan_range_vty.c
+ * "vlan A-B" creates every VLAN of the range in a single transaction.
+ * A single VLAN, "vlan N", is left to the VLAN CLI which also enters
+ * the VLAN context.
+ *
+ ***************************************************************************/
+
+#include <lib/version.h>
+#include "command.h"
+#include "vtysh/vtysh.h"
+#include "vswitch-idl.h"
+#include "ovsdb-idl.h"
+#include "openvswitch/vlog.h"
+#include "vtysh/utils/vlan_vtysh_utils.h"
+#include "vlan_range_vty.h"
+
+VLOG_DEFINE_THIS_MODULE (vtysh_vlan_range_cli);
+
+DEFUN (cli_vlan_range,
+       cli_vlan_range_cmd,
+       "vlan <R:1-4094>",
+       VLAN_STR
+       VLAN_RANGE_STR)
+{
+    struct range_list *vlans;
+    int ret;
+
+    vlans = cmd_get_range_value (argv[0], 0);
+    if (vlans == NULL)
+    {
+        vty_out (vty, "Invalid vlan input%s", VTY_NEWLINE);
+        return CMD_WARNING;
+    }
+    ret = create_vlans (vlans);
+    cmd_free_memory_range_list (vlans);
+    return ret;
+}
+
+/* Install the bulk VLAN command. */
+void
+vlan_range_vty_init (void)
+{
+    install_element (CONFIG_NODE, &cli_vlan_range_cmd);
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: vlan_range_vty.h
+ *
+ * Purpose:  To add declarations required for vlan_range_vty.c
+ */
+
+#ifndef _VLAN_RANGE_VTY_H
+#define _VLAN_RANGE_VTY_H
+
+#define VLAN_RANGE_STR  "VLAN ranges to create, e.g. 2-4094\n"
+
+void
+vlan_range_vty_init (void);
+
+#endif /* _VLAN_RANGE_VTY_H */
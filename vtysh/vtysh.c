@@ -59,10 +59,15 @@
 #include "vty.h"
 #include "vswitch-idl.h"
 #include "smap.h"
+#include "shash.h"
+#include "svec.h"
+#include "dynamic-string.h"
 #include "loopback_vty.h"
 #include "vrf_vty.h"
 #include "ecmp_vty.h"
 #include "banner_vty.h"
+#include "vlan_range_vty.h"
+#include "vtysh_server.h"
 #endif
 
 #include "sub_intf_vty.h"
@@ -1328,6 +1333,16 @@ vtysh_exit (struct vty *vty)
     {
     case VIEW_NODE:
     case ENABLE_NODE:
+#ifdef ENABLE_OVSDB
+      /* Only root and the owner may stop the command server, with
+       * "vtysh/exit". */
+      if (vtysh_server_mode)
+      {
+          vty_out(vty, "The command server cannot be left with exit.%s",
+                  VTY_NEWLINE);
+          return CMD_ERR_NOTHING_TODO;
+      }
+#endif
       if (temp_prompt != NULL)
       {
           XFREE(MTYPE_HOST, temp_prompt);
@@ -3047,8 +3062,19 @@ set_user_passwd(void)
     char *cp = NULL;
     struct passwd *pw = NULL;
 
+#ifdef ENABLE_OVSDB
+    /* The password is read from the terminal, the command server has
+     * none. */
+    if (vtysh_server_mode)
+    {
+        vty_out(vty, "Password can only be changed in a login session.%s",
+                VTY_NEWLINE);
+        return CMD_SUCCESS;
+    }
+#endif
+
     pw = getpwuid(geteuid());
-    if (pw->pw_name == NULL)
+    if (pw == NULL || pw->pw_name == NULL)
     {
         vty_out(vty, "Could not look up user.%s", VTY_NEWLINE);
         return CMD_SUCCESS;
@@ -3254,20 +3280,21 @@ vtysh_prompt (void)
    extern struct host host;
 
 #ifdef ENABLE_OVSDB
-   const struct ovsrec_system *ovs = NULL;
+   const struct vtysh_system_fields *fields;
    const char *val;
 
-   VTYSH_OVSDB_LOCK;
-   ovs = ovsrec_system_first(idl);
+   /* Redrawn for every line, so read the System row fields without the
+    * lock and only copy the hostname when it changed. */
+   fields = vtysh_ovsdb_system_fields_get ();
 
-   if (ovs)
+   if (fields->valid)
    {
       if (temp_prompt != NULL)
           val = temp_prompt;
       else
-          val = smap_get(&ovs->mgmt_intf_status, SYSTEM_MGMT_INTF_MAP_HOSTNAME);
+          val = fields->hostname;
 
-      if (val != NULL)
+      if (val != NULL && (!host.name || strcmp (host.name, val)))
       {
          if (host.name)
             XFREE (MTYPE_HOST, host.name);
@@ -3275,7 +3302,7 @@ vtysh_prompt (void)
          host.name = XSTRDUP (MTYPE_HOST, val);
       }
    }
-   VTYSH_OVSDB_UNLOCK;
+   vtysh_ovsdb_system_fields_put (fields);
 #endif
 
    hostname = host.name;
@@ -3318,8 +3345,8 @@ create_new_vtysh_user(const char *user)
     char *cp = NULL;
 
     /* Avoid system users. */
-    if (!check_user_group(getlogin(), OPS_ADMIN_GROUP)) {
-        vty_out(vty, "%s cannot add user.%s", getlogin(), VTY_NEWLINE);
+    if (!check_user_group(cmd_user_name(), OPS_ADMIN_GROUP)) {
+        vty_out(vty, "%s cannot add user.%s", cmd_user_name(), VTY_NEWLINE);
         return CMD_ERR_NOTHING_TODO;
     }
 
@@ -3385,8 +3412,8 @@ static int
 delete_user(const char *user)
 {
     /* Avoid system users. */
-    if (!check_user_group(getlogin(), OPS_ADMIN_GROUP)) {
-        vty_out(vty, "%s cannot remove user.%s", getlogin(), VTY_NEWLINE);
+    if (!check_user_group(cmd_user_name(), OPS_ADMIN_GROUP)) {
+        vty_out(vty, "%s cannot remove user.%s", cmd_user_name(), VTY_NEWLINE);
         return CMD_ERR_NOTHING_TODO;
     }
 
@@ -3476,121 +3503,222 @@ vtysh_periodic_refresh(void)
   /* This function is called before all command exection.
      Keep it light for execution */
 
-  vty_refresh_aliases();
+  vtysh_ovsdb_track_run();
   return;
 }
 
-int vtysh_alias_count = 0;
-struct vtysh_alias_data *vtysh_aliases[VTYSH_MAX_ALIAS_SUPPORTED] = {NULL};
+struct shash vtysh_aliases = SHASH_INITIALIZER(&vtysh_aliases);
 char vtysh_alias_cmd_help_string[] = VTYSH_ALIAS_CMD_HELPSTRING;
 
+static void
+vtysh_alias_clear_definition(struct vtysh_alias_data *alias)
+{
+    size_t i, j;
 
-/*
-  * Function       : vtysh_alias_load_alias_table
-  * Responsibility : Reloads the alias information from ovsdb
-  * Parameters     : void
-  * Return         : success/failure
- */
-int
-vty_refresh_aliases(void)
+    for (i = 0; i < alias->n_commands; i++) {
+        for (j = 0; j < alias->commands[i].n_words; j++) {
+            free(alias->commands[i].words[j].text);
+        }
+        free(alias->commands[i].words);
+    }
+    free(alias->commands);
+    free(alias->definition);
+    alias->commands = NULL;
+    alias->n_commands = 0;
+    alias->definition = NULL;
+}
+
+static void
+vtysh_alias_add_word(struct vtysh_alias_command *command, size_t *allocated,
+                     struct ds *text, int arg)
 {
-    const struct ovsrec_cli_alias *alias_row = NULL;
-    int i = 0;
-    bool alias_exist = false;
-    static int refresh_count = 0;
+    struct vtysh_alias_word *word;
 
-    refresh_count = (refresh_count + 1) % 100;
+    if (!text->length) {
+        return;
+    }
+    if (command->n_words >= *allocated) {
+        command->words = x2nrealloc(command->words, allocated,
+                                    sizeof *command->words);
+    }
+    word = &command->words[command->n_words++];
+    word->text = ds_steal_cstr(text);
+    word->arg = arg;
+}
 
-    OVSREC_CLI_ALIAS_FOR_EACH(alias_row, idl)
-    {
-        alias_exist = false;
-        for (i = 0; i < vtysh_alias_count; i++)
-        {
-            if (vtysh_aliases[i]->refresh_count == refresh_count)
-            {
-                continue;
+/*
+ * Function       : vtysh_alias_parse_definition
+ * Responsibility : Splits an alias definition into its ";" separated
+ *                  commands, and each command into text and $N words, so
+ *                  that vtysh_alias_callback() only has to fill them in.
+ * Parameters     : alias, definition as stored in CLI_Alias
+ */
+static void
+vtysh_alias_parse_definition(struct vtysh_alias_data *alias,
+                             const char *definition)
+{
+    struct vtysh_alias_command *command = NULL;
+    struct ds text = DS_EMPTY_INITIALIZER;
+    size_t allocated_commands = 0;
+    size_t allocated_words = 0;
+    const char *p;
+    int arg;
+
+    vtysh_alias_clear_definition(alias);
+    alias->definition = xstrdup(definition);
+
+    for (p = definition; ; p++) {
+        if (!command) {
+            if (alias->n_commands >= allocated_commands) {
+                alias->commands = x2nrealloc(alias->commands,
+                                             &allocated_commands,
+                                             sizeof *alias->commands);
             }
-            if (strcmp(vtysh_aliases[i]->alias_def_str,
-                    alias_row->alias_name) == 0)
-            {
-                vtysh_aliases[i]->refresh_count = refresh_count;
-                alias_exist = true;
+            command = &alias->commands[alias->n_commands++];
+            memset(command, 0, sizeof *command);
+            allocated_words = 0;
+        }
+
+        arg = *p == '$' ? vtysh_alias_string_to_int(p + 1) : 0;
+        if (arg) {
+            size_t n_digits = strspn(p + 1, "0123456789");
+
+            vtysh_alias_add_word(command, &allocated_words, &text, 0);
+            ds_put_buffer(&text, p, n_digits + 1);
+            vtysh_alias_add_word(command, &allocated_words, &text, arg);
+            p += n_digits;
+        } else if (*p == ';' || *p == '\0') {
+            vtysh_alias_add_word(command, &allocated_words, &text, 0);
+            if (*p == '\0') {
                 break;
             }
+            command = NULL;
+        } else {
+            ds_put_char(&text, *p);
         }
-        if (true == alias_exist)
-        {
-            continue;
-        }
-
-        vtysh_aliases[vtysh_alias_count] =
-            (struct vtysh_alias_data*) malloc(sizeof(struct vtysh_alias_data));
-        memset(vtysh_aliases[vtysh_alias_count], 0,
-                sizeof(struct vtysh_alias_data));
-
-        strncpy(vtysh_aliases[vtysh_alias_count]->alias_def_str,
-                alias_row->alias_name, VTYSH_MAX_ALIAS_DEF_LEN);
-
-        strncpy(vtysh_aliases[vtysh_alias_count]->alias_def_str_with_args,
-                vtysh_aliases[vtysh_alias_count]->alias_def_str,
-                VTYSH_MAX_ALIAS_DEF_LEN);
-        strcat(vtysh_aliases[vtysh_alias_count]->alias_def_str_with_args,
-                " .LINE");
-
-        /* Prepare the command element & install the command in config node */
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element.string =
-            vtysh_aliases[vtysh_alias_count]->alias_def_str;
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element.func   =
-            vtysh_alias_callback;
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element.doc    =
-            vtysh_alias_cmd_help_string;
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element.attr   =
-            CMD_ATTR_NOLOCK;
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element.daemon = 0;
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.string =
-            vtysh_aliases[vtysh_alias_count]->alias_def_str_with_args;
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.func =
-            vtysh_alias_callback;
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.doc =
-            vtysh_alias_cmd_help_string;
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.attr =
-            CMD_ATTR_NOLOCK;
-        vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.daemon = 0;
-
-        /* install the new commands with alias definition as token */
-        install_element(CONFIG_NODE,
-               &vtysh_aliases[vtysh_alias_count]->alias_cmd_element);
-        install_element(CONFIG_NODE,
-               &vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args);
-        vtysh_aliases[vtysh_alias_count]->refresh_count = refresh_count;
-        vtysh_alias_count++;
     }
+    ds_destroy(&text);
+}
 
-    for (i = 0; i < vtysh_alias_count; i++)
-    {
-        if (vtysh_aliases[i]->refresh_count != refresh_count)
-        {
-            vtysh_aliases[i]->alias_cmd_element.attr |= CMD_ATTR_HIDDEN;
-            vtysh_aliases[i]->alias_cmd_element.attr |= CMD_ATTR_NOT_ENABLED;
-            vtysh_aliases[i]->alias_cmd_element.attr |= CMD_ATTR_DISABLED;
-            vtysh_aliases[i]->alias_cmd_element_with_args.attr |=
-                CMD_ATTR_HIDDEN;
-            vtysh_aliases[i]->alias_cmd_element_with_args.attr |=
-                CMD_ATTR_NOT_ENABLED;
-            vtysh_aliases[i]->alias_cmd_element_with_args.attr |=
-                CMD_ATTR_DISABLED;
-            //TODO :
-            /* free cannot be done as cmd element is still referred by vector
-               */
-            //free(vtysh_aliases[i]);
-            vtysh_aliases[i] = vtysh_aliases[vtysh_alias_count-1];
-            vtysh_aliases[vtysh_alias_count-1] = NULL;
-            vtysh_alias_count--;
+/*
+ * Function       : vtysh_alias_create
+ * Responsibility : Adds an alias and installs its commands in config node
+ * Parameters     : alias name
+ * Return         : the new alias, without definition
+ */
+static struct vtysh_alias_data *
+vtysh_alias_create(const char *name)
+{
+    struct vtysh_alias_data *alias = xzalloc(sizeof *alias);
+
+    strncpy(alias->alias_def_str, name, VTYSH_MAX_ALIAS_DEF_LEN);
+    snprintf(alias->alias_def_str_with_args,
+             sizeof alias->alias_def_str_with_args, "%s .LINE",
+             alias->alias_def_str);
+
+    alias->alias_cmd_element.string = alias->alias_def_str;
+    alias->alias_cmd_element.func = vtysh_alias_callback;
+    alias->alias_cmd_element.doc = vtysh_alias_cmd_help_string;
+    alias->alias_cmd_element.attr = CMD_ATTR_NOLOCK;
+    alias->alias_cmd_element.daemon = 0;
+    alias->alias_cmd_element_with_args.string =
+        alias->alias_def_str_with_args;
+    alias->alias_cmd_element_with_args.func = vtysh_alias_callback;
+    alias->alias_cmd_element_with_args.doc = vtysh_alias_cmd_help_string;
+    alias->alias_cmd_element_with_args.attr = CMD_ATTR_NOLOCK;
+    alias->alias_cmd_element_with_args.daemon = 0;
+
+    /* install the new commands with alias definition as token */
+    install_element(CONFIG_NODE, &alias->alias_cmd_element);
+    install_element(CONFIG_NODE, &alias->alias_cmd_element_with_args);
+
+    shash_add(&vtysh_aliases, alias->alias_def_str, alias);
+    return alias;
+}
+
+/*
+ * Function       : vtysh_alias_retire
+ * Responsibility : Disables an alias whose CLI_Alias row was deleted
+ *                  elsewhere.  Its command elements cannot be freed, as the
+ *                  main thread may be matching against them.
+ * Parameters     : alias
+ */
+static void
+vtysh_alias_retire(struct vtysh_alias_data *alias)
+{
+    alias->alias_cmd_element.attr |= CMD_ATTR_HIDDEN;
+    alias->alias_cmd_element.attr |= CMD_ATTR_NOT_ENABLED;
+    alias->alias_cmd_element.attr |= CMD_ATTR_DISABLED;
+    alias->alias_cmd_element_with_args.attr |= CMD_ATTR_HIDDEN;
+    alias->alias_cmd_element_with_args.attr |= CMD_ATTR_NOT_ENABLED;
+    alias->alias_cmd_element_with_args.attr |= CMD_ATTR_DISABLED;
+    shash_find_and_delete(&vtysh_aliases, alias->alias_def_str);
+    vtysh_alias_clear_definition(alias);
+}
+
+static struct vtysh_alias_data *
+vtysh_alias_find_row(const struct uuid *row_uuid)
+{
+    struct shash_node *node;
+
+    SHASH_FOR_EACH (node, &vtysh_aliases) {
+        struct vtysh_alias_data *alias = node->data;
+
+        if (uuid_equals(&alias->row_uuid, row_uuid)) {
+            return alias;
         }
     }
+    return NULL;
+}
 
+/*
+  * Function       : vty_refresh_aliases
+  * Responsibility : Applies the CLI_Alias changes tracked by the IDL since
+  *                  the last call, so an idle wakeup costs nothing.  Run
+  *                  by vtysh_ovsdb_track_run()
+  * Parameters     : void
+  * Return         : void
+ */
+void
+vty_refresh_aliases(void)
+{
+    static unsigned int alias_seqno;
+    const struct ovsrec_cli_alias *alias_row;
+    struct vtysh_alias_data *alias;
 
-    return CMD_SUCCESS;
+    /* CLI_Alias is only in the main IDL. */
+    if (vtysh_ovsdb_tables_generation()
+        || alias_seqno == ovsrec_cli_alias_get_seqno(idl)) {
+        return;
+    }
+    alias_seqno = ovsrec_cli_alias_get_seqno(idl);
+
+    OVSREC_CLI_ALIAS_FOR_EACH_TRACKED (alias_row, idl) {
+        alias = vtysh_alias_find_row(&alias_row->header_.uuid);
+        if (ovsrec_cli_alias_is_deleted(alias_row)) {
+            /* Only the row UUID is left of a deleted row. */
+            if (alias) {
+                vtysh_alias_retire(alias);
+            }
+            continue;
+        }
+
+        if (!alias || strcmp(alias->alias_def_str, alias_row->alias_name)) {
+            if (alias) {
+                vtysh_alias_retire(alias);
+            }
+            /* An alias added in this session is already there. */
+            alias = shash_find_data(&vtysh_aliases, alias_row->alias_name);
+            if (!alias) {
+                alias = vtysh_alias_create(alias_row->alias_name);
+            }
+            alias->row_uuid = alias_row->header_.uuid;
+        }
+        if (!alias->definition
+            || strcmp(alias->definition, alias_row->alias_definition)) {
+            vtysh_alias_parse_definition(alias, alias_row->alias_definition);
+        }
+    }
 }
 
 /*
@@ -3681,43 +3809,29 @@ DEFUN (vtysh_alias_cli,
    int i = 0, ret_val = 0;
    char *str;
    char alias_list_str[VTYSH_MAX_ALIAS_LIST_LEN] = {0};
+   struct vtysh_alias_data *alias;
 
    if (argc == 0) return CMD_WARNING;
 
    /* Check if it is alias deletion */
    if (vty_flags & CMD_FLAG_NO_CMD)
    {
-      int found = 0;
-
-      for (i = 0; i < vtysh_alias_count; i++)
-      {
-         if(NULL == vtysh_aliases[i])
-         {
-            assert(0);
-            /* Data integrity failure */
-         }
-         if(strcmp(vtysh_aliases[i]->alias_def_str, argv[0]) == 0)
-         {
-            vtysh_alias_delete_alias(vtysh_aliases[i]->alias_def_str);
-            cmd_terminate_node_element(&vtysh_aliases[i]->alias_cmd_element, ELEMENT);
-            cmd_terminate_node_element(&vtysh_aliases[i]->alias_cmd_element_with_args, ELEMENT);
-            free(vtysh_aliases[i]);
-            vtysh_aliases[i] = vtysh_aliases[vtysh_alias_count-1];
-            vtysh_aliases[vtysh_alias_count-1] = NULL;
-            vtysh_alias_count--;
-            found = 1;
-            break;
-         }
-      }
-      if (0 == found)
+      alias = shash_find_data(&vtysh_aliases, argv[0]);
+      if (NULL == alias)
       {
          vty_out(vty, VTYSH_ERROR_ALIAS_NOT_FOUND, argv[0]);
          return CMD_SUCCESS;
       }
+      vtysh_alias_delete_alias(alias->alias_def_str);
+      cmd_terminate_node_element(&alias->alias_cmd_element, ELEMENT);
+      cmd_terminate_node_element(&alias->alias_cmd_element_with_args, ELEMENT);
+      shash_find_and_delete(&vtysh_aliases, alias->alias_def_str);
+      vtysh_alias_clear_definition(alias);
+      free(alias);
       return CMD_SUCCESS;
    }
 
-   if (vtysh_alias_count >= VTYSH_MAX_ALIAS_SUPPORTED)
+   if (shash_count(&vtysh_aliases) >= VTYSH_MAX_ALIAS_SUPPORTED)
    {
       vty_out(vty, VTYSH_ERROR_MAX_ALIASES_EXCEEDED);
       return CMD_SUCCESS;
@@ -3745,31 +3859,12 @@ DEFUN (vtysh_alias_cli,
       return CMD_SUCCESS;
    }
 
-   if(NULL != vtysh_aliases[vtysh_alias_count])
-   {
-      assert(0);
-      /* Data integrity failure */
-      free(vtysh_aliases[vtysh_alias_count]);
-   }
-   vtysh_aliases[vtysh_alias_count] =
-       (struct vtysh_alias_data*) malloc(sizeof(struct vtysh_alias_data));
-   memset(vtysh_aliases[vtysh_alias_count], 0,
-           sizeof(struct vtysh_alias_data));
-
-   strncpy(vtysh_aliases[vtysh_alias_count]->alias_def_str, argv[0],
-           VTYSH_MAX_ALIAS_DEF_LEN);
-   strncpy(vtysh_aliases[vtysh_alias_count]->alias_def_str_with_args, argv[0],
-         VTYSH_MAX_ALIAS_DEF_LEN_WITH_ARGS);
-   strcat(vtysh_aliases[vtysh_alias_count]->alias_def_str_with_args, " .LINE");
-
    for (i = 1; i < argc; i++)
    {
       /* Read each args, and append to the command string */
       if(VTYSH_MAX_ALIAS_LIST_LEN <=
               strlen(alias_list_str) + strlen(argv[i]) + 2)
       {
-         free(vtysh_aliases[vtysh_alias_count]);
-         vtysh_aliases[vtysh_alias_count] = NULL;
          vty_out(vty, VTYSH_ERROR_MAX_ALIAS_LEN_EXCEEDED);
          return CMD_SUCCESS;
       }
@@ -3777,35 +3872,11 @@ DEFUN (vtysh_alias_cli,
       strcat(alias_list_str, " ");
    }
 
-   /* Prepare the command element and install the command in config node */
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element.string =
-       vtysh_aliases[vtysh_alias_count]->alias_def_str;
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element.func =
-       vtysh_alias_callback;
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element.doc =
-       vtysh_alias_cmd_help_string;
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element.attr = CMD_ATTR_NOLOCK;
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element.daemon = 0;
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.string =
-       vtysh_aliases[vtysh_alias_count]->alias_def_str_with_args;
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.func =
-       vtysh_alias_callback;
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.doc =
-       vtysh_alias_cmd_help_string;
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.attr =
-       CMD_ATTR_NOLOCK;
-   vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args.daemon = 0;
-
-   vtysh_alias_save_alias(vtysh_aliases[vtysh_alias_count]->alias_def_str,
-                           alias_list_str);
-
-   /* install the new commands with alias definition as token */
-   install_element(CONFIG_NODE,
-           &vtysh_aliases[vtysh_alias_count]->alias_cmd_element);
-   install_element(CONFIG_NODE,
-           &vtysh_aliases[vtysh_alias_count]->alias_cmd_element_with_args);
-
-   vtysh_alias_count++;
+   /* The CLI_Alias change is picked up by vty_refresh_aliases(), which
+    * finds the alias already there. */
+   alias = vtysh_alias_create(argv[0]);
+   vtysh_alias_parse_definition(alias, alias_list_str);
+   vtysh_alias_save_alias(alias->alias_def_str, alias_list_str);
 
    return CMD_SUCCESS;
 }
@@ -3824,7 +3895,7 @@ DEFUN_NO_FORM (vtysh_alias_cli,
  * Return         : integer
 */
 int
-vtysh_alias_string_to_int(char *str)
+vtysh_alias_string_to_int(const char *str)
 {
    int i = 0, ret = 0;
    if(NULL == str)
@@ -3858,124 +3929,83 @@ int
 vtysh_alias_callback(struct cmd_element *self, struct vty *vty,
       int vty_flags, int argc, const char *argv[])
 {
-   char cmd_now[VTYSH_MAX_ALIAS_LIST_LEN] = {0};
-   int len = 0, i = 0;
-   char *found_cmd = NULL;
-   int arg_count = 0, max_arg_count = 0;
-   char current_cmd[VTYSH_MAX_ALIAS_LIST_LEN] = {0};
+   size_t name_len = strcspn(self->string, " ");
+   struct svec commands = SVEC_EMPTY_INITIALIZER;
+   struct ds command = DS_EMPTY_INITIALIZER;
+   const struct vtysh_alias_data *alias;
+   struct shash_node *node;
    char *prev_buf = vty->buf;
-   const struct ovsrec_cli_alias *alias_row = NULL;
+   const char *strt;
+   int max_arg_count = 0;
+   int arg;
+   size_t i, j;
 
-   for(len = 0; len <= vty->length && vty->buf[len] != ' '; len++)
-   {
-      cmd_now[len] = vty->buf[len];
-   }
-   cmd_now[len] = '\0';
-
-   OVSREC_CLI_ALIAS_FOR_EACH (alias_row, idl)
+   /* The OVSDB thread updates the aliases, so expand the definition with
+    * the lock held, and run the commands after releasing it. */
+   VTYSH_OVSDB_LOCK;
+   node = shash_find_len(&vtysh_aliases, self->string, name_len);
+   if (NULL == node)
    {
-      if(strcmp(alias_row->alias_name, cmd_now) == 0)
-      {
-         found_cmd = alias_row->alias_definition;
-         break;
-      }
-   }
+      char *name = xmemdup0(self->string, name_len);
 
-   if(NULL == found_cmd)
-   {
-      vty_out(vty, VTYSH_ERROR_ALIAS_NOT_FOUND, cmd_now);
+      VTYSH_OVSDB_UNLOCK;
+      vty_out(vty, VTYSH_ERROR_ALIAS_NOT_FOUND, name);
+      free(name);
       return CMD_SUCCESS;
    }
+   alias = node->data;
 
-   for(len = 0, i = 0;
-           len <= VTYSH_MAX_ALIAS_LIST_LEN && found_cmd[len] != '\0'; len++)
+   for (i = 0; i < alias->n_commands; i++)
    {
-      if(found_cmd[len] == '$')
+      const struct vtysh_alias_command *c = &alias->commands[i];
+
+      ds_clear(&command);
+      for (j = 0; j < c->n_words; j++)
       {
-         arg_count = vtysh_alias_string_to_int(&(found_cmd[len+1]));
-         if( (arg_count != 0) &&( arg_count <= argc))
+         const struct vtysh_alias_word *word = &c->words[j];
+
+         if (word->arg && word->arg <= argc)
          {
-            strcat(current_cmd, argv[arg_count-1]);
-            strcat(current_cmd, " ");
-            i+= strlen(current_cmd);
-            if(max_arg_count < arg_count)
-            {
-               max_arg_count = arg_count;
-            }
-            while(arg_count)
-            {
-               len++;
-               arg_count/=10;
-            }
+            ds_put_format(&command, "%s ", argv[word->arg - 1]);
+            max_arg_count = MAX(max_arg_count, word->arg);
          }
          else
          {
-            current_cmd[i++] = found_cmd[len];
+            ds_put_cstr(&command, word->text);
          }
       }
-      else if (found_cmd[len] == ';')
+      if (i == alias->n_commands - 1)
       {
-         /* Execute the command */
-         char *strt = current_cmd;
-
-         while(*strt == ' ')
+         /* Unused args are appended to the last command. */
+         for (arg = max_arg_count; arg < argc; arg++)
          {
-            strt++;
-            if(*strt == '\0') break;
+            ds_put_format(&command, " %s", argv[arg]);
          }
-
-         if((strncmp(cmd_now, strt, strlen(cmd_now)) == 0) &&
-               (*(strt + strlen(cmd_now) + 1) == ' ' ||
-                       *(strt + strlen(cmd_now) + 1) == '\0'))
-         {
-            vty_out(vty, VTYSH_ERROR_ALIAS_LOOP_ALIAS);
-            return CMD_SUCCESS;
-         }
-         vty->buf = strt;
-         vty->length = strlen(strt);
-         //vty_out(vty, "Executing the command \"%s\" %s", strt, VTY_NEWLINE);
-         vtysh_execute(vty->buf);
-
-         memset(current_cmd, 0, VTYSH_MAX_ALIAS_LIST_LEN);
-         i = 0;
-      }
-      else
-      {
-         current_cmd[i++] = found_cmd[len];
       }
+      strt = ds_cstr(&command);
+      svec_add(&commands, strt + strspn(strt, " "));
    }
+   VTYSH_OVSDB_UNLOCK;
+   ds_destroy(&command);
 
-   max_arg_count++; /* To find unused args */
-
-   while(argc >= max_arg_count)
+   SVEC_FOR_EACH (i, strt, &commands)
    {
-      strcat(current_cmd, " ");
-      strcat(current_cmd, argv[max_arg_count - 1]);
-      max_arg_count++;
-   }
-   if(current_cmd[0] != 0)
-   {
-      /* Execute the command */
-      char *strt = current_cmd;
-
-      while(*strt == ' ')
+      if (*strt == '\0')
       {
-         strt++;
-         if(*strt == '\0') break;
+         continue;
       }
-      if((strncmp(cmd_now, strt, strlen(cmd_now)) == 0) &&
-            (*(strt + strlen(cmd_now) + 1) == ' ' ||
-                    *(strt + strlen(cmd_now) + 1) == '\0'))
+      if ((strncmp(self->string, strt, name_len) == 0) &&
+            (strt[name_len] == ' ' || strt[name_len] == '\0'))
       {
          vty_out(vty, VTYSH_ERROR_ALIAS_LOOP_ALIAS);
-         return CMD_SUCCESS;
+         break;
       }
-      //vty_out(vty, "Executing the command \"%s\" \n", current_cmd);
-      vty->buf = strt;
+      vty->buf = CONST_CAST(char *, strt);
       vty->length = strlen(strt);
       vtysh_execute(vty->buf);
    }
    vty->buf = prev_buf;
+   svec_destroy(&commands);
    return CMD_SUCCESS;
 }
 
@@ -4049,6 +4079,61 @@ DEFUN (vtysh_show_session_timeout_cli,
 }
 
 #ifdef ENABLE_OVSDB
+DEFUN (vtysh_show_cli_idl_footprint,
+       vtysh_show_cli_idl_footprint_cmd,
+       "show cli idl-footprint",
+       SHOW_STR
+       "CLI information\n"
+       "Rows, columns and bytes of the tables replicated by this session\n")
+{
+    vtysh_ovsdb_show_idl_footprint(vty);
+    return CMD_SUCCESS;
+}
+
+DEFUN (vtysh_show_cli_command_footprint,
+       vtysh_show_cli_command_footprint_cmd,
+       "show cli command-footprint",
+       SHOW_STR
+       "CLI information\n"
+       "Parsed commands and the strings and tokens they share\n")
+{
+    struct cmd_pool_stats stats;
+
+    cmd_pool_stats_get(&stats);
+    vty_out(vty, "Parsed commands: %lu of %lu%s",
+            stats.parsed, stats.elements, VTY_NEWLINE);
+    vty_out(vty, "Pooled strings: %lu, %lu references, %lu bytes%s",
+            stats.strings, stats.string_refs, stats.string_bytes,
+            VTY_NEWLINE);
+    vty_out(vty, "Shared tokens: %lu, %lu references%s",
+            stats.tokens, stats.token_refs, VTY_NEWLINE);
+    vty_out(vty, "Saved by sharing: %lu bytes%s",
+            stats.saved_bytes, VTY_NEWLINE);
+    return CMD_SUCCESS;
+}
+
+DEFUN (vtysh_show_cli_authorization_cache,
+       vtysh_show_cli_authorization_cache_cmd,
+       "show cli authorization-cache",
+       SHOW_STR
+       "CLI information\n"
+       "TACACS+ command authorization decisions of this session\n")
+{
+    struct cmd_author_stats stats;
+
+    cmd_author_stats_get(&stats);
+    vty_out(vty, "Cached decisions: %lu%s", stats.entries, VTY_NEWLINE);
+    vty_out(vty, "Hits: %lu%s", stats.hits, VTY_NEWLINE);
+    vty_out(vty, "Misses: %lu%s", stats.misses, VTY_NEWLINE);
+    vty_out(vty, "Expired: %lu%s", stats.expired, VTY_NEWLINE);
+    vty_out(vty, "Flushed on AAA changes: %lu%s", stats.flushes, VTY_NEWLINE);
+    vty_out(vty, "Allowed commands kept: %d seconds%s", stats.ttl,
+            VTY_NEWLINE);
+    vty_out(vty, "Denied commands kept: %d seconds%s", stats.negative_ttl,
+            VTY_NEWLINE);
+    return CMD_SUCCESS;
+}
+
 extern void set_page_height(int);
 
 extern int vtysh_page_height;
@@ -4164,6 +4249,23 @@ int is_valid_ip_address(const char *ip_value)
 
 #endif /* ENABLE_OVSDB */
 
+/* Install the commands that depend on the user of the session. */
+void
+vtysh_init_vty_user (struct passwd *pw)
+{
+  /* The shell and reboot commands need a terminal, the command server
+     has none. */
+  if (rbac_is_user_permitted(pw->pw_name, ADMIN_CMDS)
+#ifdef ENABLE_OVSDB
+      && !vtysh_server_mode
+#endif
+     )
+  {
+    install_element (ENABLE_NODE, &vtysh_start_shell_cmd);
+    install_element (ENABLE_NODE, &vtysh_reboot_cmd);
+  }
+}
+
 void
 vtysh_init_vty ( struct passwd *pw)
 {
@@ -4409,6 +4511,9 @@ vtysh_init_vty ( struct passwd *pw)
   install_element (ENABLE_NODE, &show_startup_config_cmd);
   install_element (ENABLE_NODE, &show_startup_config_json_cmd);
   install_element (ENABLE_NODE, &vtysh_show_session_timeout_cli_cmd);
+  install_element (ENABLE_NODE, &vtysh_show_cli_idl_footprint_cmd);
+  install_element (ENABLE_NODE, &vtysh_show_cli_command_footprint_cmd);
+  install_element (ENABLE_NODE, &vtysh_show_cli_authorization_cache_cmd);
 #endif /* ENABLE_OVSDB */
 
 #ifndef ENABLE_OVSDB
@@ -4478,11 +4583,9 @@ vtysh_init_vty ( struct passwd *pw)
   install_element (CONFIG_NODE, &no_vtysh_enable_password_cmd);
 #endif
   install_element (ENABLE_NODE, &vtysh_passwd_cmd);
-  if (rbac_is_user_permitted(pw->pw_name, ADMIN_CMDS))
-  {
-    install_element (ENABLE_NODE, &vtysh_start_shell_cmd);
-    install_element (ENABLE_NODE, &vtysh_reboot_cmd);
-  }
+  /* A zygote does not know the user yet, its sessions install these. */
+  if (pw != NULL)
+    vtysh_init_vty_user (pw);
 
  install_element (ENABLE_NODE, &vtysh_set_prompt_cmd);
  install_element (ENABLE_NODE, &vtysh_reset_prompt_cmd);
@@ -4507,5 +4610,8 @@ vtysh_init_vty ( struct passwd *pw)
 
   /* Initialize banner CLI */
   banner_vty_init();
+
+  /* Initialize bulk VLAN CLI */
+  vlan_range_vty_init();
 #endif
 }
@@ -24,6 +24,7 @@
 #define VTYSH_H
 #include <stdbool.h>
 #include "rbac.h"
+#include "uuid.h"
 
 #define VTYSH_ZEBRA  0x01
 #define VTYSH_RIPD   0x02
@@ -50,12 +51,27 @@
 #define VTYSH_MAX_ALIAS_DEF_LEN_WITH_ARGS   40
 #define VTYSH_MAX_ALIAS_LIST_LEN 400
 
+/* Text of an alias command, or $N if arg is not zero. */
+struct vtysh_alias_word {
+   char *text;
+   int arg;
+};
+
+/* One of the ";" separated commands of an alias definition. */
+struct vtysh_alias_command {
+   struct vtysh_alias_word *words;
+   size_t n_words;
+};
+
 struct vtysh_alias_data {
-   char alias_def_str[VTYSH_MAX_ALIAS_DEF_LEN];
+   char alias_def_str[VTYSH_MAX_ALIAS_DEF_LEN + 1];
    struct cmd_element alias_cmd_element;
    char alias_def_str_with_args[VTYSH_MAX_ALIAS_DEF_LEN_WITH_ARGS];
    struct cmd_element alias_cmd_element_with_args;
-   int  refresh_count;
+   struct uuid row_uuid;            /* CLI_Alias row, zero until seen. */
+   char *definition;                /* alias_definition of the row. */
+   struct vtysh_alias_command *commands;
+   size_t n_commands;
 };
 
 #define VTYSH_ALIAS_CMD_HELPSTRING            "Execute \"show aliases\" to list the command list\nArguments to replace $1, $2 etc.\n"
@@ -126,12 +142,14 @@ enum ip_type {
 int is_valid_ip_address(const char *ip_value);
 
 extern int vtysh_alias_callback(struct cmd_element *self, struct vty *vty, int vty_flags, int argc, const char *argv[]);
+int vtysh_alias_string_to_int(const char *str);
 
 extern int enable_mininet_test_prompt;
 extern int vtysh_show_startup;
 #endif
 
 void vtysh_init_vty ( struct passwd *pw);
+void vtysh_init_vty_user (struct passwd *pw);
 extern int vtysh_connect_all (const char *optional_daemon_name);
 void vtysh_readline_init (void);
 void vtysh_user_init (void);
@@ -161,7 +179,7 @@ int execute_command (const char *, int, const char *arg[]);
 
 int remove_temp_db(int initialize);
 
-int vty_refresh_aliases(void);
+void vty_refresh_aliases(void);
 /* Child process execution flag. */
 extern int execute_flag;
 
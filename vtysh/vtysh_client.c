@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: vtysh_client.c
+ *
+ * Purpose: vtysh-client, runs "vtysh -c" commands on a "vtysh --server".
+ */
+/****************************************************************************
+ * @ingroup cli/vtysh
+ *
+ * @file vtysh_client.c
+ * Takes the -c and -n options of vtysh, sends the commands to the command
+ * server, which runs them as the calling user, and prints their output.  The exit status is
+ * that of "vtysh -c".  Without a server, the commands are run by vtysh.
+ *
+ ***************************************************************************/
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "jsonrpc.h"
+#include "unixctl.h"
+#include "util.h"
+#include "vtysh_server.h"
+
+#define VTYSH_PATH "vtysh"
+
+static void
+usage(void)
+{
+    printf("Usage : %s [OPTION...]\n\n"
+           "Runs commands on the vtysh command server.\n\n"
+           "-c, --command            Execute argument as command\n"
+           "-n, --noerror            Ignore errors and discard the output\n"
+           "-s, --socket=SOCKET      Command server socket\n"
+           "-h, --help               Display this help and exit\n",
+           program_name);
+    exit(EXIT_SUCCESS);
+}
+
+/* Run the commands with vtysh itself. */
+static void
+vtysh_client_exec(char *commands[], int n_commands, bool no_error)
+{
+    char **args = xmalloc((2 * n_commands + 3) * sizeof *args);
+    int n_args = 0;
+    int i;
+
+    args[n_args++] = VTYSH_PATH;
+    if (no_error) {
+        args[n_args++] = "-n";
+    }
+    for (i = 0; i < n_commands; i++) {
+        args[n_args++] = "-c";
+        args[n_args++] = commands[i];
+    }
+    args[n_args] = NULL;
+
+    execvp(VTYSH_PATH, args);
+    fprintf(stderr, "%s: cannot run %s (%s)\n", program_name, VTYSH_PATH,
+            ovs_strerror(errno));
+    exit(EXIT_FAILURE);
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const struct option long_options[] = {
+        {"command", required_argument, NULL, 'c'},
+        {"noerror", no_argument, NULL, 'n'},
+        {"socket", required_argument, NULL, 's'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0},
+    };
+    const char *socket_path = VTYSH_SERVER_SOCKET;
+    bool no_error = false;
+    struct jsonrpc *client;
+    char **args;
+    int n_args = 0;
+    char *result = NULL;
+    char *error = NULL;
+    int status;
+    int retval;
+    int opt;
+
+    set_program_name(argv[0]);
+
+    args = xmalloc(argc * sizeof *args);
+    while ((opt = getopt_long(argc, argv, "c:ns:h", long_options,
+                              NULL)) != -1) {
+        switch (opt) {
+        case 'c':
+            args[n_args++] = optarg;
+            break;
+        case 'n':
+            no_error = true;
+            break;
+        case 's':
+            socket_path = optarg;
+            break;
+        case 'h':
+            usage();
+            break;
+        default:
+            fprintf(stderr, "Try `%s --help' for more information.\n",
+                    program_name);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (n_args == 0) {
+        fprintf(stderr, "%s: no command given.\n", program_name);
+        exit(EXIT_FAILURE);
+    }
+
+    if (unixctl_client_create(socket_path, &client)) {
+        vtysh_client_exec(args, n_args, no_error);
+    }
+
+    retval = unixctl_client_transact(client,
+                                     no_error ? VTYSH_SERVER_EXECUTE_ALL
+                                              : VTYSH_SERVER_EXECUTE,
+                                     n_args, args, &result, &error);
+    jsonrpc_close(client);
+    if (retval) {
+        fprintf(stderr, "%s: transaction error (%s)\n", program_name,
+                ovs_retval_to_string(retval));
+        exit(EXIT_FAILURE);
+    }
+
+    /* With -n, the server only fails requests it refuses to run. */
+    status = error ? EXIT_FAILURE : EXIT_SUCCESS;
+    if (error) {
+        fputs(error, no_error ? stderr : stdout);
+    } else if (!no_error && result) {
+        fputs(result, stdout);
+    }
+    free(result);
+    free(error);
+    free(args);
+    return status;
+}
@@ -29,6 +29,7 @@
 #include <sys/wait.h>
 #include <pwd.h>
 #include <termios.h>
+#include <time.h>
 
 #include <readline/readline.h>
 #include <readline/history.h>
@@ -55,8 +56,11 @@
 #include "vtysh/utils/passwd_srv_utils.h"
 #include "rbac.h"
 #include "vtysh/utils/audit_log_utils.h"
+#include "vtysh/vtysh_server.h"
+#include "vtysh/vtysh_zygote.h"
 
 #define FEATURES_CLI_PATH     "/usr/lib/cli/plugins"
+#define FEATURES_CLI_MANIFEST_PATH "/usr/lib/cli/manifests"
 VLOG_DEFINE_THIS_MODULE(vtysh_main);
 #endif
 
@@ -209,7 +213,11 @@ usage (int status)
 	    "-d, --daemon             Connect only to the specified daemon\n" \
 	    "-E, --echo               Echo prompt and command in -c mode\n" \
 	    "-C, --dryrun             Check configuration for validity and exit\n" \
-	    "-h, --help               Display this help and exit\n\n" \
+	    "-h, --help               Display this help and exit\n" \
+	    "-S, --server[=SOCKET]    Serve commands to vtysh-client\n" \
+	    "-Z, --zygote[=SOCKET]    Fork a session for every interactive login\n" \
+	    "-M, --plugin-manifest=PLUGIN\n" \
+	    "                         Print the manifest of a CLI plugin and exit\n\n" \
 	    "Note that multiple commands may be executed from the command\n" \
 	    "line by passing multiple -c args, or by embedding linefeed\n" \
 	    "characters in one or more of the commands.\n\n", progname);
@@ -235,6 +243,9 @@ struct option longopts[] =
   { "mininet-test",         no_argument,             NULL, 't'},
   { "verbose",              required_argument,       NULL, 'v'},
   { "temporary-db",         required_argument,       NULL, 'D'},
+  { "server",               optional_argument,       NULL, 'S'},
+  { "zygote",               optional_argument,       NULL, 'Z'},
+  { "plugin-manifest",      required_argument,       NULL, 'M'},
 #endif
   { 0 }
 };
@@ -306,6 +317,109 @@ static void tacacs_author_func_ptr_init()
   }
 }
 
+/* Time spent in each phase of the startup, logged at debug level by
+   vtysh_startup_log() once vtysh is ready for commands. */
+#define STARTUP_PHASES_MAX 8
+static struct
+{
+  const char *name;
+  long long int msec;
+} startup_phases[STARTUP_PHASES_MAX];
+static int n_startup_phases;
+static long long int startup_msec;
+
+static long long int
+startup_time_msec (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (long long int) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Start timing the startup from now. */
+static void
+vtysh_startup_reset (void)
+{
+  n_startup_phases = 0;
+  startup_msec = startup_time_msec ();
+}
+
+/* The phase name ends now. */
+static void
+vtysh_startup_phase (const char *name)
+{
+  long long int now = startup_time_msec ();
+
+  if (n_startup_phases < STARTUP_PHASES_MAX)
+    {
+      startup_phases[n_startup_phases].name = name;
+      startup_phases[n_startup_phases].msec = now - startup_msec;
+      n_startup_phases++;
+    }
+  startup_msec = now;
+}
+
+#ifdef ENABLE_OVSDB
+static void
+vtysh_startup_log (void)
+{
+  char buf[256];
+  long long int total = 0;
+  int len = 0;
+  int i;
+
+  buf[0] = '\0';
+  for (i = 0; i < n_startup_phases && len < sizeof buf; i++)
+    {
+      len += snprintf (buf + len, sizeof buf - len, "%s %lld ms, ",
+                       startup_phases[i].name, startup_phases[i].msec);
+      total += startup_phases[i].msec;
+    }
+  VLOG_DBG ("Startup: %stotal %lld ms", buf, total);
+}
+#endif
+
+/* Exit unless the user may use vtysh. */
+static void
+vtysh_check_user (struct passwd *pw)
+{
+  if (!rbac_is_user_permitted(pw->pw_name, VTY_SH))
+  {
+      const char *remote_user = getenv(REMOTE_USER_ENV);
+      if (remote_user != NULL) {
+          fprintf (stderr,
+              "%s does not have the required permissions to access Vtysh.\n",
+              remote_user);
+      } else {
+          fprintf (stderr,
+              "%s does not have the required permissions to access Vtysh.\n",
+              pw->pw_name);
+      }
+      exit(1);
+  }
+}
+
+#ifdef ENABLE_OVSDB
+static void
+vtysh_ovsdb_thread_start (void)
+{
+  pthread_t vtysh_ovsdb_if_thread;
+  int ret;
+
+  ret = pthread_create(&vtysh_ovsdb_if_thread,
+                       (pthread_attr_t *)NULL,
+                       vtysh_ovsdb_main_thread,
+                       NULL);
+
+  if (ret)
+  {
+      VLOG_ERR("Failed to create the poll thread %d",ret);
+      exit(-ret);
+  }
+}
+#endif
+
 /* VTY shell main routine. */
 int
 main (int argc, char **argv, char **env)
@@ -326,11 +440,14 @@ main (int argc, char **argv, char **env)
   int echo_command = 0;
   int no_error = 0;
   int ret = 0;
-  int counter=0;
   char *temp_db = NULL;
-  pthread_t vtysh_ovsdb_if_thread;
+  char *server_path = NULL;
+  char *zygote_path = NULL;
+  char *manifest_plugin = NULL;
   struct passwd *pw = NULL;
 
+  vtysh_startup_reset ();
+
   /* set CONSOLE as OFF and SYSLOG as DBG for ops-cli VLOG moduler list.*/
   vlog_set_verbosity("CONSOLE:OFF");
   vlog_set_verbosity("SYSLOG:INFO");
@@ -349,7 +466,7 @@ main (int argc, char **argv, char **env)
   while (1)
     {
 #ifdef ENABLE_OVSDB
-      opt = getopt_long (argc, argv, "be:c:d:nEhCtv:D:", longopts, 0);
+      opt = getopt_long (argc, argv, "be:c:d:nEhCtv:D:S::Z::M:", longopts, 0);
 #else
       opt = getopt_long (argc, argv, "be:c:nEhC", longopts, 0);
 #endif
@@ -406,12 +523,37 @@ main (int argc, char **argv, char **env)
           temp_db = optarg;
           vtysh_show_startup = 1;
           break;
+        case 'S':
+          vtysh_server_mode = true;
+          server_path = optarg;
+          break;
+        case 'Z':
+          vtysh_zygote_mode = true;
+          zygote_path = optarg;
+          break;
+        case 'M':
+          manifest_plugin = optarg;
+          break;
 #endif
 	default:
 	  usage (1);
 	  break;
 	}
     }
+#ifdef ENABLE_OVSDB
+  if (vtysh_zygote_mode && (cmd || boot_flag || dryrun || vtysh_server_mode))
+    usage (1);
+  if (manifest_plugin && (vtysh_zygote_mode || vtysh_server_mode))
+    usage (1);
+
+  /* Interactive logins are served by the zygote when one is running. */
+  if (!vtysh_zygote_mode && !vtysh_server_mode && !manifest_plugin && !cmd
+      && !boot_flag && !dryrun && !no_error && !temp_db && !verbosity_arg
+      && !enable_mininet_test_prompt && isatty (STDIN_FILENO)
+      && (ret = vtysh_zygote_login ()) >= 0)
+    exit (ret);
+#endif
+
   pw = getpwuid( getuid());
   if (pw == NULL)
   {
@@ -419,39 +561,32 @@ main (int argc, char **argv, char **env)
       exit(1);
   }
 
-  if (!rbac_is_user_permitted(pw->pw_name, VTY_SH))
-  {
-      const char *remote_user = getenv(REMOTE_USER_ENV);
-      if (remote_user != NULL) {
-          fprintf (stderr,
-              "%s does not have the required permissions to access Vtysh.\n",
-              remote_user);
-      } else {
-          fprintf (stderr,
-              "%s does not have the required permissions to access Vtysh.\n",
-              pw->pw_name);
-      }
-      exit(1);
-  }
 #ifdef ENABLE_OVSDB
+  /* The zygote checks the users of its sessions. */
+  if (!vtysh_zygote_mode)
+#endif
+    vtysh_check_user (pw);
+  vtysh_startup_phase ("user check");
+#ifdef ENABLE_OVSDB
+  /* Applied again below, here for the messages of the plugin loader. */
+  if (verbosity_arg)
+    vlog_set_verbosity (verbosity_arg);
   vtysh_ovsdb_init_clients();
   vtysh_ovsdb_init(argc, argv, temp_db);
+  vtysh_startup_phase ("ovsdb init");
   /* Make vty structure. */
   vty = vty_new ();
   vty->type = VTY_SHELL;
   vty->node = VIEW_NODE;
   cmd_init(0);
-  plugins_cli_init(FEATURES_CLI_PATH);
-  ret = pthread_create(&vtysh_ovsdb_if_thread,
-                       (pthread_attr_t *)NULL,
-                       vtysh_ovsdb_main_thread,
-                       NULL);
-
-  if (ret)
-  {
-      VLOG_ERR("Failed to create the poll thread %d",ret);
-      exit(-ret);
-  }
+  if (manifest_plugin)
+    plugins_cli_manifest (manifest_plugin);
+  else
+    plugins_cli_init(FEATURES_CLI_PATH, FEATURES_CLI_MANIFEST_PATH);
+  vtysh_startup_phase ("plugins");
+  /* A zygote must not have threads when it forks. */
+  if (!vtysh_zygote_mode && !manifest_plugin)
+    vtysh_ovsdb_thread_start ();
 #endif
 
   /* Initialize user input buffer. */
@@ -462,7 +597,16 @@ main (int argc, char **argv, char **env)
   vtysh_signal_init ();
 
   /* Make vty structure and register commands. */
+#ifdef ENABLE_OVSDB
+  vtysh_init_vty (vtysh_zygote_mode ? NULL : pw);
+  if (manifest_plugin)
+    {
+      plugins_cli_manifest_write (stdout);
+      exit (0);
+    }
+#else
   vtysh_init_vty (pw);
+#endif
 
   /* set CONSOLE as OFF */
   vlog_set_verbosity("CONSOLE:OFF");
@@ -480,13 +624,43 @@ main (int argc, char **argv, char **env)
   passwd_srv_path_manager_init();
 
   vty_init_vtysh ();
+  vtysh_startup_phase ("commands");
 
   /* Read vtysh configuration file before connecting to daemons. */
   vtysh_read_config (config_default);
+  vtysh_startup_phase ("config");
 
   /* Start execution only if not in dry-run mode */
   if(dryrun)
-    return(0);
+    {
+      /* Plugins are loaded and commands parsed on first use, check all of
+         them here. */
+#ifdef ENABLE_OVSDB
+      plugins_cli_load_all ();
+#endif
+      cmd_parse_all ();
+      return(0);
+    }
+
+#ifdef ENABLE_OVSDB
+  /* Zygote mode, continue in the session forked for a login. */
+  if (vtysh_zygote_mode)
+    {
+      /* Load the plugins and parse the commands once for all the
+         sessions. */
+      plugins_cli_load_all ();
+      cmd_parse_all ();
+      pw = vtysh_zygote_run (zygote_path);
+      vtysh_startup_reset ();
+      audit_close (audit_fd);
+      audit_fd = audit_open ();
+      vtysh_check_user (pw);
+      vtysh_init_vty_user (pw);
+      vtysh_ovsdb_session_init ();
+      vtysh_ovsdb_thread_start ();
+      vtysh_startup_phase ("session");
+    }
+#endif
 
   /* Ignore error messages */
   if (no_error)
@@ -504,19 +678,30 @@ main (int argc, char **argv, char **env)
     }
 #endif
 
+#ifdef ENABLE_OVSDB
+  /* Command server mode. */
+  if (vtysh_server_mode)
+    {
+      vtysh_ovsdb_wait_loaded(MAX_TIMEOUT_FOR_IDL_CHANGE * 1000);
+      vtysh_startup_phase ("idl sync");
+      vtysh_startup_log ();
+
+      tacacs_author_func_ptr_init();
+      vtysh_server_run(server_path);
+      vtysh_ovsdb_exit();
+      exit (0);
+    }
+#endif
+
   /* If eval mode. */
   if (cmd)
     {
-      /* Wait for idl sequence number */
-      do
-      {
-	 if(vtysh_ovsdb_is_loaded())
-         {
-            break;
-         }
-         sleep(1);
-         counter++;
-      }while(counter < MAX_TIMEOUT_FOR_IDL_CHANGE);
+#ifdef ENABLE_OVSDB
+      /* Start as soon as the OVSDB thread has synced the IDL. */
+      vtysh_ovsdb_wait_loaded(MAX_TIMEOUT_FOR_IDL_CHANGE * 1000);
+      vtysh_startup_phase ("idl sync");
+      vtysh_startup_log ();
+#endif
 
       /* Enter into enable node. */
       vtysh_execute ("enable");
@@ -602,19 +787,12 @@ main (int argc, char **argv, char **env)
 #ifdef ENABLE_OVSDB
   /*
    * Wait for  ovsdb to be loaded. If ovsdb is not ready and user tries to configure,
-   * commands will fail to execute. So, wait for idl sequence number to change which
-   * indicates OVSDB is ready for transactions.
+   * commands will fail to execute. So, wait for the OVSDB thread to finish the
+   * initial sync which indicates OVSDB is ready for transactions.
    */
-  counter = 0;
-  do
-  {
-    if (vtysh_ovsdb_is_loaded())
-    {
-        break;
-    }
-    usleep(500000); //sleep for 500 msec
-    counter++;
-  } while (counter < MAX_TIMEOUT_FOR_IDL_CHANGE);
+  vtysh_ovsdb_wait_loaded(MAX_TIMEOUT_FOR_IDL_CHANGE * 500);
+  vtysh_startup_phase ("idl sync");
+  vtysh_startup_log ();
 #endif
 
   ospf_area_vlink_init();
@@ -32,6 +32,7 @@
 #include "vtysh_ovsdb_config.h"
 #include "vtysh_ovsdb_if.h"
 #include "lib/vty.h"
+#include "lib/cli_plugins.h"
 #include "vtysh_ovsdb_config_context.h"
 #include "vtysh/utils/vlan_vtysh_utils.h"
 #include "vtysh/vtysh_ovsdb_router_context.h"
@@ -43,6 +44,8 @@ VLOG_DEFINE_THIS_MODULE(vtysh_ovsdb_config);
 #define CONF_DEFAULT_VER  "0.0.0"
 extern struct ovsdb_idl *idl;
 static vtysh_contextlist * show_run_contextlist = NULL;
+/* Calls to install_show_run_config_(sub)context(), for plugin manifests. */
+static unsigned int show_run_context_installs;
 
 /*-----------------------------------------------------------------------------
 | Function: vtysh_sh_run_iteratecontextlist
@@ -64,6 +67,9 @@ vtysh_sh_run_iteratecontextlist(FILE *fp)
     int idx, count;
     const char *db_ver = NULL;
 
+    /* Plugins with running-config contexts are needed from here on. */
+    plugins_cli_load_contexts();
+
     VLOG_DBG("readconfig:before- idl 0x%p seq no %d", idl,
              ovsdb_idl_get_seqno(idl));
 
@@ -147,6 +153,14 @@ vtysh_sh_run_iteratecontextlist(FILE *fp)
     return e_vtysh_ok;
 }
 
+/* Number of calls to install_show_run_config_context() and
+ * install_show_run_config_subcontext() so far. */
+unsigned int
+vtysh_sh_run_context_installs(void)
+{
+    return show_run_context_installs;
+}
+
 /*-----------------------------------------------------------------------------
 | Function: vtysh_ovsdb_cli_print
 | Responsibility : prints the command in given format
@@ -247,8 +261,10 @@ install_show_run_config_context(vtysh_contextid index,
                           void (*exit_funcptr) (struct feature_sorted_list * head))
 {
     vtysh_contextlist *current;
-    vtysh_contextlist *new_context = (vtysh_contextlist *)
-                                malloc (sizeof(vtysh_contextlist));
+    vtysh_contextlist *new_context;
+
+    show_run_context_installs++;
+    new_context = (vtysh_contextlist *) malloc (sizeof(vtysh_contextlist));
     if (new_context == NULL) {
         VLOG_ERR("Error while allocating memory in malloc\n");
         return e_vtysh_error;
@@ -314,6 +330,7 @@ install_show_run_config_subcontext(vtysh_contextid index,
 {
     vtysh_contextlist *current, *new_subcontext, *temp;
 
+    show_run_context_installs++;
     if (show_run_contextlist == NULL)
     {
         VLOG_ERR("No parent context %d to add sub-context %d.\n",
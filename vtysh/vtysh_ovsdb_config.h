@@ -164,6 +164,8 @@ extern unsigned int vtysh_ovsdb_idl_seqno;
 
 vtysh_ret_val vtysh_sh_run_iteratecontextlist(FILE *fp);
 
+unsigned int vtysh_sh_run_context_installs(void);
+
 vtysh_ret_val vtysh_ovsdb_cli_print(vtysh_ovsdb_cbmsg *p_msg, const char *fmt, ...);
 
 /* All log/debug/err logging functions */
@@ -23,7 +23,10 @@
  * Purpose: Main file for integrating vtysh with ovsdb.
 */
 
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
+#include <time.h>
 #include "vector.h"
 #include "command.h"
 #include <pthread.h>
@@ -58,10 +61,23 @@
 #endif /* HAVE_GNU_REGEX */
 
 #include "lib/vty.h"
+#include "lib/regex_cache.h"
 #include "latch.h"
+#include "bitmap.h"
+#include "dynamic-string.h"
+#include "ovsdb-data.h"
+#include "ovs-atomic.h"
 #include "lib/vty_utils.h"
+#include "vtysh/utils/bgp_nbr_vtysh_utils.h"
+#include "vtysh/utils/ospf_lookup_vtysh_utils.h"
+#include "vtysh/utils/ospf_lsdb_vtysh_utils.h"
+#include "vtysh/utils/ospf_route_vtysh_utils.h"
+#include "vtysh/utils/sub_intf_vtysh_utils.h"
+#include "vtysh/utils/vlan_vtysh_utils.h"
 #include "vtysh/utils/vrf_vtysh_utils.h"
 #include "vrf-utils.h"
+#include "vtysh/vtysh_server.h"
+#include "vtysh/vtysh_zygote.h"
 
 #define TMOUT_POLL_INTERVAL 20
 
@@ -86,8 +102,307 @@ static int cur_cfg_no = 0;
 
 boolean exiting = false;
 volatile boolean vtysh_exit_flag = false;
+
+/* Set and signaled by the OVSDB thread once the initial sync is done. */
+static pthread_mutex_t vtysh_ovsdb_loaded_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t vtysh_ovsdb_loaded_cond;
+static bool vtysh_ovsdb_loaded = false;
 extern struct vty *vty;
 
+/* On-demand tables.  The large, fast-changing tables are left out of idl.
+ * A command that reads them is declared with DEFUN_TABLES and runs against
+ * a second IDL monitoring its groups of tables, which the OVSDB thread
+ * creates the first time such a command runs and drops once none of its
+ * groups was used for VTYSH_OVSDB_TABLES_IDLE_TIMEOUT.  An IDL cannot
+ * change what it monitors once connected, so the second IDL is recreated
+ * whenever the set of groups changes. */
+#define VTYSH_OVSDB_TABLES_IDLE_TIMEOUT (120 * 1000)
+
+/* The columns the commands of each group read, for their tables and the
+ * rows those refer to.  Only these are replicated by the second IDL, so a
+ * DEFUN_TABLES command reading another column must add it here. */
+static const struct ovsdb_idl_column *const bgp_rib_columns[] = {
+    /* show ip bgp, show ipv6 bgp, show ip bgp A.B.C.D. */
+    &ovsrec_bgp_route_col_address_family,
+    &ovsrec_bgp_route_col_bgp_nexthops,
+    &ovsrec_bgp_route_col_metric,
+    &ovsrec_bgp_route_col_path_attributes,
+    &ovsrec_bgp_route_col_peer,
+    &ovsrec_bgp_route_col_prefix,
+    &ovsrec_bgp_nexthop_col_ip_address,
+    &ovsrec_bgp_router_col_router_id,
+    &ovsrec_vrf_col_active_router_id,
+    /* show ip bgp summary, show bgp summary. */
+    &ovsrec_vrf_col_bgp_routers,
+    &ovsrec_bgp_router_col_bgp_neighbors,
+    &ovsrec_bgp_neighbor_col_is_peer_group,
+    &ovsrec_bgp_neighbor_col_remote_as,
+    &ovsrec_bgp_neighbor_col_statistics,
+    &ovsrec_bgp_neighbor_col_status,
+    /* test route-map. */
+    &ovsrec_route_map_col_name,
+    &ovsrec_route_map_col_route_map_entries,
+    &ovsrec_route_map_entry_col_action,
+    &ovsrec_route_map_entry_col_match,
+    &ovsrec_route_map_entry_col_set,
+    &ovsrec_prefix_list_col_name,
+    &ovsrec_prefix_list_col_prefix_list_entries,
+    &ovsrec_prefix_list_entry_col_action,
+    &ovsrec_prefix_list_entry_col_ge,
+    &ovsrec_prefix_list_entry_col_le,
+    &ovsrec_prefix_list_entry_col_prefix,
+    NULL
+};
+
+static const struct ovsdb_idl_column *const ospf_lsdb_columns[] = {
+    /* The OSPF router of a VRF and its areas. */
+    &ovsrec_vrf_col_name,
+    &ovsrec_vrf_col_ospf_routers,
+    &ovsrec_ospf_router_col_areas,
+    &ovsrec_ospf_router_col_other_config,
+    &ovsrec_ospf_router_col_router_id,
+    &ovsrec_ospf_router_col_spf_calculation,
+    &ovsrec_ospf_router_col_status,
+    &ovsrec_ospf_router_col_stub_router_adv,
+    &ovsrec_ospf_area_col_area_type,
+    &ovsrec_ospf_area_col_ospf_auth_type,
+    &ovsrec_ospf_area_col_ospf_interfaces,
+    &ovsrec_ospf_area_col_statistics,
+    &ovsrec_ospf_area_col_status,
+    /* The interfaces counted by "show ip ospf": a reference to a row that
+     * is not replicated is dropped, so the table needs a column. */
+    &ovsrec_ospf_interface_col_name,
+    /* show ip ospf database. */
+    &ovsrec_ospf_router_col_as_ext_lsas,
+    &ovsrec_ospf_router_col_opaque_as_lsas,
+    &ovsrec_ospf_area_col_abr_summary_lsas,
+    &ovsrec_ospf_area_col_as_nssa_lsas,
+    &ovsrec_ospf_area_col_asbr_summary_lsas,
+    &ovsrec_ospf_area_col_network_lsas,
+    &ovsrec_ospf_area_col_opaque_area_lsas,
+    &ovsrec_ospf_area_col_opaque_link_lsas,
+    &ovsrec_ospf_area_col_router_lsas,
+    &ovsrec_ospf_lsa_col_adv_router,
+    &ovsrec_ospf_lsa_col_chksum,
+    &ovsrec_ospf_lsa_col_flags,
+    &ovsrec_ospf_lsa_col_length,
+    &ovsrec_ospf_lsa_col_ls_birth_time,
+    &ovsrec_ospf_lsa_col_ls_id,
+    &ovsrec_ospf_lsa_col_ls_seq_num,
+    &ovsrec_ospf_lsa_col_lsa_data,
+    &ovsrec_ospf_lsa_col_lsa_type,
+    &ovsrec_ospf_lsa_col_num_router_links,
+    &ovsrec_ospf_lsa_col_options,
+    &ovsrec_ospf_lsa_col_prefix,
+    /* show ip ospf route. */
+    &ovsrec_ospf_router_col_ext_ospf_routes,
+    &ovsrec_ospf_area_col_inter_area_ospf_routes,
+    &ovsrec_ospf_area_col_intra_area_ospf_routes,
+    &ovsrec_ospf_area_col_router_ospf_routes,
+    &ovsrec_ospf_route_col_path_type,
+    &ovsrec_ospf_route_col_paths,
+    &ovsrec_ospf_route_col_prefix,
+    &ovsrec_ospf_route_col_route_info,
+    NULL
+};
+
+static const struct {
+    unsigned int tables;        /* CMD_TABLES_* */
+    const struct ovsdb_idl_column *const *columns;
+} table_groups[] = {
+    { CMD_TABLES_BGP_RIB, bgp_rib_columns },
+    { CMD_TABLES_OSPF_LSDB, ospf_lsdb_columns },
+};
+
+static char *ovsdb_remote;
+
+/* Owned by the OVSDB thread, accessed with the IDL locked. */
+static struct ovsdb_idl *tables_idl;
+static unsigned int tables_monitored;   /* Groups of tables_idl. */
+static unsigned int tables_generation;  /* Bumped for each tables_idl. */
+static long long int tables_expire = LLONG_MAX;
+
+/* Shared with the commands, under tables_mutex. */
+static pthread_mutex_t tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tables_cond;
+static unsigned int tables_requested;   /* Groups commands want. */
+static unsigned int tables_synced;      /* Groups ready in tables_idl. */
+static long long int tables_last_used[ARRAY_SIZE(table_groups)];
+
+/* Hot fields of the System row.  The snapshot in system_fields is replaced,
+ * never modified, and only with the IDL locked, so lock holders may use it
+ * as is.  The prompt reads it without the lock between
+ * vtysh_ovsdb_system_fields_get() and vtysh_ovsdb_system_fields_put(), so a
+ * replaced snapshot is kept in retired_fields until the OVSDB thread sees no
+ * such reader. */
+static struct vtysh_system_fields system_fields_empty = {
+    .session_timeout = DEFAULT_SESSION_TIMEOUT_PERIOD,
+};
+static ATOMIC(struct vtysh_system_fields *) system_fields
+    = ATOMIC_VAR_INIT(&system_fields_empty);
+static atomic_uint system_fields_readers = ATOMIC_VAR_INIT(0);
+static unsigned int system_fields_seqno;    /* System table seqno copied. */
+static struct vtysh_system_fields **retired_fields;
+static size_t n_retired_fields, allocated_retired_fields;
+
+static char *
+system_fields_strdup(const struct smap *smap, const char *key)
+{
+    const char *value = smap_get(smap, key);
+
+    return value ? xstrdup(value) : NULL;
+}
+
+static void
+system_fields_free(struct vtysh_system_fields *fields)
+{
+    free(fields->hostname);
+    free(fields->domain_name);
+    free(fields->banner);
+    free(fields->banner_exec);
+    free(fields);
+}
+
+/* Returns the System row fields, copying them again first if the System
+ * table changed since the last copy.  The IDL must be locked. */
+static const struct vtysh_system_fields *
+system_fields_current(void)
+{
+    const struct ovsrec_system *ovs;
+    struct vtysh_system_fields *fields, *old;
+    unsigned int seqno = ovsrec_system_get_seqno(idl);
+
+    atomic_read(&system_fields, &old);
+    if (seqno == system_fields_seqno) {
+        return old;
+    }
+    system_fields_seqno = seqno;
+
+    fields = xzalloc(sizeof *fields);
+    fields->session_timeout = DEFAULT_SESSION_TIMEOUT_PERIOD;
+    ovs = ovsrec_system_first(idl);
+    if (ovs) {
+        fields->valid = true;
+        fields->hostname = system_fields_strdup(&ovs->mgmt_intf_status,
+                                            SYSTEM_MGMT_INTF_MAP_HOSTNAME);
+        fields->domain_name = system_fields_strdup(&ovs->mgmt_intf_status,
+                                            SYSTEM_MGMT_INTF_MAP_DOMAIN_NAME);
+        fields->session_timeout = smap_get_int(&ovs->other_config,
+                                 SYSTEM_OTHER_CONFIG_MAP_CLI_SESSION_TIMEOUT,
+                                 DEFAULT_SESSION_TIMEOUT_PERIOD);
+        fields->banner = system_fields_strdup(&ovs->other_config,
+                                              SYSTEM_OTHER_CONFIG_MAP_BANNER);
+        fields->banner_exec = system_fields_strdup(&ovs->other_config,
+                                         SYSTEM_OTHER_CONFIG_MAP_BANNER_EXEC);
+        fields->cur_cfg = ovs->cur_cfg;
+    }
+    atomic_store(&system_fields, fields);
+
+    if (old != &system_fields_empty) {
+        if (n_retired_fields >= allocated_retired_fields) {
+            retired_fields = x2nrealloc(retired_fields,
+                                        &allocated_retired_fields,
+                                        sizeof *retired_fields);
+        }
+        retired_fields[n_retired_fields++] = old;
+    }
+    return fields;
+}
+
+/* Frees the replaced snapshots once no lock-free reader is left.  Run by
+ * the OVSDB thread between commands, as lock holders may still use them. */
+static void
+system_fields_reclaim(void)
+{
+    unsigned int readers;
+    size_t i;
+
+    atomic_read(&system_fields_readers, &readers);
+    if (readers) {
+        return;
+    }
+    for (i = 0; i < n_retired_fields; i++) {
+        system_fields_free(retired_fields[i]);
+    }
+    n_retired_fields = 0;
+}
+
+/* Returns the System row fields without taking the IDL lock.  They stay
+ * valid until passed to vtysh_ovsdb_system_fields_put(). */
+const struct vtysh_system_fields *
+vtysh_ovsdb_system_fields_get(void)
+{
+    struct vtysh_system_fields *fields;
+    unsigned int orig;
+
+    atomic_add(&system_fields_readers, 1, &orig);
+    atomic_read(&system_fields, &fields);
+    return fields;
+}
+
+void
+vtysh_ovsdb_system_fields_put(const struct vtysh_system_fields *fields
+                              OVS_UNUSED)
+{
+    unsigned int orig;
+
+    atomic_sub(&system_fields_readers, 1, &orig);
+}
+
+/* Caches that follow the changes tracked by the IDL.  Each one is run with
+ * idl pointing to the IDL that changed, the main one or the on-demand
+ * tables one, and sees every change once: the tracked changes are cleared
+ * after the caches ran. */
+static vtysh_ovsdb_track_func **track_funcs;
+static size_t n_track_funcs, allocated_track_funcs;
+static unsigned int track_seqno;        /* idl seqno the caches follow. */
+static unsigned int tables_track_seqno; /* tables_idl seqno likewise. */
+static unsigned int txn_seqno;          /* Bumped when a txn ends. */
+
+/* Registers a cache following the IDL change tracking.  Called with the
+ * IDL locked, before the cache is first filled. */
+void
+vtysh_ovsdb_track_register(vtysh_ovsdb_track_func *func)
+{
+    if (n_track_funcs >= allocated_track_funcs) {
+        track_funcs = x2nrealloc(track_funcs, &allocated_track_funcs,
+                                 sizeof *track_funcs);
+    }
+    track_funcs[n_track_funcs++] = func;
+}
+
+/* Applies the changes tracked by the IDL idl points to since the last call
+ * to the caches.  Run by the OVSDB thread after ovsdb_idl_run(), and by the
+ * caches before a lookup, as a command may have run the IDL since.  The
+ * IDL must be locked. */
+void
+vtysh_ovsdb_track_run(void)
+{
+    unsigned int *seqnop = (tables_idl && idl == tables_idl
+                            ? &tables_track_seqno : &track_seqno);
+    unsigned int seqno = ovsdb_idl_get_seqno(idl);
+    size_t i;
+
+    if (seqno == *seqnop) {
+        return;
+    }
+    *seqnop = seqno;
+    for (i = 0; i < n_track_funcs; i++) {
+        track_funcs[i]();
+    }
+    ovsdb_idl_track_clear(idl);
+}
+
+/* Identifies the transactions of the commands: it changes whenever one is
+ * committed or aborted.  The rows written by a transaction take back their
+ * committed contents when it ends, without a tracked change, so a cache
+ * that saw a written row must be rebuilt once this changes. */
+unsigned int
+vtysh_ovsdb_txn_seqno(void)
+{
+    return txn_seqno;
+}
+
 /* Function checks if timeout period has
 *  exceeded. If yes, exits cli session.
 */
@@ -96,6 +411,11 @@ vtysh_session_timeout_run()
 {
     static int64_t session_timeout_period = 60 * DEFAULT_SESSION_TIMEOUT_PERIOD;
 
+    /* The command server has no session to time out. */
+    if (vtysh_server_mode) {
+        return;
+    }
+
     if (idl_seqno != ovsdb_idl_get_seqno(idl))
     {
         idl_seqno = ovsdb_idl_get_seqno(idl);
@@ -122,6 +442,9 @@ static void
 vtysh_run()
 {
     ovsdb_idl_run (idl);
+    vtysh_ovsdb_track_run();
+    system_fields_current();
+    system_fields_reclaim();
     vtysh_session_timeout_run();
 }
 
@@ -130,275 +453,210 @@ vtysh_wait(void)
 {
     ovsdb_idl_wait (idl);
     latch_wait (&ovsdb_latch);
+    if (tables_idl) {
+        ovsdb_idl_wait(tables_idl);
+    }
+    if (tables_expire != LLONG_MAX) {
+        poll_timer_wait_until(tables_expire);
+    }
 }
 
-static void
-bgp_ovsdb_init()
-{
+static const struct vtysh_ovsdb_column bgp_columns[] = {
     /* BGP router table. */
-    ovsdb_idl_add_table(idl, &ovsrec_table_bgp_router);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_router_id);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_networks);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_maximum_paths);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_timers);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_always_compare_med);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_deterministic_med);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_gr_stale_timer);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_bgp_neighbors);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_other_config);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_status);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_external_ids);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_fast_external_failover);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_log_neighbor_changes);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_redistribute);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_router_col_redistribute_route_map);
+    { &ovsrec_bgp_router_col_router_id, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_networks, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_maximum_paths, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_timers, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_always_compare_med, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_deterministic_med, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_gr_stale_timer, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_bgp_neighbors, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_other_config, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_status, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_bgp_router_col_external_ids, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_fast_external_failover, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_log_neighbor_changes, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_redistribute, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_router_col_redistribute_route_map, VTYSH_OVSDB_COLUMN_READ },
     /* BGP neighbor table. */
-    ovsdb_idl_add_table(idl, &ovsrec_table_bgp_neighbor);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_is_peer_group);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_description);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_shutdown);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_bgp_peer_group);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_local_interface);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_remote_as);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_allow_as_in);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_local_as);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_bfd_fallover_enable);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_bfd_session);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_weight);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_tcp_port_number);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_advertisement_interval);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_maximum_prefix_limit);
-    ovsdb_idl_add_column(idl,
-                         &ovsrec_bgp_neighbor_col_inbound_soft_reconfiguration);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_remove_private_as);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_passive);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_password);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_timers);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_route_maps);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_prefix_lists);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_aspath_filters);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_statistics);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_status);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_external_ids);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_other_config);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_ebgp_multihop);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_ttl_security_hops);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_neighbor_col_update_source);
-
+    { &ovsrec_bgp_neighbor_col_is_peer_group, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_description, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_shutdown, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_bgp_peer_group, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_local_interface, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_remote_as, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_allow_as_in, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_local_as, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_bfd_fallover_enable, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_bfd_session, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_weight, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_tcp_port_number, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_advertisement_interval,
+      VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_maximum_prefix_limit, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_inbound_soft_reconfiguration,
+      VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_remove_private_as, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_passive, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_password, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_timers, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_route_maps, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_prefix_lists, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_aspath_filters, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_statistics, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_bgp_neighbor_col_status, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_bgp_neighbor_col_external_ids, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_other_config, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_ebgp_multihop, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_ttl_security_hops, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_neighbor_col_update_source, VTYSH_OVSDB_COLUMN_READ },
     /* RIB. */
-    ovsdb_idl_add_table(idl, &ovsrec_table_route);
-    ovsdb_idl_add_column(idl, &ovsrec_route_col_prefix);
-    ovsdb_idl_add_column(idl, &ovsrec_route_col_from);
-    ovsdb_idl_add_column(idl, &ovsrec_route_col_nexthops);
-    ovsdb_idl_add_column(idl, &ovsrec_route_col_address_family);
-    ovsdb_idl_add_column(idl, &ovsrec_route_col_sub_address_family);
-    ovsdb_idl_add_column(idl, &ovsrec_route_col_selected);
-    ovsdb_idl_add_column(idl, &ovsrec_route_col_distance);
-    ovsdb_idl_add_column(idl, &ovsrec_route_col_metric);
-    ovsdb_idl_add_column(idl, &ovsrec_route_col_vrf);
-
-    /* BGP RIB table. */
-    ovsdb_idl_add_table(idl, &ovsrec_table_bgp_route);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_route_col_prefix);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_route_col_bgp_nexthops);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_route_col_address_family);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_route_col_sub_address_family);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_route_col_distance);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_route_col_metric);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_route_col_vrf);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_route_col_path_attributes);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_route_col_peer);
-
-    /* BGP Nexthop table. */
-    ovsdb_idl_add_table(idl, &ovsrec_table_bgp_nexthop);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_nexthop_col_ip_address);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_nexthop_col_type);
-
-}
+    { &ovsrec_route_col_prefix, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_col_from, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_col_nexthops, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_col_address_family, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_col_sub_address_family, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_col_selected, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_col_distance, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_col_metric, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_col_vrf, VTYSH_OVSDB_COLUMN_READ },
+};
 
 static void
-ospf_ovsdb_init()
+bgp_ovsdb_init()
 {
-    ovsdb_idl_add_table(idl, &ovsrec_table_vrf);
-    ovsdb_idl_add_table(idl, &ovsrec_table_interface);
-
-    /* Port table */
-    ovsdb_idl_add_table(idl, &ovsrec_table_port);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ospf_auth_md5_keys);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ospf_auth_text_key);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ospf_auth_type);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ospf_if_out_cost);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ospf_if_type);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ospf_intervals);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ospf_priority);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ospf_mtu_ignore);
+    vtysh_ovsdb_add_columns(bgp_columns, ARRAY_SIZE(bgp_columns));
+    bgp_nbr_index_init();
 
+    /* BGP_Route and BGP_Nexthop are on-demand tables, see
+     * bgp_rib_columns. */
+}
 
+static const struct vtysh_ovsdb_column ospf_columns[] = {
+    /* Port table */
+    { &ovsrec_port_col_ospf_auth_md5_keys, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ospf_auth_text_key, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ospf_auth_type, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ospf_if_out_cost, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ospf_if_type, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ospf_intervals, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ospf_priority, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ospf_mtu_ignore, VTYSH_OVSDB_COLUMN_READ },
     /* System table */
-    ovsdb_idl_add_table(idl, &ovsrec_table_system);
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_router_id);
-
-
+    { &ovsrec_system_col_router_id, VTYSH_OVSDB_COLUMN_READ },
     /* OSPF Router */
-    ovsdb_idl_add_table(idl, &ovsrec_table_ospf_router);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_spf_calculation);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_distance);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_redistribute);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_default_information);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_nbma_nbrs);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_other_config);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_as_ext_lsas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_passive_interface_default);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_stub_router_adv);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_status);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_router_id);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_ext_ospf_routes);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_passive_interfaces);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_opaque_as_lsas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_areas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_lsa_timers);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_router_col_networks);
-
-
+    { &ovsrec_ospf_router_col_spf_calculation, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_distance, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_redistribute, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_default_information, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_nbma_nbrs, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_other_config, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_passive_interface_default,
+      VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_stub_router_adv, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_status, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_router_col_router_id, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_passive_interfaces, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_areas, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_lsa_timers, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_router_col_networks, VTYSH_OVSDB_COLUMN_READ },
     /* OSPF Area */
-    ovsdb_idl_add_table(idl, &ovsrec_table_ospf_area);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_status);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_statistics);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_inter_area_ospf_routes);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_router_ospf_routes);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_network_lsas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_ospf_area_summary_addresses);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_opaque_area_lsas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_opaque_link_lsas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_as_nssa_lsas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_abr_summary_lsas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_other_config);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_area_type);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_intra_area_ospf_routes);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_asbr_summary_lsas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_ospf_vlinks);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_ospf_interfaces);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_ospf_auth_type);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_router_lsas);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_prefix_lists);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_area_col_nssa_translator_role);
-
-
+    { &ovsrec_ospf_area_col_status, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_area_col_statistics, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_area_col_ospf_area_summary_addresses,
+      VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_area_col_other_config, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_area_col_area_type, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_area_col_ospf_vlinks, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_area_col_ospf_interfaces, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_area_col_ospf_auth_type, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_area_col_prefix_lists, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_area_col_nssa_translator_role, VTYSH_OVSDB_COLUMN_READ },
     /* OSPF Interface */
-    ovsdb_idl_add_table(idl, &ovsrec_table_ospf_interface);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_interface_col_neighbors);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_interface_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_interface_col_status);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_interface_col_ifsm_state);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_interface_col_ospf_vlink);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_interface_col_statistics);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_interface_col_port);
-
-
+    { &ovsrec_ospf_interface_col_neighbors, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_interface_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_interface_col_status, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_interface_col_ifsm_state, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_interface_col_ospf_vlink, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_interface_col_statistics, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_interface_col_port, VTYSH_OVSDB_COLUMN_READ },
     /* OSPF Neighbor */
-    ovsdb_idl_add_table(idl, &ovsrec_table_ospf_neighbor);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_statistics);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_nfsm_state);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_nbr_if_addr);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_nbr_priority);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_nbr_options);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_bdr);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_nbma_nbr);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_dr);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_status);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_neighbor_col_nbr_router_id);
-
+    { &ovsrec_ospf_neighbor_col_statistics, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_neighbor_col_nfsm_state, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_neighbor_col_nbr_if_addr, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_neighbor_col_nbr_priority, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_neighbor_col_nbr_options, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_neighbor_col_bdr, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_neighbor_col_nbma_nbr, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_neighbor_col_dr, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_neighbor_col_status, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_neighbor_col_nbr_router_id, VTYSH_OVSDB_COLUMN_READ },
     /* OSPF Neighbor NBMA */
-    ovsdb_idl_add_table(idl,
-                        &ovsrec_table_ospf_nbma_neighbor);
-    ovsdb_idl_add_column(idl,
-                        &ovsrec_ospf_nbma_neighbor_col_nbr_address);
-    ovsdb_idl_add_column(idl,
-                        &ovsrec_ospf_nbma_neighbor_col_interface_name);
-    ovsdb_idl_add_column(idl,
-                        &ovsrec_ospf_nbma_neighbor_col_status);
-    ovsdb_idl_add_column(idl,
-                        &ovsrec_ospf_nbma_neighbor_col_nbr_router_id);
-    ovsdb_idl_add_column(idl,
-                        &ovsrec_ospf_nbma_neighbor_col_other_config);
-
-
+    { &ovsrec_ospf_nbma_neighbor_col_nbr_address, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_nbma_neighbor_col_interface_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_nbma_neighbor_col_status, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_ospf_nbma_neighbor_col_nbr_router_id, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_nbma_neighbor_col_other_config, VTYSH_OVSDB_COLUMN_READ },
     /* OSPF Summary Address  */
-    ovsdb_idl_add_table(idl, &ovsrec_table_ospf_summary_address);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_summary_address_col_prefix);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_summary_address_col_other_config);
-
-    /* OSPF Route  */
-    ovsdb_idl_add_table(idl, &ovsrec_table_ospf_route);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_route_col_route_info);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_route_col_path_type);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_route_col_prefix);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_route_col_route_info);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_route_col_paths);
-
-    /* OSPF LSA */
-    ovsdb_idl_add_table(idl, &ovsrec_table_ospf_lsa);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_area_id);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_ls_seq_num);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_lsa_data);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_length);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_num_router_links);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_ls_birth_time);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_prefix);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_lsa_type);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_flags);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_chksum);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_ls_id);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_adv_router);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_lsa_col_options);
-
+    { &ovsrec_ospf_summary_address_col_prefix, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_summary_address_col_other_config, VTYSH_OVSDB_COLUMN_READ },
     /* OSPF Vlink */
-    ovsdb_idl_add_table(idl, &ovsrec_table_ospf_vlink);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_vlink_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_vlink_col_other_config);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_vlink_col_area_id);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_vlink_col_ospf_auth_text_key);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_vlink_col_peer_router_id);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_vlink_col_ospf_auth_type);
-    ovsdb_idl_add_column(idl, &ovsrec_ospf_vlink_col_ospf_auth_md5_keys);
+    { &ovsrec_ospf_vlink_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_vlink_col_other_config, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_vlink_col_area_id, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_vlink_col_ospf_auth_text_key, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_vlink_col_peer_router_id, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_vlink_col_ospf_auth_type, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_ospf_vlink_col_ospf_auth_md5_keys, VTYSH_OVSDB_COLUMN_READ },
+};
 
+static void
+ospf_ovsdb_init()
+{
+    vtysh_ovsdb_add_columns(ospf_columns, ARRAY_SIZE(ospf_columns));
+    ospf_lookup_init();
+    ospf_lsdb_init();
+    ospf_route_view_init();
+
+    /* OSPF_Route and OSPF_LSA, and the columns of OSPF_Router and
+     * OSPF_Area referring to them, are on-demand, see ospf_lsdb_columns. */
 }
 
+static const struct vtysh_ovsdb_column vrf_columns[] = {
+    { &ovsrec_port_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_interfaces, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ip4_address, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ip4_address_secondary, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ip6_address, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_ip6_address_secondary, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_vlan_mode, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_vlan_trunks, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_admin, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_vlan_tag, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_port_col_status, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_vrf_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_vrf_col_table_id, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_vrf_col_ports, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_vrf_col_bgp_routers, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_vrf_col_ospf_routers, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_vrf_col_active_router_id, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_vrf_col_status, VTYSH_OVSDB_COLUMN_DISPLAY },
+    { &ovsrec_bridge_col_ports, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bridge_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bridge_col_vlans, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_system_col_vrfs, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_system_col_bridges, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_interface_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_interface_col_hw_intf_info, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_interface_col_user_config, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_interface_col_split_parent, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_interface_col_split_children, VTYSH_OVSDB_COLUMN_READ },
+};
+
 static void
 vrf_ovsdb_init()
 {
-    ovsdb_idl_add_table(idl, &ovsrec_table_vrf);
-    ovsdb_idl_add_table(idl, &ovsrec_table_port);
-    ovsdb_idl_add_table(idl, &ovsrec_table_bridge);
-    ovsdb_idl_add_table(idl, &ovsrec_table_interface);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_interfaces);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ip4_address);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ip4_address_secondary);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ip6_address);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_ip6_address_secondary);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_vlan_mode);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_vlan_trunks);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_admin);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_vlan_tag);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_status);
-    ovsdb_idl_add_column(idl, &ovsrec_vrf_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_vrf_col_table_id);
-    ovsdb_idl_add_column(idl, &ovsrec_vrf_col_ports);
-    ovsdb_idl_add_column(idl, &ovsrec_vrf_col_bgp_routers);
-    ovsdb_idl_add_column(idl, &ovsrec_vrf_col_ospf_routers);
-    ovsdb_idl_add_column(idl, &ovsrec_vrf_col_active_router_id);
-    ovsdb_idl_add_column(idl, &ovsrec_vrf_col_status);
-    ovsdb_idl_add_column(idl, &ovsrec_bridge_col_ports);
-    ovsdb_idl_add_column(idl, &ovsrec_bridge_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_bridge_col_vlans);
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_vrfs);
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_bridges);
-    ovsdb_idl_add_column(idl, &ovsrec_interface_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_interface_col_hw_intf_info);
-    ovsdb_idl_add_column(idl, &ovsrec_interface_col_user_config);
-    ovsdb_idl_add_column(idl, &ovsrec_interface_col_split_parent);
-    ovsdb_idl_add_column(idl, &ovsrec_interface_col_split_children);
+    vtysh_ovsdb_add_columns(vrf_columns, ARRAY_SIZE(vrf_columns));
 
     /* Creating an index for the VRF table. */
     struct ovsdb_idl_index *vrf_index = NULL;
@@ -421,41 +679,38 @@ vrf_ovsdb_init()
         VLOG_ERR("Failed to create an index for the VRF table");
         ovs_assert(vrf_index);
     }
-
 }
 
+static const struct vtysh_ovsdb_column policy_columns[] = {
+    { &ovsrec_bgp_community_filter_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_community_filter_col_type, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_community_filter_col_permit, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_community_filter_col_deny, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_aspath_filter_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_aspath_filter_col_permit, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_bgp_aspath_filter_col_deny, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_prefix_list_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_prefix_list_col_prefix_list_entries, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_prefix_list_col_description, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_prefix_list_entry_col_action, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_prefix_list_entry_col_prefix, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_prefix_list_entry_col_le, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_prefix_list_entry_col_ge, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_map_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_map_col_route_map_entries, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_map_entry_col_description, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_map_entry_col_action, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_map_entry_col_exitpolicy, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_map_entry_col_goto_target, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_map_entry_col_call, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_map_entry_col_match, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_route_map_entry_col_set, VTYSH_OVSDB_COLUMN_READ },
+};
+
 static void
 policy_ovsdb_init ()
 {
-    ovsdb_idl_add_table(idl, &ovsrec_table_bgp_community_filter);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_community_filter_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_community_filter_col_type);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_community_filter_col_permit);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_community_filter_col_deny);
-    ovsdb_idl_add_table(idl, &ovsrec_table_bgp_aspath_filter);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_aspath_filter_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_aspath_filter_col_permit);
-    ovsdb_idl_add_column(idl, &ovsrec_bgp_aspath_filter_col_deny);
-    ovsdb_idl_add_table(idl, &ovsrec_table_prefix_list);
-    ovsdb_idl_add_column(idl, &ovsrec_prefix_list_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_prefix_list_col_prefix_list_entries);
-    ovsdb_idl_add_column(idl, &ovsrec_prefix_list_col_description);
-    ovsdb_idl_add_table(idl, &ovsrec_table_prefix_list_entry);
-    ovsdb_idl_add_column(idl, &ovsrec_prefix_list_entry_col_action);
-    ovsdb_idl_add_column(idl, &ovsrec_prefix_list_entry_col_prefix);
-    ovsdb_idl_add_column(idl, &ovsrec_prefix_list_entry_col_le);
-    ovsdb_idl_add_column(idl, &ovsrec_prefix_list_entry_col_ge);
-    ovsdb_idl_add_table(idl, &ovsrec_table_route_map);
-    ovsdb_idl_add_column(idl, &ovsrec_route_map_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_route_map_col_route_map_entries);
-    ovsdb_idl_add_table(idl, &ovsrec_table_route_map_entry);
-    ovsdb_idl_add_column(idl, &ovsrec_route_map_entry_col_description);
-    ovsdb_idl_add_column(idl, &ovsrec_route_map_entry_col_action);
-    ovsdb_idl_add_column(idl, &ovsrec_route_map_entry_col_exitpolicy);
-    ovsdb_idl_add_column(idl, &ovsrec_route_map_entry_col_goto_target);
-    ovsdb_idl_add_column(idl, &ovsrec_route_map_entry_col_call);
-    ovsdb_idl_add_column(idl, &ovsrec_route_map_entry_col_match);
-    ovsdb_idl_add_column(idl, &ovsrec_route_map_entry_col_set);
+    vtysh_ovsdb_add_columns(policy_columns, ARRAY_SIZE(policy_columns));
 }
 
 
@@ -465,28 +720,145 @@ policy_ovsdb_init ()
  * @param[in]
  *      idl     : Pointer to idl structure
  ***********************************************************/
+static const struct vtysh_ovsdb_column alias_columns[] = {
+    { &ovsrec_cli_alias_col_alias_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_cli_alias_col_alias_definition, VTYSH_OVSDB_COLUMN_READ },
+};
+
 static void
 alias_ovsdb_init()
 {
-    ovsdb_idl_add_table(idl, &ovsrec_table_cli_alias);
-    ovsdb_idl_add_column(idl, &ovsrec_cli_alias_col_alias_name);
-    ovsdb_idl_add_column(idl, &ovsrec_cli_alias_col_alias_definition);
+    vtysh_ovsdb_add_columns(alias_columns, ARRAY_SIZE(alias_columns));
 
-    return;
+    /* vty_refresh_aliases() only looks at the changed rows. */
+    ovsdb_idl_track_add_column(idl, &ovsrec_cli_alias_col_alias_name);
+    ovsdb_idl_track_add_column(idl, &ovsrec_cli_alias_col_alias_definition);
+    vtysh_ovsdb_track_register(vty_refresh_aliases);
 }
 
 
+static const struct vtysh_ovsdb_column logrotate_columns[] = {
+    { &ovsrec_system_col_logrotate_config, VTYSH_OVSDB_COLUMN_READ },
+};
+
 static void
 logrotate_ovsdb_init()
 {
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_logrotate_config);
+    vtysh_ovsdb_add_columns(logrotate_columns,
+                            ARRAY_SIZE(logrotate_columns));
 }
 
+static const struct vtysh_ovsdb_column mgmt_intf_columns[] = {
+    { &ovsrec_system_col_mgmt_intf, VTYSH_OVSDB_COLUMN_READ },
+    /* The hostname and domain name in the prompt come from the status, a
+     * change must reach the System row snapshot. */
+    { &ovsrec_system_col_mgmt_intf_status, VTYSH_OVSDB_COLUMN_READ },
+};
+
 static void
 mgmt_intf_ovsdb_init()
 {
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_mgmt_intf);
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_mgmt_intf_status);
+    vtysh_ovsdb_add_columns(mgmt_intf_columns,
+                            ARRAY_SIZE(mgmt_intf_columns));
+}
+
+static const struct vtysh_ovsdb_column system_columns[] = {
+    { &ovsrec_system_col_software_info, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_system_col_switch_version, VTYSH_OVSDB_COLUMN_READ },
+    /* Package_Info for show version detail. */
+    { &ovsrec_package_info_col_name, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_package_info_col_version, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_package_info_col_src_type, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_package_info_col_src_url, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_system_col_hostname, VTYSH_OVSDB_COLUMN_READ },
+    { &ovsrec_system_col_domain_name, VTYSH_OVSDB_COLUMN_READ },
+    /* ECMP configuration. */
+    { &ovsrec_system_col_ecmp_config, VTYSH_OVSDB_COLUMN_READ },
+    /* VLAN internal commands. */
+    { &ovsrec_port_col_hw_config, VTYSH_OVSDB_COLUMN_READ },
+};
+
+/* Where vtysh_ovsdb_add_columns() writes down the columns it registers,
+ * for the manifest of a plugin.  See vtysh_ovsdb_record_columns(). */
+static struct ds *columns_record;
+
+/* Returns the class of the table that column belongs to. */
+static const struct ovsdb_idl_table_class *
+vtysh_ovsdb_column_table(const struct ovsdb_idl_column *column)
+{
+    size_t i;
+
+    for (i = 0; i < ovsrec_idl_class.n_tables; i++) {
+        const struct ovsdb_idl_table_class *tc = &ovsrec_idl_class.tables[i];
+
+        if (column >= tc->columns && column < tc->columns + tc->n_columns) {
+            return tc;
+        }
+    }
+    return NULL;
+}
+
+/* Registers the columns of a manifest in idl.  A display only column is
+ * replicated without alerts: its updates keep the seqnos of idl and of its
+ * table as they are, so they do not invalidate the caches keyed on them.
+ * Registering the column again as read restores the alerts.  Plugins call
+ * this from their cli_pre_init(). */
+void
+vtysh_ovsdb_add_columns(const struct vtysh_ovsdb_column *columns, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        ovsdb_idl_add_column(idl, columns[i].column);
+        if (columns[i].use == VTYSH_OVSDB_COLUMN_DISPLAY) {
+            ovsdb_idl_omit_alert(idl, columns[i].column);
+        }
+        if (columns_record) {
+            const struct ovsdb_idl_table_class *tc;
+
+            tc = vtysh_ovsdb_column_table(columns[i].column);
+            ds_put_format(columns_record, "column %s %s %s\n",
+                          tc ? tc->name : "-", columns[i].column->name,
+                          columns[i].use == VTYSH_OVSDB_COLUMN_DISPLAY
+                          ? "display" : "read");
+        }
+    }
+}
+
+/* Registers the column named column of table, as listed in the manifest
+ * of a plugin that is not loaded yet.  Returns false if the schema has no
+ * such column. */
+bool
+vtysh_ovsdb_add_column_by_name(const char *table, const char *column,
+                               enum vtysh_ovsdb_column_use use)
+{
+    size_t i, j;
+
+    for (i = 0; i < ovsrec_idl_class.n_tables; i++) {
+        const struct ovsdb_idl_table_class *tc = &ovsrec_idl_class.tables[i];
+
+        if (strcmp(tc->name, table)) {
+            continue;
+        }
+        for (j = 0; j < tc->n_columns; j++) {
+            if (!strcmp(tc->columns[j].name, column)) {
+                struct vtysh_ovsdb_column entry = { &tc->columns[j], use };
+
+                vtysh_ovsdb_add_columns(&entry, 1);
+                return true;
+            }
+        }
+        break;
+    }
+    return false;
+}
+
+/* Has vtysh_ovsdb_add_columns() append a "column" line of plugin manifest
+ * to record for every column it registers, until called with NULL. */
+void
+vtysh_ovsdb_record_columns(struct ds *record)
+{
+    columns_record = record;
 }
 
 /*
@@ -496,45 +868,12 @@ mgmt_intf_ovsdb_init()
 static void
 ovsdb_init(const char *db_path)
 {
-    char *idl_lock;
-    long int pid;
-
     idl = ovsdb_idl_create(db_path, &ovsrec_idl_class, false, true);
-    pid = getpid();
-    idl_lock = xasprintf("ops_cli_%ld", pid);
-    ovsdb_idl_set_lock(idl, idl_lock);
-    free(idl_lock);
     idl_seqno = ovsdb_idl_get_seqno(idl);
     ovsdb_idl_enable_reconnect(idl);
     latch_init(&ovsdb_latch);
 
-    /* Add system table. */
-    ovsdb_idl_add_table(idl, &ovsrec_table_system);
-
-    /* Add software_info column */
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_software_info);
-
-    /* Add switch version column */
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_switch_version);
-
-    /* Add Package_Info table for show version detail. */
-    ovsdb_idl_add_table(idl, &ovsrec_table_package_info);
-
-    /* Add name, src_url, src_type version column for show version detail. */
-    ovsdb_idl_add_column(idl, &ovsrec_package_info_col_name);
-    ovsdb_idl_add_column(idl, &ovsrec_package_info_col_version);
-    ovsdb_idl_add_column(idl, &ovsrec_package_info_col_src_type);
-    ovsdb_idl_add_column(idl, &ovsrec_package_info_col_src_url);
-
-    /* Add hostname columns. */
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_hostname);
-
-    /* Add domain name column */
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_domain_name);
-
-    /* Add columns for ECMP configuration. */
-    ovsdb_idl_add_column(idl, &ovsrec_system_col_ecmp_config);
-
+    vtysh_ovsdb_add_columns(system_columns, ARRAY_SIZE(system_columns));
 
    /* Management interface columns. */
     mgmt_intf_ovsdb_init();
@@ -549,14 +888,12 @@ ovsdb_init(const char *db_path)
 
     /* VRF tables. */
     vrf_ovsdb_init();
+    sub_intf_index_init();
+    vlan_bitmaps_init();
 
     /* Policy tables. */
     policy_ovsdb_init();
 
-    /* VLAN internal commands. */
-    ovsdb_idl_add_table(idl, &ovsrec_table_port);
-    ovsdb_idl_add_column(idl, &ovsrec_port_col_hw_config);
-
     /* Logrotate tables */
     logrotate_ovsdb_init();
 }
@@ -570,13 +907,45 @@ ops_vtysh_exit(struct unixctl_conn *conn, int argc OVS_UNUSED,
     unixctl_command_reply(conn, NULL);
 }
 
+/* The appctl socket and the IDL lock are named after the pid, a zygote
+ * session sets them up after the fork.  The session also needs a latch of
+ * its own, the one of the zygote is shared by all its sessions. */
+void
+vtysh_ovsdb_session_init(void)
+{
+    char *idl_lock;
+    int retval;
+
+    if (vtysh_zygote_mode) {
+        latch_destroy(&ovsdb_latch);
+        latch_init(&ovsdb_latch);
+    }
+
+    retval = unixctl_server_create(appctl_path, &appctl);
+    if (retval) {
+        exit(EXIT_FAILURE);
+    }
+
+    unixctl_command_register("exit", "", 0, 0, ops_vtysh_exit, &exiting);
+
+    idl_lock = xasprintf("ops_cli_%ld", (long int) getpid());
+    ovsdb_idl_set_lock(idl, idl_lock);
+    free(idl_lock);
+}
+
 /* The init for the ovsdb integration called in vtysh main function. */
 void
 vtysh_ovsdb_init(int argc, char *argv[], char *db_name)
 {
-    int retval;
+    pthread_condattr_t attr;
     char *ovsdb_sock;
 
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&vtysh_ovsdb_loaded_cond, &attr);
+    pthread_cond_init(&tables_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
     set_program_name(argv[0]);
     proctitle_init(argc, argv);
     fatal_ignore_sigpipe();
@@ -589,16 +958,13 @@ vtysh_ovsdb_init(int argc, char *argv[], char *db_name)
     }
     ovsrec_init();
 
-    retval = unixctl_server_create(appctl_path, &appctl);
-    if (retval) {
-        exit(EXIT_FAILURE);
-    }
-
-    unixctl_command_register("exit", "", 0, 0, ops_vtysh_exit, &exiting);
-
     ovsdb_init(ovsdb_sock);
+    if (!vtysh_zygote_mode) {
+        vtysh_ovsdb_session_init();
+    }
     vtysh_ovsdb_lib_init();
-    free(ovsdb_sock);
+    /* Kept for the IDL of the on-demand tables. */
+    ovsdb_remote = ovsdb_sock;
 
     VLOG_DBG("OPS Vtysh OVSDB Integration has been initialized");
 
@@ -678,16 +1044,13 @@ vtysh_ovsdb_domainname_reset(const char *domainname_arg)
 const char*
 vtysh_ovsdb_domainname_get()
 {
-    const struct ovsrec_system *ovs;
-    ovs = ovsrec_system_first(idl);
+    const struct vtysh_system_fields *fields = system_fields_current();
 
-    if (ovs) {
-      return smap_get(&ovs->mgmt_intf_status, SYSTEM_MGMT_INTF_MAP_DOMAIN_NAME);
-    } else {
+    if (!fields->valid) {
       VLOG_ERR("unable to retrieve any system table rows");
     }
 
-    return NULL;
+    return fields->domain_name;
 }
 
 
@@ -736,7 +1099,7 @@ vtysh_ovsdb_switch_version_get(void)
 bool
 vtysh_chk_for_system_configured_db_is_ready(void)
 {
-    const struct ovsrec_system *ovs_vsw = NULL;
+    const struct vtysh_system_fields *fields;
     static bool ready = false;
 
     if (ready == true) {
@@ -744,10 +1107,10 @@ vtysh_chk_for_system_configured_db_is_ready(void)
     }
 
     if ( vtysh_ovsdb_is_loaded()) {
-        ovs_vsw = ovsrec_system_first(idl);
-        if (ovs_vsw && (ovs_vsw->cur_cfg > (int64_t) 0)) {
+        fields = system_fields_current();
+        if (fields->valid && (fields->cur_cfg > (int64_t) 0)) {
             VLOG_DBG("System is now configured (cur_cfg=%d).",
-                    (int)ovs_vsw->cur_cfg);
+                    (int)fields->cur_cfg);
             ready = true;
             return true;
         }
@@ -828,16 +1191,13 @@ vtysh_ovsdb_hostname_reset(const char *hostname_arg)
 const char*
 vtysh_ovsdb_hostname_get()
 {
-    const struct ovsrec_system *ovs;
-    ovs = ovsrec_system_first(idl);
+    const struct vtysh_system_fields *fields = system_fields_current();
 
-    if (ovs) {
-        return smap_get(&ovs->mgmt_intf_status, SYSTEM_MGMT_INTF_MAP_HOSTNAME);
-    } else {
+    if (!fields->valid) {
         VLOG_ERR("unable to  retrieve any system table rows");
     }
 
-    return NULL;
+    return fields->hostname;
 }
 
 /*
@@ -850,18 +1210,15 @@ vtysh_ovsdb_banner_set(const char* in, enum banner_type which_banner)
     const struct ovsrec_system *ovs= NULL;
     struct ovsdb_idl_txn* status_txn = NULL;
     enum ovsdb_idl_txn_status status = TXN_ERROR;
-    uid_t uid = -1;
-    struct passwd *current_user = NULL;
+    const char *current_user = cmd_user_name();
 
-    uid = geteuid();
-    current_user = getpwuid(uid);
     if (current_user == NULL)
     {
         vty_out(vty, "An error occurred while determining the current user.%s",
                 VTY_NEWLINE);
         return CMD_SUCCESS;
     }
-    if (check_user_group(current_user->pw_name, NETOP_GROUP) == 0)
+    if (check_user_group(current_user, NETOP_GROUP) == 0)
     {
         vty_out(vty, "Only network operators may change login banners.%s", VTY_NEWLINE);
         return CMD_SUCCESS;
@@ -910,12 +1267,11 @@ vtysh_ovsdb_banner_set(const char* in, enum banner_type which_banner)
 int
 vtysh_ovsdb_banner_exec_get(char* banner)
 {
-    const struct ovsrec_system *ovs;
-    ovs = ovsrec_system_first(idl);
+    const struct vtysh_system_fields *fields = system_fields_current();
     const char *str;
 
-    if (ovs) {
-        str = smap_get(&ovs->other_config, SYSTEM_OTHER_CONFIG_MAP_BANNER_EXEC);
+    if (fields->valid) {
+        str = fields->banner_exec;
         if (str) {
             strncpy(banner, str, MAX_BANNER_LENGTH);
         }
@@ -935,12 +1291,11 @@ vtysh_ovsdb_banner_exec_get(char* banner)
 int
 vtysh_ovsdb_banner_get(char* banner)
 {
-    const struct ovsrec_system *ovs;
-    ovs = ovsrec_system_first(idl);
+    const struct vtysh_system_fields *fields = system_fields_current();
     const char *str;
 
-    if (ovs) {
-        str = smap_get(&ovs->other_config, SYSTEM_OTHER_CONFIG_MAP_BANNER);
+    if (fields->valid) {
+        str = fields->banner;
         if (str) {
             strncpy(banner, str, MAX_BANNER_LENGTH);
         }
@@ -1014,20 +1369,14 @@ vtysh_ovsdb_session_timeout_set(const char * duration)
 int64_t
 vtysh_ovsdb_session_timeout_get()
 {
-    const struct ovsrec_system *ovs= NULL;
-    int64_t timeout = 0;
+    const struct vtysh_system_fields *fields = system_fields_current();
 
-    ovs = ovsrec_system_first(idl);
-    if (!ovs)
+    if (!fields->valid)
     {
         return CMD_OVSDB_FAILURE;
     }
 
-    timeout = smap_get_int(&ovs->other_config,
-                           SYSTEM_OTHER_CONFIG_MAP_CLI_SESSION_TIMEOUT,
-                           DEFAULT_SESSION_TIMEOUT_PERIOD);
-
-    return timeout;
+    return fields->session_timeout;
 }
 
 /* Wait for database sysnchronization in case *
@@ -1039,6 +1388,297 @@ vtysh_ovsdb_is_loaded()
 }
 
 
+/* Called by the OVSDB thread with the IDL locked, wakes up
+ * vtysh_ovsdb_wait_loaded() once the initial sync is done. */
+static void
+vtysh_ovsdb_check_loaded(void)
+{
+    static bool loaded = false;
+
+    if (loaded || !vtysh_ovsdb_is_loaded()) {
+        return;
+    }
+    loaded = true;
+
+    /* Commands check this first, have it ready for them. */
+    vtysh_chk_for_system_configured_db_is_ready();
+
+    pthread_mutex_lock(&vtysh_ovsdb_loaded_mutex);
+    vtysh_ovsdb_loaded = true;
+    pthread_cond_broadcast(&vtysh_ovsdb_loaded_cond);
+    pthread_mutex_unlock(&vtysh_ovsdb_loaded_mutex);
+}
+
+/* Sets deadline to timeout_ms from now, on the clock of the conditions. */
+static void
+vtysh_ovsdb_deadline(struct timespec *deadline, long long int timeout_ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (timeout_ms % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+/* Waits up to timeout_ms for the initial sync of the IDL.  Returns true if
+ * it is done. */
+bool
+vtysh_ovsdb_wait_loaded(long long int timeout_ms)
+{
+    struct timespec deadline;
+    bool loaded;
+
+    vtysh_ovsdb_deadline(&deadline, timeout_ms);
+    pthread_mutex_lock(&vtysh_ovsdb_loaded_mutex);
+    while (!vtysh_ovsdb_loaded
+           && pthread_cond_timedwait(&vtysh_ovsdb_loaded_cond,
+                                     &vtysh_ovsdb_loaded_mutex,
+                                     &deadline) != ETIMEDOUT) {
+        continue;
+    }
+    loaded = vtysh_ovsdb_loaded;
+    pthread_mutex_unlock(&vtysh_ovsdb_loaded_mutex);
+    return loaded;
+}
+
+/* Records that the groups in tables are used now.  Called with tables_mutex
+ * held. */
+static void
+vtysh_ovsdb_tables_touch(unsigned int tables)
+{
+    long long int now = time_msec();
+    size_t i;
+
+    for (i = 0; i < ARRAY_SIZE(table_groups); i++) {
+        if (tables & table_groups[i].tables) {
+            tables_last_used[i] = now;
+        }
+    }
+}
+
+/* Replaces tables_idl by an IDL monitoring every column of the groups in
+ * tables, or by none if tables is 0. */
+static void
+vtysh_ovsdb_tables_create(unsigned int tables)
+{
+    const struct ovsdb_idl_column *const *column;
+    size_t i;
+
+    if (tables_idl) {
+        ovsdb_idl_destroy(tables_idl);
+        tables_idl = NULL;
+    }
+    tables_monitored = tables;
+    tables_generation++;
+    tables_track_seqno = 0;
+    if (!tables) {
+        return;
+    }
+
+    tables_idl = ovsdb_idl_create(ovsdb_remote, &ovsrec_idl_class, false,
+                                  true);
+    ovsdb_idl_enable_reconnect(tables_idl);
+    for (i = 0; i < ARRAY_SIZE(table_groups); i++) {
+        if (!(tables & table_groups[i].tables)) {
+            continue;
+        }
+        for (column = table_groups[i].columns; *column; column++) {
+            ovsdb_idl_add_column(tables_idl, *column);
+            ovsdb_idl_track_add_column(tables_idl, *column);
+        }
+    }
+    VLOG_DBG("Monitoring on-demand tables 0x%x", tables);
+}
+
+/* Called by the OVSDB thread with the IDL locked.  Drops the groups idle
+ * for too long, follows the groups the commands want and tells them once
+ * they are synced. */
+static void
+vtysh_ovsdb_tables_run(void)
+{
+    long long int now = time_msec();
+    unsigned int wanted;
+    unsigned int synced;
+    size_t i;
+
+    pthread_mutex_lock(&tables_mutex);
+    tables_expire = LLONG_MAX;
+    for (i = 0; i < ARRAY_SIZE(table_groups); i++) {
+        long long int expire;
+
+        if (!(tables_requested & table_groups[i].tables)) {
+            continue;
+        }
+        expire = tables_last_used[i] + VTYSH_OVSDB_TABLES_IDLE_TIMEOUT;
+        if (now >= expire) {
+            tables_requested &= ~table_groups[i].tables;
+        } else {
+            tables_expire = MIN(tables_expire, expire);
+        }
+    }
+    wanted = tables_requested;
+    pthread_mutex_unlock(&tables_mutex);
+
+    if (wanted != tables_monitored) {
+        vtysh_ovsdb_tables_create(wanted);
+    }
+    if (tables_idl) {
+        struct ovsdb_idl *main_idl = idl;
+
+        ovsdb_idl_run(tables_idl);
+        idl = tables_idl;
+        vtysh_ovsdb_track_run();
+        idl = main_idl;
+    }
+    synced = tables_idl && ovsdb_idl_has_ever_connected(tables_idl)
+             ? tables_monitored : 0;
+
+    pthread_mutex_lock(&tables_mutex);
+    if (synced != tables_synced) {
+        tables_synced = synced;
+        pthread_cond_broadcast(&tables_cond);
+    }
+    pthread_mutex_unlock(&tables_mutex);
+}
+
+/* Has the OVSDB thread monitor the on-demand tables (CMD_TABLES_*) and
+ * waits until they are synced, or MAX_TIMEOUT_FOR_IDL_CHANGE seconds.  Must
+ * be called without the IDL lock. */
+void
+vtysh_ovsdb_tables_need(unsigned int tables)
+{
+    struct timespec deadline;
+
+    vtysh_ovsdb_deadline(&deadline, MAX_TIMEOUT_FOR_IDL_CHANGE * 1000);
+    pthread_mutex_lock(&tables_mutex);
+    vtysh_ovsdb_tables_touch(tables);
+    tables_requested |= tables;
+    latch_set(&ovsdb_latch);
+    while ((tables_synced & tables) != tables
+           && pthread_cond_timedwait(&tables_cond, &tables_mutex,
+                                     &deadline) != ETIMEDOUT) {
+        continue;
+    }
+    pthread_mutex_unlock(&tables_mutex);
+}
+
+/* Points idl to the IDL of the on-demand tables, saving the main one in
+ * *main_idl, for a command reading them.  Returns false if the tables are
+ * not synced.  Must be called with the IDL lock held. */
+bool
+vtysh_ovsdb_tables_enter(unsigned int tables, struct ovsdb_idl **main_idl)
+{
+    if (!tables_idl || (tables_monitored & tables) != tables
+        || !ovsdb_idl_has_ever_connected(tables_idl)) {
+        return false;
+    }
+    *main_idl = idl;
+    idl = tables_idl;
+    return true;
+}
+
+/* Undoes vtysh_ovsdb_tables_enter(). */
+void
+vtysh_ovsdb_tables_leave(unsigned int tables, struct ovsdb_idl *main_idl)
+{
+    idl = main_idl;
+    pthread_mutex_lock(&tables_mutex);
+    vtysh_ovsdb_tables_touch(tables);
+    pthread_mutex_unlock(&tables_mutex);
+}
+
+/* Identifies the IDL idl points to, for the caches of rows: 0 for the main
+ * IDL, a new value for each IDL of the on-demand tables. */
+unsigned int
+vtysh_ovsdb_tables_generation(void)
+{
+    return tables_idl && idl == tables_idl ? tables_generation : 0;
+}
+
+/* Approximate memory used by a datum: its atoms and their strings. */
+static size_t
+vtysh_ovsdb_datum_size(const struct ovsdb_datum *datum,
+                       const struct ovsdb_type *type)
+{
+    size_t size = datum->n * sizeof *datum->keys;
+    size_t i;
+
+    if (datum->values) {
+        size += datum->n * sizeof *datum->values;
+    }
+    for (i = 0; i < datum->n; i++) {
+        if (type->key.type == OVSDB_TYPE_STRING) {
+            size += strlen(datum->keys[i].string) + 1;
+        }
+        if (datum->values && type->value.type == OVSDB_TYPE_STRING) {
+            size += strlen(datum->values[i].string) + 1;
+        }
+    }
+    return size;
+}
+
+/* Prints the rows, the columns holding data and the approximate bytes of
+ * each table replicated in footprint_idl. */
+static void
+vtysh_ovsdb_idl_footprint(struct vty *vty,
+                          const struct ovsdb_idl *footprint_idl,
+                          const char *title)
+{
+    size_t total_rows = 0, total_bytes = 0;
+    size_t i, j;
+
+    vty_out(vty, "%s%s", title, VTY_NEWLINE);
+    vty_out(vty, "%-32s %8s %8s %12s%s", "Table", "Rows", "Columns",
+            "Bytes", VTY_NEWLINE);
+    for (i = 0; i < ovsrec_idl_class.n_tables; i++) {
+        const struct ovsdb_idl_table_class *tc = &ovsrec_idl_class.tables[i];
+        const struct ovsdb_idl_row *row;
+        unsigned long *populated;
+        size_t n_rows = 0, bytes = 0;
+
+        row = ovsdb_idl_first_row(footprint_idl, tc);
+        if (!row) {
+            continue;
+        }
+        populated = bitmap_allocate(tc->n_columns);
+        for (; row; row = ovsdb_idl_next_row(row)) {
+            n_rows++;
+            bytes += tc->allocation_size
+                     + tc->n_columns * sizeof(struct ovsdb_datum);
+            for (j = 0; j < tc->n_columns; j++) {
+                const struct ovsdb_idl_column *column = &tc->columns[j];
+                const struct ovsdb_datum *datum;
+
+                datum = ovsdb_idl_read(row, column);
+                if (datum->n) {
+                    bitmap_set1(populated, j);
+                    bytes += vtysh_ovsdb_datum_size(datum, &column->type);
+                }
+            }
+        }
+        vty_out(vty, "%-32s %8"PRIuSIZE" %8"PRIuSIZE" %12"PRIuSIZE"%s",
+                tc->name, n_rows, bitmap_count1(populated, tc->n_columns),
+                bytes, VTY_NEWLINE);
+        bitmap_free(populated);
+        total_rows += n_rows;
+        total_bytes += bytes;
+    }
+    vty_out(vty, "%-32s %8"PRIuSIZE" %8s %12"PRIuSIZE"%s%s", "Total",
+            total_rows, "", total_bytes, VTY_NEWLINE, VTY_NEWLINE);
+}
+
+/* show cli idl-footprint.  Must be called with the IDL lock held. */
+void
+vtysh_ovsdb_show_idl_footprint(struct vty *vty)
+{
+    vtysh_ovsdb_idl_footprint(vty, idl, "Session IDL");
+    if (tables_idl) {
+        vtysh_ovsdb_idl_footprint(vty, tables_idl, "On-demand tables IDL");
+    }
+}
+
 /* When exiting vtysh destroy the idl cache. */
 
 void
@@ -1046,6 +1686,10 @@ vtysh_ovsdb_exit(void)
 {
     VTYSH_OVSDB_LOCK;
     ovsdb_idl_destroy(idl);
+    if (tables_idl) {
+        ovsdb_idl_destroy(tables_idl);
+        tables_idl = NULL;
+    }
     VTYSH_OVSDB_UNLOCK;
 }
 
@@ -1055,9 +1699,9 @@ bool
 ovsdb_cfg_initialized()
 {
     if (cur_cfg_no < 1) {
-        const struct ovsrec_system* ovs = ovsrec_system_first(idl);
-        if (ovs != NULL) {
-            cur_cfg_no = ovs->cur_cfg;
+        const struct vtysh_system_fields *fields = system_fields_current();
+        if (fields->valid) {
+            cur_cfg_no = fields->cur_cfg;
             if (cur_cfg_no < 1) {
                 return false;
             }
@@ -1100,6 +1744,7 @@ ovsdb_idl_txn_status cli_do_config_finish(struct ovsdb_idl_txn* status_txn)
     status = ovsdb_idl_txn_commit_block(status_txn);
     ovsdb_idl_txn_destroy(status_txn);
     status_txn = NULL;
+    txn_seqno++;
 
     return status;
 }
@@ -1113,6 +1758,7 @@ cli_do_config_abort(struct ovsdb_idl_txn* status_txn)
     }
     ovsdb_idl_txn_destroy(status_txn);
     status_txn = NULL;
+    txn_seqno++;
 }
 
 /*
@@ -1225,7 +1871,8 @@ vtysh_ovsdb_mac_match(const char *str)
     return 0;
 }
 
-/* Check if the input string matches the given regex. */
+/* Check if the input string matches the given regex.  The pattern is
+ * compiled once and kept in the regex cache. */
 int
 vtysh_regex_match(const char *regString, const char *inp)
 {
@@ -1233,23 +1880,15 @@ vtysh_regex_match(const char *regString, const char *inp)
         return 1;
     }
 
-    regex_t regex;
     int ret;
     char msgbuf[100];
 
-    ret = regcomp(&regex, regString, 0);
-    if (ret) {
-        VLOG_ERR("Could not compile regex\n");
-        return 1;
-    }
-
-    ret = regexec(&regex, inp, 0, NULL, 0);
+    ret = regex_cache_match(regString, 0, inp, msgbuf, sizeof(msgbuf));
     if (!ret) {
         return 0;
     } else if (ret == REG_NOMATCH) {
         return REG_NOMATCH;
     } else {
-        regerror(ret, &regex, msgbuf, sizeof(msgbuf));
         VLOG_ERR("Regex match failed: %s\n", msgbuf);
     }
 
@@ -1275,6 +1914,8 @@ vtysh_ovsdb_main_thread(void *arg)
         /* This function updates the Cache by running
            ovsdb_idl_run. */
         vtysh_run();
+        vtysh_ovsdb_check_loaded();
+        vtysh_ovsdb_tables_run();
 
         /* This function adds the file descriptor for the
            DB to monitor using poll_fd_wait. */
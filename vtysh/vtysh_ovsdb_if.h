@@ -24,16 +24,48 @@
 #define VTYSH_OVSDB_IF_H 1
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "vector.h"
 
 /* For banner_type enum */
 #include "banner_vty.h"
 
+struct ds;
+struct ovsdb_idl;
+struct ovsdb_idl_column;
+struct vty;
+
 #define MAX_MACADDR_LEN 17
 #define DEFAULT_SESSION_TIMEOUT_PERIOD 30
 #define OVS_OSPF_VL_MAX_COUNT        256
 
+/* How the CLI uses a column it replicates. */
+enum vtysh_ovsdb_column_use {
+    VTYSH_OVSDB_COLUMN_READ,      /* Read by commands and caches. */
+    VTYSH_OVSDB_COLUMN_DISPLAY,   /* Only displayed, e.g. statistics. */
+};
+
+/* An entry of a column manifest. */
+struct vtysh_ovsdb_column {
+    const struct ovsdb_idl_column *column;
+    enum vtysh_ovsdb_column_use use;
+};
+
 void vtysh_ovsdb_init(int argc, char *argv[], char *db_name);
 
+void vtysh_ovsdb_add_columns(const struct vtysh_ovsdb_column *columns,
+                             size_t n);
+
+bool vtysh_ovsdb_add_column_by_name(const char *table, const char *column,
+                                    enum vtysh_ovsdb_column_use use);
+
+void vtysh_ovsdb_record_columns(struct ds *record);
+
+void vtysh_ovsdb_show_idl_footprint(struct vty *vty);
+
+void vtysh_ovsdb_session_init(void);
+
 const char *vtysh_ovsdb_os_name_get(void);
 
 const char *vtysh_ovsdb_switch_version_get(void);
@@ -54,6 +86,22 @@ int vtysh_ovsdb_session_timeout_set(const char * duration);
 
 int64_t vtysh_ovsdb_session_timeout_get(void);
 
+/* Fields of the System row read on every prompt or command, copied out of
+ * the IDL by the OVSDB thread whenever the System table changes. */
+struct vtysh_system_fields {
+    bool valid;                 /* False until there is a System row. */
+    char *hostname;             /* mgmt_intf_status, NULL if unset. */
+    char *domain_name;          /* mgmt_intf_status, NULL if unset. */
+    int64_t session_timeout;    /* Minutes. */
+    char *banner;               /* other_config, NULL if unset. */
+    char *banner_exec;          /* other_config, NULL if unset. */
+    int64_t cur_cfg;
+};
+
+const struct vtysh_system_fields *vtysh_ovsdb_system_fields_get(void);
+
+void vtysh_ovsdb_system_fields_put(const struct vtysh_system_fields *fields);
+
 void vtysh_ovsdb_exit(void);
 
 void vtysh_ovsdb_lib_init(void);
@@ -80,6 +128,26 @@ bool check_port_in_vrf(const char *port_name);
 
 bool vtysh_ovsdb_is_loaded(void);
 
+bool vtysh_ovsdb_wait_loaded(long long int timeout_ms);
+
+void vtysh_ovsdb_tables_need(unsigned int tables);
+
+bool vtysh_ovsdb_tables_enter(unsigned int tables,
+                              struct ovsdb_idl **main_idl);
+
+void vtysh_ovsdb_tables_leave(unsigned int tables,
+                              struct ovsdb_idl *main_idl);
+
+unsigned int vtysh_ovsdb_tables_generation(void);
+
+typedef void vtysh_ovsdb_track_func(void);
+
+void vtysh_ovsdb_track_register(vtysh_ovsdb_track_func *func);
+
+void vtysh_ovsdb_track_run(void);
+
+unsigned int vtysh_ovsdb_txn_seqno(void);
+
 void utils_vtysh_rl_describe_output(struct vty* vty, vector describe, int width);
 
 extern struct ovsdb_idl_txn *txn;
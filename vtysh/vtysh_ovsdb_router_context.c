@@ -37,6 +37,7 @@
 #include "openswitch-dflt.h"
 #include "command.h"
 #include "ospf_vty.h"
+#include "vtysh/utils/bgp_nbr_vtysh_utils.h"
 
 /*-----------------------------------------------------------------------------
 | Function : vtysh_router_context_bgp_neighbor_callback
@@ -49,21 +50,23 @@
 void vtysh_router_context_bgp_neighbor_callback(vtysh_ovsdb_cbmsg_ptr p_msg)
 {
     const struct ovsrec_bgp_router *bgp_router_context=NULL;
-    int i = 0, n_neighbors = 0, k = 0;
+    int i = 0, n_neighbors = 0;
     const struct ovsrec_bgp_neighbor *nbr_table=NULL;
     char *neighbor = NULL;
+    const char *peer_group = NULL;
+    const size_t *peer_groups;
+    size_t n_peer_groups, k;
   /* To consider all router entries. */
     OVSREC_BGP_ROUTER_FOR_EACH(bgp_router_context, p_msg->idl)
     {
-        for (n_neighbors = 0; n_neighbors < bgp_router_context->n_bgp_neighbors;
-             n_neighbors++) {
-          /* Neighbor peer group commands. */
-            if (*(bgp_router_context->value_bgp_neighbors[n_neighbors]->
-                  is_peer_group))
-                vtysh_ovsdb_cli_print(p_msg, "%4s %s %s %s", "", "neighbor",
-                                      bgp_router_context->
-                                      key_bgp_neighbors[n_neighbors],
-                                      "peer-group");
+        /* Neighbor peer group commands, which must precede their users. */
+        peer_groups = bgp_nbr_index_peer_groups(bgp_router_context,
+                                                &n_peer_groups);
+        for (k = 0; k < n_peer_groups; k++) {
+            vtysh_ovsdb_cli_print(p_msg, "%4s %s %s %s", "", "neighbor",
+                                  bgp_router_context->
+                                  key_bgp_neighbors[peer_groups[k]],
+                                  "peer-group");
         }
         for (n_neighbors = 0; n_neighbors<bgp_router_context->n_bgp_neighbors;
              n_neighbors++) {
@@ -171,16 +174,14 @@ void vtysh_router_context_bgp_neighbor_callback(vtysh_ovsdb_cbmsg_ptr p_msg)
                                       (nbr_table->update_source));
 
             if (nbr_table->bgp_peer_group) {
-                for (k = 0; k < bgp_router_context->n_bgp_neighbors; k++) {
-                    if (nbr_table->
-                        bgp_peer_group == bgp_router_context->
-                        value_bgp_neighbors[k])
-                        vtysh_ovsdb_cli_print(p_msg, "%4s %s %s %s %s", "",
-                                              "neighbor",
-                                              neighbor,
-                                              "peer-group",
-                                              bgp_router_context->key_bgp_neighbors[k]);
-                }
+                peer_group = bgp_nbr_index_name_of(bgp_router_context,
+                                                   nbr_table->bgp_peer_group);
+                if (peer_group)
+                    vtysh_ovsdb_cli_print(p_msg, "%4s %s %s %s %s", "",
+                                          "neighbor",
+                                          neighbor,
+                                          "peer-group",
+                                          peer_group);
             }
         }
         vtysh_ovsdb_cli_print(p_msg,"!");
@@ -0,0 +1,377 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: vtysh_server.c
+ *
+ * Purpose: Command server mode of vtysh, "vtysh --server".
+ */
+/****************************************************************************
+ * @ingroup cli/vtysh
+ *
+ * @file vtysh_server.c
+ * A long lived vtysh keeps its IDL, plugins and command tree and runs
+ * command batches received on a unix socket, so scripts do not pay for a
+ * new vtysh and a full database sync on every "vtysh -c".  Requests are
+ * JSON-RPC, like unixctl, so ovs-appctl can talk to the server.  Every
+ * request runs for the user that connected, taken from the credentials of
+ * the socket: the user must be allowed to use vtysh, role checks, TACACS+
+ * command authorization and the audit log are done for that user.
+ *
+ ***************************************************************************/
+
+#include "config.h"
+#include <errno.h>
+#include <poll.h>
+#include <pwd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "command.h"
+#include "vtysh/vtysh.h"
+#include "dirs.h"
+#include "dynamic-string.h"
+#include "fatal-signal.h"
+#include "json.h"
+#include "jsonrpc.h"
+#include "poll-loop.h"
+#include "socket-util.h"
+#include "stream.h"
+#include "stream-fd.h"
+#include "util.h"
+#include "openvswitch/vlog.h"
+#include "rbac.h"
+#include "vtysh/utils/audit_log_utils.h"
+#include "vtysh_server.h"
+
+VLOG_DEFINE_THIS_MODULE(vtysh_server);
+
+extern struct vty *vty;
+
+bool vtysh_server_mode = false;
+
+static bool vtysh_server_exiting = false;
+
+/* A client of the server and the user it connected as. */
+struct vtysh_server_conn {
+    struct jsonrpc *rpc;
+    uid_t uid;
+};
+
+static struct vtysh_server_conn *vtysh_server_conns;
+static size_t vtysh_server_n_conns, vtysh_server_allocated_conns;
+
+/* Standard output of the commands of one request. */
+struct vtysh_server_capture {
+    FILE *file;
+    int saved_stdout;
+};
+
+static bool
+vtysh_server_capture_start(struct vtysh_server_capture *capture)
+{
+    fflush(stdout);
+    capture->file = tmpfile();
+    if (capture->file == NULL) {
+        return false;
+    }
+    capture->saved_stdout = dup(STDOUT_FILENO);
+    if (capture->saved_stdout < 0) {
+        fclose(capture->file);
+        return false;
+    }
+    if (dup2(fileno(capture->file), STDOUT_FILENO) < 0) {
+        close(capture->saved_stdout);
+        fclose(capture->file);
+        return false;
+    }
+    return true;
+}
+
+static void
+vtysh_server_capture_finish(struct vtysh_server_capture *capture,
+                            struct ds *output)
+{
+    char buf[4096];
+    size_t n;
+
+    fflush(stdout);
+    dup2(capture->saved_stdout, STDOUT_FILENO);
+    close(capture->saved_stdout);
+
+    rewind(capture->file);
+    while ((n = fread(buf, 1, sizeof buf, capture->file)) > 0) {
+        ds_put_buffer(output, buf, n);
+    }
+    fclose(capture->file);
+}
+
+static bool
+vtysh_server_execute_line(const char *line)
+{
+    int ret = vtysh_execute_no_pager(line);
+
+    return ret == CMD_SUCCESS || ret == CMD_SUCCESS_DAEMON
+           || ret == CMD_WARNING;
+}
+
+/* "vtysh/execute LINE..." and "vtysh/execute-all LINE...", for the user
+ * of conn.  Every request starts in the enable node.  Returns the output
+ * of the commands and sets *ok to false if the request failed. */
+static char *
+vtysh_server_execute(const struct vtysh_server_conn *conn,
+                     const struct json_array *lines_, bool keep_going,
+                     bool *ok)
+{
+    struct vtysh_server_capture capture;
+    struct ds output = DS_EMPTY_INITIALIZER;
+    char *lines, *line, *save_ptr;
+    struct passwd *pw;
+    size_t i;
+
+    *ok = false;
+    pw = getpwuid(conn->uid);
+    if (pw == NULL) {
+        ds_put_format(&output, "Unknown user %u.\n",
+                      (unsigned int) conn->uid);
+        return ds_steal_cstr(&output);
+    }
+    if (!rbac_is_user_permitted(pw->pw_name, VTY_SH)) {
+        ds_put_format(&output, "%s does not have the required permissions "
+                      "to access Vtysh.\n", pw->pw_name);
+        return ds_steal_cstr(&output);
+    }
+
+    if (!vtysh_server_capture_start(&capture)) {
+        return xstrdup("Cannot capture the output.\n");
+    }
+
+    *ok = true;
+    cmd_user_set(pw->pw_name);
+    audit_log_user_set(pw->pw_name);
+    vty->node = ENABLE_NODE;
+    for (i = 0; i < lines_->n && (*ok || keep_going); i++) {
+        lines = xstrdup(json_string(lines_->elems[i]));
+        for (line = strtok_r(lines, "\n", &save_ptr);
+             line && (*ok || keep_going);
+             line = strtok_r(NULL, "\n", &save_ptr)) {
+            if (!vtysh_server_execute_line(line)) {
+                *ok = false;
+            }
+        }
+        free(lines);
+    }
+    if (vty->node >= CONFIG_NODE) {
+        vtysh_execute_no_pager("end");
+    }
+    vty->node = ENABLE_NODE;
+    audit_log_user_set(NULL);
+    cmd_user_set(NULL);
+
+    vtysh_server_capture_finish(&capture, &output);
+    if (keep_going) {
+        *ok = true;
+    }
+    return ds_steal_cstr(&output);
+}
+
+/* Replies to the request of conn.  Only root and the user running the
+ * server may stop it. */
+static void
+vtysh_server_handle(struct vtysh_server_conn *conn,
+                    const struct jsonrpc_msg *request)
+{
+    struct jsonrpc_msg *reply;
+    const struct json_array *params;
+    char *body = NULL;
+    bool ok = false;
+    size_t i;
+
+    params = (request->params && request->params->type == JSON_ARRAY
+              ? json_array(request->params) : NULL);
+    for (i = 0; params && i < params->n; i++) {
+        if (params->elems[i]->type != JSON_STRING) {
+            params = NULL;
+        }
+    }
+
+    if (params == NULL) {
+        body = xstrdup("Invalid parameters.\n");
+    } else if (!strcmp(request->method, VTYSH_SERVER_EXECUTE)
+               || !strcmp(request->method, VTYSH_SERVER_EXECUTE_ALL)) {
+        if (params->n == 0) {
+            body = xstrdup("No command to execute.\n");
+        } else {
+            body = vtysh_server_execute(
+                conn, params,
+                !strcmp(request->method, VTYSH_SERVER_EXECUTE_ALL), &ok);
+        }
+    } else if (!strcmp(request->method, VTYSH_SERVER_EXIT)) {
+        if (conn->uid == 0 || conn->uid == getuid()) {
+            vtysh_server_exiting = true;
+            ok = true;
+        } else {
+            body = xstrdup("Permission denied.\n");
+        }
+    } else {
+        body = xasprintf("\"%s\" is not a valid command.\n",
+                         request->method);
+    }
+
+    if (ok) {
+        reply = jsonrpc_create_reply(json_string_create(body ? body : ""),
+                                     request->id);
+    } else {
+        reply = jsonrpc_create_error(json_string_create(body), request->id);
+    }
+    jsonrpc_send(conn->rpc, reply);
+    free(body);
+}
+
+/* Accepts a client on listener and records the user it runs as. */
+static void
+vtysh_server_accept(int listener)
+{
+    struct vtysh_server_conn *conn;
+    struct stream *stream;
+    struct ucred cred;
+    socklen_t cred_len = sizeof cred;
+    int error;
+    int fd;
+
+    fd = accept(listener, NULL, NULL);
+    if (fd < 0) {
+        if (errno != EAGAIN && errno != EINTR) {
+            VLOG_WARN("accept failed (%s)", ovs_strerror(errno));
+        }
+        return;
+    }
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) < 0) {
+        VLOG_WARN("Cannot get the client credentials (%s)",
+                  ovs_strerror(errno));
+        close(fd);
+        return;
+    }
+    error = set_nonblocking(fd);
+    if (!error) {
+        error = new_fd_stream("unix", fd, 0, AF_UNIX, &stream);
+    } else {
+        close(fd);
+    }
+    if (error) {
+        VLOG_WARN("Cannot open the client connection (%s)",
+                  ovs_strerror(error));
+        return;
+    }
+
+    if (vtysh_server_n_conns >= vtysh_server_allocated_conns) {
+        vtysh_server_conns = x2nrealloc(vtysh_server_conns,
+                                        &vtysh_server_allocated_conns,
+                                        sizeof *vtysh_server_conns);
+    }
+    conn = &vtysh_server_conns[vtysh_server_n_conns++];
+    conn->rpc = jsonrpc_open(stream);
+    conn->uid = cred.uid;
+}
+
+/* Runs the connection at index i, returns false if it was closed. */
+static bool
+vtysh_server_conn_run(size_t i)
+{
+    struct vtysh_server_conn *conn = &vtysh_server_conns[i];
+    struct jsonrpc_msg *msg;
+    int error;
+
+    jsonrpc_run(conn->rpc);
+    error = jsonrpc_get_status(conn->rpc);
+    if (!error && !jsonrpc_get_backlog(conn->rpc)) {
+        error = jsonrpc_recv(conn->rpc, &msg);
+        if (!error) {
+            if (msg->type == JSONRPC_REQUEST) {
+                vtysh_server_handle(conn, msg);
+            } else {
+                error = EINVAL;
+            }
+            jsonrpc_msg_destroy(msg);
+        }
+    }
+    if (error && error != EAGAIN) {
+        jsonrpc_close(conn->rpc);
+        vtysh_server_conns[i] = vtysh_server_conns[--vtysh_server_n_conns];
+        return false;
+    }
+    return true;
+}
+
+/* Serve commands on the socket path, relative to the OVS run directory
+ * unless absolute, until "vtysh/exit". */
+void
+vtysh_server_run(const char *path_)
+{
+    char *path;
+    size_t i;
+    int listener;
+
+    if (path_ == NULL) {
+        path_ = VTYSH_SERVER_SOCKET;
+    }
+    path = (path_[0] == '/' ? xstrdup(path_)
+                            : xasprintf("%s/%s", ovs_rundir(), path_));
+
+    listener = make_unix_socket(SOCK_STREAM, true, path, NULL);
+    /* Every user may connect, requests run as the connecting user. */
+    if (listener < 0 || chmod(path, 0666) < 0 || listen(listener, 64) < 0) {
+        VLOG_ERR("Failed to create the command server socket %s (%s)",
+                 path, ovs_strerror(listener < 0 ? -listener : errno));
+        exit(EXIT_FAILURE);
+    }
+    VLOG_INFO("Serving commands on %s", path);
+
+    while (!vtysh_server_exiting) {
+        vtysh_server_accept(listener);
+        for (i = 0; i < vtysh_server_n_conns; ) {
+            if (vtysh_server_conn_run(i)) {
+                i++;
+            }
+        }
+
+        poll_fd_wait(listener, POLLIN);
+        for (i = 0; i < vtysh_server_n_conns; i++) {
+            jsonrpc_wait(vtysh_server_conns[i].rpc);
+            if (!jsonrpc_get_backlog(vtysh_server_conns[i].rpc)) {
+                jsonrpc_recv_wait(vtysh_server_conns[i].rpc);
+            }
+        }
+        if (vtysh_server_exiting) {
+            poll_immediate_wake();
+        }
+        poll_block();
+    }
+
+    /* Flush the reply to "vtysh/exit". */
+    for (i = 0; i < vtysh_server_n_conns; i++) {
+        jsonrpc_run(vtysh_server_conns[i].rpc);
+        jsonrpc_close(vtysh_server_conns[i].rpc);
+    }
+    free(vtysh_server_conns);
+    close(listener);
+    fatal_signal_unlink_file_now(path);
+    free(path);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: vtysh_server.h
+ *
+ * Purpose: To add declarations required for vtysh_server.c, shared with
+ *          the vtysh-client.
+ */
+
+#ifndef _VTYSH_SERVER_H
+#define _VTYSH_SERVER_H
+
+#include <stdbool.h>
+
+/* Socket of the command server, in the OVS run directory. */
+#define VTYSH_SERVER_SOCKET       "vtysh-server.ctl"
+
+/* "vtysh/execute LINE..." runs the lines as the user that connected to the
+ * socket and stops at the first one that fails, like "vtysh -c".
+ * "vtysh/execute-all" runs every line, like "vtysh -n -c".  Lines may hold
+ * several commands separated by newlines.  The reply is the output of the
+ * commands, as an error reply if a command failed.  "vtysh/exit" is only
+ * accepted from root and from the user running the server. */
+#define VTYSH_SERVER_EXECUTE      "vtysh/execute"
+#define VTYSH_SERVER_EXECUTE_ALL  "vtysh/execute-all"
+#define VTYSH_SERVER_EXIT         "vtysh/exit"
+
+extern bool vtysh_server_mode;
+
+void vtysh_server_run(const char *path);
+
+#endif /* _VTYSH_SERVER_H */
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: vtysh_server_bench.c
+ *
+ * Purpose: Command throughput of "vtysh -c" against "vtysh --server".
+ */
+/****************************************************************************
+ * @ingroup cli/vtysh
+ *
+ * @file vtysh_server_bench.c
+ * Runs a command N times with "vtysh -c", then N times on a running
+ * command server, once with a connection per command as vtysh-client does
+ * and once over a single connection, and checks that vtysh and the server
+ * print the same output.  Run on a switch with "vtysh --server" started.
+ * Usage: vtysh_server_bench [N [COMMAND]].  Build with
+ * "make vtysh_server_bench".
+ *
+ ***************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "dynamic-string.h"
+#include "jsonrpc.h"
+#include "unixctl.h"
+#include "util.h"
+#include "vtysh_server.h"
+
+static double
+elapsed(struct timeval *start)
+{
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    return (now.tv_sec - start->tv_sec) * 1000.0
+           + (now.tv_usec - start->tv_usec) / 1000.0;
+}
+
+/* Run "vtysh -c command", appending its output to output if not NULL. */
+static void
+run_vtysh(const char *command, struct ds *output)
+{
+    int fds[2];
+    char buf[4096];
+    ssize_t n;
+    pid_t pid;
+
+    if (pipe(fds)) {
+        ovs_fatal(errno, "pipe failed");
+    }
+    pid = fork();
+    if (pid < 0) {
+        ovs_fatal(errno, "fork failed");
+    }
+    if (pid == 0) {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execlp("vtysh", "vtysh", "-c", command, (char *) NULL);
+        _exit(127);
+    }
+    close(fds[1]);
+    while ((n = read(fds[0], buf, sizeof buf)) > 0) {
+        if (output) {
+            ds_put_buffer(output, buf, n);
+        }
+    }
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+}
+
+/* Send command on client, or on a new connection if client is NULL. */
+static void
+run_server(struct jsonrpc *client, const char *command, struct ds *output)
+{
+    char *args[] = { CONST_CAST(char *, command) };
+    struct jsonrpc *conn = client;
+    char *result = NULL;
+    char *error = NULL;
+    int retval;
+
+    if (conn == NULL && unixctl_client_create(VTYSH_SERVER_SOCKET, &conn)) {
+        ovs_fatal(0, "cannot connect to the command server");
+    }
+    retval = unixctl_client_transact(conn, VTYSH_SERVER_EXECUTE, 1, args,
+                                     &result, &error);
+    if (retval) {
+        ovs_fatal(retval, "transaction failed");
+    }
+    if (output) {
+        ds_put_cstr(output, result ? result : error);
+    }
+    free(result);
+    free(error);
+    if (client == NULL) {
+        jsonrpc_close(conn);
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    int runs = argc > 1 ? atoi(argv[1]) : 100;
+    const char *command = argc > 2 ? argv[2] : "show version";
+    struct ds vtysh_output = DS_EMPTY_INITIALIZER;
+    struct ds server_output = DS_EMPTY_INITIALIZER;
+    double vtysh_ms, connect_ms, persistent_ms;
+    struct timeval start;
+    struct jsonrpc *client;
+    int mismatch;
+    int i;
+
+    set_program_name(argv[0]);
+    if (runs <= 0) {
+        ovs_fatal(0, "usage: %s [N [COMMAND]]", program_name);
+    }
+
+    run_vtysh(command, &vtysh_output);
+    run_server(NULL, command, &server_output);
+    mismatch = strcmp(ds_cstr(&vtysh_output), ds_cstr(&server_output)) != 0;
+
+    gettimeofday(&start, NULL);
+    for (i = 0; i < runs; i++) {
+        run_vtysh(command, NULL);
+    }
+    vtysh_ms = elapsed(&start);
+
+    gettimeofday(&start, NULL);
+    for (i = 0; i < runs; i++) {
+        run_server(NULL, command, NULL);
+    }
+    connect_ms = elapsed(&start);
+
+    if (unixctl_client_create(VTYSH_SERVER_SOCKET, &client)) {
+        ovs_fatal(0, "cannot connect to the command server");
+    }
+    gettimeofday(&start, NULL);
+    for (i = 0; i < runs; i++) {
+        run_server(client, command, NULL);
+    }
+    persistent_ms = elapsed(&start);
+    jsonrpc_close(client);
+
+    printf("\"%s\", %d runs\n", command, runs);
+    printf("vtysh -c:              %8.2f ms/command %8.1f commands/s\n",
+           vtysh_ms / runs, runs * 1000.0 / vtysh_ms);
+    printf("server, connect each:  %8.2f ms/command %8.1f commands/s\n",
+           connect_ms / runs, runs * 1000.0 / connect_ms);
+    printf("server, one connection:%8.2f ms/command %8.1f commands/s\n",
+           persistent_ms / runs, runs * 1000.0 / persistent_ms);
+    printf("output %s\n", mismatch ? "differs" : "matches");
+
+    ds_destroy(&vtysh_output);
+    ds_destroy(&server_output);
+    return mismatch;
+}
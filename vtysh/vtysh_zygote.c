@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: vtysh_zygote.c
+ *
+ * Purpose: Zygote mode of vtysh, "vtysh --zygote".
+ */
+/****************************************************************************
+ * @ingroup cli/vtysh
+ *
+ * @file vtysh_zygote.c
+ * The zygote is a vtysh that has loaded the plugins and built the command
+ * tree, and forks a session for every interactive login.  The vtysh started
+ * for the login passes its terminal and a few environment variables to the
+ * zygote and waits until the session ends.  The session gets the user that
+ * connected as its login uid, takes the terminal if the login gave it up,
+ * becomes that user, and returns to main() to check that the user may use
+ * vtysh before it starts its own OVSDB session.  The command
+ * tree is shared with the zygote copy-on-write.  The zygote must stay single
+ * threaded, the OVSDB thread is only started in the sessions.
+ *
+ ***************************************************************************/
+
+#include "config.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <grp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <unistd.h>
+#include "dirs.h"
+#include "util.h"
+#include "openvswitch/vlog.h"
+#include "vtysh/utils/audit_log_utils.h"
+#include "vtysh_zygote.h"
+
+VLOG_DEFINE_THIS_MODULE(vtysh_zygote);
+
+bool vtysh_zygote_mode = false;
+
+/* Largest environment passed from the login to its session. */
+#define VTYSH_ZYGOTE_ENV_MAX      4096
+
+/* Seconds a login has to send its terminal once connected.  Logins are
+ * received one at a time, so a client that connects and sends nothing
+ * must not hold up the ones after it. */
+#define VTYSH_ZYGOTE_RECV_TIMEOUT 2
+
+/* Environment of the login that is kept in its session. */
+static const char *const vtysh_zygote_env_names[] = {
+    "TERM", "LANG", "LC_ALL", "TZ", "PATH", "VTYSH_PAGER", REMOTE_USER_ENV,
+    "SSH_CLIENT", "SSH_CONNECTION", "SSH_TTY",
+};
+
+static char *
+vtysh_zygote_path(const char *path)
+{
+    if (path == NULL) {
+        path = VTYSH_ZYGOTE_SOCKET;
+    }
+    return (path[0] == '/' ? xstrdup(path)
+                           : xasprintf("%s/%s", ovs_rundir(), path));
+}
+
+static bool
+vtysh_zygote_sockaddr(const char *path, struct sockaddr_un *sun)
+{
+    if (strlen(path) >= sizeof sun->sun_path) {
+        return false;
+    }
+    memset(sun, 0, sizeof *sun);
+    sun->sun_family = AF_UNIX;
+    strcpy(sun->sun_path, path);
+    return true;
+}
+
+/* Returns the index of the environment variable var in
+ * vtysh_zygote_env_names, or -1 if it is not passed to sessions. */
+static int
+vtysh_zygote_env_find(const char *var)
+{
+    size_t len = strcspn(var, "=");
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(vtysh_zygote_env_names); i++) {
+        if (strlen(vtysh_zygote_env_names[i]) == len
+            && !strncmp(var, vtysh_zygote_env_names[i], len)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Sends the terminal fds and the environment, as NUL terminated
+ * "NAME=VALUE" strings, on sock. */
+static bool
+vtysh_zygote_send(int sock)
+{
+    int fds[3] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+    char env[VTYSH_ZYGOTE_ENV_MAX];
+    size_t env_len = 0;
+    union {
+        struct cmsghdr cm;
+        char control[CMSG_SPACE(sizeof fds)];
+    } control;
+    struct cmsghdr *cmsg;
+    struct msghdr msg;
+    struct iovec iov;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(vtysh_zygote_env_names); i++) {
+        const char *value = getenv(vtysh_zygote_env_names[i]);
+        int n;
+
+        if (value == NULL) {
+            continue;
+        }
+        n = snprintf(env + env_len, sizeof env - env_len, "%s=%s",
+                     vtysh_zygote_env_names[i], value);
+        if (n < 0 || n + 1 > sizeof env - env_len) {
+            break;
+        }
+        env_len += n + 1;
+    }
+    if (env_len == 0) {
+        env[env_len++] = '\0';
+    }
+
+    memset(&msg, 0, sizeof msg);
+    iov.iov_base = env;
+    iov.iov_len = env_len;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.control;
+    msg.msg_controllen = sizeof control.control;
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof fds);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof fds);
+
+    return sendmsg(sock, &msg, 0) == env_len;
+}
+
+/* Hands the terminal to the zygote, which forks a session for it, and
+ * waits until the session ends.  Returns -1 if there is no zygote and the
+ * login must start vtysh itself, otherwise the exit status. */
+int
+vtysh_zygote_login(void)
+{
+    struct sockaddr_un sun;
+    bool released;
+    char *path;
+    char buf;
+    int sock;
+
+    path = vtysh_zygote_path(NULL);
+    sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0 || !vtysh_zygote_sockaddr(path, &sun)
+        || connect(sock, (struct sockaddr *) &sun, sizeof sun) < 0) {
+        if (sock >= 0) {
+            close(sock);
+        }
+        free(path);
+        return -1;
+    }
+    free(path);
+
+    /* The session makes the terminal its controlling terminal without
+     * stealing it, which works only once no session has it: a login that
+     * leads its session gives it up first. */
+    released = getsid(0) == getpid() && isatty(STDIN_FILENO);
+    if (released) {
+        signal(SIGHUP, SIG_IGN);
+        if (ioctl(STDIN_FILENO, TIOCNOTTY) < 0) {
+            signal(SIGHUP, SIG_DFL);
+            released = false;
+        }
+    }
+    if (!vtysh_zygote_send(sock)) {
+        if (released) {
+            ioctl(STDIN_FILENO, TIOCSCTTY, 0);
+            signal(SIGHUP, SIG_DFL);
+        }
+        close(sock);
+        return -1;
+    }
+
+    /* The session owns the terminal now, keys are for it. */
+    signal(SIGINT, SIG_IGN);
+    signal(SIGQUIT, SIG_IGN);
+    signal(SIGTSTP, SIG_IGN);
+
+    /* The connection is closed when the session exits. */
+    for (;;) {
+        ssize_t n = read(sock, &buf, 1);
+
+        if (n == 0 || (n < 0 && errno != EINTR)) {
+            break;
+        }
+    }
+    close(sock);
+    return 0;
+}
+
+/* Receives the terminal fds and the environment sent by
+ * vtysh_zygote_send() on conn, and the uid of the login. */
+static bool
+vtysh_zygote_receive(int conn, int fds[3], char *env, size_t env_size,
+                     size_t *env_len, uid_t *uid)
+{
+    union {
+        struct cmsghdr cm;
+        char control[CMSG_SPACE(3 * sizeof(int))];
+    } control;
+    struct cmsghdr *cmsg;
+    struct ucred cred;
+    socklen_t cred_len = sizeof cred;
+    struct timeval timeout;
+    struct msghdr msg;
+    struct iovec iov;
+    ssize_t n;
+
+    if (getsockopt(conn, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) < 0) {
+        VLOG_WARN("Cannot get the login credentials (%s)",
+                  ovs_strerror(errno));
+        return false;
+    }
+    *uid = cred.uid;
+
+    timeout.tv_sec = VTYSH_ZYGOTE_RECV_TIMEOUT;
+    timeout.tv_usec = 0;
+    if (setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+                   sizeof timeout) < 0) {
+        VLOG_WARN("Cannot set the login receive timeout (%s)",
+                  ovs_strerror(errno));
+        return false;
+    }
+
+    memset(&msg, 0, sizeof msg);
+    iov.iov_base = env;
+    iov.iov_len = env_size - 1;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.control;
+    msg.msg_controllen = sizeof control.control;
+    do {
+        n = recvmsg(conn, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        VLOG_WARN("Login of uid %u sent nothing in %d seconds, dropped",
+                  (unsigned int) cred.uid, VTYSH_ZYGOTE_RECV_TIMEOUT);
+        return false;
+    }
+    if (n <= 0) {
+        return false;
+    }
+    env[n] = '\0';
+    *env_len = n;
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg == NULL || cmsg->cmsg_level != SOL_SOCKET
+        || cmsg->cmsg_type != SCM_RIGHTS
+        || cmsg->cmsg_len != CMSG_LEN(3 * sizeof(int))) {
+        VLOG_WARN("Login of uid %u did not pass its terminal",
+                  (unsigned int) cred.uid);
+        return false;
+    }
+    memcpy(fds, CMSG_DATA(cmsg), 3 * sizeof(int));
+    return true;
+}
+
+/* Makes uid the login uid of the process, as login does, so that the
+ * audit records of the session name the user of the login and not the
+ * one that started the zygote.  Needs root, before the uid changes. */
+static void
+vtysh_zygote_set_loginuid(uid_t uid)
+{
+    char buf[16];
+    int fd;
+    int n;
+
+    fd = open("/proc/self/loginuid", O_WRONLY);
+    if (fd < 0) {
+        /* No loginuid without audit support in the kernel. */
+        if (errno != ENOENT) {
+            VLOG_WARN("Cannot set the login uid to %u (%s)",
+                      (unsigned int) uid, ovs_strerror(errno));
+        }
+        return;
+    }
+    n = snprintf(buf, sizeof buf, "%u", (unsigned int) uid);
+    if (write(fd, buf, n) != n) {
+        VLOG_WARN("Cannot set the login uid to %u (%s)",
+                  (unsigned int) uid, ovs_strerror(errno));
+    }
+    close(fd);
+}
+
+/* Turns the forked process into the session of the user uid on the
+ * terminal fds. */
+static struct passwd *
+vtysh_zygote_session(int conn, int fds[3], char *env, size_t env_len,
+                     uid_t uid)
+{
+    struct passwd *pw;
+    char *var;
+    int i;
+
+    vtysh_zygote_set_loginuid(uid);
+    setsid();
+    for (i = 0; i < 3; i++) {
+        dup2(fds[i], i);
+    }
+    for (i = 0; i < 3; i++) {
+        if (fds[i] > STDERR_FILENO) {
+            close(fds[i]);
+        }
+    }
+    /* Make the terminal the controlling terminal if the login gave it up,
+     * never steal it from another session. */
+    if (isatty(STDIN_FILENO)) {
+        if (ioctl(STDIN_FILENO, TIOCSCTTY, 0) == 0) {
+            tcsetpgrp(STDIN_FILENO, getpgrp());
+        } else {
+            VLOG_DBG("Session of uid %u runs without a controlling "
+                     "terminal (%s)", (unsigned int) uid,
+                     ovs_strerror(errno));
+        }
+    }
+
+    pw = getpwuid(uid);
+    if (pw == NULL) {
+        fprintf(stderr, "Unknown User.\n");
+        exit(1);
+    }
+    if (initgroups(pw->pw_name, pw->pw_gid) || setgid(pw->pw_gid)
+        || setuid(pw->pw_uid)) {
+        fprintf(stderr, "Cannot start a session for %s (%s).\n",
+                pw->pw_name, ovs_strerror(errno));
+        exit(1);
+    }
+
+    clearenv();
+    setenv("HOME", pw->pw_dir, 1);
+    setenv("USER", pw->pw_name, 1);
+    setenv("LOGNAME", pw->pw_name, 1);
+    setenv("SHELL", pw->pw_shell, 1);
+    for (var = env; var < env + env_len; var += strlen(var) + 1) {
+        if (vtysh_zygote_env_find(var) >= 0) {
+            putenv(xstrdup(var));
+        }
+    }
+    if (chdir(pw->pw_dir) < 0) {
+        ignore(chdir("/"));
+    }
+
+    /* The login waits for conn to be closed, which happens when the session
+     * exits.  Programs run from the session must not keep it open. */
+    ignore(fcntl(conn, F_SETFD, FD_CLOEXEC));
+    return pw;
+}
+
+/* Accepts logins on the socket path, relative to the OVS run directory
+ * unless absolute.  Returns only in the forked session of a login, as the
+ * user of that login. */
+struct passwd *
+vtysh_zygote_run(const char *path_)
+{
+    char *path = vtysh_zygote_path(path_);
+    struct sockaddr_un sun;
+    int listener;
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || !vtysh_zygote_sockaddr(path, &sun)) {
+        VLOG_ERR("Failed to create the zygote socket %s", path);
+        exit(EXIT_FAILURE);
+    }
+    unlink(path);
+    /* Every user may connect, the session runs as the connecting user. */
+    if (bind(listener, (struct sockaddr *) &sun, sizeof sun) < 0
+        || chmod(path, 0666) < 0 || listen(listener, 64) < 0) {
+        VLOG_ERR("Failed to create the zygote socket %s (%s)",
+                 path, ovs_strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    signal(SIGCHLD, SIG_IGN);
+    VLOG_INFO("Zygote waiting for logins on %s", path);
+
+    for (;;) {
+        char env[VTYSH_ZYGOTE_ENV_MAX];
+        size_t env_len;
+        int fds[3];
+        uid_t uid;
+        pid_t pid;
+        int conn;
+        int i;
+
+        conn = accept(listener, NULL, NULL);
+        if (conn < 0) {
+            if (errno != EINTR) {
+                VLOG_WARN("accept failed on %s (%s)", path,
+                          ovs_strerror(errno));
+            }
+            continue;
+        }
+        if (!vtysh_zygote_receive(conn, fds, env, sizeof env, &env_len,
+                                  &uid)) {
+            close(conn);
+            continue;
+        }
+
+        pid = fork();
+        if (pid == 0) {
+            signal(SIGCHLD, SIG_DFL);
+            close(listener);
+            free(path);
+            return vtysh_zygote_session(conn, fds, env, env_len, uid);
+        }
+        if (pid < 0) {
+            VLOG_ERR("Failed to fork a session for uid %u (%s)",
+                     (unsigned int) uid, ovs_strerror(errno));
+        }
+        for (i = 0; i < 3; i++) {
+            close(fds[i]);
+        }
+        close(conn);
+    }
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2016 Hewlett Packard Enterprise Development LP
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * File: vtysh_zygote.h
+ *
+ * Purpose: To add declarations required for vtysh_zygote.c
+ */
+
+#ifndef _VTYSH_ZYGOTE_H
+#define _VTYSH_ZYGOTE_H
+
+#include <pwd.h>
+#include <stdbool.h>
+
+/* Socket of the zygote, in the OVS run directory. */
+#define VTYSH_ZYGOTE_SOCKET       "vtysh-zygote.sock"
+
+/* True in the zygote and in the sessions forked from it. */
+extern bool vtysh_zygote_mode;
+
+int vtysh_zygote_login(void);
+struct passwd *vtysh_zygote_run(const char *path);
+
+#endif /* _VTYSH_ZYGOTE_H */